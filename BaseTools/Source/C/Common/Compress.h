@@ -2,7 +2,7 @@
 Header file for compression routine.
 Providing both EFI and Tiano Compress algorithms.
 
-Copyright (c) 2004 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2004 - 2020, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -79,4 +79,68 @@ EFI_STATUS
   IN OUT  UINT32  *DstSize
   );
 
+//
+// Compression levels. COMPRESS_LEVEL_DEFAULT uses the binary tree match
+// finder, higher levels the hash chain match finder.
+//
+#define COMPRESS_LEVEL_DEFAULT  0
+#define COMPRESS_LEVEL_MAX      9
+
+/*++
+
+Routine Description:
+
+  Receives an original character (CharC < 0x100, Pos ignored), or a
+  string length element and the position (distance - 1) of a pointer.
+
+--*/
+typedef
+VOID
+(*COMPRESS_OUTPUT_FUNCTION) (
+  IN UINT32  CharC,
+  IN UINT32  Pos
+  );
+
+/*++
+
+Routine Description:
+
+  Select the match finder used by EfiCompress () and TianoCompress ().
+
+--*/
+EFI_STATUS
+SetCompressLevel (
+  IN UINT32  Level
+  )
+;
+
+/*++
+
+Routine Description:
+
+  Return the compression level set by SetCompressLevel ().
+
+--*/
+UINT32
+GetCompressLevel (
+  VOID
+  )
+;
+
+/*++
+
+Routine Description:
+
+  LZ77 parse of the whole source with the hash chain match finder.
+
+--*/
+EFI_STATUS
+HashChainEncode (
+  IN UINT8                     *SrcBuffer,
+  IN UINT32                    SrcSize,
+  IN UINT32                    WindowBits,
+  IN COMPRESS_OUTPUT_FUNCTION  Output
+  )
+;
+
 #endif
@@ -0,0 +1,318 @@
+/** @file
+Hash chain match finder shared by the EFI and Tiano compression routines.
+
+The default compression level keeps using the binary tree match finder of
+EfiCompress.c and TianoCompress.c, which produces the same output as older
+tools. Levels 1 - 9 replace it with hash chains of bounded depth and,
+from level 4 on, lazy matching. The output is the same bitstream and can be
+decompressed by any EFI/Tiano decompressor.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "Compress.h"
+
+#define UINT8_MAX_VALUE   0xff
+#define THRESHOLD         3
+#define MAXMATCH          256
+#define HASH_BITS         16
+#define HASH_SIZE         (1U << HASH_BITS)
+#define HASH_NIL          0xFFFFFFFFU
+//
+// A match of THRESHOLD bytes farther away than this costs more bits than
+// the characters, see the Tiano Encode ().
+//
+#define FAR_THRESHOLD_POS (1U << 11)
+
+typedef struct {
+  UINT32   MaxChain;   // Candidates visited per position
+  UINT32   NiceLength; // Stop searching once a match this long is found
+  BOOLEAN  Lazy;       // Defer a match if the next position has a longer one
+} COMPRESS_LEVEL_CONFIG;
+
+STATIC CONST COMPRESS_LEVEL_CONFIG mLevelConfig[COMPRESS_LEVEL_MAX + 1] = {
+  {    0,        0, FALSE },  // 0: binary tree match finder, not used here
+  {    4,       16, FALSE },
+  {    8,       32, FALSE },
+  {   16,       64, FALSE },
+  {   16,       32, TRUE  },
+  {   32,       64, TRUE  },
+  {   64,      128, TRUE  },
+  {  256, MAXMATCH, TRUE  },
+  { 1024, MAXMATCH, TRUE  },
+  { 4096, MAXMATCH, TRUE  }
+};
+
+STATIC UINT32  mCompressLevel = COMPRESS_LEVEL_DEFAULT;
+
+STATIC UINT8   *mHcSrc;
+STATIC UINT32  mHcSrcSize;
+STATIC UINT32  mHcWindowMask;
+STATIC UINT32  mHcMaxDistance;
+STATIC UINT32  *mHcHead;
+STATIC UINT32  *mHcPrev;
+STATIC CONST COMPRESS_LEVEL_CONFIG *mHcConfig;
+
+EFI_STATUS
+SetCompressLevel (
+  IN UINT32  Level
+  )
+/*++
+
+Routine Description:
+
+  Select the match finder used by EfiCompress () and TianoCompress ().
+
+Arguments:
+
+  Level       - COMPRESS_LEVEL_DEFAULT for the binary tree match finder,
+                1 - COMPRESS_LEVEL_MAX for hash chains, higher is slower
+                and usually smaller.
+
+Returns:
+
+  EFI_SUCCESS           - The level is set.
+  EFI_INVALID_PARAMETER - Level is out of range.
+
+--*/
+{
+  if (Level > COMPRESS_LEVEL_MAX) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mCompressLevel = Level;
+  return EFI_SUCCESS;
+}
+
+UINT32
+GetCompressLevel (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Return the compression level set by SetCompressLevel ().
+
+--*/
+{
+  return mCompressLevel;
+}
+
+STATIC
+UINT32
+HashChainHash (
+  IN UINT32 Pos
+  )
+{
+  UINT32  Value;
+
+  Value = ((UINT32) mHcSrc[Pos] << 16) | ((UINT32) mHcSrc[Pos + 1] << 8) | mHcSrc[Pos + 2];
+  return (Value * 2654435761U) >> (32 - HASH_BITS);
+}
+
+STATIC
+VOID
+HashChainInsert (
+  IN UINT32 Pos
+  )
+{
+  UINT32  Hash;
+
+  if (Pos + THRESHOLD > mHcSrcSize) {
+    return;
+  }
+
+  Hash                            = HashChainHash (Pos);
+  mHcPrev[Pos & mHcWindowMask]    = mHcHead[Hash];
+  mHcHead[Hash]                   = Pos;
+}
+
+STATIC
+UINT32
+HashChainFindMatch (
+  IN  UINT32 Pos,
+  OUT UINT32 *Distance
+  )
+/*++
+
+Routine Description:
+
+  Find the longest earlier string matching the one at Pos. Pos itself must
+  not have been inserted yet.
+
+Arguments:
+
+  Pos         - The position in the source to match
+  Distance    - The distance back to the match
+
+Returns:
+
+  The length of the match, 0 if none of at least THRESHOLD bytes was found.
+
+--*/
+{
+  UINT32  Limit;
+  UINT32  Candidate;
+  UINT32  Chain;
+  UINT32  BestLength;
+  UINT32  Length;
+  UINT8   *Current;
+  UINT8   *Match;
+
+  if (Pos + THRESHOLD > mHcSrcSize) {
+    return 0;
+  }
+
+  Limit = mHcSrcSize - Pos;
+  if (Limit > MAXMATCH) {
+    Limit = MAXMATCH;
+  }
+
+  Current    = mHcSrc + Pos;
+  BestLength = THRESHOLD - 1;
+  Candidate  = mHcHead[HashChainHash (Pos)];
+  Chain      = mHcConfig->MaxChain;
+
+  while (Candidate != HASH_NIL && Pos - Candidate <= mHcMaxDistance && Chain-- > 0) {
+    Match = mHcSrc + Candidate;
+    //
+    // Only a candidate which also matches the byte after the best match
+    // so far can be longer.
+    //
+    if (Match[BestLength] == Current[BestLength] && Match[0] == Current[0] && Match[1] == Current[1]) {
+      Length = 2;
+      while (Length < Limit && Match[Length] == Current[Length]) {
+        Length++;
+      }
+
+      if (Length > BestLength) {
+        BestLength = Length;
+        *Distance  = Pos - Candidate;
+        if (Length >= Limit || Length >= mHcConfig->NiceLength) {
+          break;
+        }
+      }
+    }
+
+    Candidate = mHcPrev[Candidate & mHcWindowMask];
+  }
+
+  if (BestLength < THRESHOLD) {
+    return 0;
+  }
+
+  if (BestLength == THRESHOLD && *Distance - 1 > FAR_THRESHOLD_POS) {
+    return 0;
+  }
+
+  return BestLength;
+}
+
+EFI_STATUS
+HashChainEncode (
+  IN UINT8                     *SrcBuffer,
+  IN UINT32                    SrcSize,
+  IN UINT32                    WindowBits,
+  IN COMPRESS_OUTPUT_FUNCTION  Output
+  )
+/*++
+
+Routine Description:
+
+  LZ77 parse of the whole source with the hash chain match finder, at the
+  level set by SetCompressLevel (). The caller must have started Huffman
+  encoding, Output () receives the same symbols as from the binary tree
+  match finder.
+
+Arguments:
+
+  SrcBuffer   - The buffer storing the source data
+  SrcSize     - The size of source data
+  WindowBits  - log2 of the sliding window size of the bitstream format
+  Output      - Receives each original character, or string length and position
+
+Returns:
+
+  EFI_SUCCESS           - The source is parsed.
+  EFI_OUT_OF_RESOURCES  - Not enough memory for compression process.
+  EFI_INVALID_PARAMETER - The compression level is the default one.
+
+--*/
+{
+  UINT32  Pos;
+  UINT32  Index;
+  UINT32  Length;
+  UINT32  Distance;
+  UINT32  NextLength;
+  UINT32  NextDistance;
+  BOOLEAN HaveNext;
+
+  if (mCompressLevel == COMPRESS_LEVEL_DEFAULT) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mHcHead = malloc (HASH_SIZE * sizeof (*mHcHead));
+  mHcPrev = malloc ((1U << WindowBits) * sizeof (*mHcPrev));
+  if (mHcHead == NULL || mHcPrev == NULL) {
+    free (mHcHead);
+    free (mHcPrev);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  memset (mHcHead, 0xFF, HASH_SIZE * sizeof (*mHcHead));
+
+  mHcSrc          = SrcBuffer;
+  mHcSrcSize      = SrcSize;
+  mHcWindowMask   = (1U << WindowBits) - 1;
+  mHcMaxDistance  = (1U << WindowBits) - 1;
+  mHcConfig       = &mLevelConfig[mCompressLevel];
+
+  NextLength   = 0;
+  NextDistance = 0;
+  Distance     = 0;
+  HaveNext     = FALSE;
+  Pos          = 0;
+  while (Pos < SrcSize) {
+    if (HaveNext) {
+      Length    = NextLength;
+      Distance  = NextDistance;
+      HaveNext  = FALSE;
+    } else {
+      Length = HashChainFindMatch (Pos, &Distance);
+    }
+    HashChainInsert (Pos);
+
+    if (Length == 0) {
+      Output (SrcBuffer[Pos], 0);
+      Pos++;
+      continue;
+    }
+
+    if (mHcConfig->Lazy && Length < mHcConfig->NiceLength) {
+      //
+      // Emit a character instead if a longer match starts at the next position
+      //
+      NextLength = HashChainFindMatch (Pos + 1, &NextDistance);
+      if (NextLength > Length) {
+        HaveNext = TRUE;
+        Output (SrcBuffer[Pos], 0);
+        Pos++;
+        continue;
+      }
+    }
+
+    Output (Length + (UINT8_MAX_VALUE + 1 - THRESHOLD), Distance - 1);
+    for (Index = 1; Index < Length; Index++) {
+      HashChainInsert (Pos + Index);
+    }
+    Pos += Length;
+  }
+
+  free (mHcHead);
+  free (mHcPrev);
+  mHcHead = NULL;
+  mHcPrev = NULL;
+  return EFI_SUCCESS;
+}
@@ -4,7 +4,7 @@ coding. LZ77 transforms the source data into a sequence of Original Characters
 and Pointers to repeated strings. This sequence is further divided into Blocks
 and Huffman codings are applied to each Block.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2020, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -870,10 +870,23 @@ Returns:
     return Status;
   }
 
-  InitSlide();
-
   HufEncodeStart();
 
+  if (GetCompressLevel() != COMPRESS_LEVEL_DEFAULT) {
+    //
+    // Hash chain match finder over the whole source
+    //
+    mOrigSize = (UINT32) (mSrcUpperLimit - mSrc);
+    Status    = HashChainEncode(mSrc, mOrigSize, WNDBIT, Output);
+    if (!EFI_ERROR(Status)) {
+      HufEncodeEnd();
+    }
+    FreeMemory();
+    return Status;
+  }
+
+  InitSlide();
+
   mRemainder = FreadCrc(&mText[WNDSIZ], WNDSIZ + MAXMATCH);
 
   mMatchLen = 0;
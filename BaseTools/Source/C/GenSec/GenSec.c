@@ -1,7 +1,7 @@
 /** @file
 Creates output file that is a properly formed section per the PI spec.
 
-Copyright (c) 2004 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2004 - 2020, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -149,7 +149,7 @@ Returns:
   //
   // Copyright declaration
   //
-  fprintf (stdout, "Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.\n\n");
+  fprintf (stdout, "Copyright (c) 2007 - 2020, Intel Corporation. All rights reserved.\n\n");
 
   //
   // Details Option
@@ -171,6 +171,10 @@ Returns:
   fprintf (stdout, "  -c [Type], --compress [Type]\n\
                         Compress method type can be PI_NONE or PI_STD.\n\
                         if -c option is not given, PI_STD is default type.\n");
+  fprintf (stdout, "  --compress-level Level\n\
+                        Level of PI_STD compression, 0~9. 0 (default) uses the\n\
+                        original match finder, 1~9 the faster hash chain match\n\
+                        finder, 9 compresses best.\n");
   fprintf (stdout, "  -g GuidValue, --vendor GuidValue\n\
                         GuidValue is one specific vendor guid value.\n\
                         Its format is xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx\n");
@@ -1128,6 +1132,7 @@ Returns:
   UINT8                     *OutFileBuffer;
   EFI_STATUS                Status;
   UINT64                    LogLevel;
+  UINT64                    CompressLevel;
   UINT32                    *InputFileAlign;
   UINT32                    InputFileAlignNum;
   EFI_COMMON_SECTION_HEADER *SectionHeader;
@@ -1226,6 +1231,22 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--compress-level") == 0) {
+      if (argv[1] == NULL) {
+        Error (NULL, 0, 1003, "Invalid option value", "Compression level can't be NULL");
+        goto Finish;
+      }
+      Status = AsciiStringToUint64 (argv[1], FALSE, &CompressLevel);
+      if (EFI_ERROR (Status) || CompressLevel > COMPRESS_LEVEL_MAX) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        goto Finish;
+      }
+      SetCompressLevel ((UINT32) CompressLevel);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
     if ((stricmp (argv[0], "-g") == 0) || (stricmp (argv[0], "--vendor") == 0)) {
       Status = StringToGuid (argv[1], &VendorGuid);
       if (EFI_ERROR (Status)) {
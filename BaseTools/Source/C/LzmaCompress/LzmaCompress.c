@@ -5,7 +5,7 @@
     LzmaUtil.c -- Test application for LZMA compression
     2018-04-30 : Igor Pavlov : Public domain
 
-  Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2020, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -27,6 +27,17 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Chunked container, see LZMA_CHUNKED_HEADER in
+// MdeModulePkg/Include/Guid/LzmaDecompress.h. The header is followed by
+// ChunkCount + 1 UINT32 offsets of the chunks from the start of the
+// container, the last one being the container size. Every chunk is an
+// independent LZMA stream with its own LZMA_HEADER_SIZE header.
+//
+#define LZMA_CHUNKED_SIGNATURE    0x4B435A4C  // "LZCK"
+#define LZMA_CHUNKED_HEADER_SIZE  24
+#define LZMA_CHUNKED_DEFAULT_SIZE 1024        // in KB
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -44,6 +55,7 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mChunkSize = 0;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -60,6 +72,8 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --chunked: split the data into independently compressed chunks\n"
+             "  --chunk-size Size: chunk size in KB for --chunked, default: 1024\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -238,6 +252,170 @@ Done:
   return res;
 }
 
+static void WriteUInt32(Byte *buffer, UInt32 value)
+{
+  int i;
+  for (i = 0; i < 4; i++)
+    buffer[i] = (Byte)(value >> (8 * i));
+}
+
+static UInt32 ReadUInt32(const Byte *buffer)
+{
+  return (UInt32)buffer[0] | ((UInt32)buffer[1] << 8) | ((UInt32)buffer[2] << 16) | ((UInt32)buffer[3] << 24);
+}
+
+static SRes EncodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  size_t chunkSize = (size_t)mChunkSize;
+  UInt32 chunkCount;
+  UInt32 index;
+  size_t headerSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t outPos;
+
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+
+  inBuffer = (Byte *)MyAlloc(inSize == 0 ? 1 : inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = (UInt32)((inSize + chunkSize - 1) / chunkSize);
+  headerSize = LZMA_CHUNKED_HEADER_SIZE + ((size_t)chunkCount + 1) * 4;
+
+  // every chunk gets 105% of its size + 64KB, as for the unchunked stream
+  outSize = headerSize + (inSize / 20 * 21) + (size_t)chunkCount * ((1 << 16) + LZMA_HEADER_SIZE);
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+  memset(outBuffer, 0, headerSize);
+  WriteUInt32(outBuffer, LZMA_CHUNKED_SIGNATURE);
+  WriteUInt32(outBuffer + 4, (UInt32)chunkSize);
+  WriteUInt32(outBuffer + 8, chunkCount);
+  WriteUInt32(outBuffer + 16, (UInt32)inSize);
+
+  outPos = headerSize;
+  for (index = 0; index < chunkCount; index++) {
+    size_t chunkStart = (size_t)index * chunkSize;
+    size_t chunkLength = inSize - chunkStart < chunkSize ? inSize - chunkStart : chunkSize;
+    size_t outSizeProcessed = outSize - outPos - LZMA_HEADER_SIZE;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    int i;
+
+    WriteUInt32(outBuffer + LZMA_CHUNKED_HEADER_SIZE + (size_t)index * 4, (UInt32)outPos);
+    for (i = 0; i < 8; i++)
+      outBuffer[outPos + LZMA_PROPS_SIZE + i] = (Byte)((UInt64)chunkLength >> (8 * i));
+
+    res = LzmaEncode(outBuffer + outPos + LZMA_HEADER_SIZE, &outSizeProcessed,
+        inBuffer + chunkStart, chunkLength,
+        props, outBuffer + outPos, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+
+    outPos += LZMA_HEADER_SIZE + outSizeProcessed;
+  }
+  WriteUInt32(outBuffer + LZMA_CHUNKED_HEADER_SIZE + (size_t)chunkCount * 4, (UInt32)outPos);
+
+  res = SZ_OK;
+  if (outStream->Write(outStream, outBuffer, outPos) != outPos)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t outPos;
+  UInt32 chunkCount;
+  UInt32 index;
+
+  if (inSize < LZMA_CHUNKED_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = ReadUInt32(inBuffer + 8);
+  outSize = ReadUInt32(inBuffer + 16);
+  if (ReadUInt32(inBuffer) != LZMA_CHUNKED_SIGNATURE ||
+      inSize < LZMA_CHUNKED_HEADER_SIZE + ((size_t)chunkCount + 1) * 4) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  outBuffer = (Byte *)MyAlloc(outSize == 0 ? 1 : outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  outPos = 0;
+  for (index = 0; index < chunkCount; index++) {
+    size_t chunkStart = ReadUInt32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + (size_t)index * 4);
+    size_t chunkEnd = ReadUInt32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + ((size_t)index + 1) * 4);
+    size_t chunkLength;
+    size_t inSizePure;
+    ELzmaStatus status;
+
+    if (chunkEnd > inSize || chunkStart + LZMA_HEADER_SIZE > chunkEnd) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+    chunkLength = (size_t)ReadUInt32(inBuffer + chunkStart + LZMA_PROPS_SIZE);
+    if (chunkLength > outSize - outPos) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+    inSizePure = chunkEnd - chunkStart - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + outPos, &chunkLength, inBuffer + chunkStart + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer + chunkStart, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+    outPos += chunkLength;
+  }
+
+  if (outPos != outSize) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 int main2(int numArgs, const char *args[], char *rs)
 {
   CFileSeqInStream inStream;
@@ -272,6 +450,19 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunked") == 0) {
+      if (mChunkSize == 0) {
+        mChunkSize = LZMA_CHUNKED_DEFAULT_SIZE;
+      }
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[param + 1],FALSE,&mChunkSize);
+      if ((mChunkSize == 0) || (mChunkSize > 0x100000)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      param++;
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -342,6 +533,11 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if ((mChunkSize != 0) && (mConType != NoConverter)) {
+    return PrintError(rs, "--chunked can not be used together with --f86");
+  }
+  mChunkSize *= 1024;
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -364,14 +560,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    if (mChunkSize != 0) {
+      res = EncodeChunked(&outStream.vt, &inStream.vt, fileSize, &props);
+    } else {
+      res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    if (mChunkSize != 0) {
+      res = DecodeChunked(&outStream.vt, &inStream.vt, fileSize);
+    } else {
+      res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
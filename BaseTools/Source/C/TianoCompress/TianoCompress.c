@@ -5,7 +5,7 @@ and Pointers to repeated strings.
 This sequence is further divided into Blocks and Huffman codings are applied to
 each Block.
 
-Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2007 - 2020, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -763,10 +763,23 @@ Returns:
     return Status;
   }
 
-  InitSlide ();
-
   HufEncodeStart ();
 
+  if (GetCompressLevel () != COMPRESS_LEVEL_DEFAULT) {
+    //
+    // Hash chain match finder over the whole source
+    //
+    mOrigSize = (UINT32) (mSrcUpperLimit - mSrc);
+    Status    = HashChainEncode (mSrc, mOrigSize, WNDBIT, Output);
+    if (!EFI_ERROR (Status)) {
+      HufEncodeEnd ();
+    }
+    FreeMemory ();
+    return Status;
+  }
+
+  InitSlide ();
+
   mRemainder  = FreadCrc (&mText[WNDSIZ], WNDSIZ + MAXMATCH);
 
   mMatchLen   = 0;
@@ -1693,7 +1706,7 @@ Returns:
   //
   // Copyright declaration
   //
-  fprintf (stdout, "Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.\n\n");
+  fprintf (stdout, "Copyright (c) 2007 - 2020, Intel Corporation. All rights reserved.\n\n");
 
   //
   // Details Option
@@ -1701,6 +1714,9 @@ Returns:
   fprintf (stdout, "Options:\n");
   fprintf (stdout, "  --uefi\n\
             Enable UefiCompress, use TianoCompress when without this option\n");
+  fprintf (stdout, "  --level [0-9]\n\
+            Compression level. 0 (default) uses the original match finder,\n\
+            1-9 use the faster hash chain match finder, 9 compresses best.\n");
   fprintf (stdout, "  -o FileName, --output FileName\n\
             File will be created to store the output content.\n");
   fprintf (stdout, "  -v, --verbose\n\
@@ -1752,6 +1768,7 @@ Returns:
   UINT8      *Src;
   UINT32     OrigSize;
   UINT32     CompSize;
+  UINT64     Level;
 
   SetUtilityName(UTILITY_NAME);
 
@@ -1829,6 +1846,22 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--level") == 0) {
+      if (argc < 2) {
+        Error (NULL, 0, 1003, "Invalid option value", "Compression level is missing for --level option");
+        goto ERROR;
+      }
+      Status = AsciiStringToUint64 (argv[1], FALSE, &Level);
+      if (EFI_ERROR (Status) || Level > COMPRESS_LEVEL_MAX) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        goto ERROR;
+      }
+      SetCompressLevel ((UINT32) Level);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
     if (stricmp (argv[0], "--debug") == 0) {
       argc-=2;
       argv++;
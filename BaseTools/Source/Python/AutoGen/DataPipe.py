@@ -155,6 +155,8 @@ class MemoryDataPipe(DataPipe):
 
         self.DataContainer = {"DatabasePath":GlobalData.gDatabasePath}
 
+        self.DataContainer = {"MetaFileCacheDir":GlobalData.gMetaFileCacheDir}
+
         self.DataContainer = {"FdfParser": True if GlobalData.gFdfParser else False}
 
         self.DataContainer = {"LogLevel": EdkLogger.GetLevel()}
@@ -0,0 +1,140 @@
+## @file
+# Content addressed cache of the files generated by the GenFds tools
+#
+# The cache is used by GenFds when it runs GenSec, GenFfs and GenFw itself,
+# and by the GenFdsCache tool, which wraps the same commands in the module
+# makefiles generated for --genfds-multi-thread.
+#
+# Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+import os
+import shutil
+import tempfile
+from hashlib import sha256
+
+## Digest of the real binary of each tool, None if it can't be cached
+_ToolDigest = {}
+
+## Check whether a file is a script rather than a binary
+#
+#   The BinWrappers of the BaseTools C tools and of the Python tools are
+# scripts. Hashing them says nothing about the tool that actually runs.
+#
+def _IsScript(Path):
+    if os.path.splitext(Path)[1].lower() in ('.bat', '.cmd', '.py', '.sh'):
+        return True
+    with open(Path, 'rb') as File:
+        return File.read(2) == b'#!'
+
+## Locate the binary that runs for a tool name
+#
+#   The PosixLike wrapper of a BaseTools C tool executes the binary of the
+# same name, which is located the same way here. Tools which don't resolve
+# to a binary, e.g. Python tools, are not cached: their sources and the
+# files they read implicitly can't be hashed reliably.
+#
+#   @param  Tool            Tool name or path, as used in the command line
+#
+#   @retval string          Path of the tool binary
+#   @retval None            The tool is not a binary
+#
+def GetToolFile(Tool):
+    ToolFile = Tool if os.path.isfile(Tool) else shutil.which(Tool)
+    if not ToolFile or not _IsScript(ToolFile):
+        return ToolFile
+
+    Name = os.path.basename(ToolFile)
+    Candidates = []
+    if os.environ.get('WORKSPACE'):
+        Candidates.append(os.path.join(os.environ['WORKSPACE'], 'Conf', 'BaseToolsCBinaries', Name))
+    if os.environ.get('EDK_TOOLS_PATH'):
+        Candidates.append(os.path.join(os.environ['EDK_TOOLS_PATH'], 'Source', 'C', 'bin', Name))
+    Candidates.append(os.path.join(os.path.dirname(ToolFile), '..', '..', 'Source', 'C', 'bin', Name))
+    for Candidate in Candidates:
+        if os.path.isfile(Candidate) and not _IsScript(Candidate):
+            return os.path.normpath(Candidate)
+    return None
+
+## Get the digest of a tool binary, or None if the tool can't be cached
+def GetToolDigest(Tool):
+    if Tool not in _ToolDigest:
+        Digest = None
+        ToolFile = GetToolFile(Tool)
+        if ToolFile:
+            with open(ToolFile, 'rb') as File:
+                Digest = sha256(File.read()).hexdigest()
+        _ToolDigest[Tool] = Digest
+    return _ToolDigest[Tool]
+
+## Compute the cache key of a tool invocation
+#
+#   The key covers the tool binary and all arguments, with input files replaced
+# by the digest of their content and the output file name left out, so the
+# same invocation from another workspace maps to the same cache entry.
+#
+#   @param  Cmd             Tool command line
+#   @param  Output          Path of output file
+#
+#   @retval string          The cache key
+#   @retval None            The invocation can't be cached
+#
+def GetCacheKey(Cmd, Output):
+    ToolDigest = GetToolDigest(Cmd[0])
+    if ToolDigest is None:
+        return None
+    Hash = sha256(ToolDigest.encode('utf-8'))
+    for Arg in Cmd[1:]:
+        if Arg == Output:
+            Hash.update(b'\0<output>')
+        elif os.path.isfile(Arg):
+            with open(Arg, 'rb') as File:
+                Hash.update(b'\0<file>' + sha256(File.read()).digest())
+        else:
+            Hash.update(b'\0' + Arg.encode('utf-8'))
+    return Hash.hexdigest()
+
+## Get the path of a cache entry
+def GetCacheFile(CacheDir, Key):
+    return os.path.join(CacheDir, Key[0:2], Key)
+
+## Copy a cached output to Output
+#
+#   @retval True            Output was restored from the cache
+#   @retval False           The cache has no entry for Key
+#
+def RestoreFromCache(CacheDir, Key, Output):
+    CacheFile = GetCacheFile(CacheDir, Key)
+    if not os.path.isfile(CacheFile):
+        return False
+    OutputDir = os.path.dirname(Output)
+    if OutputDir and not os.path.exists(OutputDir):
+        os.makedirs(OutputDir)
+    shutil.copyfile(CacheFile, Output)
+    return True
+
+## Save Output in the cache
+#
+#   The file is copied to a temporary file first, the cache may be shared by
+# several builds running at the same time.
+#
+#   @retval None            Output was saved
+#   @retval string          The reason it wasn't
+#
+def SaveToCache(CacheDir, Key, Output):
+    CacheFile = GetCacheFile(CacheDir, Key)
+    try:
+        CacheFileDir = os.path.dirname(CacheFile)
+        if not os.path.exists(CacheFileDir):
+            os.makedirs(CacheFileDir)
+        with tempfile.NamedTemporaryFile(dir=CacheFileDir, delete=False) as TempFile:
+            with open(Output, 'rb') as File:
+                shutil.copyfileobj(File, TempFile)
+        shutil.move(TempFile.name, CacheFile)
+    except (IOError, OSError) as X:
+        return str(X)
+    return None
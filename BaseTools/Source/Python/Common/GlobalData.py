@@ -100,6 +100,13 @@ gPcdSkuOverrides={}
 # Pcd name for the Pcd which used in the Conditional directives
 gConditionalPcds = []
 
+#
+# Directory of the persistent parsed INF/DEC table cache, None to disable it.
+# gMetaFileCacheReparse forces parsing but still refreshes the cache.
+#
+gMetaFileCacheDir = None
+gMetaFileCacheReparse = False
+
 gUseHashCache = None
 gBinCacheDest = None
 gBinCacheSource = None
@@ -107,6 +114,8 @@ gPlatformHash = None
 gPackageHash = {}
 gModuleHash = {}
 gEnableGenfdsMultiThread = True
+# Content addressed cache directory of GenFds outputs, None to disable it
+gGenFdsCacheDir = None
 gSikpAutoGenCache = set()
 
 # Dictionary for tracking Module build status as success or failure
@@ -22,6 +22,7 @@ from array import array
 from Common.BuildToolError import COMMAND_FAILURE,GENFDS_ERROR
 from Common import EdkLogger
 from Common.Misc import SaveFileOnChange
+from Common.GenFdsCache import GetCacheKey, RestoreFromCache, SaveToCache
 
 from Common.TargetTxtClassObject import TargetTxt
 from Common.ToolDefClassObject import ToolDef
@@ -72,6 +73,14 @@ class GenFdsGlobalVariable:
     ModuleFile = ''
     EnableGenfdsMultiThread = True
 
+    #
+    # Content addressed cache of section and FFS outputs, which may be shared
+    # by several workspaces. Empty if the cache is disabled.
+    #
+    GenFdsCacheDir = ''
+    CacheHit = 0
+    CacheMiss = 0
+
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
     # At the beginning of each generation of FV, false flag is appended to the list,
@@ -327,6 +336,8 @@ class GenFdsGlobalVariable:
         GenFdsGlobalVariable.ActivePlatform = GlobalData.gActivePlatform
         GenFdsGlobalVariable.ConfDir  = GlobalData.gConfDirectory
         GenFdsGlobalVariable.EnableGenfdsMultiThread = GlobalData.gEnableGenfdsMultiThread
+        if GlobalData.gGenFdsCacheDir:
+            GenFdsGlobalVariable.GenFdsCacheDir = os.path.abspath(GlobalData.gGenFdsCacheDir)
         for Arch in ArchList:
             GenFdsGlobalVariable.OutputDirDict[Arch] = os.path.normpath(
                 os.path.join(GlobalData.gWorkspace,
@@ -456,6 +467,7 @@ class GenFdsGlobalVariable:
                 else:
                     Cmd += ("-n", '"' + Ui + '"')
                 Cmd += ("-o", Output)
+                Cmd = GenFdsGlobalVariable._CachedMakefileCmd(Cmd)
                 if ' '.join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             else:
@@ -475,18 +487,20 @@ class GenFdsGlobalVariable:
 
             SaveFileOnChange(CommandFile, ' '.join(Cmd), False)
             if IsMakefile:
+                Cmd = GenFdsGlobalVariable._CachedMakefileCmd(Cmd)
                 if ' '.join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             else:
                 if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                     return
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallExternalToolCached(Cmd, Output, "Failed to generate section")
         else:
             Cmd += ("-o", Output)
             Cmd += Input
 
             SaveFileOnChange(CommandFile, ' '.join(Cmd), False)
             if IsMakefile:
+                Cmd = GenFdsGlobalVariable._CachedMakefileCmd(Cmd)
                 if sys.platform == "win32":
                     Cmd = ['if', 'exist', Input[0]] + Cmd
                 else:
@@ -495,7 +509,7 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallExternalToolCached(Cmd, Output, "Failed to generate section")
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
                     GenFdsGlobalVariable.LargeFileInFvFlags):
                     GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
@@ -544,6 +558,7 @@ class GenFdsGlobalVariable:
 
         GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
         if MakefilePath:
+            Cmd = GenFdsGlobalVariable._CachedMakefileCmd(Cmd)
             if (tuple(Cmd), tuple(GenFdsGlobalVariable.SecCmdList), tuple(GenFdsGlobalVariable.CopyList)) not in GenFdsGlobalVariable.FfsCmdDict:
                 GenFdsGlobalVariable.FfsCmdDict[tuple(Cmd), tuple(GenFdsGlobalVariable.SecCmdList), tuple(GenFdsGlobalVariable.CopyList)] = MakefilePath
             GenFdsGlobalVariable.SecCmdList = []
@@ -551,7 +566,7 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            GenFdsGlobalVariable.CallExternalToolCached(Cmd, Output, "Failed to generate FFS")
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -617,10 +632,11 @@ class GenFdsGlobalVariable:
         Cmd += ("-o", Output)
         Cmd += Input
         if IsMakefile:
+            Cmd = GenFdsGlobalVariable._CachedMakefileCmd(Cmd)
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate firmware image")
+            GenFdsGlobalVariable.CallExternalToolCached(Cmd, Output, "Failed to generate firmware image")
 
     @staticmethod
     def GenerateOptionRom(Output, EfiInput, BinaryInput, Compress=False, ClassCode=None,
@@ -681,6 +697,49 @@ class GenFdsGlobalVariable:
         else:
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
 
+    ## Wrap a GenSec, GenFfs or GenFw command line of a module makefile in GenFdsCache
+    #
+    #   The command is returned unchanged if the cache is disabled.
+    #
+    @staticmethod
+    def _CachedMakefileCmd(Cmd):
+        if not GenFdsGlobalVariable.GenFdsCacheDir:
+            return Cmd
+        return ["GenFdsCache", GenFdsGlobalVariable.GenFdsCacheDir] + list(Cmd)
+
+    ## Call an external tool producing Output, reusing a cached output if possible
+    #
+    #   @param  cmd             Tool command line
+    #   @param  Output          Path of the single output file of the tool
+    #   @param  errorMess       Error message reported if the tool fails
+    #   @param  returnValue     Same as CallExternalTool
+    #
+    @staticmethod
+    def CallExternalToolCached(cmd, Output, errorMess, returnValue=[]):
+        Key = None
+        if GenFdsGlobalVariable.GenFdsCacheDir:
+            Key = GetCacheKey(cmd, Output)
+        if Key is None:
+            GenFdsGlobalVariable.CallExternalTool(cmd, errorMess, returnValue)
+            return
+
+        if RestoreFromCache(GenFdsGlobalVariable.GenFdsCacheDir, Key, Output):
+            GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s is restored from cache" % Output)
+            GenFdsGlobalVariable.CacheHit += 1
+            if returnValue != []:
+                returnValue[0] = 0
+            return
+
+        GenFdsGlobalVariable.CacheMiss += 1
+        GenFdsGlobalVariable.CallExternalTool(list(cmd), errorMess, returnValue)
+        if returnValue != [] and returnValue[0] != 0:
+            return
+        if not os.path.isfile(Output):
+            return
+        Error = SaveToCache(GenFdsGlobalVariable.GenFdsCacheDir, Key, Output)
+        if Error:
+            GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "Failed to save %s to cache: %s" % (Output, Error))
+
     @staticmethod
     def CallExternalTool (cmd, errorMess, returnValue=[]):
 
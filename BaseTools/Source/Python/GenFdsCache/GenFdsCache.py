@@ -0,0 +1,57 @@
+## @file
+# Run a GenSec, GenFfs or GenFw command through the GenFds content addressed
+# cache.
+#
+# The module makefiles generated for --genfds-multi-thread call the tools
+# through this wrapper when build is run with --genfds-cache.
+#
+# Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+'''
+GenFdsCache
+'''
+from __future__ import print_function
+
+import sys
+import subprocess
+from Common.GenFdsCache import GetCacheKey, RestoreFromCache, SaveToCache
+
+__prog__  = 'GenFdsCache'
+__usage__ = '%s CacheDir Tool [ToolOptions]' % (__prog__)
+
+## Get the output file of a tool command line, the argument of -o
+def GetOutput(Cmd):
+    for Index in range(1, len(Cmd) - 1):
+        if Cmd[Index] == '-o':
+            return Cmd[Index + 1]
+    return None
+
+def Main():
+    if len(sys.argv) < 3:
+        print('Usage: %s' % __usage__, file=sys.stderr)
+        return 1
+
+    CacheDir = sys.argv[1]
+    Cmd = sys.argv[2:]
+    Output = GetOutput(Cmd)
+
+    Key = None
+    if Output:
+        Key = GetCacheKey(Cmd, Output)
+    if Key is not None and RestoreFromCache(CacheDir, Key, Output):
+        return 0
+
+    ReturnCode = subprocess.call(Cmd)
+    if ReturnCode == 0 and Key is not None:
+        Error = SaveToCache(CacheDir, Key, Output)
+        if Error:
+            print('%s: failed to save %s to cache: %s' % (__prog__, Output, Error), file=sys.stderr)
+    return ReturnCode
+
+if __name__ == '__main__':
+    r = Main()
+    ## 0-127 is a safe return range, and 1 is a standard default error
+    if r < 0 or r > 127: r = 1
+    sys.exit(r)
@@ -0,0 +1,155 @@
+## @file
+# This file is used to keep parsed INF/DEC meta file tables on disk, so that
+# unchanged meta files don't need to be parsed again by later build invocations
+#
+# Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+import Common.LongFilePathOs as os
+import pickle
+import shutil
+import tempfile
+from hashlib import sha1
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from Common.BuildVersion import gBUILD_VERSION
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+## Bump this when the layout of cached records changes
+_CACHE_FORMAT_VERSION_ = 1
+
+## Parser attributes which are set by Start() and must survive a cache hit
+_PARSER_STATE_ = ('_Defines', '_Version', '_FileLocalMacros')
+
+## Column index of BelongsToItem in ModuleTable and PackageTable records
+_BELONGS_TO_ITEM_ = 7
+
+## Persistent cache of raw meta file tables
+#
+#   Entries are keyed by the meta file path, a digest of its content, the
+# global macros visible to the parser and a digest of the parser itself. A
+# changed file, macro set or BaseTools version therefore produces a new key
+# and never hits a stale entry. Only the raw (pre post-process) tables of INF
+# and DEC files are cached; DSC files pull in !include files and conditional
+# directives, and are always parsed.
+#
+class MetaFileCache(object):
+    _ParserDigest = None
+
+    Hit = 0
+    Miss = 0
+
+    ## Digest of the parser sources, so that a BaseTools update invalidates the cache
+    @staticmethod
+    def _GetParserDigest():
+        if MetaFileCache._ParserDigest is None:
+            Hash = sha1(gBUILD_VERSION.encode('utf-8'))
+            Hash.update(str(_CACHE_FORMAT_VERSION_).encode('utf-8'))
+            Here = os.path.dirname(os.path.abspath(__file__))
+            for Name in ('MetaFileParser.py', 'MetaFileTable.py', 'MetaFileCache.py'):
+                try:
+                    with open(os.path.join(Here, Name), 'rb') as File:
+                        Hash.update(File.read())
+                except:
+                    pass
+            MetaFileCache._ParserDigest = Hash.hexdigest()
+        return MetaFileCache._ParserDigest
+
+    ## Compute the cache file name for a parser, or None if the file can't be read
+    @staticmethod
+    def _GetEntryPath(Parser):
+        try:
+            with open(str(Parser.MetaFile), 'rb') as File:
+                Content = File.read()
+        except:
+            return None
+        Hash = sha1(MetaFileCache._GetParserDigest().encode('utf-8'))
+        Hash.update(str(Parser.MetaFile.Path).encode('utf-8'))
+        Hash.update(str(Parser._FileType).encode('utf-8'))
+        Hash.update(Content)
+        Hash.update(repr(sorted(GlobalData.gGlobalDefines.items())).encode('utf-8'))
+        if GlobalData.gOptions and GlobalData.gOptions.CheckUsage:
+            Hash.update(b'CheckUsage')
+        return os.path.join(GlobalData.gMetaFileCacheDir, Hash.hexdigest())
+
+    ## Restore the raw table and parser state from the cache
+    #
+    #   @param      Parser      The InfParser or DecParser object to fill
+    #
+    #   @retval     True        The table was restored, no parsing is needed
+    #   @retval     False       The meta file must be parsed
+    #
+    @staticmethod
+    def Load(Parser):
+        if not GlobalData.gMetaFileCacheDir or GlobalData.gMetaFileCacheReparse:
+            return False
+        EntryPath = MetaFileCache._GetEntryPath(Parser)
+        if EntryPath is None or not os.path.exists(EntryPath):
+            MetaFileCache.Miss += 1
+            return False
+        try:
+            with open(EntryPath, 'rb') as File:
+                Entry = pickle.load(File)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Discard meta file cache entry %s: %s" % (EntryPath, str(Exc)))
+            MetaFileCache.Miss += 1
+            return False
+
+        #
+        # Record IDs are derived from the table's file ID, which depends on the
+        # order files are opened in this build. Rebase them onto this table.
+        #
+        Table = Parser._RawTable
+        Delta = Table.ID - Entry['Base']
+        Content = []
+        for Record in Entry['Content']:
+            Record = list(Record)
+            if Record[0] > 0:
+                Record[0] += Delta
+            if Record[_BELONGS_TO_ITEM_] > 0:
+                Record[_BELONGS_TO_ITEM_] += Delta
+            Content.append(Record)
+            if Record[0] > Table.ID:
+                Table.ID = Record[0]
+        Table.CurrentContent = Content
+        for Name, Value in Entry['State'].items():
+            setattr(Parser, Name, Value)
+        Parser._Finished = True
+        MetaFileCache.Hit += 1
+        return True
+
+    ## Save the raw table and parser state after a successful parse
+    #
+    #   @param      Parser      The InfParser or DecParser object just parsed
+    #   @param      Base        The table ID before parsing started
+    #
+    @staticmethod
+    def Store(Parser, Base):
+        if not GlobalData.gMetaFileCacheDir or not Parser._Finished:
+            return
+        EntryPath = MetaFileCache._GetEntryPath(Parser)
+        if EntryPath is None:
+            return
+        Entry = {
+            'Base'      : Base,
+            'Content'   : Parser._RawTable.CurrentContent,
+            'State'     : dict((Name, getattr(Parser, Name)) for Name in _PARSER_STATE_),
+            }
+        #
+        # Write to a temporary file first so that concurrent AutoGen workers
+        # never see a partially written entry
+        #
+        try:
+            if not os.path.exists(GlobalData.gMetaFileCacheDir):
+                os.makedirs(GlobalData.gMetaFileCacheDir)
+            with tempfile.NamedTemporaryFile(dir=GlobalData.gMetaFileCacheDir, delete=False) as File:
+                pickle.dump(Entry, File, pickle.HIGHEST_PROTOCOL)
+            shutil.move(File.name, EntryPath)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to save meta file cache entry %s: %s" % (EntryPath, str(Exc)))
@@ -29,6 +29,7 @@ from CommonDataClass.Exceptions import *
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from collections import defaultdict
 from .MetaFileTable import MetaFileStorage
+from .MetaFileCache import MetaFileCache
 from .MetaFileCommentParser import CheckInfComment
 from Common.DataType import TAB_COMMENT_EDK_START, TAB_COMMENT_EDK_END
 
@@ -122,6 +123,9 @@ class MetaFileParser(object):
     # Parser objects used to implement singleton
     MetaFiles = {}
 
+    # Whether the raw table of this kind of file can be kept in MetaFileCache
+    _Cacheable = False
+
     ## Factory method
     #
     # One file, one parser object. This factory method makes sure that there's
@@ -258,7 +262,12 @@ class MetaFileParser(object):
             else:
                 self._Table = self._RawTable
                 self._PostProcessed = False
+                if self._Cacheable and MetaFileCache.Load(self):
+                    return
+                Base = self._RawTable.ID
                 self.Start()
+                if self._Cacheable:
+                    MetaFileCache.Store(self, Base)
     ## Data parser for the common format in different type of file
     #
     #   The common format in the meatfile is like
@@ -533,6 +542,9 @@ class MetaFileParser(object):
 #   @param      Macros          Macros used for replacement in file
 #
 class InfParser(MetaFileParser):
+    # INF raw tables only depend on file content and global macros
+    _Cacheable = True
+
     # INF file supported data types (one type per section)
     DataType = {
         TAB_UNKNOWN.upper() : MODEL_UNKNOWN,
@@ -1748,6 +1760,9 @@ class DscParser(MetaFileParser):
 #   @param      Macros          Macros used for replacement in file
 #
 class DecParser(MetaFileParser):
+    # DEC raw tables only depend on file content and global macros
+    _Cacheable = True
+
     # DEC file supported data types (one type per section)
     DataType = {
         TAB_DEC_DEFINES.upper()                     :   MODEL_META_DATA_HEADER,
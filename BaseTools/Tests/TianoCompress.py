@@ -1,7 +1,7 @@
 ## @file
 # Unit tests for TianoCompress utility
 #
-#  Copyright (c) 2008, Intel Corporation. All rights reserved.<BR>
+#  Copyright (c) 2008 - 2020, Intel Corporation. All rights reserved.<BR>
 #
 #  SPDX-License-Identifier: BSD-2-Clause-Patent
 #
@@ -28,14 +28,14 @@ class Tests(TestTools.BaseToolsTest):
         #self.DisplayFile('help')
         self.assertTrue(result == 0)
 
-    def compressionTestCycle(self, data):
+    def compressionTestCycle(self, data, *options):
         path = self.GetTmpFilePath('input')
         self.WriteTmpFile('input', data)
-        result = self.RunTool(
-            '-e',
+        args = options + (
             '-o', self.GetTmpFilePath('output1'),
             self.GetTmpFilePath('input')
             )
+        result = self.RunTool('-e', *args)
         self.assertTrue(result == 0)
         result = self.RunTool(
             '-d',
@@ -60,6 +60,13 @@ class Tests(TestTools.BaseToolsTest):
             self.compressionTestCycle(data)
             self.CleanUpTmpDir()
 
+    def testLevelCycles(self):
+        data = self.GetRandomString(1024, 2048)
+        data = data + data[:512] + data
+        for level in range(10):
+            self.compressionTestCycle(data, '--level', str(level))
+            self.CleanUpTmpDir()
+
 TheTestSuite = TestTools.MakeTheTestSuite(locals())
 
 if __name__ == '__main__':
@@ -0,0 +1,460 @@
+/** @file
+  A shell application that reports the speed of the cryptographic operations
+  that dominate UEFI Secure Boot, capsule verification and HTTPS boot:
+  RSA PKCS#1 v1.5 signature verification, SHA-256 and AES-256-GCM.
+
+  It's meant to compare OpensslLib instances on the same platform. A TimerLib
+  instance with a real performance counter is required.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#undef _WIN32
+#undef _WIN64
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/BaseCryptLib.h>
+
+#include "CrtLibSupport.h"
+
+#include <openssl/evp.h>
+
+//
+// Every operation is repeated for at least this long, in nanoseconds.
+//
+#define BENCHMARK_DURATION      1000000000ULL
+
+//
+// An operation is never repeated more than this, so the benchmark ends even
+// if the performance counter doesn't run.
+//
+#define BENCHMARK_MAX_COUNT     1000000ULL
+
+#define BENCHMARK_MAX_DATA_SIZE SIZE_16KB
+
+#define AES_GCM_TAG_SIZE        16
+
+typedef
+BOOLEAN
+(*BENCHMARK_OPERATION) (
+  IN VOID  *Context,
+  IN UINTN DataSize
+  );
+
+typedef struct {
+  VOID           *Rsa;
+  UINT8          MessageHash[SHA256_DIGEST_SIZE];
+  CONST UINT8    *Signature;
+  UINTN          SignatureSize;
+} RSA_BENCHMARK_CONTEXT;
+
+typedef struct {
+  EVP_CIPHER_CTX *Ctx;
+  UINT8          *Input;
+  UINT8          *Output;
+  UINT8          Tag[AES_GCM_TAG_SIZE];
+} AES_GCM_BENCHMARK_CONTEXT;
+
+UINTN mDataSize[] = { 64, SIZE_1KB, BENCHMARK_MAX_DATA_SIZE };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST CHAR8 mRsaMessage[] = "CryptoBenchmark";
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mRsaE[] = { 0x01, 0x00, 0x01 };
+
+//
+// RSA-2048 public key modulus
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mRsa2048N[] = {
+  0xee, 0x5b, 0xc7, 0x37, 0x7a, 0xf6, 0x1d, 0xa3, 0x3f, 0x2b, 0x18, 0x6a, 0x6e, 0x82, 0x5b, 0xc2,
+  0xba, 0x20, 0x55, 0xde, 0x51, 0xc6, 0x50, 0x11, 0x2a, 0x99, 0xae, 0x9f, 0x0c, 0xaf, 0xd8, 0xd1,
+  0x66, 0x14, 0xcb, 0x0c, 0x79, 0xc0, 0xd1, 0x37, 0xfb, 0xc0, 0xd3, 0x28, 0x3a, 0x16, 0xd3, 0x41,
+  0xdf, 0xa9, 0x77, 0x01, 0xa5, 0xf2, 0x95, 0x76, 0xe0, 0x7b, 0x57, 0xbf, 0x2d, 0x50, 0xf3, 0x82,
+  0x20, 0xde, 0xfc, 0xc5, 0x81, 0x5a, 0xa3, 0x6c, 0x11, 0x7a, 0x9f, 0xf7, 0x5f, 0x71, 0x68, 0x1c,
+  0xb1, 0x60, 0xec, 0x29, 0xb6, 0xe6, 0x4c, 0x4b, 0x67, 0x0a, 0x55, 0x5b, 0xef, 0xbd, 0xcf, 0xde,
+  0xa3, 0xdc, 0x26, 0x54, 0xbe, 0xa2, 0x67, 0xaa, 0x99, 0x48, 0xfa, 0xee, 0xde, 0xd7, 0x67, 0xea,
+  0xef, 0x57, 0x6b, 0x36, 0x3e, 0xf5, 0x7b, 0x68, 0x4a, 0x85, 0x17, 0x1e, 0xf5, 0x3a, 0xb1, 0xc2,
+  0x87, 0xd3, 0xe2, 0x94, 0xc0, 0xbd, 0x09, 0x71, 0xca, 0x8c, 0xd9, 0x40, 0xca, 0x73, 0xd4, 0x72,
+  0x2d, 0x97, 0xfd, 0x79, 0x5b, 0x84, 0xe0, 0x68, 0x5d, 0xee, 0xa6, 0x83, 0xd3, 0x16, 0xb1, 0x18,
+  0xee, 0x7a, 0x3b, 0x05, 0x30, 0x46, 0xd9, 0x80, 0x86, 0xa3, 0x93, 0x80, 0x4f, 0x74, 0x93, 0x87,
+  0x3e, 0x56, 0x43, 0xa0, 0xeb, 0x06, 0xd9, 0x53, 0xae, 0x14, 0x83, 0xf5, 0x57, 0x38, 0x60, 0x21,
+  0x30, 0x88, 0x9d, 0xe2, 0xc7, 0x87, 0xd7, 0x1f, 0xfb, 0x32, 0x9f, 0xde, 0x77, 0xc8, 0x39, 0x62,
+  0x04, 0x06, 0xf9, 0x24, 0xde, 0xed, 0x6c, 0xb5, 0x2d, 0xdf, 0x10, 0x77, 0x0e, 0x85, 0x20, 0x44,
+  0x78, 0x87, 0xb5, 0x62, 0xe7, 0xef, 0x6c, 0xe8, 0xf1, 0x49, 0xb6, 0xcb, 0x8b, 0xc0, 0x5f, 0xdb,
+  0x0d, 0xa9, 0xd4, 0x2d, 0x6a, 0x8f, 0x9d, 0x2a, 0x55, 0xc2, 0xb8, 0x64, 0x20, 0xca, 0x7d, 0xb1
+  };
+
+//
+// RSASSA-PKCS1-v1_5 SHA-256 signature of "CryptoBenchmark"
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mRsa2048Signature[] = {
+  0xc8, 0x97, 0x9d, 0x7a, 0x24, 0x06, 0x39, 0x45, 0xad, 0x1a, 0x56, 0x17, 0x4c, 0x0d, 0x64, 0xac,
+  0xd0, 0x93, 0x45, 0x60, 0x72, 0xbf, 0xf6, 0x6f, 0xcd, 0x2d, 0x6d, 0x31, 0x9b, 0x94, 0xd0, 0x3a,
+  0xa7, 0x1d, 0x35, 0xbc, 0xcf, 0xde, 0xcb, 0xe7, 0x32, 0x6a, 0x9f, 0x31, 0x4b, 0xea, 0xf3, 0xfb,
+  0xfa, 0xbf, 0xfc, 0x06, 0xb3, 0x72, 0xd0, 0xa7, 0xe2, 0x45, 0x8a, 0x4e, 0x37, 0x05, 0x46, 0xf8,
+  0x25, 0xdb, 0xfa, 0x19, 0x84, 0xeb, 0x4b, 0x4d, 0x72, 0x8b, 0x9a, 0x24, 0x21, 0x85, 0x37, 0xbb,
+  0xdf, 0xf1, 0x07, 0x1d, 0x4b, 0x71, 0x15, 0x82, 0x1f, 0x2b, 0x86, 0x86, 0xcb, 0xd9, 0x23, 0x67,
+  0xd1, 0x0e, 0x30, 0x2d, 0xec, 0xf5, 0x5b, 0x67, 0x80, 0xe9, 0x23, 0x54, 0xed, 0x92, 0x4a, 0x76,
+  0x79, 0x1c, 0x43, 0x44, 0x17, 0xb4, 0xe5, 0x89, 0x14, 0x03, 0xf9, 0x29, 0x06, 0xba, 0xc8, 0x29,
+  0x5a, 0xac, 0x75, 0x42, 0x1a, 0x12, 0x4c, 0xb3, 0xb5, 0xe2, 0x68, 0x7a, 0xb6, 0xa8, 0x80, 0xa5,
+  0xbb, 0x27, 0x31, 0x09, 0x17, 0x4f, 0xef, 0xfd, 0x04, 0xd2, 0xbe, 0xfb, 0xce, 0x93, 0x19, 0x47,
+  0x96, 0x5f, 0xbb, 0x83, 0xd2, 0x35, 0xf1, 0x9c, 0xe6, 0xca, 0x37, 0x05, 0xc3, 0xc5, 0xb5, 0xe5,
+  0xe9, 0x91, 0x21, 0x21, 0x02, 0x8d, 0xff, 0xc7, 0xaf, 0xd9, 0xd5, 0xdf, 0x43, 0xf8, 0x6a, 0x84,
+  0x44, 0x50, 0x8c, 0x9e, 0x08, 0x81, 0x60, 0x87, 0xbb, 0x8b, 0xbc, 0xdc, 0x73, 0x4e, 0xaf, 0xa6,
+  0x78, 0x54, 0x5e, 0xc2, 0xb0, 0x3e, 0xe2, 0x8e, 0xb9, 0xb8, 0x39, 0x36, 0x3a, 0x86, 0x6c, 0x71,
+  0x9d, 0xe1, 0x62, 0x52, 0x8a, 0x50, 0xc6, 0xc4, 0x66, 0x3e, 0xff, 0x53, 0x61, 0x49, 0xee, 0xfb,
+  0x9e, 0xf4, 0x9a, 0x50, 0x41, 0x25, 0x40, 0x49, 0x91, 0xc2, 0x29, 0xd3, 0x6a, 0x95, 0x10, 0x1c
+  };
+
+//
+// RSA-3072 public key modulus
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mRsa3072N[] = {
+  0xe2, 0xad, 0x85, 0xb9, 0xe3, 0x31, 0x9d, 0x0f, 0x18, 0xe3, 0x2f, 0x5d, 0x5e, 0xde, 0x63, 0x22,
+  0xce, 0x34, 0xb0, 0xf9, 0xde, 0x1b, 0x46, 0x7e, 0x30, 0xb8, 0x7b, 0x91, 0x0a, 0x36, 0x99, 0xa2,
+  0x70, 0x0c, 0xd3, 0xd1, 0xe2, 0x3f, 0x02, 0xd6, 0xe6, 0x04, 0x8a, 0xdb, 0xd3, 0x68, 0x83, 0x78,
+  0x26, 0x51, 0x91, 0x11, 0xf9, 0x11, 0x65, 0xd0, 0xfe, 0x24, 0xa2, 0x40, 0xd1, 0x47, 0xac, 0xca,
+  0x74, 0x1c, 0xa4, 0xfa, 0x91, 0x9b, 0x9b, 0x55, 0x35, 0x39, 0x53, 0x6d, 0x5d, 0xe6, 0xba, 0xba,
+  0x5b, 0xb5, 0xb1, 0x5a, 0x6d, 0xc0, 0x0d, 0x1a, 0x67, 0x44, 0x15, 0xfb, 0xfe, 0x02, 0x42, 0x5f,
+  0xd4, 0x87, 0x1d, 0xbc, 0x53, 0xc2, 0xb3, 0x62, 0xa0, 0xfb, 0x7b, 0x42, 0x32, 0xab, 0x21, 0x7f,
+  0x1f, 0x9c, 0x5b, 0xf1, 0x55, 0x00, 0x89, 0x62, 0xda, 0x70, 0xd9, 0xec, 0xe0, 0xa2, 0xf6, 0xe1,
+  0x0a, 0x4e, 0x36, 0xde, 0x9a, 0x7f, 0x78, 0xf6, 0xd7, 0xb9, 0xba, 0x67, 0x97, 0x46, 0x4e, 0xc6,
+  0x89, 0x02, 0x3f, 0x0f, 0x6d, 0xe4, 0x40, 0x2f, 0x93, 0xd1, 0x92, 0x4c, 0xe2, 0xa1, 0x3f, 0x89,
+  0x81, 0x0c, 0xe5, 0xa4, 0x41, 0x4a, 0x47, 0xf7, 0xbf, 0x63, 0xdd, 0x9e, 0x34, 0x66, 0x8e, 0x54,
+  0x00, 0x34, 0xad, 0xf5, 0x91, 0xea, 0xe3, 0xa8, 0xf7, 0xd3, 0x89, 0x56, 0x1e, 0xdc, 0x1f, 0x8b,
+  0x1b, 0xe4, 0x59, 0xa1, 0xeb, 0x50, 0xfc, 0xbc, 0x1a, 0x49, 0x9d, 0x21, 0x89, 0xc9, 0x66, 0xb6,
+  0x3d, 0x6a, 0xbe, 0x3b, 0x10, 0xfa, 0xc1, 0x69, 0x1e, 0xe1, 0xe2, 0x0e, 0xde, 0xf1, 0x5b, 0xf7,
+  0xb1, 0x5c, 0x2d, 0xd5, 0xf1, 0xfd, 0x01, 0xfd, 0xb9, 0x30, 0x62, 0x40, 0x90, 0x5f, 0x69, 0x1d,
+  0x60, 0x63, 0x9c, 0xaa, 0x3f, 0xb3, 0xa0, 0xed, 0xa3, 0x54, 0x8b, 0xff, 0x52, 0x3b, 0xfe, 0x64,
+  0xd2, 0x2d, 0x3d, 0xcc, 0x88, 0x55, 0xdc, 0x63, 0x03, 0x97, 0x2e, 0xfb, 0x22, 0x24, 0xbd, 0xf1,
+  0xe3, 0x3a, 0xb6, 0xf4, 0x20, 0x3d, 0xb6, 0x0b, 0x9b, 0x8c, 0x09, 0x5d, 0x85, 0x51, 0x81, 0x75,
+  0x54, 0xfd, 0x99, 0xf4, 0x46, 0x2f, 0x41, 0xa4, 0x00, 0x4e, 0xe0, 0xb4, 0x85, 0xba, 0xd3, 0x8b,
+  0x43, 0x7a, 0x1e, 0xd0, 0xe4, 0xac, 0x7a, 0x7a, 0xd6, 0xef, 0x40, 0x91, 0x26, 0x6d, 0x88, 0x88,
+  0xa9, 0xbc, 0x04, 0x05, 0xb8, 0x1b, 0xb5, 0xe3, 0x66, 0xfd, 0xf4, 0xc2, 0xf4, 0x9d, 0xda, 0x4a,
+  0xb9, 0x53, 0xca, 0x36, 0x2e, 0xbd, 0xbc, 0x75, 0xb3, 0xfa, 0xec, 0x01, 0xdd, 0xad, 0xae, 0xeb,
+  0xd2, 0x0d, 0x75, 0xb5, 0x2f, 0x43, 0x3d, 0xa6, 0x60, 0x25, 0xc9, 0xcd, 0x0c, 0x02, 0x60, 0x40,
+  0x7f, 0x2e, 0x75, 0x62, 0x03, 0x86, 0x5a, 0x52, 0x88, 0xbd, 0x51, 0xfe, 0x3b, 0x3a, 0xd9, 0xe1
+  };
+
+//
+// RSASSA-PKCS1-v1_5 SHA-256 signature of "CryptoBenchmark"
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mRsa3072Signature[] = {
+  0xdd, 0xfe, 0x13, 0x44, 0xbd, 0xd4, 0x1a, 0xd5, 0x1c, 0xc3, 0x9c, 0x0d, 0x9d, 0x1f, 0x8d, 0x61,
+  0xa1, 0x97, 0x32, 0xd0, 0xfb, 0x90, 0x94, 0x22, 0x55, 0x04, 0x34, 0x84, 0xb2, 0x2e, 0x3f, 0xbe,
+  0x2b, 0xc8, 0xc8, 0xde, 0x49, 0x79, 0xa4, 0x47, 0x14, 0xb7, 0x35, 0xc4, 0x3d, 0x0b, 0x58, 0xab,
+  0xaa, 0xea, 0x74, 0xe1, 0x9a, 0x09, 0x43, 0x2d, 0x2b, 0xbf, 0xbc, 0x24, 0x73, 0xe1, 0x67, 0x70,
+  0xfa, 0x8c, 0xbc, 0xa2, 0x6c, 0xff, 0xba, 0x6e, 0xf7, 0x89, 0x58, 0x60, 0xc5, 0x56, 0x6b, 0xdb,
+  0x57, 0xda, 0x9a, 0x2d, 0x01, 0x80, 0x23, 0x9a, 0x92, 0xc1, 0x2b, 0x32, 0xda, 0x84, 0x72, 0x52,
+  0x6e, 0x14, 0x68, 0x23, 0x3a, 0xd5, 0x95, 0xda, 0x3a, 0xce, 0x79, 0x68, 0x7b, 0x39, 0x6c, 0xf6,
+  0xe8, 0x8d, 0x36, 0x82, 0x06, 0x48, 0x2e, 0x6d, 0x12, 0x15, 0x70, 0xa7, 0x8a, 0x04, 0x28, 0x17,
+  0x07, 0xcf, 0x6c, 0xeb, 0x00, 0x72, 0x5d, 0x78, 0x6b, 0x79, 0x60, 0x2d, 0xe1, 0xcb, 0x96, 0xe4,
+  0xf5, 0xf2, 0x84, 0xb9, 0xd4, 0x96, 0xca, 0x25, 0x4e, 0xec, 0x31, 0x07, 0x43, 0x73, 0x29, 0x75,
+  0xc6, 0xea, 0x15, 0x63, 0x0b, 0xfd, 0x2a, 0x7d, 0x07, 0xf2, 0xd0, 0x1f, 0x71, 0x27, 0xbd, 0xb2,
+  0x71, 0xe5, 0x97, 0x1d, 0x85, 0x01, 0x1c, 0x00, 0x69, 0x46, 0x4c, 0x9b, 0x40, 0x8b, 0x4c, 0x86,
+  0x29, 0xec, 0xa1, 0xe7, 0xcd, 0x32, 0xa3, 0x51, 0x6c, 0xa1, 0x2a, 0xd0, 0xaa, 0xa5, 0x29, 0xc8,
+  0x1b, 0x6e, 0xed, 0xb8, 0x8c, 0x4d, 0x50, 0x49, 0x5d, 0xca, 0xa6, 0xb1, 0xe8, 0x65, 0x25, 0x10,
+  0x6c, 0xcb, 0x7e, 0xee, 0x0f, 0xa0, 0x01, 0x5a, 0xb6, 0x7f, 0x98, 0x81, 0x6e, 0xfb, 0xbd, 0xe0,
+  0x99, 0x32, 0xcb, 0x72, 0x4f, 0x48, 0x4d, 0x37, 0x00, 0x8d, 0x73, 0xa4, 0xd6, 0x54, 0x13, 0x17,
+  0x3d, 0x67, 0x15, 0xcf, 0xa9, 0xf7, 0xbf, 0x48, 0xf8, 0xe7, 0x2c, 0x22, 0xf3, 0xa7, 0x42, 0x39,
+  0xe1, 0x5e, 0x58, 0xaa, 0x1d, 0xe2, 0x39, 0x57, 0xb2, 0xa5, 0xd3, 0xf0, 0x90, 0x5b, 0xd0, 0x3b,
+  0x43, 0x46, 0x5d, 0xfa, 0x2b, 0xda, 0xd0, 0x75, 0x44, 0x92, 0xa8, 0x02, 0x02, 0x69, 0x4a, 0x4d,
+  0xb3, 0x88, 0x39, 0x16, 0x69, 0x96, 0x63, 0x3e, 0x18, 0x1f, 0x37, 0x51, 0xcc, 0xfa, 0xea, 0xf2,
+  0x75, 0x15, 0xbf, 0x64, 0xb1, 0xab, 0x09, 0x41, 0x2d, 0x1d, 0x0c, 0x87, 0x5a, 0x0d, 0xa8, 0xfa,
+  0x83, 0x65, 0xae, 0x89, 0xde, 0xcd, 0x56, 0xec, 0x0f, 0x07, 0xf9, 0x36, 0xca, 0x27, 0xc5, 0xa2,
+  0xda, 0x59, 0x64, 0xea, 0x14, 0xed, 0xf5, 0xac, 0x68, 0x08, 0x1b, 0x96, 0x31, 0x78, 0x45, 0x37,
+  0xee, 0x5c, 0x92, 0x2b, 0xb5, 0xb5, 0xc4, 0xce, 0xee, 0xc0, 0xef, 0x17, 0xeb, 0x08, 0x02, 0xdc
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mAesKey[32] = {
+  0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+  0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 mAesGcmIv[12] = {
+  0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88
+  };
+
+/**
+  Get the time elapsed between two performance counter values.
+
+  @param[in]  Start         The performance counter value at the start.
+  @param[in]  End           The performance counter value at the end.
+
+  @return The elapsed time in nanoseconds.
+**/
+UINT64
+GetElapsedTime (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  //
+  // Some performance counters count down.
+  //
+  if (EndValue < StartValue) {
+    return GetTimeInNanoSecond (Start - End);
+  }
+  return GetTimeInNanoSecond (End - Start);
+}
+
+/**
+  Repeat an operation for BENCHMARK_DURATION, or BENCHMARK_MAX_COUNT times,
+  and print how many times per second it runs.
+
+  @param[in]  Name          Name of the operation.
+  @param[in]  Operation     The operation.
+  @param[in]  Context       The context of the operation.
+  @param[in]  DataSize      Size of the data processed by the operation, 0 if
+                            the throughput isn't meaningful.
+
+**/
+VOID
+RunBenchmark (
+  IN CONST CHAR16         *Name,
+  IN BENCHMARK_OPERATION  Operation,
+  IN VOID                 *Context,
+  IN UINTN                DataSize
+  )
+{
+  UINT64  Start;
+  UINT64  ElapsedTime;
+  UINT64  Count;
+  UINT64  OpsPerSecond;
+
+  Count = 0;
+  Start = GetPerformanceCounter ();
+  do {
+    if (!Operation (Context, DataSize)) {
+      Print (L"%-20s %6d  Failed\n", Name, DataSize);
+      return;
+    }
+    Count++;
+    ElapsedTime = GetElapsedTime (Start, GetPerformanceCounter ());
+  } while ((ElapsedTime < BENCHMARK_DURATION) && (Count < BENCHMARK_MAX_COUNT));
+
+  if (ElapsedTime < 1000) {
+    Print (L"%-20s %6d  No performance counter\n", Name, DataSize);
+    return;
+  }
+
+  OpsPerSecond = DivU64x64Remainder (MultU64x32 (Count, 1000000), DivU64x32 (ElapsedTime, 1000), NULL);
+  if (DataSize == 0) {
+    Print (L"%-20s %6s  %10ld\n", Name, L"-", OpsPerSecond);
+  } else {
+    Print (L"%-20s %6d  %10ld  %8ld\n", Name, DataSize, OpsPerSecond, DivU64x32 (MultU64x32 (OpsPerSecond, (UINT32)DataSize), SIZE_1KB));
+  }
+}
+
+/**
+  Verify the RSA signature of the benchmark message.
+
+  @param[in]  Context       RSA_BENCHMARK_CONTEXT.
+  @param[in]  DataSize      Not used.
+
+  @retval TRUE              The signature is valid.
+  @retval FALSE             The signature is invalid.
+**/
+BOOLEAN
+RsaVerifyOperation (
+  IN VOID  *Context,
+  IN UINTN DataSize
+  )
+{
+  RSA_BENCHMARK_CONTEXT  *RsaContext;
+
+  RsaContext = Context;
+  return RsaPkcs1Verify (
+           RsaContext->Rsa,
+           RsaContext->MessageHash,
+           sizeof (RsaContext->MessageHash),
+           RsaContext->Signature,
+           RsaContext->SignatureSize
+           );
+}
+
+/**
+  Calculate the SHA-256 digest of a buffer.
+
+  @param[in]  Context       The buffer.
+  @param[in]  DataSize      Size of the buffer in bytes.
+
+  @retval TRUE              The digest is calculated.
+  @retval FALSE             The digest can't be calculated.
+**/
+BOOLEAN
+Sha256Operation (
+  IN VOID  *Context,
+  IN UINTN DataSize
+  )
+{
+  UINT8  Digest[SHA256_DIGEST_SIZE];
+
+  return Sha256HashAll (Context, DataSize, Digest);
+}
+
+/**
+  Encrypt a buffer with AES-256-GCM and calculate its tag.
+
+  @param[in]  Context       AES_GCM_BENCHMARK_CONTEXT.
+  @param[in]  DataSize      Size of the buffer in bytes.
+
+  @retval TRUE              The buffer is encrypted.
+  @retval FALSE             The buffer can't be encrypted.
+**/
+BOOLEAN
+AesGcmOperation (
+  IN VOID  *Context,
+  IN UINTN DataSize
+  )
+{
+  AES_GCM_BENCHMARK_CONTEXT  *GcmContext;
+  INT32                      Length;
+  INT32                      FinalLength;
+
+  GcmContext = Context;
+  if ((EVP_EncryptInit_ex (GcmContext->Ctx, NULL, NULL, NULL, mAesGcmIv) != 1) ||
+      (EVP_EncryptUpdate (GcmContext->Ctx, GcmContext->Output, &Length, GcmContext->Input, (int)DataSize) != 1) ||
+      (EVP_EncryptFinal_ex (GcmContext->Ctx, GcmContext->Output + Length, &FinalLength) != 1)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(EVP_CIPHER_CTX_ctrl (GcmContext->Ctx, EVP_CTRL_AEAD_GET_TAG, AES_GCM_TAG_SIZE, GcmContext->Tag) == 1);
+}
+
+/**
+  Measure the RSA signature verification.
+
+  @param[in]  Name          Name of the key.
+  @param[in]  N             The public key modulus.
+  @param[in]  NSize         Size of N in bytes.
+  @param[in]  Signature     The signature of mRsaMessage.
+  @param[in]  SignatureSize Size of Signature in bytes.
+
+**/
+VOID
+BenchmarkRsaVerify (
+  IN CONST CHAR16  *Name,
+  IN CONST UINT8   *N,
+  IN UINTN         NSize,
+  IN CONST UINT8   *Signature,
+  IN UINTN         SignatureSize
+  )
+{
+  RSA_BENCHMARK_CONTEXT  RsaContext;
+
+  RsaContext.Rsa = RsaNew ();
+  if (RsaContext.Rsa == NULL) {
+    Print (L"%-20s %6s  Out of resources\n", Name, L"-");
+    return;
+  }
+
+  RsaContext.Signature     = Signature;
+  RsaContext.SignatureSize = SignatureSize;
+  if (!RsaSetKey (RsaContext.Rsa, RsaKeyN, N, NSize) ||
+      !RsaSetKey (RsaContext.Rsa, RsaKeyE, mRsaE, sizeof (mRsaE)) ||
+      !Sha256HashAll (mRsaMessage, AsciiStrLen (mRsaMessage), RsaContext.MessageHash)) {
+    Print (L"%-20s %6s  Failed to set the key\n", Name, L"-");
+  } else {
+    RunBenchmark (Name, RsaVerifyOperation, &RsaContext, 0);
+  }
+
+  RsaFree (RsaContext.Rsa);
+}
+
+/**
+  Measure AES-256-GCM encryption for all the data sizes.
+
+  @param[in]  Buffer        The data to be encrypted, BENCHMARK_MAX_DATA_SIZE
+                            bytes.
+
+**/
+VOID
+BenchmarkAesGcm (
+  IN UINT8  *Buffer
+  )
+{
+  AES_GCM_BENCHMARK_CONTEXT  GcmContext;
+  UINTN                      Index;
+
+  GcmContext.Input  = Buffer;
+  GcmContext.Output = AllocatePool (BENCHMARK_MAX_DATA_SIZE + AES_GCM_TAG_SIZE);
+  GcmContext.Ctx    = EVP_CIPHER_CTX_new ();
+  if ((GcmContext.Output == NULL) || (GcmContext.Ctx == NULL)) {
+    Print (L"%-20s %6s  Out of resources\n", L"AES-256-GCM", L"-");
+    goto Done;
+  }
+
+  if (EVP_EncryptInit_ex (GcmContext.Ctx, EVP_aes_256_gcm (), NULL, mAesKey, mAesGcmIv) != 1) {
+    Print (L"%-20s %6s  Failed to set the key\n", L"AES-256-GCM", L"-");
+    goto Done;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mDataSize); Index++) {
+    RunBenchmark (L"AES-256-GCM encrypt", AesGcmOperation, &GcmContext, mDataSize[Index]);
+  }
+
+Done:
+  if (GcmContext.Ctx != NULL) {
+    EVP_CIPHER_CTX_free (GcmContext.Ctx);
+  }
+  if (GcmContext.Output != NULL) {
+    FreePool (GcmContext.Output);
+  }
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the application.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  UINT8   *Buffer;
+  UINTN   Index;
+
+  Buffer = AllocatePool (BENCHMARK_MAX_DATA_SIZE);
+  if (Buffer == NULL) {
+    Print (L"CryptoBenchmark: Out of resources.\n");
+    return EFI_OUT_OF_RESOURCES;
+  }
+  SetMem (Buffer, BENCHMARK_MAX_DATA_SIZE, 0x5A);
+
+  Print (L"Operation             Bytes       ops/s      KB/s\n");
+
+  BenchmarkRsaVerify (L"RSA-2048 verify", mRsa2048N, sizeof (mRsa2048N), mRsa2048Signature, sizeof (mRsa2048Signature));
+  BenchmarkRsaVerify (L"RSA-3072 verify", mRsa3072N, sizeof (mRsa3072N), mRsa3072Signature, sizeof (mRsa3072Signature));
+
+  for (Index = 0; Index < ARRAY_SIZE (mDataSize); Index++) {
+    RunBenchmark (L"SHA-256", Sha256Operation, Buffer, mDataSize[Index]);
+  }
+
+  BenchmarkAesGcm (Buffer);
+
+  FreePool (Buffer);
+
+  return EFI_SUCCESS;
+}
@@ -20,6 +20,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <openssl/ssl.h>
 #include <openssl/bio.h>
 #include <openssl/err.h>
+#include <openssl/sha.h>
 
 typedef struct {
   //
@@ -35,7 +36,49 @@ typedef struct {
   // Memory BIO for the TLS/SSL Writing operations.
   //
   BIO                             *OutBio;
+  //
+  // Digest of the host name and flags set by TlsSetVerifyHost(), so that a
+  // certificate chain verified for one host is never reused for another.
+  //
+  UINT8                           VerifyHostDigest[SHA256_DIGEST_SIZE];
 } TLS_CONNECTION;
 
+/**
+  Certificate verification callback of the SSL_CTX.
+
+  The peer certificate chains that have been verified successfully are
+  cached, so that a later connection to the same server doesn't need to
+  verify the same chain again.
+
+  @param[in]  StoreCtx    Pointer to the X509_STORE_CTX holding the peer chain.
+  @param[in]  Arg         Argument set with the callback, not used.
+
+  @retval  1    The chain is verified.
+  @retval  0    The chain can't be verified.
+
+**/
+int
+TlsVerifyCertCallback (
+  IN     X509_STORE_CTX           *StoreCtx,
+  IN     VOID                     *Arg
+  );
+
+/**
+  Calculate the digest of the trusted certificates and revocation lists in
+  a cert store.
+
+  @param[in]   Store       Pointer to the X509_STORE.
+  @param[out]  Digest      Buffer of SHA256_DIGEST_SIZE bytes to receive the digest.
+
+  @retval  TRUE   The digest is calculated.
+  @retval  FALSE  The digest can't be calculated.
+
+**/
+BOOLEAN
+TlsGetCaStoreDigest (
+  IN     X509_STORE               *Store,
+  OUT    UINT8                    *Digest
+  );
+
 #endif
 
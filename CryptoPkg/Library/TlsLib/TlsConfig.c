@@ -522,6 +522,7 @@ TlsSetVerifyHost (
   UINTN             BinaryAddressSize;
   UINT8             BinaryAddress[MAX (NS_INADDRSZ, NS_IN6ADDRSZ)];
   INTN              ParamStatus;
+  SHA256_CTX        Sha256Ctx;
 
   TlsConn = (TLS_CONNECTION *) Tls;
   if (TlsConn == NULL || TlsConn->Ssl == NULL || HostName == NULL) {
@@ -530,6 +531,15 @@ TlsSetVerifyHost (
 
   SSL_set_hostflags(TlsConn->Ssl, Flags);
 
+  //
+  // Remember what the peer certificate is checked against, for the cache of
+  // verified certificate chains.
+  //
+  SHA256_Init (&Sha256Ctx);
+  SHA256_Update (&Sha256Ctx, &Flags, sizeof (Flags));
+  SHA256_Update (&Sha256Ctx, HostName, AsciiStrLen (HostName));
+  SHA256_Final (TlsConn->VerifyHostDigest, &Sha256Ctx);
+
   VerifyParam = SSL_get0_param (TlsConn->Ssl);
   ASSERT (VerifyParam != NULL);
 
@@ -596,6 +606,53 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() on a previous
+  connection to the same server, so that the handshake of the connection
+  to be established can resume it instead of doing a full handshake.
+  The session must be set before the handshake is started. The TLS object
+  takes its own reference to the session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_UNSUPPORTED       The session can't be resumed.
+  @retval  EFI_ACCESS_DENIED     The handshake is already started.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+  if (TlsConn == NULL || TlsConn->Ssl == NULL || Session == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_in_before (TlsConn->Ssl) != 1) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  if (SSL_SESSION_is_resumable ((SSL_SESSION *) Session) != 1) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, (SSL_SESSION *) Session) != 1) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1033,6 +1090,92 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the session established by the specified TLS connection.
+
+  This function returns the session negotiated by the handshake of the
+  specified TLS connection, if it can be resumed by a later connection to
+  the same server. The returned session must be freed by TlsFreeSession().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  Pointer to the session object.
+           If there is no resumable session, TlsGetSession() returns NULL.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID                     *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+  if (TlsConn == NULL || TlsConn->Ssl == NULL) {
+    return NULL;
+  }
+
+  Session = SSL_get1_session (TlsConn->Ssl);
+  if (Session == NULL) {
+    return NULL;
+  }
+
+  if (SSL_SESSION_is_resumable (Session) != 1) {
+    SSL_SESSION_free (Session);
+    return NULL;
+  }
+
+  return (VOID *) Session;
+}
+
+/**
+  Free a session returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session         Pointer to the session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID                     *Session
+  )
+{
+  if (Session == NULL) {
+    return;
+  }
+
+  SSL_SESSION_free ((SSL_SESSION *) Session);
+}
+
+/**
+  Checks if the handshake of the specified TLS connection resumed a session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE   The session set by TlsSetSession() was resumed.
+  @retval  FALSE  A full handshake was done, or Tls is NULL.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID                     *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+  if (TlsConn == NULL || TlsConn->Ssl == NULL) {
+    return FALSE;
+  }
+
+  return (BOOLEAN) (SSL_session_reused (TlsConn->Ssl) == 1);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -1160,6 +1303,54 @@ TlsGetCaCertificate (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Gets the digest of the CA certificates in the cert store.
+
+  This function returns a SHA-256 digest of the CA certificates and of the
+  certificate revocation lists in the cert store used by the specified TLS
+  object. It changes whenever a CA certificate is added, so that results
+  which depend on the trusted certificates, e.g. the sessions kept for
+  resumption, can be checked against the current cert store.
+
+  @param[in]      Tls         Pointer to the TLS object.
+  @param[out]     Digest      Pointer to the buffer to receive the digest.
+  @param[in,out]  DigestSize  The size of Digest buffer in bytes.
+
+  @retval  EFI_SUCCESS             The operation succeeded.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_BUFFER_TOO_SMALL    The Digest is too small to hold the digest.
+  @retval  EFI_ABORTED             The digest can't be calculated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetCaCertificateDigest (
+  IN     VOID                     *Tls,
+  OUT    UINT8                    *Digest,
+  IN OUT UINTN                    *DigestSize
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+  if (TlsConn == NULL || TlsConn->Ssl == NULL || DigestSize == NULL ||
+      (Digest == NULL && *DigestSize != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*DigestSize < SHA256_DIGEST_SIZE) {
+    *DigestSize = SHA256_DIGEST_SIZE;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DigestSize = SHA256_DIGEST_SIZE;
+  if (!TlsGetCaStoreDigest (SSL_CTX_get_cert_store (SSL_get_SSL_CTX (TlsConn->Ssl)), Digest)) {
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Gets the local public Certificate set in the specified TLS object.
 
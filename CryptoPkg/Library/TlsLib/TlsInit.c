@@ -106,6 +106,11 @@ TlsCtxNew (
   //
   SSL_CTX_set_min_proto_version (TlsCtx, ProtoVersion);
 
+  //
+  // Skip the verification of the peer certificate chains verified before.
+  //
+  SSL_CTX_set_cert_verify_callback (TlsCtx, TlsVerifyCertCallback, NULL);
+
   return (VOID *) TlsCtx;
 }
 
@@ -175,6 +180,7 @@ TlsNew (
   }
 
   TlsConn->Ssl = NULL;
+  ZeroMem (TlsConn->VerifyHostDigest, sizeof (TlsConn->VerifyHostDigest));
 
   //
   // Create a new SSL Object
@@ -195,6 +201,11 @@ TlsNew (
   //
   SSL_set_info_callback (TlsConn->Ssl, NULL);
 
+  //
+  // Let the certificate verification callback find the TLS connection.
+  //
+  SSL_set_app_data (TlsConn->Ssl, TlsConn);
+
   TlsConn->InBio = NULL;
 
   //
@@ -261,3 +272,50 @@ TlsNew (
   return (VOID *) TlsConn;
 }
 
+/**
+  Reset a TLS object so that it can be used for a new connection.
+
+  This function discards the state of the previous connection, including any
+  pending data in the read and write buffers and the session set for
+  resumption, and keeps the setting inherited from the context and the
+  configuration done on the TLS object.
+
+  @param[in]  Tls    Pointer to the TLS object to be reset.
+
+  @retval  EFI_SUCCESS             The TLS object is reset.
+  @retval  EFI_INVALID_PARAMETER   Tls is NULL.
+  @retval  EFI_ABORTED             The TLS object can't be reset.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsReset (
+  IN     VOID                     *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+  if (TlsConn == NULL || TlsConn->Ssl == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_clear (TlsConn->Ssl) != 1) {
+    return EFI_ABORTED;
+  }
+
+  //
+  // SSL_clear() keeps the session of the previous connection. Drop it, the
+  // caller sets the one to resume, if any, by TlsSetSession().
+  //
+  SSL_set_session (TlsConn->Ssl, NULL);
+
+  BIO_reset (TlsConn->InBio);
+  BIO_reset (TlsConn->OutBio);
+
+  if (!SSL_is_server (TlsConn->Ssl)) {
+    SSL_set_connect_state (TlsConn->Ssl);
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,232 @@
+/** @file
+  Cache of the peer certificate chains verified by TlsLib.
+
+  Every new connection to a server verifies the same certificate chain
+  against the same trusted certificates again, which costs a few public key
+  operations per connection. The chains verified successfully are cached
+  here, keyed by a digest of the certificates sent by the peer, of the host
+  name that was checked and of the trusted certificates the chain was
+  verified against, and a connection presenting a cached chain skips the
+  verification.
+
+  Since the trusted certificates are part of the key, a chain verified
+  against the cert store of one SSL_CTX is never taken as verified by
+  another one, and the results verified before a CA is added to a cert
+  store simply stop matching. Hashing the trusted certificates again for
+  every handshake costs far less than the public key operations saved.
+
+  The validity period isn't part of the key since TlsLib never checks the
+  time (X509_V_FLAG_NO_CHECK_TIME).
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalTlsLib.h"
+
+#define TLS_VERIFY_CACHE_SIZE   8
+
+typedef struct {
+  BOOLEAN                         Valid;
+  UINT8                           Key[SHA256_DIGEST_SIZE];
+} TLS_VERIFY_CACHE_ENTRY;
+
+TLS_VERIFY_CACHE_ENTRY  mTlsVerifyCache[TLS_VERIFY_CACHE_SIZE];
+
+//
+// Entry to be replaced when a new chain is added.
+//
+UINTN                   mTlsVerifyCacheNext = 0;
+
+/**
+  Calculate the digest of the trusted certificates and revocation lists in
+  a cert store.
+
+  @param[in]   Store       Pointer to the X509_STORE.
+  @param[out]  Digest      Buffer of SHA256_DIGEST_SIZE bytes to receive the digest.
+
+  @retval  TRUE   The digest is calculated.
+  @retval  FALSE  The digest can't be calculated.
+
+**/
+BOOLEAN
+TlsGetCaStoreDigest (
+  IN     X509_STORE               *Store,
+  OUT    UINT8                    *Digest
+  )
+{
+  STACK_OF (X509_OBJECT)  *Objects;
+  X509_OBJECT             *Object;
+  X509_LOOKUP_TYPE        Type;
+  SHA256_CTX              Sha256Ctx;
+  UINT8                   Fingerprint[EVP_MAX_MD_SIZE];
+  unsigned int            FingerprintSize;
+  INTN                    Index;
+  int                     Ret;
+
+  if (Store == NULL) {
+    return FALSE;
+  }
+
+  Ret = 1;
+  SHA256_Init (&Sha256Ctx);
+
+  X509_STORE_lock (Store);
+  Objects = X509_STORE_get0_objects (Store);
+
+  //
+  // Lookups keep the objects sorted by subject name, sort them here too so
+  // that the digest doesn't depend on the lookups done so far. Objects with
+  // the same subject may still come in any order, which only costs a miss.
+  //
+  sk_X509_OBJECT_sort (Objects);
+
+  for (Index = 0; Index < sk_X509_OBJECT_num (Objects); Index++) {
+    Object = sk_X509_OBJECT_value (Objects, (int) Index);
+    Type   = X509_OBJECT_get_type (Object);
+    switch (Type) {
+    case X509_LU_X509:
+      Ret = X509_digest (X509_OBJECT_get0_X509 (Object), EVP_sha256 (), Fingerprint, &FingerprintSize);
+      break;
+    case X509_LU_CRL:
+      Ret = X509_CRL_digest (X509_OBJECT_get0_X509_CRL (Object), EVP_sha256 (), Fingerprint, &FingerprintSize);
+      break;
+    default:
+      continue;
+    }
+
+    if (Ret != 1) {
+      break;
+    }
+
+    SHA256_Update (&Sha256Ctx, &Type, sizeof (Type));
+    SHA256_Update (&Sha256Ctx, Fingerprint, FingerprintSize);
+  }
+
+  X509_STORE_unlock (Store);
+
+  if (Ret != 1) {
+    return FALSE;
+  }
+
+  SHA256_Final (Digest, &Sha256Ctx);
+  return TRUE;
+}
+
+/**
+  Calculate the cache key of a peer certificate chain.
+
+  @param[in]   StoreCtx    Pointer to the X509_STORE_CTX holding the peer chain.
+  @param[in]   TlsConn     Pointer to the TLS connection being verified.
+  @param[out]  Key         Buffer to receive the key.
+
+  @retval  TRUE   The key is calculated.
+  @retval  FALSE  The key can't be calculated.
+
+**/
+STATIC
+BOOLEAN
+TlsGetVerifyCacheKey (
+  IN     X509_STORE_CTX           *StoreCtx,
+  IN     TLS_CONNECTION           *TlsConn,
+  OUT    UINT8                    *Key
+  )
+{
+  STACK_OF (X509)  *Chain;
+  X509             *Cert;
+  SHA256_CTX       Sha256Ctx;
+  UINT8            Fingerprint[EVP_MAX_MD_SIZE];
+  unsigned int     FingerprintSize;
+  UINT8            CaStoreDigest[SHA256_DIGEST_SIZE];
+  INTN             Index;
+
+  Cert  = X509_STORE_CTX_get0_cert (StoreCtx);
+  Chain = X509_STORE_CTX_get0_untrusted (StoreCtx);
+  if (Cert == NULL) {
+    return FALSE;
+  }
+
+  if (!TlsGetCaStoreDigest (X509_STORE_CTX_get0_store (StoreCtx), CaStoreDigest)) {
+    return FALSE;
+  }
+
+  SHA256_Init (&Sha256Ctx);
+
+  //
+  // A cached chain skips the verification, so the fingerprints must be
+  // collision resistant. The SHA-1 one cached by OpenSSL isn't.
+  //
+  if (X509_digest (Cert, EVP_sha256 (), Fingerprint, &FingerprintSize) != 1) {
+    return FALSE;
+  }
+  SHA256_Update (&Sha256Ctx, Fingerprint, FingerprintSize);
+
+  for (Index = 0; Chain != NULL && Index < sk_X509_num (Chain); Index++) {
+    if (X509_digest (sk_X509_value (Chain, (int) Index), EVP_sha256 (), Fingerprint, &FingerprintSize) != 1) {
+      return FALSE;
+    }
+    SHA256_Update (&Sha256Ctx, Fingerprint, FingerprintSize);
+  }
+
+  SHA256_Update (&Sha256Ctx, TlsConn->VerifyHostDigest, sizeof (TlsConn->VerifyHostDigest));
+  SHA256_Update (&Sha256Ctx, CaStoreDigest, sizeof (CaStoreDigest));
+  SHA256_Final (Key, &Sha256Ctx);
+  return TRUE;
+}
+
+/**
+  Certificate verification callback of the SSL_CTX.
+
+  The peer certificate chains that have been verified successfully are
+  cached, so that a later connection to the same server doesn't need to
+  verify the same chain again.
+
+  @param[in]  StoreCtx    Pointer to the X509_STORE_CTX holding the peer chain.
+  @param[in]  Arg         Argument set with the callback, not used.
+
+  @retval  1    The chain is verified.
+  @retval  0    The chain can't be verified.
+
+**/
+int
+TlsVerifyCertCallback (
+  IN     X509_STORE_CTX           *StoreCtx,
+  IN     VOID                     *Arg
+  )
+{
+  SSL             *Ssl;
+  TLS_CONNECTION  *TlsConn;
+  UINT8           Key[SHA256_DIGEST_SIZE];
+  BOOLEAN         KeyValid;
+  UINTN           Index;
+  int             Ret;
+
+  KeyValid = FALSE;
+  Ssl      = X509_STORE_CTX_get_ex_data (StoreCtx, SSL_get_ex_data_X509_STORE_CTX_idx ());
+  if (Ssl != NULL) {
+    TlsConn = (TLS_CONNECTION *) SSL_get_app_data (Ssl);
+    if (TlsConn != NULL) {
+      KeyValid = TlsGetVerifyCacheKey (StoreCtx, TlsConn, Key);
+    }
+  }
+
+  if (KeyValid) {
+    for (Index = 0; Index < TLS_VERIFY_CACHE_SIZE; Index++) {
+      if (mTlsVerifyCache[Index].Valid &&
+          CompareMem (mTlsVerifyCache[Index].Key, Key, sizeof (Key)) == 0) {
+        X509_STORE_CTX_set_error (StoreCtx, X509_V_OK);
+        return 1;
+      }
+    }
+  }
+
+  Ret = X509_verify_cert (StoreCtx);
+  if ((Ret == 1) && KeyValid) {
+    CopyMem (mTlsVerifyCache[mTlsVerifyCacheNext].Key, Key, sizeof (Key));
+    mTlsVerifyCache[mTlsVerifyCacheNext].Valid = TRUE;
+    mTlsVerifyCacheNext = (mTlsVerifyCacheNext + 1) % TLS_VERIFY_CACHE_SIZE;
+  }
+
+  return Ret;
+}
@@ -184,6 +184,35 @@ TlsSetSessionId (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() on a previous
+  connection to the same server, so that the handshake of the connection
+  to be established can resume it instead of doing a full handshake.
+  The session must be set before the handshake is started. The TLS object
+  takes its own reference to the session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_UNSUPPORTED       The session can't be resumed.
+  @retval  EFI_ACCESS_DENIED     The handshake is already started.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  )
+{
+  ASSERT(FALSE);
+  return EFI_UNSUPPORTED;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -443,6 +472,65 @@ TlsGetSessionId (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Gets the session established by the specified TLS connection.
+
+  This function returns the session negotiated by the handshake of the
+  specified TLS connection, if it can be resumed by a later connection to
+  the same server. The returned session must be freed by TlsFreeSession().
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @return  Pointer to the session object.
+           If there is no resumable session, TlsGetSession() returns NULL.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID                     *Tls
+  )
+{
+  ASSERT(FALSE);
+  return NULL;
+}
+
+/**
+  Free a session returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session         Pointer to the session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID                     *Session
+  )
+{
+  ASSERT(FALSE);
+}
+
+/**
+  Checks if the handshake of the specified TLS connection resumed a session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+
+  @retval  TRUE   The session set by TlsSetSession() was resumed.
+  @retval  FALSE  A full handshake was done, or Tls is NULL.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID                     *Tls
+  )
+{
+  ASSERT(FALSE);
+  return FALSE;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -538,6 +626,38 @@ TlsGetCaCertificate (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Gets the digest of the CA certificates in the cert store.
+
+  This function returns a SHA-256 digest of the CA certificates and of the
+  certificate revocation lists in the cert store used by the specified TLS
+  object. It changes whenever a CA certificate is added, so that results
+  which depend on the trusted certificates, e.g. the sessions kept for
+  resumption, can be checked against the current cert store.
+
+  @param[in]      Tls         Pointer to the TLS object.
+  @param[out]     Digest      Pointer to the buffer to receive the digest.
+  @param[in,out]  DigestSize  The size of Digest buffer in bytes.
+
+  @retval  EFI_SUCCESS             The operation succeeded.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_BUFFER_TOO_SMALL    The Digest is too small to hold the digest.
+  @retval  EFI_ABORTED             The digest can't be calculated.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetCaCertificateDigest (
+  IN     VOID                     *Tls,
+  OUT    UINT8                    *Digest,
+  IN OUT UINTN                    *DigestSize
+  )
+{
+  ASSERT(FALSE);
+  return EFI_UNSUPPORTED;
+}
+
 /**
   Gets the local public Certificate set in the specified TLS object.
 
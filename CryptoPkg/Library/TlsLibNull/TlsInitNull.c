@@ -109,3 +109,27 @@ TlsNew (
   return NULL;
 }
 
+/**
+  Reset a TLS object so that it can be used for a new connection.
+
+  This function discards the state of the previous connection, including any
+  pending data in the read and write buffers and the session set for
+  resumption, and keeps the setting inherited from the context and the
+  configuration done on the TLS object.
+
+  @param[in]  Tls    Pointer to the TLS object to be reset.
+
+  @retval  EFI_SUCCESS             The TLS object is reset.
+  @retval  EFI_INVALID_PARAMETER   Tls is NULL.
+  @retval  EFI_ABORTED             The TLS object can't be reset.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsReset (
+  IN     VOID                     *Tls
+  )
+{
+  ASSERT(FALSE);
+  return EFI_UNSUPPORTED;
+}
@@ -1067,6 +1067,609 @@ Exit:
   return Status;
 }
 
+/**
+  Build the command list entry and the command table of a queued command.
+
+  Unlike AhciBuildCommand(), the received FIS area of the port is kept as is,
+  since other queued commands may be outstanding on the port.
+
+  @param    PciIo                 The PCI IO protocol instance.
+  @param    AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param    Port                  The number of port.
+  @param    PortMultiplier        The port multiplier port number.
+  @param    CommandFis            The control fis will be used for the transfer.
+  @param    CommandList           The command list will be used for the transfer.
+  @param    CommandSlotNumber     The command slot will be used for the transfer.
+  @param    DataPhysicalAddr      The pointer to the data buffer pci bus master address.
+  @param    DataLength            The data count to be transferred.
+
+**/
+VOID
+EFIAPI
+AhciBuildQueuedCommand (
+  IN     EFI_PCI_IO_PROTOCOL        *PciIo,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     UINT8                      PortMultiplier,
+  IN     EFI_AHCI_COMMAND_FIS       *CommandFis,
+  IN     EFI_AHCI_COMMAND_LIST      *CommandList,
+  IN     UINT8                      CommandSlotNumber,
+  IN OUT VOID                       *DataPhysicalAddr,
+  IN     UINT32                     DataLength
+  )
+{
+  EFI_AHCI_QUEUED_COMMAND_TABLE *CommandTable;
+  UINT32                        PrdtNumber;
+  UINT32                        PrdtIndex;
+  UINTN                         RemainedData;
+  UINTN                         MemAddr;
+  DATA_64                       Data64;
+
+  PrdtNumber = (UINT32)DivU64x32 (((UINT64)DataLength + EFI_AHCI_MAX_DATA_PER_PRDT - 1), EFI_AHCI_MAX_DATA_PER_PRDT);
+  ASSERT (PrdtNumber <= EFI_AHCI_MAX_QUEUED_PRDT);
+
+  CommandTable = &AhciRegisters->AhciQueuedCommandTable[CommandSlotNumber];
+  ZeroMem (CommandTable, sizeof (EFI_AHCI_QUEUED_COMMAND_TABLE));
+
+  CommandFis->AhciCFisPmNum = PortMultiplier;
+
+  CopyMem (&CommandTable->CommandFis, CommandFis, sizeof (EFI_AHCI_COMMAND_FIS));
+
+  RemainedData = (UINTN) DataLength;
+  MemAddr      = (UINTN) DataPhysicalAddr;
+  CommandList->AhciCmdPrdtl = PrdtNumber;
+
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    if (RemainedData < EFI_AHCI_MAX_DATA_PER_PRDT) {
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = (UINT32)RemainedData - 1;
+    } else {
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = EFI_AHCI_MAX_DATA_PER_PRDT - 1;
+    }
+
+    Data64.Uint64 = (UINT64)MemAddr;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba  = Data64.Uint32.Lower32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau = Data64.Uint32.Upper32;
+    RemainedData -= EFI_AHCI_MAX_DATA_PER_PRDT;
+    MemAddr      += EFI_AHCI_MAX_DATA_PER_PRDT;
+  }
+
+  //
+  // Set the last PRDT to Interrupt On Complete
+  //
+  if (PrdtNumber > 0) {
+    CommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
+  }
+
+  CopyMem (
+    &AhciRegisters->AhciCmdList[CommandSlotNumber],
+    CommandList,
+    sizeof (EFI_AHCI_COMMAND_LIST)
+    );
+
+  Data64.Uint64 = (UINT64)(UINTN) &AhciRegisters->AhciQueuedCommandTablePciAddr[CommandSlotNumber];
+  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdCtba  = Data64.Uint32.Lower32;
+  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdCtbau = Data64.Uint32.Upper32;
+  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdPmp   = PortMultiplier;
+}
+
+/**
+  Check whether the queued command in a given slot is completed.
+
+  The device completes queued commands by sending a Set Device Bits FIS, which
+  makes the HBA clear the corresponding bits of PxSACT. An error reported by
+  the device aborts all the queued commands outstanding on the port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  AhciRegisters      The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port               The number of port.
+  @param  CommandSlot        The command slot of the queued command.
+
+  @retval EFI_SUCCESS        The queued command is completed successfully.
+  @retval EFI_NOT_READY      The queued command is still outstanding.
+  @retval EFI_DEVICE_ERROR   The device or the HBA reported an error.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciCheckQueuedCommand (
+  IN  EFI_PCI_IO_PROTOCOL       *PciIo,
+  IN  EFI_AHCI_REGISTERS        *AhciRegisters,
+  IN  UINT8                     Port,
+  IN  UINT8                     CommandSlot
+  )
+{
+  UINT32     PortBase;
+  UINT32     PortIs;
+  UINT32     SlotBit;
+  UINTN      SdbFis;
+
+  PortBase = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH;
+  SlotBit  = (UINT32) 1 << CommandSlot;
+
+  PortIs = AhciReadReg (PciIo, PortBase + EFI_AHCI_PORT_IS);
+  if ((PortIs & (EFI_AHCI_PORT_IS_TFES | EFI_AHCI_PORT_IS_HBFS | EFI_AHCI_PORT_IS_HBDS | EFI_AHCI_PORT_IS_IFS)) != 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (((AhciReadReg (PciIo, PortBase + EFI_AHCI_PORT_SACT) |
+        AhciReadReg (PciIo, PortBase + EFI_AHCI_PORT_CI)) & SlotBit) != 0) {
+    return EFI_NOT_READY;
+  }
+
+  //
+  // The completion is notified by a Set Device Bits FIS. Acknowledge it and
+  // check the status it carries.
+  //
+  if ((PortIs & EFI_AHCI_PORT_IS_SDBS) != 0) {
+    AhciWriteReg (PciIo, PortBase + EFI_AHCI_PORT_IS, EFI_AHCI_PORT_IS_SDBS);
+  }
+
+  SdbFis = (UINTN)AhciRegisters->AhciRFis + Port * sizeof (EFI_AHCI_RECEIVED_FIS) + EFI_AHCI_SDB_FIS_OFFSET;
+  if ((*(volatile UINT8 *) SdbFis == EFI_AHCI_FIS_SET_DEVICE) &&
+      ((*(volatile UINT8 *) (SdbFis + 2) & EFI_AHCI_PORT_TFD_ERR) != 0)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Abort all queued commands outstanding on the port after an error.
+
+  The port is stopped, which clears PxSACT and PxCI, and the received FIS of
+  the port is cleared so that a stale Set Device Bits FIS isn't taken for a
+  completion. The data buffers of all the started queued tasks are unmapped
+  and the tasks are marked aborted, they are left in the non-blocking task
+  list for the caller to complete with EFI_ABORTED.
+
+  @param  Instance           The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param  AhciRegisters      The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port               The number of port.
+  @param  Timeout            The timeout value of stop, uses 100ns as a unit.
+
+**/
+VOID
+EFIAPI
+AhciAbortQueuedCommands (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN  EFI_AHCI_REGISTERS           *AhciRegisters,
+  IN  UINT8                        Port,
+  IN  UINT64                       Timeout
+  )
+{
+  EFI_PCI_IO_PROTOCOL          *PciIo;
+  LIST_ENTRY                   *Entry;
+  ATA_NONBLOCK_TASK            *Task;
+
+  PciIo = Instance->PciIo;
+
+  AhciStopCommand (
+    PciIo,
+    Port,
+    Timeout
+    );
+
+  AhciDisableFisReceive (
+    PciIo,
+    Port,
+    Timeout
+    );
+
+  ZeroMem (
+    (VOID *)((UINTN)AhciRegisters->AhciRFis + Port * sizeof (EFI_AHCI_RECEIVED_FIS)),
+    sizeof (EFI_AHCI_RECEIVED_FIS)
+    );
+
+  for (Entry = GetFirstNode (&Instance->NonBlockingTaskList);
+       !IsNull (&Instance->NonBlockingTaskList, Entry);
+       Entry = GetNextNode (&Instance->NonBlockingTaskList, Entry)) {
+    Task = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    if (Task->IsStart && (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA)) {
+      if (Task->Map != NULL) {
+        PciIo->Unmap (PciIo, Task->Map);
+        Task->Map = NULL;
+      }
+      Task->IsAborted = TRUE;
+    }
+  }
+
+  AhciRegisters->QueuedActiveSlots = 0;
+}
+
+/**
+  Complete all outstanding queued commands.
+
+  A non-queued command makes the device abort the queued commands, and all ports
+  share one command list. So the queued commands must be finished before any other
+  command is issued to the HBA.
+
+  @param  Instance           The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+
+**/
+VOID
+EFIAPI
+AhciFlushQueuedCommands (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE *Instance
+  )
+{
+  EFI_TPL                      OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while (Instance->AhciRegisters.QueuedActiveSlots != 0) {
+    AsyncNonBlockingTransferRoutine (NULL, Instance);
+    //
+    // Stall for 100us.
+    //
+    MicroSecondDelay (100);
+  }
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Get the command slots that can be used for the queued commands of a device.
+
+  The tag of a queued command is its command slot, so only as many slots as
+  the queue depth reported in word 75 of the IDENTIFY data of the device are
+  used.
+
+  @param  Instance           The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param  Port               The number of port.
+  @param  PortMultiplier     The port multiplier port number.
+
+  @return The mask of the command slots.
+
+**/
+UINT32
+AhciGetQueuedSlotMask (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN  UINT8                        Port,
+  IN  UINT8                        PortMultiplier
+  )
+{
+  LIST_ENTRY                   *Node;
+  EFI_ATA_DEVICE_INFO          *DeviceInfo;
+  UINTN                        QueueDepth;
+
+  for (Node = GetFirstNode (&Instance->DeviceList);
+       !IsNull (&Instance->DeviceList, Node);
+       Node = GetNextNode (&Instance->DeviceList, Node)) {
+    DeviceInfo = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+    if ((DeviceInfo->Type == EfiIdeHarddisk) &&
+        (DeviceInfo->Port == Port) &&
+        ((UINT8) DeviceInfo->PortMultiplier == PortMultiplier) &&
+        (DeviceInfo->IdentifyData != NULL)) {
+      QueueDepth = (DeviceInfo->IdentifyData->AtaData.queue_depth & 0x1F) + 1;
+      return Instance->AhciRegisters.QueuedSlotMask & (UINT32) (LShiftU64 (1, QueueDepth) - 1);
+    }
+  }
+
+  return Instance->AhciRegisters.QueuedSlotMask;
+}
+
+/**
+  Start a queued (NCQ) DMA data transfer on specific port.
+
+  Up to the number of command slots of the HBA or the queue depth of the device,
+  whichever is lower, queued commands are outstanding at the same time. The tag of the command is the command slot allocated for it,
+  and the command completes when the device clears its bit of PxSACT through a
+  Set Device Bits FIS.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The port multiplier port number.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The DMA data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     The HBA doesn't support queued commands.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer can't be described by a queued command.
+  @retval EFI_ABORTED         The command was aborted by an error of another queued
+                              command (non-blocking mode only).
+  @retval EFI_NOT_READY       The command is not finished yet, or no command slot
+                              is available to start it (non-blocking mode only).
+  @retval EFI_SUCCESS         The DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciFpdmaTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     UINT8                      PortMultiplier,
+  IN     BOOLEAN                    Read,
+  IN     EFI_ATA_COMMAND_BLOCK      *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN OUT VOID                       *MemoryAddr,
+  IN     UINT32                     DataCount,
+  IN     UINT64                     Timeout,
+  IN     ATA_NONBLOCK_TASK          *Task
+  )
+{
+  EFI_STATUS                    Status;
+  UINT32                        Offset;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+  VOID                          *Map;
+  UINTN                         MapLength;
+  EFI_PCI_IO_PROTOCOL_OPERATION Flag;
+  EFI_AHCI_COMMAND_FIS          CFis;
+  EFI_AHCI_COMMAND_LIST         CmdList;
+  UINT32                        FreeSlots;
+  UINT8                         Slot;
+  UINT32                        SlotBit;
+  UINT32                        PortTfd;
+  UINT64                        Delay;
+  BOOLEAN                       InfiniteWait;
+
+  EFI_PCI_IO_PROTOCOL           *PciIo;
+  EFI_TPL                       OldTpl;
+
+  Map   = NULL;
+  PciIo = Instance->PciIo;
+
+  if (PciIo == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (AhciRegisters->AhciQueuedCommandTable == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Before starting the Blocking BlockIO operation, push to finish all non-blocking
+  // BlockIO tasks.
+  // Delay 100us to simulate the blocking time out checking.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while ((Task == NULL) && (!IsListEmpty (&Instance->NonBlockingTaskList))) {
+    AsyncNonBlockingTransferRoutine (NULL, Instance);
+    //
+    // Stall for 100us.
+    //
+    MicroSecondDelay (100);
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if ((Task == NULL) || (!Task->IsStart)) {
+    //
+    // All ports share one command list, so queued commands are only outstanding
+    // on one port at a time. Other ports wait until the queue drains.
+    //
+    if ((AhciRegisters->QueuedActiveSlots != 0) &&
+        ((AhciRegisters->QueuedPort != Port) || (AhciRegisters->QueuedPortMultiplier != PortMultiplier))) {
+      return EFI_NOT_READY;
+    }
+
+    FreeSlots = AhciGetQueuedSlotMask (Instance, Port, PortMultiplier) & ~AhciRegisters->QueuedActiveSlots;
+    if (FreeSlots == 0) {
+      return EFI_NOT_READY;
+    }
+
+    if (DivU64x32 ((UINT64)DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1, EFI_AHCI_MAX_DATA_PER_PRDT) > EFI_AHCI_MAX_QUEUED_PRDT) {
+      return EFI_BAD_BUFFER_SIZE;
+    }
+
+    Slot    = (UINT8) LowBitSet32 (FreeSlots);
+    SlotBit = (UINT32) 1 << Slot;
+
+    if (Read) {
+      Flag = EfiPciIoOperationBusMasterWrite;
+    } else {
+      Flag = EfiPciIoOperationBusMasterRead;
+    }
+
+    //
+    // Construct command list and command table with pci bus address.
+    //
+    MapLength = DataCount;
+    Status = PciIo->Map (
+                      PciIo,
+                      Flag,
+                      MemoryAddr,
+                      &MapLength,
+                      &PhyAddr,
+                      &Map
+                      );
+
+    if (EFI_ERROR (Status) || (DataCount != MapLength)) {
+      if (!EFI_ERROR (Status)) {
+        PciIo->Unmap (PciIo, Map);
+      }
+      return EFI_BAD_BUFFER_SIZE;
+    }
+
+    AhciBuildCommandFis (&CFis, AtaCommandBlock);
+
+    //
+    // The tag of a queued command lives in bits 7:3 of the sector count, and
+    // the FUA bit of the device register is taken from the command block.
+    //
+    CFis.AhciCFisSecCount = (UINT8) (Slot << 3);
+    CFis.AhciCFisDevHead  = (UINT8) (AtaCommandBlock->AtaDeviceHead | BIT6);
+
+    ZeroMem (&CmdList, sizeof (EFI_AHCI_COMMAND_LIST));
+
+    CmdList.AhciCmdCfl = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+    CmdList.AhciCmdW   = Read ? 0 : 1;
+
+    AhciBuildQueuedCommand (
+      PciIo,
+      AhciRegisters,
+      Port,
+      PortMultiplier,
+      &CFis,
+      &CmdList,
+      Slot,
+      (VOID *)(UINTN)PhyAddr,
+      DataCount
+      );
+
+    if (AhciRegisters->QueuedActiveSlots == 0) {
+      //
+      // First queued command on the port, clear the stale received FIS and start
+      // the port.
+      //
+      ZeroMem (
+        (VOID *)((UINTN)AhciRegisters->AhciRFis + Port * sizeof (EFI_AHCI_RECEIVED_FIS)),
+        sizeof (EFI_AHCI_RECEIVED_FIS)
+        );
+
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+      AhciAndReg (PciIo, Offset, (UINT32)~(EFI_AHCI_PORT_CMD_DLAE | EFI_AHCI_PORT_CMD_ATAPI));
+
+      Status = AhciStartPort (
+                 PciIo,
+                 Port,
+                 Timeout
+                 );
+      if (EFI_ERROR (Status)) {
+        PciIo->Unmap (PciIo, Map);
+        return Status;
+      }
+
+      AhciRegisters->QueuedPort           = Port;
+      AhciRegisters->QueuedPortMultiplier = PortMultiplier;
+    }
+
+    AhciRegisters->QueuedActiveSlots |= SlotBit;
+
+    //
+    // PxSACT must be set before PxCI. Only write the bit of this slot, as
+    // writing back the other outstanding bits could reissue completed commands.
+    //
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+    AhciWriteReg (PciIo, Offset, SlotBit);
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+    AhciWriteReg (PciIo, Offset, SlotBit);
+
+    if (Task != NULL) {
+      //
+      // Mark the Task to indicate that it has been started.
+      //
+      Task->IsStart = TRUE;
+      Task->Slot    = Slot;
+      Task->Map     = Map;
+    }
+  } else {
+    Slot    = Task->Slot;
+    SlotBit = (UINT32) 1 << Slot;
+
+    //
+    // The command was aborted along with the other queued commands of the port
+    // and its buffer is already unmapped.
+    //
+    if (Task->IsAborted) {
+      if (AtaStatusBlock != NULL) {
+        ZeroMem (AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
+        AtaStatusBlock->AtaStatus = BIT0;
+      }
+      return EFI_ABORTED;
+    }
+  }
+
+  //
+  // Wait for command compelte
+  //
+  if (Task != NULL) {
+    //
+    // For Non-blocking
+    //
+    Task->RetryTimes--;
+    Status = AhciCheckQueuedCommand (PciIo, AhciRegisters, Port, Slot);
+    if ((Status == EFI_NOT_READY) && !Task->InfiniteWait && (Task->RetryTimes == 0)) {
+      Status = EFI_TIMEOUT;
+    }
+  } else {
+    InfiniteWait = (BOOLEAN) (Timeout == 0);
+    Delay        = DivU64x32 (Timeout, 1000) + 1;
+    do {
+      Status = AhciCheckQueuedCommand (PciIo, AhciRegisters, Port, Slot);
+      if (Status != EFI_NOT_READY) {
+        break;
+      }
+
+      //
+      // Stall for 100 microseconds.
+      //
+      MicroSecondDelay (100);
+
+      Delay--;
+    } while (InfiniteWait || (Delay > 0));
+
+    if (Status == EFI_NOT_READY) {
+      Status = EFI_TIMEOUT;
+    }
+  }
+
+  if (Status == EFI_NOT_READY) {
+    return Status;
+  }
+
+  //
+  // No D2H FIS is received for the completion of a queued command, so update
+  // the status block through PxTFD which reflects the Set Device Bits FIS.
+  //
+  if (AtaStatusBlock != NULL) {
+    ZeroMem (AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
+
+    Offset  = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+    PortTfd = AhciReadReg (PciIo, Offset);
+
+    AtaStatusBlock->AtaStatus = (UINT8)PortTfd;
+    if ((AtaStatusBlock->AtaStatus & BIT0) != 0) {
+      AtaStatusBlock->AtaError = (UINT8)(PortTfd >> 8);
+    } else if (EFI_ERROR (Status)) {
+      AtaStatusBlock->AtaStatus |= BIT0;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AhciFpdmaTransfer: queued command on port %d slot %d failed - %r\n", Port, Slot, Status));
+    //
+    // The device aborts all outstanding queued commands on error, stop the port
+    // and release them all.
+    //
+    AhciAbortQueuedCommands (Instance, AhciRegisters, Port, Timeout);
+    if ((Task == NULL) && (Map != NULL)) {
+      PciIo->Unmap (PciIo, Map);
+    }
+    return Status;
+  }
+
+  if (Task != NULL) {
+    Map       = Task->Map;
+    Task->Map = NULL;
+  }
+  if (Map != NULL) {
+    PciIo->Unmap (PciIo, Map);
+  }
+
+  AhciRegisters->QueuedActiveSlots &= ~SlotBit;
+  if (AhciRegisters->QueuedActiveSlots == 0) {
+    AhciStopCommand (
+      PciIo,
+      Port,
+      Timeout
+      );
+
+    AhciDisableFisReceive (
+      PciIo,
+      Port,
+      Timeout
+      );
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Start a non data transfer on specific port.
 
@@ -1228,28 +1831,25 @@ AhciStopCommand (
 }
 
 /**
-  Start command for give slot on specific port.
+  Start the command list processing on specific port.
 
   @param  PciIo              The PCI IO protocol instance.
   @param  Port               The number of port.
-  @param  CommandSlot        The number of Command Slot.
   @param  Timeout            The timeout value of start, uses 100ns as a unit.
 
-  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_DEVICE_ERROR   The port start unsuccessfully.
   @retval EFI_TIMEOUT        The operation is time out.
-  @retval EFI_SUCCESS        The command start successfully.
+  @retval EFI_SUCCESS        The port start successfully.
 
 **/
 EFI_STATUS
 EFIAPI
-AhciStartCommand (
+AhciStartPort (
   IN  EFI_PCI_IO_PROTOCOL       *PciIo,
   IN  UINT8                     Port,
-  IN  UINT8                     CommandSlot,
   IN  UINT64                    Timeout
   )
 {
-  UINT32     CmdSlotBit;
   EFI_STATUS Status;
   UINT32     PortStatus;
   UINT32     StartCmd;
@@ -1262,8 +1862,6 @@ AhciStartCommand (
   //
   Capability = AhciReadReg(PciIo, EFI_AHCI_CAPABILITY_OFFSET);
 
-  CmdSlotBit = (UINT32) (1 << CommandSlot);
-
   AhciClearPortStatus (
     PciIo,
     Port
@@ -1310,6 +1908,47 @@ AhciStartCommand (
   Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
   AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_ST | StartCmd);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Start command for give slot on specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  CommandSlot        The number of Command Slot.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The command start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartCommand (
+  IN  EFI_PCI_IO_PROTOCOL       *PciIo,
+  IN  UINT8                     Port,
+  IN  UINT8                     CommandSlot,
+  IN  UINT64                    Timeout
+  )
+{
+  UINT32     CmdSlotBit;
+  EFI_STATUS Status;
+  UINT32     Offset;
+
+  CmdSlotBit = (UINT32) (1 << CommandSlot);
+
+  Status = AhciStartPort (
+             PciIo,
+             Port,
+             Timeout
+             );
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Setting the command
   //
@@ -2108,6 +2747,98 @@ Error6:
   return Status;
 }
 
+/**
+  Allocate the command tables used by the queued (NCQ) commands, one for each
+  command slot of the HBA.
+
+  The queued commands are optional, so a failure here leaves them disabled
+  instead of failing the controller initialization.
+
+  @param  PciIo                 The PCI IO protocol instance.
+  @param  AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+
+  @retval EFI_UNSUPPORTED       The HBA doesn't support Native Command Queuing.
+  @retval EFI_OUT_OF_RESOURCES  The command tables can't be allocated.
+  @retval EFI_DEVICE_ERROR      The command tables are above 4GB for a 32bit HBA.
+  @retval EFI_SUCCESS           The command tables are allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciCreateQueuedCommandTable (
+  IN     EFI_PCI_IO_PROTOCOL    *PciIo,
+  IN OUT EFI_AHCI_REGISTERS     *AhciRegisters
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Bytes;
+  VOID                  *Buffer;
+  UINT32                Capability;
+  UINT8                 MaxCommandSlotNumber;
+  UINT64                MaxQueuedCommandTableSize;
+  EFI_PHYSICAL_ADDRESS  AhciQueuedCommandTablePciAddr;
+
+  AhciRegisters->AhciQueuedCommandTable = NULL;
+  AhciRegisters->QueuedSlotMask         = 0;
+  AhciRegisters->QueuedActiveSlots      = 0;
+
+  Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+  if ((Capability & EFI_AHCI_CAP_SNCQ) == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MaxCommandSlotNumber      = (UINT8) (((Capability & 0x1F00) >> 8) + 1);
+  MaxQueuedCommandTableSize = MaxCommandSlotNumber * sizeof (EFI_AHCI_QUEUED_COMMAND_TABLE);
+
+  Buffer = NULL;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES ((UINTN) MaxQueuedCommandTableSize),
+                    &Buffer,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Buffer, (UINTN)MaxQueuedCommandTableSize);
+  Bytes  = (UINTN)MaxQueuedCommandTableSize;
+
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &AhciQueuedCommandTablePciAddr,
+                    &AhciRegisters->MapQueuedCommandTable
+                    );
+  if (EFI_ERROR (Status) || (Bytes != MaxQueuedCommandTableSize)) {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, AhciRegisters->MapQueuedCommandTable);
+    }
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES ((UINTN) MaxQueuedCommandTableSize), Buffer);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (((Capability & EFI_AHCI_CAP_S64A) == 0) && (AhciQueuedCommandTablePciAddr > 0x100000000ULL)) {
+    //
+    // The AHCI HBA doesn't support 64bit addressing, so should not get a >4G pci bus master address.
+    //
+    PciIo->Unmap (PciIo, AhciRegisters->MapQueuedCommandTable);
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES ((UINTN) MaxQueuedCommandTableSize), Buffer);
+    return EFI_DEVICE_ERROR;
+  }
+
+  AhciRegisters->AhciQueuedCommandTable        = Buffer;
+  AhciRegisters->AhciQueuedCommandTablePciAddr = (EFI_AHCI_QUEUED_COMMAND_TABLE *)(UINTN)AhciQueuedCommandTablePciAddr;
+  AhciRegisters->MaxQueuedCommandTableSize     = MaxQueuedCommandTableSize;
+  AhciRegisters->QueuedSlotMask                = (UINT32) (LShiftU64 (1, MaxCommandSlotNumber) - 1);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read logs from SATA device.
 
@@ -2542,6 +3273,9 @@ AhciModeInitialization (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Status = AhciCreateQueuedCommandTable (PciIo, AhciRegisters);
+  DEBUG ((DEBUG_INFO, "AhciModeInitialization: Native Command Queuing - %r\n", Status));
+
   for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port ++) {
     if ((PortImplementBitMap & (((UINT32)BIT0) << Port)) != 0) {
       //
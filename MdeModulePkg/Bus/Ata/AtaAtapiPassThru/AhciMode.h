@@ -13,6 +13,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET             0x0000
 #define   EFI_AHCI_CAP_SAM                     BIT18
 #define   EFI_AHCI_CAP_SSS                     BIT27
+#define   EFI_AHCI_CAP_SNCQ                    BIT30
 #define   EFI_AHCI_CAP_S64A                    BIT31
 #define EFI_AHCI_GHC_OFFSET                    0x0004
 #define   EFI_AHCI_GHC_RESET                   BIT0
@@ -61,6 +62,12 @@ typedef union {
 //
 #define EFI_AHCI_MAX_DATA_PER_PRDT             0x400000
 
+//
+// Queued commands transfer at most 65536 sectors. With 4KB logical sectors it
+// takes 64 PRDT entries to describe the largest transfer.
+//
+#define EFI_AHCI_MAX_QUEUED_PRDT               64
+
 #define EFI_AHCI_FIS_REGISTER_H2D              0x27      //Register FIS - Host to Device
 #define   EFI_AHCI_FIS_REGISTER_H2D_LENGTH     20
 #define EFI_AHCI_FIS_REGISTER_D2H              0x34      //Register FIS - Device to Host
@@ -272,6 +279,17 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Command table used by the queued (NCQ) commands, one per command slot.
+// Its size keeps every table on the 128 bytes alignment required by CTBA.
+//
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;       // A software constructed FIS.
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;         // 12 or 16 bytes ATAPI cmd.
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[EFI_AHCI_MAX_QUEUED_PRDT];  // The scatter/gather list for data transfer
+} EFI_AHCI_QUEUED_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -311,6 +329,20 @@ typedef struct {
   VOID                      *MapRFis;
   VOID                      *MapCmdList;
   VOID                      *MapCommandTable;
+
+  //
+  // Resource of the queued (NCQ) commands. AhciQueuedCommandTable is NULL when
+  // the HBA doesn't support NCQ. As the command list is shared by all ports,
+  // queued commands are only outstanding on one port at a time.
+  //
+  EFI_AHCI_QUEUED_COMMAND_TABLE *AhciQueuedCommandTable;
+  EFI_AHCI_QUEUED_COMMAND_TABLE *AhciQueuedCommandTablePciAddr;
+  UINT64                    MaxQueuedCommandTableSize;
+  VOID                      *MapQueuedCommandTable;
+  UINT32                    QueuedSlotMask;
+  UINT32                    QueuedActiveSlots;
+  UINT8                     QueuedPort;
+  UINT8                     QueuedPortMultiplier;
 } EFI_AHCI_REGISTERS;
 
 /**
@@ -338,6 +370,26 @@ AhciPacketCommandExecute (
   IN  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet
   );
 
+/**
+  Start the command list processing on specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The port start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The port start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartPort (
+  IN  EFI_PCI_IO_PROTOCOL       *PciIo,
+  IN  UINT8                     Port,
+  IN  UINT64                    Timeout
+  );
+
 /**
   Start command for give slot on specific port.
 
@@ -284,6 +284,12 @@ AtaPassThruPassThruExecute (
         //
         PortMultiplierPort = 0;
       }
+      //
+      // Queued commands are aborted by any other command, finish them first.
+      //
+      if ((Task == NULL) && (Protocol != EFI_ATA_PASS_THRU_PROTOCOL_FPDMA)) {
+        AhciFlushQueuedCommands (Instance);
+      }
       switch (Protocol) {
         case EFI_ATA_PASS_THRU_PROTOCOL_ATA_NON_DATA:
           Status = AhciNonDataTransfer (
@@ -367,6 +373,37 @@ AtaPassThruPassThruExecute (
                      Task
                      );
           break;
+        case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
+          if (Packet->InTransferLength != 0) {
+            Status = AhciFpdmaTransfer (
+                       Instance,
+                       &Instance->AhciRegisters,
+                       (UINT8)Port,
+                       (UINT8)PortMultiplierPort,
+                       TRUE,
+                       Packet->Acb,
+                       Packet->Asb,
+                       Packet->InDataBuffer,
+                       Packet->InTransferLength,
+                       Packet->Timeout,
+                       Task
+                       );
+          } else {
+            Status = AhciFpdmaTransfer (
+                       Instance,
+                       &Instance->AhciRegisters,
+                       (UINT8)Port,
+                       (UINT8)PortMultiplierPort,
+                       FALSE,
+                       Packet->Acb,
+                       Packet->Asb,
+                       Packet->OutDataBuffer,
+                       Packet->OutTransferLength,
+                       Packet->Timeout,
+                       Task
+                       );
+          }
+          break;
         default :
           return EFI_UNSUPPORTED;
       }
@@ -396,23 +433,28 @@ AsyncNonBlockingTransferRoutine (
   )
 {
   LIST_ENTRY                   *Entry;
+  LIST_ENTRY                   *NextEntry;
   LIST_ENTRY                   *EntryHeader;
   ATA_NONBLOCK_TASK            *Task;
   EFI_STATUS                   Status;
   ATA_ATAPI_PASS_THRU_INSTANCE *Instance;
+  BOOLEAN                      IsQueued;
 
   Instance   = (ATA_ATAPI_PASS_THRU_INSTANCE *) Context;
   EntryHeader = &Instance->NonBlockingTaskList;
   //
   // Get the Taks from the Taks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
-  //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
-      return;
+  // Queued (NCQ) tasks are outstanding together, so go on with the following
+  // tasks while they are busy. Any other task only starts when it is the first
+  // one in the list, and the following tasks wait for it.
+  //
+  Entry = GetFirstNode (EntryHeader);
+  while (!IsNull (EntryHeader, Entry)) {
+    Task     = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    IsQueued = (BOOLEAN) (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA);
+    if (!IsQueued && (Entry != GetFirstNode (EntryHeader))) {
+      break;
     }
 
     Status = AtaPassThruPassThruExecute (
@@ -437,11 +479,16 @@ AsyncNonBlockingTransferRoutine (
     // is not finished yet. Otherwise the operation is successful.
     //
     if (Status == EFI_NOT_READY) {
-      break;
+      if (!IsQueued) {
+        break;
+      }
+      Entry = GetNextNode (EntryHeader, Entry);
     } else {
+      NextEntry = GetNextNode (EntryHeader, Entry);
       RemoveEntryList (&Task->Link);
       gBS->SignalEvent (Task->Event);
       FreePool (Task);
+      Entry = NextEntry;
     }
   }
 }
@@ -917,6 +964,14 @@ AtaAtapiPassThruStop (
     gBS->CloseEvent (Instance->TimerEvent);
     Instance->TimerEvent = NULL;
   }
+  if ((Instance->Mode == EfiAtaAhciMode) && (Instance->AhciRegisters.QueuedActiveSlots != 0)) {
+    AhciAbortQueuedCommands (
+      Instance,
+      &Instance->AhciRegisters,
+      Instance->AhciRegisters.QueuedPort,
+      ATA_ATAPI_TIMEOUT
+      );
+  }
   DestroyAsynTaskList (Instance, FALSE);
   //
   // Free allocated resource
@@ -941,6 +996,17 @@ AtaAtapiPassThruStop (
   //
   if (Instance->Mode == EfiAtaAhciMode) {
     AhciRegisters = &Instance->AhciRegisters;
+    if (AhciRegisters->AhciQueuedCommandTable != NULL) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapQueuedCommandTable
+               );
+      PciIo->FreeBuffer (
+               PciIo,
+               EFI_SIZE_TO_PAGES ((UINTN) AhciRegisters->MaxQueuedCommandTableSize),
+               AhciRegisters->AhciQueuedCommandTable
+               );
+    }
     PciIo->Unmap (
              PciIo,
              AhciRegisters->MapCommandTable
@@ -1293,6 +1359,14 @@ AtaPassThruPassThru (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Queued (NCQ) commands are only supported by an AHCI HBA with NCQ capability.
+  //
+  if ((Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) &&
+      ((Instance->Mode != EfiAtaAhciMode) || (Instance->AhciRegisters.AhciQueuedCommandTable == NULL))) {
+    return EFI_UNSUPPORTED;
+  }
+
   Node = SearchDeviceInfoList (Instance, Port, PortMultiplierPort, EfiIdeHarddisk);
 
   if (Node == NULL) {
@@ -2088,6 +2162,7 @@ ExtScsiPassThruPassThru (
         //
         PortMultiplier = 0;
       }
+      AhciFlushQueuedCommands (Instance);
       Status = AhciPacketCommandExecute (Instance->PciIo, &Instance->AhciRegisters, Port, PortMultiplier, Packet);
       break;
     default :
@@ -138,6 +138,8 @@ struct _ATA_NONBLOCK_TASK {
   VOID                              *TableMap;       // Pointer to PRD table map.
   EFI_ATA_DMA_PRD                   *MapBaseAddress; //  Pointer to range Base address for Map.
   UINTN                             PageCount;       //  The page numbers used by PCIO freebuffer.
+  UINT8                             Slot;            //  The command slot used by queued (NCQ) command.
+  BOOLEAN                           IsAborted;       //  The queued (NCQ) command is aborted by an error.
 };
 
 //
@@ -1149,6 +1151,94 @@ AhciDmaTransfer (
   IN     ATA_NONBLOCK_TASK            *Task
   );
 
+/**
+  Start a queued (NCQ) DMA data transfer on specific port.
+
+  Up to the number of command slots of the HBA or the queue depth of the device,
+  whichever is lower, queued commands are outstanding at the same time. The tag of the command is the command slot allocated for it,
+  and the command completes when the device clears its bit of PxSACT through a
+  Set Device Bits FIS.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The port multiplier port number.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The DMA data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     The HBA doesn't support queued commands.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer can't be described by a queued command.
+  @retval EFI_ABORTED         The command was aborted by an error of another queued
+                              command (non-blocking mode only).
+  @retval EFI_NOT_READY       The command is not finished yet, or no command slot
+                              is available to start it (non-blocking mode only).
+  @retval EFI_SUCCESS         The DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciFpdmaTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS           *AhciRegisters,
+  IN     UINT8                        Port,
+  IN     UINT8                        PortMultiplier,
+  IN     BOOLEAN                      Read,
+  IN     EFI_ATA_COMMAND_BLOCK        *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK         *AtaStatusBlock,
+  IN OUT VOID                         *MemoryAddr,
+  IN     UINT32                       DataCount,
+  IN     UINT64                       Timeout,
+  IN     ATA_NONBLOCK_TASK            *Task
+  );
+
+/**
+  Abort all queued commands outstanding on the port after an error.
+
+  The port is stopped, which clears PxSACT and PxCI, and the received FIS of
+  the port is cleared so that a stale Set Device Bits FIS isn't taken for a
+  completion. The data buffers of all the started queued tasks are unmapped
+  and the tasks are marked aborted, they are left in the non-blocking task
+  list for the caller to complete with EFI_ABORTED.
+
+  @param[in]  Instance         The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  AhciRegisters    The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port             The number of port.
+  @param[in]  Timeout          The timeout value of stop, uses 100ns as a unit.
+
+**/
+VOID
+EFIAPI
+AhciAbortQueuedCommands (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN  EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN  UINT8                         Port,
+  IN  UINT64                        Timeout
+  );
+
+/**
+  Complete all outstanding queued commands.
+
+  A non-queued command makes the device abort the queued commands, and all ports
+  share one command list. So the queued commands must be finished before any other
+  command is issued to the HBA.
+
+  @param[in]  Instance         The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+
+**/
+VOID
+EFIAPI
+AhciFlushQueuedCommands (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
 /**
   Start a PIO data transfer on specific port.
 
@@ -115,6 +115,10 @@ typedef struct {
 
   BOOLEAN                               UdmaValid;
   BOOLEAN                               Lba48Bit;
+  //
+  // Non-blocking transfers use READ/WRITE FPDMA QUEUED when it is TRUE.
+  //
+  BOOLEAN                               NcqValid;
 
   //
   // Cached data for ATA identify data
@@ -138,6 +138,8 @@ UsbHcFreeMemBlock (
 
   @param  Block          The memory block to allocate memory from.
   @param  Units          Number of memory units to allocate.
+  @param  AllocationForRing  The allocated memory is for a ring segment, which
+                             must not cross a 64KB boundary.
 
   @return The pointer to the allocated memory. If couldn't allocate the needed memory,
           the return value is NULL.
@@ -146,7 +148,8 @@ UsbHcFreeMemBlock (
 VOID *
 UsbHcAllocMemFromBlock (
   IN  USBHC_MEM_BLOCK     *Block,
-  IN  UINTN               Units
+  IN  UINTN               Units,
+  IN  BOOLEAN             AllocationForRing
   )
 {
   UINTN                   Byte;
@@ -171,6 +174,18 @@ UsbHcAllocMemFromBlock (
     if (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit)) {
       Available++;
 
+      //
+      // A ring segment must not cross a 64KB boundary. The unit size divides
+      // 64KB, so a run crosses one only when this unit starts on it; restart
+      // the run from this unit in that case.
+      //
+      if (AllocationForRing && (Available > 1) &&
+          ((((UINTN) Block->Buf + (Byte * 8 + Bit) * USBHC_MEM_UNIT) & (SIZE_64KB - 1)) == 0)) {
+        Available  = 1;
+        StartByte  = Byte;
+        StartBit   = Bit;
+      }
+
       if (Available >= Units) {
         break;
       }
@@ -450,6 +465,8 @@ UsbHcFreeMemPool (
 
   @param  Pool           The host controller's memory pool.
   @param  Size           Size of the memory to allocate.
+  @param  AllocationForRing  The allocated memory is for a ring segment, which
+                             must not cross a 64KB boundary.
 
   @return The allocated memory or NULL.
 
@@ -457,7 +474,8 @@ UsbHcFreeMemPool (
 VOID *
 UsbHcAllocateMem (
   IN  USBHC_MEM_POOL      *Pool,
-  IN  UINTN               Size
+  IN  UINTN               Size,
+  IN  BOOLEAN             AllocationForRing
   )
 {
   USBHC_MEM_BLOCK         *Head;
@@ -476,7 +494,7 @@ UsbHcAllocateMem (
   // First check whether current memory blocks can satisfy the allocation.
   //
   for (Block = Head; Block != NULL; Block = Block->Next) {
-    Mem = UsbHcAllocMemFromBlock (Block, AllocSize / USBHC_MEM_UNIT);
+    Mem = UsbHcAllocMemFromBlock (Block, AllocSize / USBHC_MEM_UNIT, AllocationForRing);
 
     if (Mem != NULL) {
       ZeroMem (Mem, Size);
@@ -492,7 +510,9 @@ UsbHcAllocateMem (
   // Create a new memory block if there is not enough memory
   // in the pool. If the allocation size is larger than the
   // default page number, just allocate a large enough memory
-  // block. Otherwise allocate default pages.
+  // block. Otherwise allocate default pages. A ring segment
+  // needs twice its size so that the block is guaranteed to
+  // hold it without crossing a 64KB boundary.
   //
   if (AllocSize > EFI_PAGES_TO_SIZE (USBHC_MEM_DEFAULT_PAGES)) {
     Pages = EFI_SIZE_TO_PAGES (AllocSize) + 1;
@@ -500,6 +520,10 @@ UsbHcAllocateMem (
     Pages = USBHC_MEM_DEFAULT_PAGES;
   }
 
+  if (AllocationForRing && (Pages < 2 * EFI_SIZE_TO_PAGES (AllocSize))) {
+    Pages = 2 * EFI_SIZE_TO_PAGES (AllocSize);
+  }
+
   NewBlock = UsbHcAllocMemBlock (Pool, Pages);
 
   if (NewBlock == NULL) {
@@ -511,7 +535,7 @@ UsbHcAllocateMem (
   // Add the new memory block to the pool, then allocate memory from it
   //
   UsbHcInsertMemBlockToPool (Head, NewBlock);
-  Mem = UsbHcAllocMemFromBlock (NewBlock, AllocSize / USBHC_MEM_UNIT);
+  Mem = UsbHcAllocMemFromBlock (NewBlock, AllocSize / USBHC_MEM_UNIT, AllocationForRing);
 
   if (Mem != NULL) {
     ZeroMem (Mem, Size);
@@ -98,6 +98,8 @@ UsbHcFreeMemPool (
 
   @param  Pool  The host controller's memory pool.
   @param  Size  Size of the memory to allocate.
+  @param  AllocationForRing  The allocated memory is for a ring segment, which
+                             must not cross a 64KB boundary.
 
   @return The allocated memory or NULL.
 
@@ -105,7 +107,8 @@ UsbHcFreeMemPool (
 VOID *
 UsbHcAllocateMem (
   IN  USBHC_MEM_POOL      *Pool,
-  IN  UINTN               Size
+  IN  UINTN               Size,
+  IN  BOOLEAN             AllocationForRing
   );
 
 
@@ -1767,6 +1767,16 @@ XhcCreateUsbHc (
   Xhc->OriginalPciAttributes = OriginalPciAttributes;
   CopyMem (&Xhc->Usb2Hc, &gXhciUsb2HcTemplate, sizeof (EFI_USB2_HC_PROTOCOL));
 
+  //
+  // Get the ring sizes, keep them in the range the controller can handle.
+  //
+  Xhc->TrRingTrbNumber    = PcdGet32 (PcdXhciTransferRingTrbNumber);
+  Xhc->TrRingTrbNumber    = MAX (Xhc->TrRingTrbNumber, XHC_MIN_RING_TRB_NUMBER);
+  Xhc->TrRingTrbNumber    = MIN (Xhc->TrRingTrbNumber, XHC_MAX_RING_TRB_NUMBER);
+  Xhc->EventRingTrbNumber = PcdGet32 (PcdXhciEventRingTrbNumber);
+  Xhc->EventRingTrbNumber = MAX (Xhc->EventRingTrbNumber, XHC_MIN_RING_TRB_NUMBER);
+  Xhc->EventRingTrbNumber = MIN (Xhc->EventRingTrbNumber, XHC_MAX_RING_TRB_NUMBER);
+
   Status = PciIo->Pci.Read (
                         PciIo,
                         EfiPciIoWidthUint8,
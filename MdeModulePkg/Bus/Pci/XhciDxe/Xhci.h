@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 #include <IndustryStandard/Pci.h>
 
@@ -72,9 +73,17 @@ typedef struct _USB_DEV_CONTEXT      USB_DEV_CONTEXT;
 #define XHC_TPL                      TPL_NOTIFY
 
 #define CMD_RING_TRB_NUMBER          0x100
-#define TR_RING_TRB_NUMBER           0x100
 #define ERST_NUMBER                  0x01
-#define EVENT_RING_TRB_NUMBER        0x200
+
+//
+// The transfer ring and event ring sizes come from PcdXhciTransferRingTrbNumber
+// and PcdXhciEventRingTrbNumber. A ring segment must not cross a 64KB boundary
+// (UsbHcAllocateMem places ring segments accordingly), and the event ring
+// segment size field is limited to 4096 TRBs, so the PCD values are clamped to
+// this range.
+//
+#define XHC_MIN_RING_TRB_NUMBER      0x10
+#define XHC_MAX_RING_TRB_NUMBER      0x1000
 
 #define CMD_INTER                    0
 #define CTRL_INTER                   1
@@ -239,6 +248,11 @@ struct _USB_XHCI_INSTANCE {
   UINT32                    MaxSlotsEn;
   URB                       *PendingUrb;
   //
+  // Number of TRBs in each transfer ring and in the event ring.
+  //
+  UINT32                    TrRingTrbNumber;
+  UINT32                    EventRingTrbNumber;
+  //
   // Cmd Transfer Ring
   //
   TRANSFER_RING             CmdRing;
@@ -25,12 +25,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _USB_MASS_TRANSPORT USB_MASS_TRANSPORT;
 typedef struct _USB_MASS_DEVICE    USB_MASS_DEVICE;
 
 #include "UsbMassBot.h"
 #include "UsbMassCbi.h"
+#include "UsbMassUas.h"
 #include "UsbMassBoot.h"
 #include "UsbMassDiskInfo.h"
 #include "UsbMassImpl.h"
@@ -153,7 +155,7 @@ EFI_STATUS
 ///
 /// This structure contains information necessary to select the
 /// proper transport protocol. The mass storage class defines
-/// two transport protocols. One is the CBI, and the other is BOT.
+/// three transport protocols: CBI, BOT and UAS.
 /// CBI is being obseleted. The design is made modular by this
 /// structure so that the CBI protocol can be easily removed when
 /// it is no longer necessary.
@@ -165,6 +167,7 @@ struct _USB_MASS_TRANSPORT {
   USB_MASS_RESET          Reset;       ///< Reset the device
   USB_MASS_GET_MAX_LUN    GetMaxLun;   ///< Get max lun, only for bot
   USB_MASS_CLEAN_UP       CleanUp;     ///< Clean up the resources.
+  UINT32                  MaxCarrySize; ///< Max data carried by one read/write command
 };
 
 struct _USB_MASS_DEVICE {
@@ -18,7 +18,8 @@ USB_MASS_TRANSPORT mUsbBotTransport = {
   UsbBotExecCommand,
   UsbBotResetDevice,
   UsbBotGetMaxLun,
-  UsbBotCleanUp
+  UsbBotCleanUp,
+  USB_BOOT_MAX_CARRY_SIZE
 };
 
 /**
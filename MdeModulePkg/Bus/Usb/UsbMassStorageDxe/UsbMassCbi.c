@@ -20,7 +20,8 @@ USB_MASS_TRANSPORT mUsbCbi0Transport = {
   UsbCbiExecCommand,
   UsbCbiResetDevice,
   NULL,
-  UsbCbiCleanUp
+  UsbCbiCleanUp,
+  USB_BOOT_MAX_CARRY_SIZE
 };
 
 //
@@ -32,7 +33,8 @@ USB_MASS_TRANSPORT mUsbCbi1Transport = {
   UsbCbiExecCommand,
   UsbCbiResetDevice,
   NULL,
-  UsbCbiCleanUp
+  UsbCbiCleanUp,
+  USB_BOOT_MAX_CARRY_SIZE
 };
 
 /**
@@ -8,7 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "UsbMass.h"
 
-#define USB_MASS_TRANSPORT_COUNT    3
+#define USB_MASS_TRANSPORT_COUNT    4
 //
 // Array of USB transport interfaces.
 //
@@ -16,6 +16,7 @@ USB_MASS_TRANSPORT *mUsbMassTransport[USB_MASS_TRANSPORT_COUNT] = {
   &mUsbCbi0Transport,
   &mUsbCbi1Transport,
   &mUsbBotTransport,
+  &mUsbUasTransport,
 };
 
 EFI_DRIVER_BINDING_PROTOCOL gUSBMassDriverBinding = {
@@ -415,6 +416,21 @@ UsbMassInitTransport (
     goto ON_EXIT;
   }
 
+  //
+  // A UAS device usually also exposes BOT in the default alternate setting
+  // of the same interface. BOT stays the default. When the platform opts
+  // in to UAS, the UAS setting is used if the device answers a command on
+  // it, otherwise the interface is left in BOT.
+  //
+  if (FeaturePcdGet (PcdUsbMassStorageUas) &&
+      (Interface.InterfaceProtocol == USB_MASS_STORE_BOT)) {
+    *Transport = &mUsbUasTransport;
+    Status     = (*Transport)->Init (UsbIo, Context);
+    if (!EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
   Status = EFI_UNSUPPORTED;
 
   //
@@ -0,0 +1,843 @@
+/** @file
+  Implementation of the USB Attached SCSI (UAS) transport protocol,
+  according to USB Mass Storage Class - USB Attached SCSI Protocol, Revision 1.0.
+
+  Bulk streams are out of scope: the USB I/O Protocol has no stream support,
+  so only the non-stream (high speed) mode is implemented, and a setting
+  with SuperSpeed endpoint companions is never used. Each command runs the
+  command, ready, data and sense IU sequence on its own before the next one
+  is issued, so only one command is in flight at any time.
+
+  The driver only switches a BOT interface to UAS when PcdUsbMassStorageUas
+  is TRUE, and only keeps it in UAS if the device answers an INQUIRY there.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbMass.h"
+
+//
+// Definition of USB UAS Transport Protocol
+//
+USB_MASS_TRANSPORT mUsbUasTransport = {
+  USB_MASS_STORE_UAS,
+  UsbUasInit,
+  UsbUasExecCommand,
+  UsbUasResetDevice,
+  UsbUasGetMaxLun,
+  UsbUasCleanUp,
+  USB_UAS_MAX_CARRY_SIZE
+};
+
+/**
+  Select an alternate setting of the interface with the standard
+  SET_INTERFACE request. USB bus driver updates the endpoints returned
+  by the USB I/O Protocol once the request succeeds.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  InterfaceNumber       The interface to select the setting for
+  @param  Setting               The alternate setting to select
+
+  @retval EFI_SUCCESS           The alternate setting is selected.
+  @retval Others                Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+UsbUasSelectSetting (
+  IN EFI_USB_IO_PROTOCOL      *UsbIo,
+  IN UINT8                    InterfaceNumber,
+  IN UINT8                    Setting
+  )
+{
+  EFI_USB_DEVICE_REQUEST      Request;
+  UINT32                      Result;
+  UINT32                      Timeout;
+
+  Request.RequestType = USB_DEV_SET_INTERFACE_REQ_TYPE;
+  Request.Request     = USB_DEV_SET_INTERFACE;
+  Request.Value       = Setting;
+  Request.Index       = InterfaceNumber;
+  Request.Length      = 0;
+  Timeout             = USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  return UsbIo->UsbControlTransfer (
+                  UsbIo,
+                  &Request,
+                  EfiUsbNoData,
+                  Timeout,
+                  NULL,
+                  0,
+                  &Result
+                  );
+}
+
+/**
+  Read the whole active configuration descriptor from the device.
+
+  USB I/O Protocol only returns the configuration descriptor header, while
+  UAS identifies its pipes with class specific Pipe Usage descriptors that
+  follow each endpoint descriptor.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+
+  @return The configuration descriptor with all its sub descriptors,
+          or NULL if it can't be read. The caller frees the buffer.
+
+**/
+UINT8 *
+UsbUasGetConfigDescriptor (
+  IN EFI_USB_IO_PROTOCOL      *UsbIo
+  )
+{
+  EFI_USB_DEVICE_DESCRIPTOR   DevDesc;
+  EFI_USB_CONFIG_DESCRIPTOR   CfgDesc;
+  EFI_USB_DEVICE_REQUEST      Request;
+  EFI_STATUS                  Status;
+  UINT8                       *Buffer;
+  UINT8                       Index;
+  UINT32                      Result;
+  UINT32                      Timeout;
+
+  Status = UsbIo->UsbGetDeviceDescriptor (UsbIo, &DevDesc);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Status = UsbIo->UsbGetConfigDescriptor (UsbIo, &CfgDesc);
+  if (EFI_ERROR (Status) || (CfgDesc.TotalLength < sizeof (EFI_USB_CONFIG_DESCRIPTOR))) {
+    return NULL;
+  }
+
+  Buffer = AllocateZeroPool (CfgDesc.TotalLength);
+  if (Buffer == NULL) {
+    return NULL;
+  }
+
+  //
+  // GET_DESCRIPTOR takes the configuration index rather than its value,
+  // so look for the index of the active configuration.
+  //
+  Timeout = USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  for (Index = 0; Index < DevDesc.NumConfigurations; Index++) {
+    Request.RequestType = USB_DEV_GET_DESCRIPTOR_REQ_TYPE;
+    Request.Request     = USB_DEV_GET_DESCRIPTOR;
+    Request.Value       = (UINT16) ((USB_DESC_TYPE_CONFIG << 8) | Index);
+    Request.Index       = 0;
+    Request.Length      = CfgDesc.TotalLength;
+
+    Status = UsbIo->UsbControlTransfer (
+                      UsbIo,
+                      &Request,
+                      EfiUsbDataIn,
+                      Timeout,
+                      Buffer,
+                      CfgDesc.TotalLength,
+                      &Result
+                      );
+    if (!EFI_ERROR (Status) &&
+        (((EFI_USB_CONFIG_DESCRIPTOR *) Buffer)->ConfigurationValue == CfgDesc.ConfigurationValue)) {
+      return Buffer;
+    }
+  }
+
+  FreePool (Buffer);
+  return NULL;
+}
+
+/**
+  Find the UAS alternate setting of the interface and its four pipes.
+
+  @param  UsbUas                The USB UAS device
+  @param  InterfaceNumber       The interface to search
+  @param  Setting               Return the UAS alternate setting
+
+  @retval EFI_SUCCESS           A usable UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no usable UAS alternate setting.
+
+**/
+EFI_STATUS
+UsbUasFindSetting (
+  IN  USB_UAS_PROTOCOL        *UsbUas,
+  IN  UINT8                   InterfaceNumber,
+  OUT UINT8                   *Setting
+  )
+{
+  EFI_USB_CONFIG_DESCRIPTOR     *CfgDesc;
+  EFI_USB_INTERFACE_DESCRIPTOR  *IfDesc;
+  EFI_USB_ENDPOINT_DESCRIPTOR   *EpDesc;
+  UINT8                         *Buffer;
+  UINT8                         *Desc;
+  UINTN                         Offset;
+  UINT8                         Endpoint;
+  BOOLEAN                       InSetting;
+  BOOLEAN                       Found;
+
+  Buffer = UsbUasGetConfigDescriptor (UsbUas->UsbIo);
+  if (Buffer == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  CfgDesc   = (EFI_USB_CONFIG_DESCRIPTOR *) Buffer;
+  Offset    = 0;
+  Endpoint  = 0;
+  InSetting = FALSE;
+  Found     = FALSE;
+
+  while ((Offset + 2 <= CfgDesc->TotalLength) && !Found) {
+    Desc = Buffer + Offset;
+    if ((Desc[0] < 2) || (Offset + Desc[0] > CfgDesc->TotalLength)) {
+      break;
+    }
+    Offset += Desc[0];
+
+    switch (Desc[1]) {
+    case USB_DESC_TYPE_INTERFACE:
+      IfDesc    = (EFI_USB_INTERFACE_DESCRIPTOR *) Desc;
+      InSetting = (BOOLEAN) ((IfDesc->InterfaceNumber == InterfaceNumber) &&
+                             (IfDesc->InterfaceClass == USB_MASS_STORE_CLASS) &&
+                             (IfDesc->InterfaceSubClass == USB_MASS_STORE_SCSI) &&
+                             (IfDesc->InterfaceProtocol == USB_MASS_STORE_UAS));
+      if (InSetting) {
+        *Setting             = IfDesc->AlternateSetting;
+        UsbUas->CommandPipe  = 0;
+        UsbUas->StatusPipe   = 0;
+        UsbUas->DataInPipe   = 0;
+        UsbUas->DataOutPipe  = 0;
+      }
+      Endpoint = 0;
+      break;
+
+    case USB_DESC_TYPE_ENDPOINT:
+      EpDesc   = (EFI_USB_ENDPOINT_DESCRIPTOR *) Desc;
+      Endpoint = USB_IS_BULK_ENDPOINT (EpDesc->Attributes) ? EpDesc->EndpointAddress : 0;
+      break;
+
+    case USB_UAS_DESC_TYPE_SS_COMPANION:
+      //
+      // The device runs at SuperSpeed, where UAS requires bulk streams.
+      //
+      if (InSetting) {
+        DEBUG ((EFI_D_INFO, "UsbUasFindSetting: setting %d needs bulk streams\n", *Setting));
+        InSetting = FALSE;
+      }
+      break;
+
+    case USB_UAS_DESC_TYPE_PIPE_USAGE:
+      if (!InSetting || (Endpoint == 0) || (Desc[0] < 3)) {
+        break;
+      }
+
+      switch (Desc[2]) {
+      case USB_UAS_PIPE_COMMAND:
+        UsbUas->CommandPipe = USB_IS_OUT_ENDPOINT (Endpoint) ? Endpoint : 0;
+        break;
+      case USB_UAS_PIPE_STATUS:
+        UsbUas->StatusPipe  = USB_IS_IN_ENDPOINT (Endpoint) ? Endpoint : 0;
+        break;
+      case USB_UAS_PIPE_DATA_IN:
+        UsbUas->DataInPipe  = USB_IS_IN_ENDPOINT (Endpoint) ? Endpoint : 0;
+        break;
+      case USB_UAS_PIPE_DATA_OUT:
+        UsbUas->DataOutPipe = USB_IS_OUT_ENDPOINT (Endpoint) ? Endpoint : 0;
+        break;
+      }
+
+      Found = (BOOLEAN) ((UsbUas->CommandPipe != 0) && (UsbUas->StatusPipe != 0) &&
+                         (UsbUas->DataInPipe != 0) && (UsbUas->DataOutPipe != 0));
+      break;
+    }
+  }
+
+  FreePool (Buffer);
+  return Found ? EFI_SUCCESS : EFI_UNSUPPORTED;
+}
+
+/**
+  Check that the device answers a command in the UAS setting, by
+  reading its standard INQUIRY data.
+
+  @param  UsbUas                The USB UAS protocol instance
+
+  @retval EFI_SUCCESS           The device completed the INQUIRY command.
+  @retval EFI_DEVICE_ERROR      The device failed the INQUIRY command.
+  @retval Others                The command couldn't be transferred.
+
+**/
+EFI_STATUS
+UsbUasProbe (
+  IN USB_UAS_PROTOCOL         *UsbUas
+  )
+{
+  USB_BOOT_INQUIRY_CMD        InquiryCmd;
+  USB_BOOT_INQUIRY_DATA       InquiryData;
+  UINT32                      CmdResult;
+  EFI_STATUS                  Status;
+
+  ZeroMem (&InquiryCmd, sizeof (USB_BOOT_INQUIRY_CMD));
+  InquiryCmd.OpCode   = USB_BOOT_INQUIRY_OPCODE;
+  InquiryCmd.AllocLen = (UINT8) sizeof (USB_BOOT_INQUIRY_DATA);
+
+  Status = UsbUasExecCommand (
+             UsbUas,
+             &InquiryCmd,
+             (UINT8) sizeof (USB_BOOT_INQUIRY_CMD),
+             EfiUsbDataIn,
+             &InquiryData,
+             (UINT32) sizeof (USB_BOOT_INQUIRY_DATA),
+             0,
+             USB_BOOT_GENERAL_CMD_TIMEOUT,
+             &CmdResult
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return (CmdResult == USB_MASS_CMD_SUCCESS) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+/**
+  Initializes USB UAS protocol.
+
+  This function initializes the USB mass storage class UAS protocol.
+  If the interface exposes a UAS alternate setting, it is selected when
+  Context isn't NULL, and the context which is a USB_UAS_PROTOCOL
+  structure is saved in the Context.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The transport protocol doesn't support the device.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL       *UsbIo,
+  OUT VOID                      **Context OPTIONAL
+  )
+{
+  USB_UAS_PROTOCOL              *UsbUas;
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  EFI_STATUS                    Status;
+  UINT8                         Setting;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &Interface);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Interface.InterfaceClass != USB_MASS_STORE_CLASS) {
+    return EFI_UNSUPPORTED;
+  }
+
+  UsbUas = AllocateZeroPool (sizeof (USB_UAS_PROTOCOL));
+  ASSERT (UsbUas != NULL);
+
+  UsbUas->UsbIo          = UsbIo;
+  UsbUas->DefaultSetting = Interface.AlternateSetting;
+
+  Status = UsbUasFindSetting (UsbUas, Interface.InterfaceNumber, &Setting);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Context == NULL) {
+    FreePool (UsbUas);
+    return EFI_SUCCESS;
+  }
+
+  //
+  // A UAS device usually exposes BOT in alternate setting 0 and UAS
+  // in alternate setting 1, switch to the UAS one.
+  //
+  if (Setting != Interface.AlternateSetting) {
+    Status = UsbUasSelectSetting (UsbIo, Interface.InterfaceNumber, Setting);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "UsbUasInit: failed to select setting %d (%r)\n", Setting, Status));
+      goto ON_ERROR;
+    }
+  }
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &UsbUas->Interface);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  ASSERT (UsbUas->Interface.InterfaceProtocol == USB_MASS_STORE_UAS);
+
+  //
+  // The USB UAS protocol uses Tag to match the command and its IUs.
+  //
+  UsbUas->Tag = 0x01;
+
+  //
+  // Only give up the BOT setting if the device really works in UAS,
+  // otherwise switch the interface back for BOT to use it.
+  //
+  if (Setting != Interface.AlternateSetting) {
+    Status = UsbUasProbe (UsbUas);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "UsbUasInit: UAS setting %d doesn't work (%r)\n", Setting, Status));
+      UsbUasSelectSetting (UsbIo, Interface.InterfaceNumber, Interface.AlternateSetting);
+      goto ON_ERROR;
+    }
+  }
+
+  *Context = UsbUas;
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  FreePool (UsbUas);
+  return Status;
+}
+
+/**
+  Allocate the tag for a new command or task management function.
+
+  @param  UsbUas                The USB UAS device
+
+  @return The tag to use.
+
+**/
+UINT16
+UsbUasNextTag (
+  IN USB_UAS_PROTOCOL         *UsbUas
+  )
+{
+  UINT16                      Tag;
+
+  Tag = UsbUas->Tag;
+  UsbUas->Tag = (UINT16) ((Tag >= USB_UAS_MAX_TAG) ? 1 : (Tag + 1));
+  return Tag;
+}
+
+/**
+  Send an IU to the device on the command pipe.
+
+  @param  UsbUas                The USB UAS device
+  @param  Iu                    The IU to send
+  @param  IuLen                 The length of the IU
+
+  @retval EFI_SUCCESS           The IU is sent to the device.
+  @retval EFI_NOT_READY         The device return NAK to the transfer
+  @retval Others                Failed to send the IU to device
+
+**/
+EFI_STATUS
+UsbUasSendIu (
+  IN USB_UAS_PROTOCOL         *UsbUas,
+  IN VOID                     *Iu,
+  IN UINTN                    IuLen
+  )
+{
+  EFI_STATUS                  Status;
+  UINT32                      Result;
+  UINTN                       Timeout;
+
+  Result  = 0;
+  Timeout = USB_UAS_SEND_IU_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            UsbUas->CommandPipe,
+                            Iu,
+                            &IuLen,
+                            Timeout,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->CommandPipe);
+    } else if (USB_IS_ERROR (Result, EFI_USB_ERR_NAK)) {
+      Status = EFI_NOT_READY;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Receive an IU for the tag from the device on the status pipe.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The tag the IU is expected for
+  @param  Timeout               The time to wait the IU, in microseconds
+  @param  Iu                    The buffer to hold the IU
+
+  @retval EFI_SUCCESS           An IU for the tag is received.
+  @retval Others                Failed to receive the IU.
+
+**/
+EFI_STATUS
+UsbUasGetStatus (
+  IN  USB_UAS_PROTOCOL        *UsbUas,
+  IN  UINT16                  Tag,
+  IN  UINT32                  Timeout,
+  OUT USB_UAS_STATUS_IU       *Iu
+  )
+{
+  EFI_STATUS                  Status;
+  UINT32                      Result;
+  UINTN                       Len;
+
+  ZeroMem (Iu, sizeof (USB_UAS_STATUS_IU));
+  Result = 0;
+  Len    = sizeof (USB_UAS_STATUS_IU);
+
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            UsbUas->StatusPipe,
+                            Iu,
+                            &Len,
+                            Timeout / USB_MASS_1_MILLISECOND,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->StatusPipe);
+    }
+    return Status;
+  }
+
+  if ((Len < sizeof (USB_UAS_IU_HEADER)) || (SwapBytes16 (Iu->Header.Tag) != Tag)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasGetStatus: unexpected IU 0x%x for tag 0x%x\n", Iu->Header.IuId, Tag));
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Transfer the data between the device and host on the data pipes.
+
+  @param  UsbUas                The USB UAS device
+  @param  DataDir               The direction of the data
+  @param  Data                  The buffer to hold data
+  @param  TransLen              The expected length of the data
+  @param  Timeout               The time to wait the command to complete
+
+  @retval EFI_SUCCESS           The data is transferred
+  @retval EFI_NOT_READY         The device return NAK to the transfer
+  @retval Others                Failed to transfer data
+
+**/
+EFI_STATUS
+UsbUasDataTransfer (
+  IN USB_UAS_PROTOCOL         *UsbUas,
+  IN EFI_USB_DATA_DIRECTION   DataDir,
+  IN OUT UINT8                *Data,
+  IN OUT UINTN                *TransLen,
+  IN UINT32                   Timeout
+  )
+{
+  EFI_STATUS                  Status;
+  UINT32                      Result;
+  UINT8                       Endpoint;
+
+  Endpoint = (DataDir == EfiUsbDataIn) ? UsbUas->DataInPipe : UsbUas->DataOutPipe;
+  Result   = 0;
+
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            Endpoint,
+                            Data,
+                            TransLen,
+                            Timeout / USB_MASS_1_MILLISECOND,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      DEBUG ((EFI_D_INFO, "UsbUasDataTransfer: Data Stall\n"));
+      UsbClearEndpointStall (UsbUas->UsbIo, Endpoint);
+    } else if (USB_IS_ERROR (Result, EFI_USB_ERR_NAK)) {
+      Status = EFI_NOT_READY;
+    } else {
+      DEBUG ((EFI_D_ERROR, "UsbUasDataTransfer: (%r)\n", Status));
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Call the USB Mass Storage Class UAS protocol to issue the
+  command/ready/data/sense sequence to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  )
+{
+  USB_UAS_PROTOCOL            *UsbUas;
+  USB_UAS_COMMAND_IU          CmdIu;
+  USB_UAS_STATUS_IU           StatusIu;
+  EFI_STATUS                  Status;
+  EFI_STATUS                  DataStatus;
+  UINTN                       TransLen;
+  UINT16                      Tag;
+  UINT8                       ReadyIu;
+
+  ASSERT ((CmdLen > 0) && (CmdLen <= USB_UAS_MAX_CMDLEN));
+
+  *CmdStatus = USB_MASS_CMD_FAIL;
+  UsbUas     = (USB_UAS_PROTOCOL *) Context;
+
+  //
+  // The sense data of a failed command has already arrived in its
+  // Sense IU, and the device may have discarded it since.
+  //
+  if ((*(UINT8 *) Cmd == USB_BOOT_REQUEST_SENSE_OPCODE) && UsbUas->SenseValid) {
+    ZeroMem (Data, DataLen);
+    CopyMem (Data, UsbUas->SenseData, MIN (DataLen, UsbUas->SenseLen));
+    UsbUas->SenseValid = FALSE;
+    *CmdStatus         = USB_MASS_CMD_SUCCESS;
+    return EFI_SUCCESS;
+  }
+
+  UsbUas->SenseValid = FALSE;
+
+  //
+  // Fill in the Command IU, then send it on the command pipe.
+  //
+  Tag = UsbUasNextTag (UsbUas);
+
+  ZeroMem (&CmdIu, sizeof (USB_UAS_COMMAND_IU));
+  CmdIu.Header.IuId = USB_UAS_IU_COMMAND;
+  CmdIu.Header.Tag  = SwapBytes16 (Tag);
+  CmdIu.Lun[1]      = Lun;
+  CopyMem (CmdIu.Cdb, Cmd, CmdLen);
+
+  Status = UsbUasSendIu (UsbUas, &CmdIu, sizeof (USB_UAS_COMMAND_IU));
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: UsbUasSendIu (%r)\n", Status));
+    return Status;
+  }
+
+  if ((DataDir == EfiUsbNoData) || (DataLen == 0)) {
+    ReadyIu = 0;
+  } else {
+    ReadyIu = (UINT8) ((DataDir == EfiUsbDataIn) ? USB_UAS_IU_READ_READY : USB_UAS_IU_WRITE_READY);
+  }
+
+  //
+  // The device answers with a Read/Write Ready IU once it is ready to move
+  // the data, or with the Sense IU straight away if the command failed.
+  //
+  DataStatus = EFI_SUCCESS;
+  TransLen   = 0;
+  Status     = UsbUasGetStatus (UsbUas, Tag, Timeout, &StatusIu);
+  if (!EFI_ERROR (Status) && (ReadyIu != 0) && (StatusIu.Header.IuId == ReadyIu)) {
+    //
+    // Don't return immediately even data transfer failed. The device
+    // still reports the command status in the Sense IU.
+    //
+    TransLen   = (UINTN) DataLen;
+    DataStatus = UsbUasDataTransfer (UsbUas, DataDir, Data, &TransLen, Timeout);
+
+    Status = UsbUasGetStatus (UsbUas, Tag, USB_UAS_RECV_IU_TIMEOUT, &StatusIu);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: UsbUasGetStatus (%r)\n", Status));
+    return Status;
+  }
+
+  if (StatusIu.Header.IuId != USB_UAS_IU_SENSE) {
+    //
+    // A Response IU means the device rejected the Command IU itself.
+    //
+    DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: IU 0x%x instead of Sense IU\n", StatusIu.Header.IuId));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (StatusIu.Sense.Status == USB_UAS_STATUS_GOOD) {
+    //
+    // A failed or short data phase must not pass for a complete transfer,
+    // the command has no way to report the residue to its caller.
+    //
+    if ((ReadyIu != 0) && (EFI_ERROR (DataStatus) || (TransLen < DataLen))) {
+      DEBUG ((
+        EFI_D_ERROR,
+        "UsbUasExecCommand: Data phase (%r) transferred %d of %d bytes\n",
+        DataStatus,
+        TransLen,
+        DataLen
+        ));
+      return EFI_DEVICE_ERROR;
+    }
+    *CmdStatus = USB_MASS_CMD_SUCCESS;
+  } else if (StatusIu.Sense.Length != 0) {
+    UsbUas->SenseLen   = (UINT8) MIN (SwapBytes16 (StatusIu.Sense.Length), USB_UAS_MAX_SENSE_LEN);
+    UsbUas->SenseValid = TRUE;
+    CopyMem (UsbUas->SenseData, StatusIu.Sense.SenseData, UsbUas->SenseLen);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue a LOGICAL UNIT RESET task management function.
+                                If TRUE, reset parent hub port instead.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID                    *Context,
+  IN  BOOLEAN                 ExtendedVerification
+  )
+{
+  USB_UAS_PROTOCOL            *UsbUas;
+  USB_UAS_TASK_MANAGEMENT_IU  TaskIu;
+  USB_UAS_STATUS_IU           StatusIu;
+  EFI_STATUS                  Status;
+  UINT16                      Tag;
+
+  UsbUas             = (USB_UAS_PROTOCOL *) Context;
+  UsbUas->SenseValid = FALSE;
+
+  if (ExtendedVerification) {
+    //
+    // If we need to do strictly reset, reset its parent hub port. The port
+    // reset puts the interface back to alternate setting 0, so select the
+    // UAS setting again.
+    //
+    Status = UsbUas->UsbIo->UsbPortReset (UsbUas->UsbIo);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Status = UsbUasSelectSetting (
+               UsbUas->UsbIo,
+               UsbUas->Interface.InterfaceNumber,
+               UsbUas->Interface.AlternateSetting
+               );
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Clear any stall left on the pipes, then abort all tasks of the
+  // logical unit with the LOGICAL UNIT RESET task management function.
+  //
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->CommandPipe);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->StatusPipe);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataInPipe);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataOutPipe);
+
+  Tag = UsbUasNextTag (UsbUas);
+
+  ZeroMem (&TaskIu, sizeof (USB_UAS_TASK_MANAGEMENT_IU));
+  TaskIu.Header.IuId = USB_UAS_IU_TASK_MANAGEMENT;
+  TaskIu.Header.Tag  = SwapBytes16 (Tag);
+  TaskIu.Function    = USB_UAS_TM_LOGICAL_UNIT_RESET;
+
+  Status = UsbUasSendIu (UsbUas, &TaskIu, sizeof (USB_UAS_TASK_MANAGEMENT_IU));
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = UsbUasGetStatus (UsbUas, Tag, USB_UAS_RESET_DEVICE_TIMEOUT, &StatusIu);
+  if (EFI_ERROR (Status) ||
+      (StatusIu.Header.IuId != USB_UAS_IU_RESPONSE) ||
+      ((StatusIu.Response.ResponseCode != USB_UAS_TM_COMPLETE) &&
+       (StatusIu.Response.ResponseCode != USB_UAS_TM_SUCCEEDED))) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+
+  UAS has no class request to report the LUN count, so only LUN 0 is used.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN.
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID                    *Context,
+  OUT UINT8                   *MaxLun
+  )
+{
+  if (Context == NULL || MaxLun == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *MaxLun = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  The interface is switched back to the alternate setting it had before
+  UAS was initialized, so that a later start finds it unchanged.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID                    *Context
+  )
+{
+  USB_UAS_PROTOCOL            *UsbUas;
+
+  UsbUas = (USB_UAS_PROTOCOL *) Context;
+
+  if (UsbUas->Interface.AlternateSetting != UsbUas->DefaultSetting) {
+    UsbUasSelectSetting (
+      UsbUas->UsbIo,
+      UsbUas->Interface.InterfaceNumber,
+      UsbUas->DefaultSetting
+      );
+  }
+
+  FreePool (UsbUas);
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,261 @@
+/** @file
+  Definition for the USB Attached SCSI (UAS) transport protocol,
+  based on "Universal Serial Bus Mass Storage Class - USB Attached SCSI
+  Protocol (UASP)" Revision 1.0, June 24, 2009.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _EFI_USBMASS_UAS_H_
+#define _EFI_USBMASS_UAS_H_
+
+extern USB_MASS_TRANSPORT mUsbUasTransport;
+
+#define USB_MASS_STORE_UAS            0x62 ///< USB Attached SCSI
+
+//
+// Class specific descriptors used by UAS
+//
+#define USB_UAS_DESC_TYPE_PIPE_USAGE   0x24 ///< Pipe Usage descriptor, follows each endpoint
+#define USB_UAS_DESC_TYPE_SS_COMPANION 0x30 ///< SuperSpeed endpoint companion descriptor
+
+//
+// Pipe IDs carried by the Pipe Usage descriptor
+//
+#define USB_UAS_PIPE_COMMAND          0x01
+#define USB_UAS_PIPE_STATUS           0x02
+#define USB_UAS_PIPE_DATA_IN          0x03
+#define USB_UAS_PIPE_DATA_OUT         0x04
+
+//
+// Information Unit IDs
+//
+#define USB_UAS_IU_COMMAND            0x01
+#define USB_UAS_IU_SENSE              0x03
+#define USB_UAS_IU_RESPONSE           0x04
+#define USB_UAS_IU_TASK_MANAGEMENT    0x05
+#define USB_UAS_IU_READ_READY         0x06
+#define USB_UAS_IU_WRITE_READY        0x07
+
+//
+// Task management functions and response codes
+//
+#define USB_UAS_TM_LOGICAL_UNIT_RESET 0x08
+#define USB_UAS_TM_COMPLETE           0x00
+#define USB_UAS_TM_SUCCEEDED          0x08
+
+//
+// SCSI status in the Sense IU
+//
+#define USB_UAS_STATUS_GOOD           0x00
+
+#define USB_UAS_MAX_CMDLEN            16   ///< CDB length without additional CDB bytes
+#define USB_UAS_MAX_SENSE_LEN         252  ///< Max sense data length in a Sense IU
+#define USB_UAS_MAX_TAG               0xFFFE
+
+//
+// Max data carried by one READ/WRITE command. Unlike BOT, a UAS device
+// tells the host when it is ready for data, so larger transfers don't
+// have to be split to keep the device from timing out.
+//
+#define USB_UAS_MAX_CARRY_SIZE        SIZE_256KB
+
+//
+// Usb UAS transport timeout, set by experience
+//
+#define USB_UAS_SEND_IU_TIMEOUT       (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RECV_IU_TIMEOUT       (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
+
+#pragma pack(1)
+///
+/// Header shared by all Information Units.
+///
+typedef struct {
+  UINT8               IuId;
+  UINT8               Reserved;
+  UINT16              Tag;      ///< Big endian
+} USB_UAS_IU_HEADER;
+
+///
+/// Command IU, sent on the command pipe.
+///
+typedef struct {
+  USB_UAS_IU_HEADER   Header;
+  UINT8               Attribute; ///< Bits 0~2: task attribute, 0 ~ simple
+  UINT8               Reserved;
+  UINT8               AddCdbLen; ///< Bits 2~7: additional CDB length in dwords
+  UINT8               Reserved2;
+  UINT8               Lun[8];
+  UINT8               Cdb[USB_UAS_MAX_CMDLEN];
+} USB_UAS_COMMAND_IU;
+
+///
+/// Task Management IU, sent on the command pipe.
+///
+typedef struct {
+  USB_UAS_IU_HEADER   Header;
+  UINT8               Function;
+  UINT8               Reserved;
+  UINT16              ManagedTag;
+  UINT8               Lun[8];
+} USB_UAS_TASK_MANAGEMENT_IU;
+
+///
+/// Sense IU, received on the status pipe when a command completes.
+///
+typedef struct {
+  USB_UAS_IU_HEADER   Header;
+  UINT16              StatusQualifier;
+  UINT8               Status;   ///< SCSI status
+  UINT8               Reserved[7];
+  UINT16              Length;   ///< Big endian length of SenseData
+  UINT8               SenseData[USB_UAS_MAX_SENSE_LEN];
+} USB_UAS_SENSE_IU;
+
+///
+/// Response IU, received on the status pipe for task management
+/// functions and rejected commands.
+///
+typedef struct {
+  USB_UAS_IU_HEADER   Header;
+  UINT8               ResponseInfo[3];
+  UINT8               ResponseCode;
+} USB_UAS_RESPONSE_IU;
+
+///
+/// Any IU that may arrive on the status pipe.
+///
+typedef union {
+  USB_UAS_IU_HEADER   Header;
+  USB_UAS_SENSE_IU    Sense;
+  USB_UAS_RESPONSE_IU Response;
+} USB_UAS_STATUS_IU;
+#pragma pack()
+
+typedef struct {
+  //
+  // Put Interface at the first field to make it easy to distinguish BOT/CBI/UAS Protocol instance
+  //
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  EFI_USB_IO_PROTOCOL           *UsbIo;
+  UINT8                         CommandPipe;
+  UINT8                         StatusPipe;
+  UINT8                         DataInPipe;
+  UINT8                         DataOutPipe;
+  UINT8                         DefaultSetting; ///< Alternate setting to restore on clean up
+  UINT16                        Tag;
+  //
+  // UAS returns sense data along with the failed command, so keep it
+  // to answer the REQUEST SENSE issued by the boot layer.
+  //
+  BOOLEAN                       SenseValid;
+  UINT8                         SenseLen;
+  UINT8                         SenseData[USB_UAS_MAX_SENSE_LEN];
+} USB_UAS_PROTOCOL;
+
+/**
+  Initializes USB UAS protocol.
+
+  This function initializes the USB mass storage class UAS protocol.
+  If the interface exposes a UAS alternate setting, it is selected when
+  Context isn't NULL, and the context which is a USB_UAS_PROTOCOL
+  structure is saved in the Context.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The transport protocol doesn't support the device.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL       *UsbIo,
+  OUT VOID                      **Context OPTIONAL
+  );
+
+/**
+  Call the USB Mass Storage Class UAS protocol to issue the
+  command/ready/data/sense sequence to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  );
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue a LOGICAL UNIT RESET task management function.
+                                If TRUE, reset parent hub port instead.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID                    *Context,
+  IN  BOOLEAN                 ExtendedVerification
+  );
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+
+  UAS has no class request to report the LUN count, so only LUN 0 is used.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN.
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID                    *Context,
+  OUT UINT8                   *MaxLun
+  );
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID                    *Context
+  );
+
+#endif
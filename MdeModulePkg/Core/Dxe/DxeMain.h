@@ -47,6 +47,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
+#include <Protocol/DriverBindingPrerequisites.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
@@ -1151,6 +1152,17 @@ CoreConnectHandlesByKey (
   );
 
 
+/**
+  Report how many driver binding Supported() calls ConnectController() made,
+  and how many were avoided by the prerequisites and the cache of failures.
+
+**/
+VOID
+CoreReportDriverSupportedStatistics (
+  VOID
+  );
+
+
 
 /**
   Connects one or more drivers to a controller.
@@ -741,6 +741,8 @@ CoreExitBootServices (
 {
   EFI_STATUS                Status;
 
+  CoreReportDriverSupportedStatistics ();
+
   //
   // Disable Timer
   //
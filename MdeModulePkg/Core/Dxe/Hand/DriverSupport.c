@@ -9,6 +9,328 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "DxeMain.h"
 #include "Handle.h"
 
+//
+// Number of protocols a failed Supported() may look up and still be cached.
+//
+#define DRIVER_SUPPORTED_MAX_PROTOCOLS  4
+
+///
+/// A protocol looked up by Supported(), and how many times an interface of
+/// it had been installed at that time.
+///
+typedef struct {
+  PROTOCOL_ENTRY                *ProtEntry;
+  UINTN                         InstallCount;
+} DRIVER_SUPPORTED_PROTOCOL;
+
+///
+/// A failed Supported() of a driver binding on a controller. The result stays
+/// valid as long as the controller's handle database key and the cache
+/// generation don't change, and no interface of the protocols Supported()
+/// looked up, on the controller or on any other handle, is installed.
+///
+typedef struct {
+  EFI_DRIVER_BINDING_PROTOCOL   *DriverBinding;
+  EFI_HANDLE                    ControllerHandle;
+  UINT64                        Key;
+  UINTN                         Generation;
+  UINTN                         ProtocolCount;
+  DRIVER_SUPPORTED_PROTOCOL     Protocols[DRIVER_SUPPORTED_MAX_PROTOCOLS];
+} DRIVER_SUPPORTED_CACHE_ENTRY;
+
+DRIVER_SUPPORTED_CACHE_ENTRY  *mDriverSupportedCache = NULL;
+
+//
+// Start from 1 so that a zeroed cache entry never matches.
+//
+UINTN                         mDriverSupportedCacheGeneration = 1;
+
+//
+// The driver whose Supported() is running. The protocols it closes are
+// the ones it has just opened for the test, so they don't invalidate the cache.
+//
+EFI_HANDLE                    mDriverSupportedAgent = NULL;
+
+//
+// The protocols looked up by the Supported() running. A count above
+// DRIVER_SUPPORTED_MAX_PROTOCOLS means its result can't be cached.
+//
+DRIVER_SUPPORTED_PROTOCOL     mDriverSupportedProtocols[DRIVER_SUPPORTED_MAX_PROTOCOLS];
+UINTN                         mDriverSupportedProtocolCount = 0;
+
+UINT64                        mDriverSupportedCalled  = 0;
+UINT64                        mDriverSupportedAvoided = 0;
+
+/**
+  Get the cache slot of a driver binding and controller pair.
+
+  The cache is allocated the first time it is used.
+
+  @param  DriverBinding         The driver binding protocol instance.
+  @param  ControllerHandle      The handle of the controller.
+
+  @return The cache slot, or NULL if the cache is disabled or can't be allocated.
+
+**/
+DRIVER_SUPPORTED_CACHE_ENTRY *
+CoreGetDriverSupportedCacheEntry (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding,
+  IN EFI_HANDLE                   ControllerHandle
+  )
+{
+  UINT32                          CacheSize;
+  UINTN                           Index;
+
+  CacheSize = PcdGet32 (PcdDriverSupportedCacheSize);
+  if (CacheSize == 0) {
+    return NULL;
+  }
+
+  if (mDriverSupportedCache == NULL) {
+    mDriverSupportedCache = AllocateZeroPool (CacheSize * sizeof (DRIVER_SUPPORTED_CACHE_ENTRY));
+    if (mDriverSupportedCache == NULL) {
+      return NULL;
+    }
+  }
+
+  //
+  // Both are pool allocations, so the low bits of the addresses are always 0.
+  //
+  Index = ((((UINTN) DriverBinding) >> 3) * 31 + (((UINTN) ControllerHandle) >> 3)) % CacheSize;
+  return &mDriverSupportedCache[Index];
+}
+
+/**
+  Check whether Supported() of a driver binding is known to fail on a controller.
+
+  @param  DriverBinding         The driver binding protocol instance.
+  @param  ControllerHandle      The handle of the controller.
+
+  @retval TRUE                  Supported() failed on the controller and nothing
+                                that could change the result has happened since.
+  @retval FALSE                 Supported() has to be called.
+
+**/
+BOOLEAN
+CoreIsDriverSupportedCached (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding,
+  IN EFI_HANDLE                   ControllerHandle
+  )
+{
+  DRIVER_SUPPORTED_CACHE_ENTRY    *Entry;
+  UINTN                           Index;
+
+  Entry = CoreGetDriverSupportedCacheEntry (DriverBinding, ControllerHandle);
+  if ((Entry == NULL) ||
+      (Entry->DriverBinding != DriverBinding) ||
+      (Entry->ControllerHandle != ControllerHandle) ||
+      (Entry->Key != ((IHANDLE *) ControllerHandle)->Key) ||
+      (Entry->Generation != mDriverSupportedCacheGeneration)) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < Entry->ProtocolCount; Index++) {
+    if (Entry->Protocols[Index].ProtEntry->InstallCount != Entry->Protocols[Index].InstallCount) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Record a protocol looked up by the driver binding Supported() running, so
+  that its failure is only cached until an interface of the protocol is
+  installed. The gProtocolDatabaseLock must be owned.
+
+  @param  Protocol              The GUID of the protocol, or NULL if all the
+                                protocols of a handle were looked up.
+
+**/
+VOID
+CoreRecordDriverSupportedProtocol (
+  IN EFI_GUID                     *Protocol OPTIONAL
+  )
+{
+  PROTOCOL_ENTRY                  *ProtEntry;
+  UINTN                           Index;
+
+  if ((mDriverSupportedAgent == NULL) ||
+      (mDriverSupportedProtocolCount > DRIVER_SUPPORTED_MAX_PROTOCOLS)) {
+    return;
+  }
+
+  //
+  // The entry of a protocol that was never installed is created here, so that
+  // its first install is seen too.
+  //
+  ProtEntry = NULL;
+  if (Protocol != NULL) {
+    ProtEntry = CoreFindProtocolEntry (Protocol, TRUE);
+  }
+
+  if ((ProtEntry == NULL) || (mDriverSupportedProtocolCount == DRIVER_SUPPORTED_MAX_PROTOCOLS)) {
+    mDriverSupportedProtocolCount = DRIVER_SUPPORTED_MAX_PROTOCOLS + 1;
+    return;
+  }
+
+  for (Index = 0; Index < mDriverSupportedProtocolCount; Index++) {
+    if (mDriverSupportedProtocols[Index].ProtEntry == ProtEntry) {
+      return;
+    }
+  }
+
+  mDriverSupportedProtocols[Index].ProtEntry    = ProtEntry;
+  mDriverSupportedProtocols[Index].InstallCount = ProtEntry->InstallCount;
+  mDriverSupportedProtocolCount++;
+}
+
+/**
+  Remember that Supported() of a driver binding failed on a controller, with
+  the protocols it looked up.
+
+  @param  DriverBinding         The driver binding protocol instance.
+  @param  ControllerHandle      The handle of the controller.
+
+**/
+VOID
+CoreCacheDriverSupportedFailure (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding,
+  IN EFI_HANDLE                   ControllerHandle
+  )
+{
+  DRIVER_SUPPORTED_CACHE_ENTRY    *Entry;
+
+  if (mDriverSupportedProtocolCount > DRIVER_SUPPORTED_MAX_PROTOCOLS) {
+    return;
+  }
+
+  Entry = CoreGetDriverSupportedCacheEntry (DriverBinding, ControllerHandle);
+  if (Entry != NULL) {
+    Entry->DriverBinding    = DriverBinding;
+    Entry->ControllerHandle = ControllerHandle;
+    Entry->Key              = ((IHANDLE *) ControllerHandle)->Key;
+    Entry->Generation       = mDriverSupportedCacheGeneration;
+    Entry->ProtocolCount    = mDriverSupportedProtocolCount;
+    CopyMem (Entry->Protocols, mDriverSupportedProtocols, mDriverSupportedProtocolCount * sizeof (DRIVER_SUPPORTED_PROTOCOL));
+  }
+}
+
+/**
+  Drop all the cached Supported() failures.
+
+  It's called when a driver binding is removed, and when an agent closes a
+  protocol it opened BY_DRIVER or EXCLUSIVE, which may let another driver
+  manage the controller.
+
+  @param  AgentHandle           The agent that closed the protocol, or NULL.
+                                The closes done by the driver whose Supported()
+                                is running are ignored.
+
+**/
+VOID
+CoreInvalidateDriverSupportedCache (
+  IN EFI_HANDLE                   AgentHandle OPTIONAL
+  )
+{
+  if ((AgentHandle != NULL) && (AgentHandle == mDriverSupportedAgent)) {
+    return;
+  }
+
+  mDriverSupportedCacheGeneration++;
+}
+
+/**
+  Find a protocol interface on a handle, without validating the handle.
+  The gProtocolDatabaseLock must be owned.
+
+  @param  Handle                The handle to search.
+  @param  Protocol              The GUID of the protocol.
+
+  @return The protocol interface, or NULL if it isn't installed on Handle.
+
+**/
+PROTOCOL_INTERFACE *
+CoreFindHandleProtocol (
+  IN IHANDLE                      *Handle,
+  IN EFI_GUID                     *Protocol
+  )
+{
+  LIST_ENTRY                      *Link;
+  PROTOCOL_INTERFACE              *Prot;
+
+  for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (CompareGuid (&Prot->Protocol->ProtocolID, Protocol)) {
+      return Prot;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Check the protocols that a driver binding declares through
+  EDKII_DRIVER_BINDING_PREREQUISITES_PROTOCOL against a controller.
+
+  @param  DriverBinding         The driver binding protocol instance.
+  @param  ControllerHandle      The handle of the controller.
+
+  @retval TRUE                  The controller has all the prerequisite protocols,
+                                or the driver binding declares none.
+  @retval FALSE                 A prerequisite protocol is missing.
+
+**/
+BOOLEAN
+CoreDriverBindingPrerequisitesMet (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding,
+  IN EFI_HANDLE                   ControllerHandle
+  )
+{
+  PROTOCOL_INTERFACE                          *Prot;
+  EDKII_DRIVER_BINDING_PREREQUISITES_PROTOCOL *Prerequisites;
+  UINTN                                       Index;
+  BOOLEAN                                     Met;
+
+  Met = TRUE;
+
+  CoreAcquireProtocolLock ();
+  Prot = CoreFindHandleProtocol (
+           (IHANDLE *) DriverBinding->DriverBindingHandle,
+           &gEdkiiDriverBindingPrerequisitesProtocolGuid
+           );
+  if (Prot != NULL) {
+    Prerequisites = (EDKII_DRIVER_BINDING_PREREQUISITES_PROTOCOL *) Prot->Interface;
+    for (Index = 0; Index < Prerequisites->ProtocolCount; Index++) {
+      if (CoreFindHandleProtocol ((IHANDLE *) ControllerHandle, Prerequisites->Protocols[Index]) == NULL) {
+        Met = FALSE;
+        break;
+      }
+    }
+  }
+  CoreReleaseProtocolLock ();
+
+  return Met;
+}
+
+/**
+  Report how many driver binding Supported() calls ConnectController() made,
+  and how many were avoided by the prerequisites and the cache of failures.
+
+**/
+VOID
+CoreReportDriverSupportedStatistics (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "ConnectController: %ld Supported() calls, %ld avoided\n",
+    mDriverSupportedCalled,
+    mDriverSupportedAvoided
+    ));
+}
+
 
 //
 // Driver Support Functions
@@ -402,6 +724,7 @@ CoreConnectSingleController (
   UINTN                                      SortIndex;
   BOOLEAN                                    OneStarted;
   BOOLEAN                                    DriverFound;
+  EFI_HANDLE                                 SupportedAgent;
 
   //
   // Initialize local variables
@@ -621,6 +944,22 @@ CoreConnectSingleController (
     for (Index = 0; (Index < NumberOfSortedDriverBindingProtocols) && !DriverFound; Index++) {
       if (SortedDriverBindingProtocols[Index] != NULL) {
         DriverBinding = SortedDriverBindingProtocols[Index];
+
+        //
+        // Skip the drivers that can't manage the controller for sure. A failure is
+        // only cached for the controller itself, not for a child specified by
+        // RemainingDevicePath.
+        //
+        if (!CoreDriverBindingPrerequisitesMet (DriverBinding, ControllerHandle) ||
+            ((RemainingDevicePath == NULL) && CoreIsDriverSupportedCached (DriverBinding, ControllerHandle))) {
+          mDriverSupportedAvoided++;
+          continue;
+        }
+
+        mDriverSupportedCalled++;
+        SupportedAgent                = mDriverSupportedAgent;
+        mDriverSupportedAgent         = DriverBinding->DriverBindingHandle;
+        mDriverSupportedProtocolCount = 0;
         PERF_DRIVER_BINDING_SUPPORT_BEGIN (DriverBinding->DriverBindingHandle, ControllerHandle);
         Status = DriverBinding->Supported(
                                   DriverBinding,
@@ -628,6 +967,18 @@ CoreConnectSingleController (
                                   RemainingDevicePath
                                   );
         PERF_DRIVER_BINDING_SUPPORT_END (DriverBinding->DriverBindingHandle, ControllerHandle);
+        mDriverSupportedAgent = SupportedAgent;
+        if (EFI_ERROR (Status) && (RemainingDevicePath == NULL)) {
+          CoreCacheDriverSupportedFailure (DriverBinding, ControllerHandle);
+        }
+
+        //
+        // A Supported() calling ConnectController() lost the protocols it
+        // looked up before, its failure can't be cached.
+        //
+        if (SupportedAgent != NULL) {
+          mDriverSupportedProtocolCount = DRIVER_SUPPORTED_MAX_PROTOCOLS + 1;
+        }
         if (!EFI_ERROR (Status)) {
           SortedDriverBindingProtocols[Index] = NULL;
           DriverFound = TRUE;
@@ -142,6 +142,7 @@ CoreFindProtocolEntry (
       CopyGuid ((VOID *)&ProtEntry->ProtocolID, Protocol);
       InitializeListHead (&ProtEntry->Protocols);
       InitializeListHead (&ProtEntry->Notify);
+      ProtEntry->InstallCount = 0;
 
       //
       // Add it to protocol database
@@ -466,6 +467,14 @@ CoreInstallProtocolInterfaceNotify (
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
 
+  //
+  // The cached Supported() failures that looked the protocol up, on this
+  // handle or on any other, are no longer valid. The key of an existing
+  // handle is left unchanged, as ConnectController() uses it to find the
+  // handles created by Start().
+  //
+  ProtEntry->InstallCount++;
+
   //
   // Notify the notification list for this protocol
   //
@@ -770,6 +779,14 @@ CoreUninstallProtocolInterface (
     gHandleDatabaseKey++;
     Handle->Key = gHandleDatabaseKey;
 
+    //
+    // Supported() failures cached for the driver binding must not be matched
+    // by another one allocated at the same address.
+    //
+    if (CompareGuid (Protocol, &gEfiDriverBindingProtocolGuid)) {
+      CoreInvalidateDriverSupportedCache (NULL);
+    }
+
     //
     // Remove the protocol interface from the handle
     //
@@ -1056,6 +1073,7 @@ CoreOpenProtocol (
   // Lock the protocol database
   //
   CoreAcquireProtocolLock ();
+  CoreRecordDriverSupportedProtocol (Protocol);
 
   //
   // Look at each protocol interface for a match
@@ -1281,6 +1299,9 @@ CoreCloseProtocol (
     OpenData = CR (Link, OPEN_PROTOCOL_DATA, Link, OPEN_PROTOCOL_DATA_SIGNATURE);
     Link = Link->ForwardLink;
     if ((OpenData->AgentHandle == AgentHandle) && (OpenData->ControllerHandle == ControllerHandle)) {
+        if ((OpenData->Attributes & (EFI_OPEN_PROTOCOL_BY_DRIVER | EFI_OPEN_PROTOCOL_EXCLUSIVE)) != 0) {
+          CoreInvalidateDriverSupportedCache (AgentHandle);
+        }
         RemoveEntryList (&OpenData->Link);
         ProtocolInterface->OpenListCount--;
         CoreFreePool (OpenData);
@@ -1338,6 +1359,7 @@ CoreOpenProtocolInformation (
   // Lock the protocol database
   //
   CoreAcquireProtocolLock ();
+  CoreRecordDriverSupportedProtocol (Protocol);
 
   //
   // Look at each protocol interface for a match
@@ -1455,6 +1477,7 @@ CoreProtocolsPerHandle (
   ProtocolCount = 0;
 
   CoreAcquireProtocolLock ();
+  CoreRecordDriverSupportedProtocol (NULL);
 
   for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
     ProtocolCount++;
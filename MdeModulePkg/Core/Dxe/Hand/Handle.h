@@ -45,6 +45,8 @@ typedef struct {
   LIST_ENTRY          Protocols;
   /// Registerd notification handlers
   LIST_ENTRY          Notify;
+  /// Number of times an interface of the protocol was installed or reinstalled
+  UINTN               InstallCount;
 } PROTOCOL_ENTRY;
 
 
@@ -254,6 +256,37 @@ CoreValidateHandle (
   IN  EFI_HANDLE                UserHandle
   );
 
+/**
+  Record a protocol looked up by the driver binding Supported() running, so
+  that its failure is only cached until an interface of the protocol is
+  installed. The gProtocolDatabaseLock must be owned.
+
+  @param  Protocol              The GUID of the protocol, or NULL if all the
+                                protocols of a handle were looked up.
+
+**/
+VOID
+CoreRecordDriverSupportedProtocol (
+  IN EFI_GUID                   *Protocol OPTIONAL
+  );
+
+/**
+  Drop all the cached Supported() failures.
+
+  It's called when a driver binding is removed, and when an agent closes a
+  protocol it opened BY_DRIVER or EXCLUSIVE, which may let another driver
+  manage the controller.
+
+  @param  AgentHandle           The agent that closed the protocol, or NULL.
+                                The closes done by the driver whose Supported()
+                                is running are ignored.
+
+**/
+VOID
+CoreInvalidateDriverSupportedCache (
+  IN EFI_HANDLE                 AgentHandle OPTIONAL
+  );
+
 //
 // Externs
 //
@@ -173,6 +173,7 @@ CoreLocateHandle (
       Status = EFI_INVALID_PARAMETER;
       break;
     }
+    CoreRecordDriverSupportedProtocol (Protocol);
     //
     // Look up the protocol entry and set the head pointer
     //
@@ -579,6 +580,7 @@ CoreLocateProtocol (
   mEfiLocateHandleRequest += 1;
 
   if (Registration == NULL) {
+    CoreRecordDriverSupportedProtocol (Protocol);
     //
     // Look up the protocol entry and set the head pointer
     //
@@ -239,6 +239,14 @@ CoreReinstallProtocolInterface (
 
   ProtEntry = Prot->Protocol;
 
+  //
+  // Supported() failures cached for the old driver binding must not be
+  // matched by another one allocated at the same address.
+  //
+  if (CompareGuid (Protocol, &gEfiDriverBindingProtocolGuid)) {
+    CoreInvalidateDriverSupportedCache (NULL);
+  }
+
   //
   // Update the interface on the protocol
   //
@@ -249,6 +257,7 @@ CoreReinstallProtocolInterface (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  ProtEntry->InstallCount++;
 
   //
   // Update the Key to show that the handle has been created/modified
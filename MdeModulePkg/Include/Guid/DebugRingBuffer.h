@@ -0,0 +1,77 @@
+/** @file
+  Debug ring buffer GUID and structure.
+
+  The ring buffer DebugLib instances write the DEBUG() and ASSERT() messages to
+  a memory ring buffer, and send them to the serial port later, when the serial
+  port is ready or the firmware is idle. In PEI, the ring buffer is the data of
+  a GUIDed HOB named with this GUID. In DXE, the ring buffer holding the log of
+  both phases is installed in the EFI System Table as a configuration table
+  with the same GUID, so the OS can read the firmware log.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __DEBUG_RING_BUFFER_GUID_H__
+#define __DEBUG_RING_BUFFER_GUID_H__
+
+#define EDKII_DEBUG_RING_BUFFER_GUID \
+  { \
+    0x5b4825fe, 0xdf16, 0x42c6, { 0xbe, 0xd3, 0xd4, 0x1b, 0xa3, 0xa5, 0x05, 0xad } \
+  }
+
+#define EDKII_DEBUG_RING_BUFFER_SIGNATURE  SIGNATURE_32 ('D', 'R', 'N', 'G')
+
+///
+/// The messages are sent to the serial port as soon as they are written.
+///
+#define EDKII_DEBUG_RING_BUFFER_WRITE_THROUGH  BIT0
+
+///
+/// The offsets count the bytes written since the ring buffer was created. The
+/// byte at offset N is stored at byte (N % BufferSize) of the data, which
+/// follows the header. The log is made of the bytes from offset
+/// (CommitOffset - MIN (CommitOffset, BufferSize)) to CommitOffset.
+///
+typedef struct {
+  UINT32           Signature;
+  ///
+  /// The offset of the data from the start of the header.
+  ///
+  UINT32           HeaderSize;
+  ///
+  /// The size of the data in bytes.
+  ///
+  UINT32           BufferSize;
+  ///
+  /// EDKII_DEBUG_RING_BUFFER_xxx flags.
+  ///
+  volatile UINT32  Flags;
+  ///
+  /// The end of the space reserved by the writers.
+  ///
+  volatile UINT64  WriteOffset;
+  ///
+  /// The end of the messages completely written. It is at most WriteOffset.
+  ///
+  volatile UINT64  CommitOffset;
+  ///
+  /// The end of the messages sent to the serial port. It is at most
+  /// CommitOffset. The writers don't overwrite the bytes from DrainOffset on.
+  ///
+  volatile UINT64  DrainOffset;
+  ///
+  /// Non-zero while the messages are being sent to the serial port.
+  ///
+  volatile UINT32  DrainLock;
+  ///
+  /// Non-zero when a DXE module sends the messages to the serial port on
+  /// timer and idle events.
+  ///
+  volatile UINT32  DrainOwner;
+} EDKII_DEBUG_RING_BUFFER;
+
+extern EFI_GUID gEdkiiDebugRingBufferGuid;
+
+#endif
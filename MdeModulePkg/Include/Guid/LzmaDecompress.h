@@ -1,7 +1,7 @@
 /** @file
   Lzma Custom decompress algorithm Guid definition.
 
-Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2020, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -23,7 +23,33 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been split into chunks
+/// which are compressed independently using LZMA.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0x472E8DB9, 0x8AF7, 0x4E6B, { 0xA5, 0xC2, 0x6C, 0x16, 0x04, 0xD0, 0x92, 0xA5 } }
+
+#define LZMA_CHUNKED_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'C', 'K')
+
+///
+/// Header of the data in a LZMA chunked section. It is followed by
+/// ChunkCount + 1 UINT32 offsets of the chunks, relative to the start of
+/// the header. The last offset is the end of the last chunk. Each chunk
+/// is a complete LZMA stream, which decompresses to ChunkSize bytes, except
+/// for the last one which holds the remainder of UncompressedSize.
+///
+typedef struct {
+  UINT32  Signature;
+  UINT32  ChunkSize;
+  UINT32  ChunkCount;
+  UINT32  Reserved;
+  UINT64  UncompressedSize;
+} LZMA_CHUNKED_HEADER;
+
 extern GUID gLzmaCustomDecompressGuid;
 extern GUID gLzmaF86CustomDecompressGuid;
+extern GUID gLzmaChunkedCustomDecompressGuid;
 
 #endif
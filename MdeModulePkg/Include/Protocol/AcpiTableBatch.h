@@ -0,0 +1,75 @@
+/** @file
+  ACPI Table Batch protocol lets a caller install many ACPI tables through
+  EFI_ACPI_TABLE_PROTOCOL at the cost of publishing them once.
+
+  Every EFI_ACPI_TABLE_PROTOCOL.InstallAcpiTable() call normally updates the
+  RSDT/XSDT, checksums them and the RSDP again and reinstalls the RSDP in the
+  EFI System Table. Between BeginBatch() and CommitBatch(), the tables are
+  still copied and added to the RSDT/XSDT by each call, but the common tables
+  are only checksummed and published by CommitBatch(). The protocol is
+  installed on the same handle as EFI_ACPI_TABLE_PROTOCOL.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ACPI_TABLE_BATCH_H__
+#define __ACPI_TABLE_BATCH_H__
+
+#define EDKII_ACPI_TABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0x0ac5029e, 0xdd7b, 0x4ff3, { 0x82, 0x80, 0x08, 0x57, 0xbe, 0x1f, 0xd8, 0x0c } \
+  }
+
+typedef struct _EDKII_ACPI_TABLE_BATCH_PROTOCOL EDKII_ACPI_TABLE_BATCH_PROTOCOL;
+
+/**
+  Starts a batch of ACPI table installations.
+
+  Batches may be nested. The tables are published when the outermost batch is
+  committed.
+
+  @param  This                  A pointer to the EDKII_ACPI_TABLE_BATCH_PROTOCOL instance.
+  @param  TableCount            The number of tables the caller expects to
+                                install in the batch, used to reserve the
+                                RSDT/XSDT entries at once. 0 if unknown.
+
+  @retval EFI_SUCCESS           The batch is started.
+  @retval EFI_OUT_OF_RESOURCES  The RSDT/XSDT entries can't be reserved. The
+                                batch is not started.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_ACPI_TABLE_BEGIN_BATCH)(
+  IN EDKII_ACPI_TABLE_BATCH_PROTOCOL   *This,
+  IN UINTN                             TableCount
+  );
+
+/**
+  Ends a batch of ACPI table installations. When the outermost batch ends,
+  the RSDP, RSDT and XSDT are checksummed and the RSDP is installed in the
+  EFI System Table.
+
+  @param  This                  A pointer to the EDKII_ACPI_TABLE_BATCH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The batch is ended.
+  @retval EFI_NOT_STARTED       No batch is in progress.
+  @retval EFI_ABORTED           The tables can't be published.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_ACPI_TABLE_COMMIT_BATCH)(
+  IN EDKII_ACPI_TABLE_BATCH_PROTOCOL   *This
+  );
+
+struct _EDKII_ACPI_TABLE_BATCH_PROTOCOL {
+  EDKII_ACPI_TABLE_BEGIN_BATCH     BeginBatch;
+  EDKII_ACPI_TABLE_COMMIT_BATCH    CommitBatch;
+};
+
+extern EFI_GUID gEdkiiAcpiTableBatchProtocolGuid;
+
+#endif
@@ -0,0 +1,41 @@
+/** @file
+  Driver Binding Prerequisites protocol lets a UEFI driver declare the
+  protocols a controller must carry before its Supported() is worth calling.
+
+  The protocol is optionally installed on the same handle as
+  EFI_DRIVER_BINDING_PROTOCOL. ConnectController() skips the Supported()
+  service of the driver binding for any controller that doesn't have all the
+  listed protocols installed, so a driver which only manages PCI devices, for
+  example, is never asked about USB or network handles.
+
+  The list is only a filter. Supported() must still do its own checks on the
+  controllers that pass it.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __DRIVER_BINDING_PREREQUISITES_H__
+#define __DRIVER_BINDING_PREREQUISITES_H__
+
+#define EDKII_DRIVER_BINDING_PREREQUISITES_PROTOCOL_GUID \
+  { \
+    0xdf9994ea, 0xfeee, 0x4a3d, { 0x83, 0x28, 0x00, 0xc6, 0x43, 0x6c, 0xc5, 0x96 } \
+  }
+
+typedef struct {
+  ///
+  /// The number of entries in Protocols.
+  ///
+  UINTN                 ProtocolCount;
+  ///
+  /// The protocols that must all be installed on a controller handle for
+  /// the driver binding to support it.
+  ///
+  EFI_GUID              **Protocols;
+} EDKII_DRIVER_BINDING_PREREQUISITES_PROTOCOL;
+
+extern EFI_GUID gEdkiiDriverBindingPrerequisitesProtocolGuid;
+
+#endif
@@ -0,0 +1,109 @@
+/** @file
+  HII Config Access Block protocol lets the Form Browser exchange the settings
+  of a buffer varstore with its configuration driver as binary blocks.
+
+  EFI_HII_CONFIG_ACCESS_PROTOCOL carries the settings in <ConfigResp> strings,
+  so every byte of a buffer varstore is converted to hex text and parsed back
+  each time a form is loaded or saved. A driver may install this protocol on
+  the same handle as EFI_HII_CONFIG_ACCESS_PROTOCOL to let the browser read and
+  write (offset, width) blocks of the varstore directly. The browser falls back
+  to EFI_HII_CONFIG_ACCESS_PROTOCOL when a service returns an error.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HII_CONFIG_ACCESS_BLOCK_H__
+#define __HII_CONFIG_ACCESS_BLOCK_H__
+
+#define EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL_GUID \
+  { \
+    0xa8b5c6bb, 0xc557, 0x42c2, { 0xb3, 0x56, 0x8b, 0x65, 0x1b, 0x84, 0xe4, 0xb7 } \
+  }
+
+typedef struct _EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL;
+
+///
+/// A range of bytes in a buffer varstore.
+///
+typedef struct {
+  UINT16                                   Offset;
+  UINT16                                   Width;
+} EDKII_HII_CONFIG_BLOCK;
+
+/**
+  Reads blocks of a buffer varstore.
+
+  @param  This                  A pointer to the EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL instance.
+  @param  VarStoreGuid          The GUID of the varstore.
+  @param  VarStoreName          The name of the varstore.
+  @param  BlockCount            The number of entries in Blocks.
+  @param  Blocks                The blocks to read.
+  @param  Buffer                The image of the varstore. The bytes of each
+                                block are returned at the block offset, the
+                                other bytes are not touched.
+  @param  BufferSize            The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS           All the blocks are read.
+  @retval EFI_NOT_FOUND         The varstore isn't managed by this driver.
+  @retval EFI_INVALID_PARAMETER A block lies outside Buffer.
+  @retval EFI_UNSUPPORTED       The varstore can only be accessed through
+                                EFI_HII_CONFIG_ACCESS_PROTOCOL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_HII_CONFIG_ACCESS_EXTRACT_BLOCKS)(
+  IN     EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL  *This,
+  IN     CONST EFI_GUID                          *VarStoreGuid,
+  IN     CONST CHAR16                            *VarStoreName,
+  IN     UINTN                                   BlockCount,
+  IN     CONST EDKII_HII_CONFIG_BLOCK            *Blocks,
+  IN OUT UINT8                                   *Buffer,
+  IN     UINTN                                   BufferSize
+  );
+
+/**
+  Writes blocks of a buffer varstore.
+
+  The driver applies the blocks as EFI_HII_CONFIG_ACCESS_PROTOCOL.RouteConfig()
+  would apply a <ConfigResp> holding the same settings.
+
+  @param  This                  A pointer to the EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL instance.
+  @param  VarStoreGuid          The GUID of the varstore.
+  @param  VarStoreName          The name of the varstore.
+  @param  BlockCount            The number of entries in Blocks.
+  @param  Blocks                The blocks to write.
+  @param  Buffer                The image of the varstore holding the new
+                                settings at the block offsets.
+  @param  BufferSize            The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS           All the blocks are written.
+  @retval EFI_NOT_FOUND         The varstore isn't managed by this driver.
+  @retval EFI_INVALID_PARAMETER A block lies outside Buffer.
+  @retval EFI_UNSUPPORTED       The varstore can only be accessed through
+                                EFI_HII_CONFIG_ACCESS_PROTOCOL.
+  @retval Others                The settings can't be saved.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_HII_CONFIG_ACCESS_ROUTE_BLOCKS)(
+  IN     EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL  *This,
+  IN     CONST EFI_GUID                          *VarStoreGuid,
+  IN     CONST CHAR16                            *VarStoreName,
+  IN     UINTN                                   BlockCount,
+  IN     CONST EDKII_HII_CONFIG_BLOCK            *Blocks,
+  IN     CONST UINT8                             *Buffer,
+  IN     UINTN                                   BufferSize
+  );
+
+struct _EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL {
+  EDKII_HII_CONFIG_ACCESS_EXTRACT_BLOCKS   ExtractBlocks;
+  EDKII_HII_CONFIG_ACCESS_ROUTE_BLOCKS     RouteBlocks;
+};
+
+extern EFI_GUID gEdkiiHiiConfigAccessBlockProtocolGuid;
+
+#endif
@@ -0,0 +1,50 @@
+/** @file
+  SMBIOS Flush protocol lets a caller ask for the SMBIOS tables to be
+  published in the EFI System Table right away.
+
+  To avoid rebuilding the whole SMBIOS table for every record added, updated
+  or removed through EFI_SMBIOS_PROTOCOL, the SMBIOS driver may defer the
+  construction of the tables until the Ready To Boot event. A driver that
+  reads the SMBIOS tables from the EFI System Table before that point uses
+  this protocol to get them up to date. The protocol is installed on the same
+  handle as EFI_SMBIOS_PROTOCOL.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __SMBIOS_FLUSH_H__
+#define __SMBIOS_FLUSH_H__
+
+#define EDKII_SMBIOS_FLUSH_PROTOCOL_GUID \
+  { \
+    0x147ec84c, 0x71fe, 0x408f, { 0xbb, 0x80, 0x10, 0xe0, 0xe4, 0xbd, 0x06, 0x41 } \
+  }
+
+typedef struct _EDKII_SMBIOS_FLUSH_PROTOCOL EDKII_SMBIOS_FLUSH_PROTOCOL;
+
+/**
+  Builds the SMBIOS tables changed since they were last published and installs
+  them in the EFI System Table.
+
+  @param  This                  A pointer to the EDKII_SMBIOS_FLUSH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The SMBIOS tables in the EFI System Table are up to date.
+  @retval EFI_OUT_OF_RESOURCES  A table can't be built for lack of resources.
+  @retval EFI_ACCESS_DENIED     The SMBIOS records are being updated.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SMBIOS_FLUSH)(
+  IN EDKII_SMBIOS_FLUSH_PROTOCOL   *This
+  );
+
+struct _EDKII_SMBIOS_FLUSH_PROTOCOL {
+  EDKII_SMBIOS_FLUSH    Flush;
+};
+
+extern EFI_GUID gEdkiiSmbiosFlushProtocolGuid;
+
+#endif
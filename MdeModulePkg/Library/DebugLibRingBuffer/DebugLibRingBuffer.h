@@ -0,0 +1,125 @@
+/** @file
+  Internal definitions of the ring buffer DebugLib instances.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _DEBUG_LIB_RING_BUFFER_H_
+#define _DEBUG_LIB_RING_BUFFER_H_
+
+#include <PiPei.h>
+
+#include <Guid/DebugRingBuffer.h>
+
+#include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
+#include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/DebugPrintErrorLevelLib.h>
+
+//
+// Define the maximum debug and assert message length that this library supports
+//
+#define MAX_DEBUG_MESSAGE_LENGTH  0x100
+
+/**
+  Get the ring buffer of the current phase.
+
+  @return The ring buffer, or NULL if the messages are sent to the serial port
+          directly.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+GetDebugRingBuffer (
+  VOID
+  );
+
+/**
+  Initialize a ring buffer.
+
+  @param  RingBuffer      The ring buffer, followed by BufferSize bytes.
+  @param  BufferSize      The size of the data in bytes.
+
+**/
+VOID
+InitializeDebugRingBuffer (
+  OUT EDKII_DEBUG_RING_BUFFER  *RingBuffer,
+  IN  UINT32                   BufferSize
+  );
+
+/**
+  Find the ring buffer in a HOB list.
+
+  @param  HobList         The HOB list.
+
+  @return The ring buffer, or NULL if the HOB list doesn't have it.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+FindDebugRingBufferHob (
+  IN VOID                      *HobList
+  );
+
+/**
+  Write a message to a ring buffer.
+
+  If the ring buffer is full, the oldest messages are sent to the serial port
+  to make room for the new one.
+
+  @param  RingBuffer      The ring buffer.
+  @param  Buffer          The message.
+  @param  Length          The length of the message in bytes.
+
+  @retval TRUE            The message is written.
+  @retval FALSE           The message doesn't fit in the ring buffer, or the
+                          ring buffer is full while the serial port is being
+                          written by an interrupted caller.
+
+**/
+BOOLEAN
+DebugRingBufferWrite (
+  IN EDKII_DEBUG_RING_BUFFER   *RingBuffer,
+  IN CONST UINT8               *Buffer,
+  IN UINTN                     Length
+  );
+
+/**
+  Send the messages of a ring buffer to the serial port.
+
+  @param  RingBuffer      The ring buffer.
+  @param  Length          The maximum number of bytes to send, MAX_UINTN to
+                          send all the messages.
+
+  @retval TRUE            The messages are sent.
+  @retval FALSE           The serial port is being written by another caller.
+
+**/
+BOOLEAN
+DebugRingBufferDrain (
+  IN EDKII_DEBUG_RING_BUFFER   *RingBuffer,
+  IN UINTN                     Length
+  );
+
+/**
+  Copy the messages of a ring buffer to an empty one.
+
+  The messages not sent to the serial port yet are still to be sent from the
+  new ring buffer. If the new ring buffer is smaller, the oldest messages are
+  dropped.
+
+  @param  RingBuffer      The empty ring buffer.
+  @param  OldRingBuffer   The ring buffer to copy.
+
+**/
+VOID
+DebugRingBufferImport (
+  IN OUT EDKII_DEBUG_RING_BUFFER  *RingBuffer,
+  IN     EDKII_DEBUG_RING_BUFFER  *OldRingBuffer
+  );
+
+#endif
@@ -0,0 +1,418 @@
+/** @file
+  DXE part of the ring buffer Debug library instance.
+
+  The ring buffer is allocated by the constructor of the first module linked
+  with this library, which copies the messages of the PEI ring buffer HOB to
+  it and installs it as a configuration table. The other modules find it in
+  the configuration table.
+
+  The first module that finds the ring buffer with no drainer sends the
+  messages to the serial port from a timer event, when the serial port has
+  sent the previous ones, and from the idle loop event. All the messages are
+  sent at Ready To Boot, and from Exit Boot Services on, the messages are sent
+  as soon as they are written.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+
+#include "DebugLibRingBuffer.h"
+
+#include <Guid/EventGroup.h>
+#include <Guid/HobList.h>
+#include <Guid/IdleLoopEvent.h>
+
+//
+// The number of bytes sent to the serial port each time the DXE Core is idle.
+// About 45ms at 115200 baud, so a waiting event is not delayed too much.
+//
+#define IDLE_DRAIN_LENGTH  0x200
+
+//
+// The library can't use UefiBootServicesTableLib, as it depends on DebugLib
+// and has a constructor.
+//
+EFI_BOOT_SERVICES          *mDebugBootServices          = NULL;
+EDKII_DEBUG_RING_BUFFER    *mDebugRingBuffer            = NULL;
+
+//
+// Events of the module that drains the ring buffer.
+//
+EFI_EVENT                  mDrainTimerEvent            = NULL;
+EFI_EVENT                  mDrainIdleEvent             = NULL;
+EFI_EVENT                  mDrainReadyToBootEvent      = NULL;
+EFI_EVENT                  mDrainExitBootServicesEvent = NULL;
+
+/**
+  Get the ring buffer of the current phase.
+
+  @return The ring buffer, or NULL if the messages are sent to the serial port
+          directly.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+GetDebugRingBuffer (
+  VOID
+  )
+{
+  return mDebugRingBuffer;
+}
+
+/**
+  Find a configuration table.
+
+  UefiLib isn't used, as it depends on UefiBootServicesTableLib.
+
+  @param  SystemTable   A pointer to the EFI System Table.
+  @param  TableGuid     The GUID of the configuration table.
+
+  @return The configuration table, or NULL if it isn't installed.
+
+**/
+VOID *
+FindConfigurationTable (
+  IN EFI_SYSTEM_TABLE          *SystemTable,
+  IN EFI_GUID                  *TableGuid
+  )
+{
+  UINTN                        Index;
+
+  for (Index = 0; Index < SystemTable->NumberOfTableEntries; Index++) {
+    if (CompareGuid (TableGuid, &SystemTable->ConfigurationTable[Index].VendorGuid)) {
+      return SystemTable->ConfigurationTable[Index].VendorTable;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Allocate the ring buffer, copy the messages of the PEI ring buffer to it and
+  install it as a configuration table.
+
+  The ring buffer is allocated in runtime services data, so the OS can read
+  the firmware log.
+
+  @param  SystemTable   A pointer to the EFI System Table.
+  @param  PeiRingBuffer The PEI ring buffer, or NULL if there is none.
+
+  @return The ring buffer, or NULL if it can't be created.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+CreateDebugRingBufferTable (
+  IN EFI_SYSTEM_TABLE          *SystemTable,
+  IN EDKII_DEBUG_RING_BUFFER   *PeiRingBuffer   OPTIONAL
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_PHYSICAL_ADDRESS         Address;
+  EDKII_DEBUG_RING_BUFFER      *RingBuffer;
+  UINTN                        Pages;
+
+  if (PcdGet32 (PcdDebugRingBufferDxeSize) < MAX_DEBUG_MESSAGE_LENGTH) {
+    return NULL;
+  }
+
+  Pages  = EFI_SIZE_TO_PAGES (sizeof (EDKII_DEBUG_RING_BUFFER) + PcdGet32 (PcdDebugRingBufferDxeSize));
+  Status = SystemTable->BootServices->AllocatePages (
+                                        AllocateAnyPages,
+                                        EfiRuntimeServicesData,
+                                        Pages,
+                                        &Address
+                                        );
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  RingBuffer = (EDKII_DEBUG_RING_BUFFER *)(UINTN)Address;
+  InitializeDebugRingBuffer (
+    RingBuffer,
+    (UINT32)(EFI_PAGES_TO_SIZE (Pages) - sizeof (EDKII_DEBUG_RING_BUFFER))
+    );
+  if (PeiRingBuffer != NULL) {
+    DebugRingBufferImport (RingBuffer, PeiRingBuffer);
+  }
+
+  Status = SystemTable->BootServices->InstallConfigurationTable (&gEdkiiDebugRingBufferGuid, RingBuffer);
+  if (EFI_ERROR (Status)) {
+    //
+    // The messages imported from PEI would be lost, send them now.
+    //
+    DebugRingBufferDrain (RingBuffer, MAX_UINTN);
+    SystemTable->BootServices->FreePages (Address, Pages);
+    return NULL;
+  }
+
+  return RingBuffer;
+}
+
+/**
+  Send the messages to the serial port, if it has sent the previous ones.
+
+  At most PcdDebugRingBufferDrainSize bytes are sent, so the serial port
+  can take them without waiting when it is set to the size of its FIFO.
+
+  @param  Event         The timer event.
+  @param  Context       NULL.
+
+**/
+VOID
+EFIAPI
+DrainTimerNotify (
+  IN EFI_EVENT                 Event,
+  IN VOID                      *Context
+  )
+{
+  RETURN_STATUS                Status;
+  UINT32                       Control;
+
+  Status = SerialPortGetControl (&Control);
+  if (!RETURN_ERROR (Status) && ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) == 0)) {
+    return;
+  }
+
+  DebugRingBufferDrain (mDebugRingBuffer, PcdGet32 (PcdDebugRingBufferDrainSize));
+}
+
+/**
+  Send part of the messages to the serial port while the DXE Core is idle.
+
+  @param  Event         The idle loop event.
+  @param  Context       NULL.
+
+**/
+VOID
+EFIAPI
+DrainIdleNotify (
+  IN EFI_EVENT                 Event,
+  IN VOID                      *Context
+  )
+{
+  DebugRingBufferDrain (mDebugRingBuffer, IDLE_DRAIN_LENGTH);
+}
+
+/**
+  Send all the messages to the serial port at Ready To Boot.
+
+  @param  Event         The Ready To Boot event.
+  @param  Context       NULL.
+
+**/
+VOID
+EFIAPI
+DrainReadyToBootNotify (
+  IN EFI_EVENT                 Event,
+  IN VOID                      *Context
+  )
+{
+  DebugRingBufferDrain (mDebugRingBuffer, MAX_UINTN);
+}
+
+/**
+  Send all the messages to the serial port at Exit Boot Services, and the next
+  ones as soon as they are written, as the timer and idle events stop.
+
+  @param  Event         The Exit Boot Services event.
+  @param  Context       NULL.
+
+**/
+VOID
+EFIAPI
+DrainExitBootServicesNotify (
+  IN EFI_EVENT                 Event,
+  IN VOID                      *Context
+  )
+{
+  mDebugRingBuffer->Flags |= EDKII_DEBUG_RING_BUFFER_WRITE_THROUGH;
+  DebugRingBufferDrain (mDebugRingBuffer, MAX_UINTN);
+}
+
+/**
+  Close the events that drain the ring buffer.
+
+**/
+VOID
+CloseDrainEvents (
+  VOID
+  )
+{
+  if (mDrainTimerEvent != NULL) {
+    mDebugBootServices->CloseEvent (mDrainTimerEvent);
+    mDrainTimerEvent = NULL;
+  }
+  if (mDrainIdleEvent != NULL) {
+    mDebugBootServices->CloseEvent (mDrainIdleEvent);
+    mDrainIdleEvent = NULL;
+  }
+  if (mDrainReadyToBootEvent != NULL) {
+    mDebugBootServices->CloseEvent (mDrainReadyToBootEvent);
+    mDrainReadyToBootEvent = NULL;
+  }
+  if (mDrainExitBootServicesEvent != NULL) {
+    mDebugBootServices->CloseEvent (mDrainExitBootServicesEvent);
+    mDrainExitBootServicesEvent = NULL;
+  }
+}
+
+/**
+  Create the events that drain the ring buffer.
+
+  @retval EFI_SUCCESS   The events are created.
+  @retval Others        An event can't be created. No event is created.
+
+**/
+EFI_STATUS
+CreateDrainEvents (
+  VOID
+  )
+{
+  EFI_STATUS                   Status;
+
+  if (PcdGet32 (PcdDebugRingBufferDrainPeriod) != 0) {
+    Status = mDebugBootServices->CreateEvent (
+                                   EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                                   TPL_CALLBACK,
+                                   DrainTimerNotify,
+                                   NULL,
+                                   &mDrainTimerEvent
+                                   );
+    if (!EFI_ERROR (Status)) {
+      Status = mDebugBootServices->SetTimer (
+                                     mDrainTimerEvent,
+                                     TimerPeriodic,
+                                     PcdGet32 (PcdDebugRingBufferDrainPeriod)
+                                     );
+    }
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  Status = mDebugBootServices->CreateEventEx (
+                                 EVT_NOTIFY_SIGNAL,
+                                 TPL_CALLBACK,
+                                 DrainIdleNotify,
+                                 NULL,
+                                 &gIdleLoopEventGuid,
+                                 &mDrainIdleEvent
+                                 );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = mDebugBootServices->CreateEventEx (
+                                 EVT_NOTIFY_SIGNAL,
+                                 TPL_CALLBACK,
+                                 DrainReadyToBootNotify,
+                                 NULL,
+                                 &gEfiEventReadyToBootGuid,
+                                 &mDrainReadyToBootEvent
+                                 );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // At TPL_NOTIFY, to send the messages of the other Exit Boot Services
+  // callbacks right away.
+  //
+  Status = mDebugBootServices->CreateEventEx (
+                                 EVT_NOTIFY_SIGNAL,
+                                 TPL_NOTIFY,
+                                 DrainExitBootServicesNotify,
+                                 NULL,
+                                 &gEfiEventExitBootServicesGuid,
+                                 &mDrainExitBootServicesEvent
+                                 );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  CloseDrainEvents ();
+  return Status;
+}
+
+/**
+  The constructor function initializes the Serial Port library, finds or
+  creates the ring buffer, and drains it if no other module does.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The constructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeDebugLibRingBufferConstructor (
+  IN EFI_HANDLE                ImageHandle,
+  IN EFI_SYSTEM_TABLE          *SystemTable
+  )
+{
+  EFI_STATUS                   Status;
+  VOID                         *HobList;
+  EDKII_DEBUG_RING_BUFFER      *PeiRingBuffer;
+
+  SerialPortInitialize ();
+
+  mDebugBootServices = SystemTable->BootServices;
+  mDebugRingBuffer   = FindConfigurationTable (SystemTable, &gEdkiiDebugRingBufferGuid);
+  if (mDebugRingBuffer == NULL) {
+    PeiRingBuffer = NULL;
+    HobList       = FindConfigurationTable (SystemTable, &gEfiHobListGuid);
+    if (HobList != NULL) {
+      PeiRingBuffer = FindDebugRingBufferHob (HobList);
+    }
+
+    mDebugRingBuffer = CreateDebugRingBufferTable (SystemTable, PeiRingBuffer);
+    if ((mDebugRingBuffer == NULL) && (PeiRingBuffer != NULL)) {
+      //
+      // The messages are sent directly, send the ones left from PEI first.
+      //
+      DebugRingBufferDrain (PeiRingBuffer, MAX_UINTN);
+    }
+  }
+
+  if ((mDebugRingBuffer != NULL) &&
+      (InterlockedCompareExchange32 (&mDebugRingBuffer->DrainOwner, 0, 1) == 0)) {
+    Status = CreateDrainEvents ();
+    if (EFI_ERROR (Status)) {
+      InterlockedCompareExchange32 (&mDebugRingBuffer->DrainOwner, 1, 0);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  The destructor function drains the ring buffer and closes its events, so
+  that the next module linked with this library drains it.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeDebugLibRingBufferDestructor (
+  IN EFI_HANDLE                ImageHandle,
+  IN EFI_SYSTEM_TABLE          *SystemTable
+  )
+{
+  if (mDrainIdleEvent != NULL) {
+    CloseDrainEvents ();
+    DebugRingBufferDrain (mDebugRingBuffer, MAX_UINTN);
+    InterlockedCompareExchange32 (&mDebugRingBuffer->DrainOwner, 1, 0);
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,107 @@
+/** @file
+  PEI part of the ring buffer Debug library instance.
+
+  The ring buffer is the data of a GUIDed HOB, created by the first DEBUG()
+  call of a PEIM linked with this library, and moved with the HOB list when
+  the permanent memory is installed. PEI has no timer events, so the messages
+  are only sent to the serial port when the ring buffer is full. The messages
+  left in the ring buffer are sent by the DXE instance.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DebugLibRingBuffer.h"
+
+#include <Library/PeiServicesLib.h>
+
+/**
+  Create the ring buffer HOB.
+
+  The HOB is only created if the HOB list has room for it, as the PEI Core
+  reports a failure to create a HOB through DEBUG().
+
+  @param  HobList       The HOB list.
+
+  @return The ring buffer, or NULL if it can't be created.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+CreateDebugRingBufferHob (
+  IN VOID                      *HobList
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_HOB_HANDOFF_INFO_TABLE   *HandOffHob;
+  EFI_HOB_GUID_TYPE            *GuidHob;
+  EDKII_DEBUG_RING_BUFFER      *RingBuffer;
+  UINT32                       BufferSize;
+  UINT32                       HobLength;
+
+  BufferSize = PcdGet32 (PcdDebugRingBufferPeiSize);
+  if (BufferSize < MAX_DEBUG_MESSAGE_LENGTH) {
+    return NULL;
+  }
+
+  //
+  // The size of a HOB is limited to 64KB.
+  //
+  BufferSize = MIN (
+                 BufferSize,
+                 (MAX_UINT16 & ~0x7) - sizeof (EFI_HOB_GUID_TYPE) - sizeof (EDKII_DEBUG_RING_BUFFER)
+                 );
+  HobLength  = (UINT32)ALIGN_VALUE (sizeof (EFI_HOB_GUID_TYPE) + sizeof (EDKII_DEBUG_RING_BUFFER) + BufferSize, 8);
+
+  HandOffHob = (EFI_HOB_HANDOFF_INFO_TABLE *)HobList;
+  if (HandOffHob->EfiFreeMemoryTop - HandOffHob->EfiFreeMemoryBottom < HobLength) {
+    return NULL;
+  }
+
+  Status = PeiServicesCreateHob (EFI_HOB_TYPE_GUID_EXTENSION, (UINT16)HobLength, (VOID **)&GuidHob);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  CopyGuid (&GuidHob->Name, &gEdkiiDebugRingBufferGuid);
+  RingBuffer = (EDKII_DEBUG_RING_BUFFER *)(GuidHob + 1);
+  InitializeDebugRingBuffer (RingBuffer, BufferSize);
+
+  //
+  // This library has no constructor, as PeiServicesTablePointerLib may have
+  // one that depends on DebugLib. Initialize the serial port along with the
+  // ring buffer instead.
+  //
+  SerialPortInitialize ();
+
+  return RingBuffer;
+}
+
+/**
+  Get the ring buffer of the current phase.
+
+  @return The ring buffer, or NULL if the messages are sent to the serial port
+          directly.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+GetDebugRingBuffer (
+  VOID
+  )
+{
+  EFI_STATUS                   Status;
+  VOID                         *HobList;
+  EDKII_DEBUG_RING_BUFFER      *RingBuffer;
+
+  Status = PeiServicesGetHobList (&HobList);
+  if (EFI_ERROR (Status) || (HobList == NULL)) {
+    return NULL;
+  }
+
+  RingBuffer = FindDebugRingBufferHob (HobList);
+  if (RingBuffer == NULL) {
+    RingBuffer = CreateDebugRingBufferHob (HobList);
+  }
+
+  return RingBuffer;
+}
@@ -0,0 +1,328 @@
+/** @file
+  Lock-free ring buffer of the debug messages.
+
+  A writer reserves the space of its message by moving WriteOffset forward
+  with a compare exchange, so the processors writing messages at the same time
+  never wait for each other to copy their messages. The messages are committed
+  in the order of their reservations, so CommitOffset never passes a message
+  still being copied. The interrupts are disabled from the reservation to the
+  commit, so a writer can't be interrupted by another one on the same
+  processor while its message is not committed.
+
+  The messages are sent to the serial port by a single drainer at a time, with
+  the interrupts enabled. A writer only waits for the serial port when the ring
+  buffer is full.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DebugLibRingBuffer.h"
+
+/**
+  Read an offset of a ring buffer in one access, even where UINT64 is read in
+  two parts.
+
+  @param  Offset          The offset to read.
+
+  @return The offset.
+
+**/
+UINT64
+ReadRingBufferOffset (
+  IN volatile UINT64           *Offset
+  )
+{
+  return InterlockedCompareExchange64 (Offset, 0, 0);
+}
+
+/**
+  Get the data of a ring buffer.
+
+  @param  RingBuffer      The ring buffer.
+
+  @return The data.
+
+**/
+UINT8 *
+GetRingBufferData (
+  IN EDKII_DEBUG_RING_BUFFER   *RingBuffer
+  )
+{
+  return (UINT8 *)RingBuffer + RingBuffer->HeaderSize;
+}
+
+/**
+  Initialize a ring buffer.
+
+  @param  RingBuffer      The ring buffer, followed by BufferSize bytes.
+  @param  BufferSize      The size of the data in bytes.
+
+**/
+VOID
+InitializeDebugRingBuffer (
+  OUT EDKII_DEBUG_RING_BUFFER  *RingBuffer,
+  IN  UINT32                   BufferSize
+  )
+{
+  ZeroMem (RingBuffer, sizeof (EDKII_DEBUG_RING_BUFFER));
+  RingBuffer->Signature  = EDKII_DEBUG_RING_BUFFER_SIGNATURE;
+  RingBuffer->HeaderSize = sizeof (EDKII_DEBUG_RING_BUFFER);
+  RingBuffer->BufferSize = BufferSize;
+}
+
+/**
+  Find the ring buffer in a HOB list.
+
+  HobLib isn't used, as it reports its errors through DebugLib.
+
+  @param  HobList         The HOB list.
+
+  @return The ring buffer, or NULL if the HOB list doesn't have it.
+
+**/
+EDKII_DEBUG_RING_BUFFER *
+FindDebugRingBufferHob (
+  IN VOID                      *HobList
+  )
+{
+  EFI_PEI_HOB_POINTERS         Hob;
+  EDKII_DEBUG_RING_BUFFER      *RingBuffer;
+
+  for (Hob.Raw = HobList;
+       Hob.Header->HobType != EFI_HOB_TYPE_END_OF_HOB_LIST;
+       Hob.Raw += Hob.Header->HobLength) {
+    if ((Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) &&
+        CompareGuid (&Hob.Guid->Name, &gEdkiiDebugRingBufferGuid)) {
+      RingBuffer = (EDKII_DEBUG_RING_BUFFER *)(Hob.Guid + 1);
+      if (RingBuffer->Signature != EDKII_DEBUG_RING_BUFFER_SIGNATURE) {
+        return NULL;
+      }
+      return RingBuffer;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Write a message to a ring buffer.
+
+  If the ring buffer is full, the oldest messages are sent to the serial port
+  to make room for the new one.
+
+  @param  RingBuffer      The ring buffer.
+  @param  Buffer          The message.
+  @param  Length          The length of the message in bytes.
+
+  @retval TRUE            The message is written.
+  @retval FALSE           The message doesn't fit in the ring buffer, or the
+                          ring buffer is full while the serial port is being
+                          written by an interrupted caller.
+
+**/
+BOOLEAN
+DebugRingBufferWrite (
+  IN EDKII_DEBUG_RING_BUFFER   *RingBuffer,
+  IN CONST UINT8               *Buffer,
+  IN UINTN                     Length
+  )
+{
+  UINT8                        *Data;
+  UINT64                       WriteOffset;
+  UINT64                       DrainOffset;
+  UINT32                       Index;
+  UINTN                        Size;
+  BOOLEAN                      InterruptState;
+
+  if (Length == 0) {
+    return TRUE;
+  }
+  if (Length > RingBuffer->BufferSize) {
+    return FALSE;
+  }
+
+  //
+  // Reserve the space of the message.
+  //
+  while (TRUE) {
+    InterruptState = SaveAndDisableInterrupts ();
+    WriteOffset    = ReadRingBufferOffset (&RingBuffer->WriteOffset);
+    DrainOffset    = ReadRingBufferOffset (&RingBuffer->DrainOffset);
+    if (WriteOffset + Length <= DrainOffset + RingBuffer->BufferSize) {
+      if (InterlockedCompareExchange64 (
+            &RingBuffer->WriteOffset,
+            WriteOffset,
+            WriteOffset + Length
+            ) == WriteOffset) {
+        break;
+      }
+      SetInterruptState (InterruptState);
+      continue;
+    }
+    SetInterruptState (InterruptState);
+
+    //
+    // The ring buffer is full. Send the oldest messages to the serial port.
+    // If the serial port is being written, the drainer may be the code this
+    // call interrupted, so don't wait for it.
+    //
+    if (!DebugRingBufferDrain (
+           RingBuffer,
+           (UINTN)(WriteOffset + Length - DrainOffset - RingBuffer->BufferSize)
+           )) {
+      return FALSE;
+    }
+    CpuPause ();
+  }
+
+  //
+  // Copy the message, wrapping around the end of the data.
+  //
+  Data  = GetRingBufferData (RingBuffer);
+  Index = ModU64x32 (WriteOffset, RingBuffer->BufferSize);
+  Size  = MIN (Length, RingBuffer->BufferSize - Index);
+  CopyMem (Data + Index, Buffer, Size);
+  CopyMem (Data, Buffer + Size, Length - Size);
+
+  //
+  // Commit the message after the messages reserved before it.
+  //
+  while (InterlockedCompareExchange64 (
+           &RingBuffer->CommitOffset,
+           WriteOffset,
+           WriteOffset + Length
+           ) != WriteOffset) {
+    CpuPause ();
+  }
+  SetInterruptState (InterruptState);
+
+  if ((RingBuffer->Flags & EDKII_DEBUG_RING_BUFFER_WRITE_THROUGH) != 0) {
+    DebugRingBufferDrain (RingBuffer, MAX_UINTN);
+  }
+
+  return TRUE;
+}
+
+/**
+  Send the messages of a ring buffer to the serial port.
+
+  @param  RingBuffer      The ring buffer.
+  @param  Length          The maximum number of bytes to send, MAX_UINTN to
+                          send all the messages.
+
+  @retval TRUE            The messages are sent.
+  @retval FALSE           The serial port is being written by another caller.
+
+**/
+BOOLEAN
+DebugRingBufferDrain (
+  IN EDKII_DEBUG_RING_BUFFER   *RingBuffer,
+  IN UINTN                     Length
+  )
+{
+  UINT8                        *Data;
+  UINT64                       DrainOffset;
+  UINT64                       EndOffset;
+  UINT32                       Index;
+  UINTN                        Size;
+
+  if (InterlockedCompareExchange32 (&RingBuffer->DrainLock, 0, 1) != 0) {
+    return FALSE;
+  }
+
+  //
+  // DrainOffset is only changed by the owner of the lock.
+  //
+  Data        = GetRingBufferData (RingBuffer);
+  DrainOffset = ReadRingBufferOffset (&RingBuffer->DrainOffset);
+  EndOffset   = ReadRingBufferOffset (&RingBuffer->CommitOffset);
+  if (EndOffset - DrainOffset > Length) {
+    EndOffset = DrainOffset + Length;
+  }
+
+  while (DrainOffset < EndOffset) {
+    Index = ModU64x32 (DrainOffset, RingBuffer->BufferSize);
+    Size  = (UINTN)MIN (EndOffset - DrainOffset, RingBuffer->BufferSize - Index);
+    SerialPortWrite (Data + Index, Size);
+
+    //
+    // Make room for the writers as each part is sent.
+    //
+    InterlockedCompareExchange64 (
+      &RingBuffer->DrainOffset,
+      DrainOffset,
+      DrainOffset + Size
+      );
+    DrainOffset += Size;
+  }
+
+  InterlockedCompareExchange32 (&RingBuffer->DrainLock, 1, 0);
+  return TRUE;
+}
+
+/**
+  Copy the messages of a ring buffer to an empty one.
+
+  The messages not sent to the serial port yet are still to be sent from the
+  new ring buffer. If the new ring buffer is smaller, the oldest messages are
+  dropped.
+
+  @param  RingBuffer      The empty ring buffer.
+  @param  OldRingBuffer   The ring buffer to copy.
+
+**/
+VOID
+DebugRingBufferImport (
+  IN OUT EDKII_DEBUG_RING_BUFFER  *RingBuffer,
+  IN     EDKII_DEBUG_RING_BUFFER  *OldRingBuffer
+  )
+{
+  UINT8                           *OldData;
+  UINT64                          CommitOffset;
+  UINT64                          DrainOffset;
+  UINT64                          Offset;
+  UINT32                          Index;
+  UINTN                           Length;
+  UINTN                           Size;
+
+  CommitOffset = ReadRingBufferOffset (&OldRingBuffer->CommitOffset);
+  DrainOffset  = ReadRingBufferOffset (&OldRingBuffer->DrainOffset);
+
+  //
+  // The messages not sent yet must fit in the new ring buffer.
+  //
+  if (CommitOffset - DrainOffset > RingBuffer->BufferSize) {
+    DebugRingBufferDrain (
+      OldRingBuffer,
+      (UINTN)(CommitOffset - DrainOffset - RingBuffer->BufferSize)
+      );
+    DrainOffset = ReadRingBufferOffset (&OldRingBuffer->DrainOffset);
+  }
+
+  Length = (UINTN)MIN (CommitOffset, MIN (OldRingBuffer->BufferSize, RingBuffer->BufferSize));
+  if (Length < CommitOffset - DrainOffset) {
+    return;
+  }
+
+  OldData = GetRingBufferData (OldRingBuffer);
+  for (Offset = CommitOffset - Length; Offset < CommitOffset; Offset += Size) {
+    Index = ModU64x32 (Offset, OldRingBuffer->BufferSize);
+    Size  = (UINTN)MIN (CommitOffset - Offset, OldRingBuffer->BufferSize - Index);
+    CopyMem (
+      GetRingBufferData (RingBuffer) + (UINTN)(Offset - (CommitOffset - Length)),
+      OldData + Index,
+      Size
+      );
+  }
+
+  RingBuffer->WriteOffset  = Length;
+  RingBuffer->CommitOffset = Length;
+  RingBuffer->DrainOffset  = Length - (CommitOffset - DrainOffset);
+
+  //
+  // The messages now belong to the new ring buffer.
+  //
+  OldRingBuffer->DrainOffset = CommitOffset;
+}
@@ -12,6 +12,7 @@
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
 #include <Library/FrameBufferBltLib.h>
 
 struct FRAME_BUFFER_CONFIGURE {
@@ -20,6 +21,7 @@ struct FRAME_BUFFER_CONFIGURE {
   UINT32                          Width;
   UINT32                          Height;
   UINT8                           *FrameBuffer;
+  UINT8                           *Shadow;     // Copy of FrameBuffer in system memory, or NULL
   EFI_GRAPHICS_PIXEL_FORMAT       PixelFormat;
   EFI_PIXEL_BITMASK               PixelMasks;
   INT8                            PixelShl[4]; // R-G-B-Rsvd
@@ -86,6 +88,11 @@ FrameBufferBltLibConfigurePixelFormat (
 
   The configuration is returned in the caller provided buffer.
 
+  If PcdFrameBufferBltShadow is TRUE, the configuration also holds a copy of
+  the frame buffer in system memory, so that the blt operations never read
+  the frame buffer. The frame buffer must then only be written through
+  FrameBufferBlt ().
+
   @param[in] FrameBuffer       Pointer to the start of the frame buffer.
   @param[in] FrameBufferInfo   Describes the frame buffer characteristics.
   @param[in,out] Configure     The created configuration information.
@@ -111,6 +118,8 @@ FrameBufferBltConfigure (
   UINT32                                       BytesPerPixel;
   INT8                                         PixelShl[4];
   INT8                                         PixelShr[4];
+  UINTN                                        LineBufferSize;
+  UINTN                                        ShadowSize;
 
   if (ConfigureSize == NULL) {
     return RETURN_INVALID_PARAMETER;
@@ -144,10 +153,18 @@ FrameBufferBltConfigure (
 
   FrameBufferBltLibConfigurePixelFormat (BitMask, &BytesPerPixel, PixelShl, PixelShr);
 
-  if (*ConfigureSize < sizeof (FRAME_BUFFER_CONFIGURE)
-                     + FrameBufferInfo->HorizontalResolution * BytesPerPixel) {
-    *ConfigureSize = sizeof (FRAME_BUFFER_CONFIGURE)
-                   + FrameBufferInfo->HorizontalResolution * BytesPerPixel;
+  //
+  // The pixels are converted as UINT32, which may access the line buffer up to
+  // sizeof (UINT32) bytes after the last pixel.
+  //
+  LineBufferSize = ALIGN_VALUE (FrameBufferInfo->HorizontalResolution * BytesPerPixel + sizeof (UINT32), sizeof (UINT64));
+  ShadowSize     = 0;
+  if (FeaturePcdGet (PcdFrameBufferBltShadow)) {
+    ShadowSize = (UINTN) FrameBufferInfo->PixelsPerScanLine * FrameBufferInfo->VerticalResolution * BytesPerPixel;
+  }
+
+  if (*ConfigureSize < sizeof (FRAME_BUFFER_CONFIGURE) + LineBufferSize + ShadowSize) {
+    *ConfigureSize = sizeof (FRAME_BUFFER_CONFIGURE) + LineBufferSize + ShadowSize;
     return RETURN_BUFFER_TOO_SMALL;
   }
 
@@ -164,10 +181,192 @@ FrameBufferBltConfigure (
   Configure->Width             = FrameBufferInfo->HorizontalResolution;
   Configure->Height            = FrameBufferInfo->VerticalResolution;
   Configure->PixelsPerScanLine = FrameBufferInfo->PixelsPerScanLine;
+  Configure->Shadow            = NULL;
+
+  if (ShadowSize != 0) {
+    //
+    // The frame buffer is only read once, to initialize its shadow.
+    //
+    Configure->Shadow = Configure->LineBuffer + LineBufferSize;
+    CopyMem (Configure->Shadow, Configure->FrameBuffer, ShadowSize);
+  }
 
   return RETURN_SUCCESS;
 }
 
+/**
+  Get the pixels the blt operations read and write: the shadow of the frame
+  buffer if there is one, the frame buffer otherwise.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+
+  @return The pixels, PixelsPerScanLine pixels per line.
+**/
+UINT8 *
+FrameBufferBltLibGetPixels (
+  IN  FRAME_BUFFER_CONFIGURE        *Configure
+  )
+{
+  return (Configure->Shadow != NULL) ? Configure->Shadow : Configure->FrameBuffer;
+}
+
+/**
+  Copy a rectangle of the shadow of the frame buffer to the frame buffer.
+
+  Nothing is done if the frame buffer has no shadow.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[in]  X             X location of the rectangle.
+  @param[in]  Y             Y location of the rectangle.
+  @param[in]  Width         Width (in pixels).
+  @param[in]  Height        Height.
+**/
+VOID
+FrameBufferBltLibFlushShadow (
+  IN  FRAME_BUFFER_CONFIGURE        *Configure,
+  IN  UINTN                         X,
+  IN  UINTN                         Y,
+  IN  UINTN                         Width,
+  IN  UINTN                         Height
+  )
+{
+  UINTN                             Offset;
+  UINTN                             LineStride;
+  UINTN                             WidthInBytes;
+
+  if (Configure->Shadow == NULL) {
+    return;
+  }
+
+  Offset       = Configure->BytesPerPixel * ((Y * Configure->PixelsPerScanLine) + X);
+  LineStride   = Configure->BytesPerPixel * Configure->PixelsPerScanLine;
+  WidthInBytes = Width * Configure->BytesPerPixel;
+
+  if (WidthInBytes == LineStride) {
+    //
+    // Full lines are contiguous, so write them at once.
+    //
+    CopyMem (Configure->FrameBuffer + Offset, Configure->Shadow + Offset, WidthInBytes * Height);
+    return;
+  }
+
+  while (Height-- > 0) {
+    CopyMem (Configure->FrameBuffer + Offset, Configure->Shadow + Offset, WidthInBytes);
+    Offset += LineStride;
+  }
+}
+
+/**
+  Convert a line of pixels from the Blt buffer format to the frame buffer
+  format.
+
+  The conversions of the 8 bits per color formats are loops simple enough for
+  the compiler to vectorize.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[out] Destination   The pixels in the frame buffer format. For the
+                            PixelBitMask format, it must have room for
+                            sizeof (UINT32) more bytes.
+  @param[in]  Source        The pixels in the Blt buffer format.
+  @param[in]  Width         Width (in pixels).
+**/
+VOID
+FrameBufferBltLibConvertFromBltPixels (
+  IN  FRAME_BUFFER_CONFIGURE        *Configure,
+  OUT UINT8                         *Destination,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Source,
+  IN  UINTN                         Width
+  )
+{
+  UINTN                             IndexX;
+  UINT32                            Uint32;
+
+  switch (Configure->PixelFormat) {
+  case PixelBlueGreenRedReserved8BitPerColor:
+    CopyMem (Destination, Source, Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    break;
+
+  case PixelRedGreenBlueReserved8BitPerColor:
+    for (IndexX = 0; IndexX < Width; IndexX++) {
+      Uint32 = ((UINT32 *) Source)[IndexX];
+      ((UINT32 *) Destination)[IndexX] =
+        (Uint32 & 0x0000ff00) | ((Uint32 & 0x000000ff) << 16) | ((Uint32 >> 16) & 0x000000ff);
+    }
+    break;
+
+  default:
+    for (IndexX = 0; IndexX < Width; IndexX++) {
+      Uint32 = ((UINT32 *) Source)[IndexX];
+      *(UINT32*) (Destination + (IndexX * Configure->BytesPerPixel)) =
+        (UINT32) (
+            (((Uint32 << Configure->PixelShl[0]) >> Configure->PixelShr[0]) &
+             Configure->PixelMasks.RedMask) |
+            (((Uint32 << Configure->PixelShl[1]) >> Configure->PixelShr[1]) &
+             Configure->PixelMasks.GreenMask) |
+            (((Uint32 << Configure->PixelShl[2]) >> Configure->PixelShr[2]) &
+             Configure->PixelMasks.BlueMask)
+          );
+    }
+    break;
+  }
+}
+
+/**
+  Convert a line of pixels from the frame buffer format to the Blt buffer
+  format.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[out] Destination   The pixels in the Blt buffer format.
+  @param[in]  Source        The pixels in the frame buffer format. For the
+                            PixelBitMask format, it must be followed by
+                            sizeof (UINT32) readable bytes.
+  @param[in]  Width         Width (in pixels).
+**/
+VOID
+FrameBufferBltLibConvertToBltPixels (
+  IN  FRAME_BUFFER_CONFIGURE        *Configure,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL *Destination,
+  IN  UINT8                         *Source,
+  IN  UINTN                         Width
+  )
+{
+  UINTN                             IndexX;
+  UINT32                            Uint32;
+
+  switch (Configure->PixelFormat) {
+  case PixelBlueGreenRedReserved8BitPerColor:
+    CopyMem (Destination, Source, Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    break;
+
+  case PixelRedGreenBlueReserved8BitPerColor:
+    for (IndexX = 0; IndexX < Width; IndexX++) {
+      Uint32 = ((UINT32 *) Source)[IndexX];
+      ((UINT32 *) Destination)[IndexX] =
+        (Uint32 & 0x0000ff00) | ((Uint32 & 0x000000ff) << 16) | ((Uint32 >> 16) & 0x000000ff);
+    }
+    break;
+
+  default:
+    for (IndexX = 0; IndexX < Width; IndexX++) {
+      Uint32 = *(UINT32*) (Source + (IndexX * Configure->BytesPerPixel));
+      ((UINT32 *) Destination)[IndexX] =
+        (UINT32) (
+          (((Uint32 & Configure->PixelMasks.RedMask) >>
+            Configure->PixelShl[0]) << Configure->PixelShr[0]) |
+            (((Uint32 & Configure->PixelMasks.GreenMask) >>
+              Configure->PixelShl[1]) << Configure->PixelShr[1]) |
+              (((Uint32 & Configure->PixelMasks.BlueMask) >>
+                Configure->PixelShl[2]) << Configure->PixelShr[2])
+            );
+    }
+    break;
+  }
+}
+
 /**
   Performs a UEFI Graphics Output Protocol Blt Video Fill.
 
@@ -204,6 +403,7 @@ FrameBufferBltLibVideoFill (
   UINTN                             Offset;
   UINTN                             WidthInBytes;
   UINTN                             SizeInBytes;
+  UINT8                             *Pixels;
 
   //
   // BltBuffer to Video: Source is BltBuffer, destination is Video
@@ -224,6 +424,7 @@ FrameBufferBltLibVideoFill (
   }
 
   WidthInBytes = Width * Configure->BytesPerPixel;
+  Pixels       = FrameBufferBltLibGetPixels (Configure);
 
   Uint32 = *(UINT32*) Color;
   WideFill =
@@ -270,7 +471,7 @@ FrameBufferBltLibVideoFill (
     DEBUG ((EFI_D_VERBOSE, "VideoFill (wide, one-shot)\n"));
     Offset = DestinationY * Configure->PixelsPerScanLine;
     Offset = Configure->BytesPerPixel * Offset;
-    Destination = Configure->FrameBuffer + Offset;
+    Destination = Pixels + Offset;
     SizeInBytes = WidthInBytes * Height;
     if (SizeInBytes >= 8) {
       SetMem32 (Destination, SizeInBytes & ~3, (UINT32) WideFill);
@@ -285,7 +486,7 @@ FrameBufferBltLibVideoFill (
     for (IndexY = DestinationY; IndexY < (Height + DestinationY); IndexY++) {
       Offset = (IndexY * Configure->PixelsPerScanLine) + DestinationX;
       Offset = Configure->BytesPerPixel * Offset;
-      Destination = Configure->FrameBuffer + Offset;
+      Destination = Pixels + Offset;
 
       if (UseWideFill && (((UINTN) Destination & 7) == 0)) {
         DEBUG ((EFI_D_VERBOSE, "VideoFill (wide)\n"));
@@ -298,6 +499,9 @@ FrameBufferBltLibVideoFill (
         if (SizeInBytes > 0) {
           CopyMem (Destination, &WideFill, SizeInBytes);
         }
+      } else if (UseWideFill && (Configure->BytesPerPixel == sizeof (UINT32)) && (((UINTN) Destination & 3) == 0)) {
+        DEBUG ((EFI_D_VERBOSE, "VideoFill (wide, 32-bit)\n"));
+        SetMem32 (Destination, WidthInBytes, (UINT32) WideFill);
       } else {
         DEBUG ((EFI_D_VERBOSE, "VideoFill (not wide)\n"));
         if (!LineBufferReady) {
@@ -317,6 +521,8 @@ FrameBufferBltLibVideoFill (
     }
   }
 
+  FrameBufferBltLibFlushShadow (Configure, DestinationX, DestinationY, Width, Height);
+
   return RETURN_SUCCESS;
 }
 
@@ -353,13 +559,11 @@ FrameBufferBltLibVideoToBltBuffer (
 {
   UINTN                                  DstY;
   UINTN                                  SrcY;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL          *Blt;
   UINT8                                  *Source;
   UINT8                                  *Destination;
-  UINTN                                  IndexX;
-  UINT32                                 Uint32;
   UINTN                                  Offset;
   UINTN                                  WidthInBytes;
+  UINT8                                  *Pixels;
 
   //
   // Video to BltBuffer: Source is Video, destination is BltBuffer
@@ -386,6 +590,20 @@ FrameBufferBltLibVideoToBltBuffer (
   }
 
   WidthInBytes = Width * Configure->BytesPerPixel;
+  Pixels       = FrameBufferBltLibGetPixels (Configure);
+
+  if ((Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) &&
+      (Width == Configure->PixelsPerScanLine) && (Delta == WidthInBytes)) {
+    //
+    // The lines are contiguous in both the video and BltBuffer, so copy them at once.
+    //
+    CopyMem (
+      (UINT8 *) BltBuffer + (DestinationY * Delta) + (DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)),
+      Pixels + (SourceY * WidthInBytes),
+      WidthInBytes * Height
+      );
+    return RETURN_SUCCESS;
+  }
 
   //
   // Video to BltBuffer: Source is Video, destination is BltBuffer
@@ -396,33 +614,24 @@ FrameBufferBltLibVideoToBltBuffer (
 
     Offset = (SrcY * Configure->PixelsPerScanLine) + SourceX;
     Offset = Configure->BytesPerPixel * Offset;
-    Source = Configure->FrameBuffer + Offset;
+    Source = Pixels + Offset;
+    Destination = (UINT8 *) BltBuffer + (DstY * Delta) + (DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
 
-    if (Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
-      Destination = (UINT8 *) BltBuffer + (DstY * Delta) + (DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-    } else {
-      Destination = Configure->LineBuffer;
+    //
+    // Read the frame buffer a line at a time, the shadow can be converted in place.
+    //
+    if ((Configure->PixelFormat == PixelBitMask) ||
+        ((Configure->Shadow == NULL) && (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor))) {
+      CopyMem (Configure->LineBuffer, Source, WidthInBytes);
+      Source = Configure->LineBuffer;
     }
 
-    CopyMem (Destination, Source, WidthInBytes);
-
-    if (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
-      for (IndexX = 0; IndexX < Width; IndexX++) {
-        Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)
-          ((UINT8 *) BltBuffer + (DstY * Delta) +
-          (DestinationX + IndexX) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-        Uint32 = *(UINT32*) (Configure->LineBuffer + (IndexX * Configure->BytesPerPixel));
-        *(UINT32*) Blt =
-          (UINT32) (
-          (((Uint32 & Configure->PixelMasks.RedMask) >>
-            Configure->PixelShl[0]) << Configure->PixelShr[0]) |
-            (((Uint32 & Configure->PixelMasks.GreenMask) >>
-              Configure->PixelShl[1]) << Configure->PixelShr[1]) |
-              (((Uint32 & Configure->PixelMasks.BlueMask) >>
-                Configure->PixelShl[2]) << Configure->PixelShr[2])
-            );
-      }
-    }
+    FrameBufferBltLibConvertToBltPixels (
+      Configure,
+      (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) Destination,
+      Source,
+      Width
+      );
   }
 
   return RETURN_SUCCESS;
@@ -461,13 +670,11 @@ FrameBufferBltLibBufferToVideo (
 {
   UINTN                                    DstY;
   UINTN                                    SrcY;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL            *Blt;
   UINT8                                    *Source;
   UINT8                                    *Destination;
-  UINTN                                    IndexX;
-  UINT32                                   Uint32;
   UINTN                                    Offset;
   UINTN                                    WidthInBytes;
+  UINT8                                    *Pixels;
 
   //
   // BltBuffer to Video: Source is BltBuffer, destination is Video
@@ -494,42 +701,53 @@ FrameBufferBltLibBufferToVideo (
   }
 
   WidthInBytes = Width * Configure->BytesPerPixel;
+  Pixels       = FrameBufferBltLibGetPixels (Configure);
 
-  for (SrcY = SourceY, DstY = DestinationY;
-       SrcY < (Height + SourceY);
-       SrcY++, DstY++) {
-
-    Offset = (DstY * Configure->PixelsPerScanLine) + DestinationX;
-    Offset = Configure->BytesPerPixel * Offset;
-    Destination = Configure->FrameBuffer + Offset;
+  if ((Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) &&
+      (Width == Configure->PixelsPerScanLine) && (Delta == WidthInBytes)) {
+    //
+    // The lines are contiguous in both BltBuffer and the video, so copy them at once.
+    //
+    CopyMem (
+      Pixels + (DestinationY * WidthInBytes),
+      (UINT8 *) BltBuffer + (SourceY * Delta) + (SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)),
+      WidthInBytes * Height
+      );
+  } else {
+    for (SrcY = SourceY, DstY = DestinationY;
+         SrcY < (Height + SourceY);
+         SrcY++, DstY++) {
 
-    if (Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
+      Offset = (DstY * Configure->PixelsPerScanLine) + DestinationX;
+      Offset = Configure->BytesPerPixel * Offset;
+      Destination = Pixels + Offset;
       Source = (UINT8 *) BltBuffer + (SrcY * Delta) + SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
-    } else {
-      for (IndexX = 0; IndexX < Width; IndexX++) {
-        Blt =
-          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) (
-              (UINT8 *) BltBuffer +
-              (SrcY * Delta) +
-              ((SourceX + IndexX) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
-            );
-        Uint32 = *(UINT32*) Blt;
-        *(UINT32*) (Configure->LineBuffer + (IndexX * Configure->BytesPerPixel)) =
-          (UINT32) (
-              (((Uint32 << Configure->PixelShl[0]) >> Configure->PixelShr[0]) &
-               Configure->PixelMasks.RedMask) |
-              (((Uint32 << Configure->PixelShl[1]) >> Configure->PixelShr[1]) &
-               Configure->PixelMasks.GreenMask) |
-              (((Uint32 << Configure->PixelShl[2]) >> Configure->PixelShr[2]) &
-               Configure->PixelMasks.BlueMask)
-            );
+
+      //
+      // Write the frame buffer a line at a time, the shadow can be converted in place.
+      //
+      if ((Configure->PixelFormat == PixelBitMask) ||
+          ((Configure->Shadow == NULL) && (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor))) {
+        FrameBufferBltLibConvertFromBltPixels (
+          Configure,
+          Configure->LineBuffer,
+          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) Source,
+          Width
+          );
+        CopyMem (Destination, Configure->LineBuffer, WidthInBytes);
+      } else {
+        FrameBufferBltLibConvertFromBltPixels (
+          Configure,
+          Destination,
+          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) Source,
+          Width
+          );
       }
-      Source = Configure->LineBuffer;
     }
-
-    CopyMem (Destination, Source, WidthInBytes);
   }
 
+  FrameBufferBltLibFlushShadow (Configure, DestinationX, DestinationY, Width, Height);
+
   return RETURN_SUCCESS;
 }
 
@@ -564,6 +782,8 @@ FrameBufferBltLibVideoToVideo (
   UINTN                                     Offset;
   UINTN                                     WidthInBytes;
   INTN                                      LineStride;
+  UINT8                                     *Pixels;
+  UINTN                                     Index;
 
   //
   // Video to Video: Source is Video, destination is Video
@@ -590,31 +810,47 @@ FrameBufferBltLibVideoToVideo (
 
   WidthInBytes = Width * Configure->BytesPerPixel;
 
+  //
+  // With a shadow, the pixels are moved in the shadow and written to the
+  // frame buffer, which is never read.
+  //
+  Pixels = FrameBufferBltLibGetPixels (Configure);
+
   Offset = (SourceY * Configure->PixelsPerScanLine) + SourceX;
   Offset = Configure->BytesPerPixel * Offset;
-  Source = Configure->FrameBuffer + Offset;
+  Source = Pixels + Offset;
 
   Offset = (DestinationY * Configure->PixelsPerScanLine) + DestinationX;
   Offset = Configure->BytesPerPixel * Offset;
-  Destination = Configure->FrameBuffer + Offset;
+  Destination = Pixels + Offset;
 
   LineStride = Configure->BytesPerPixel * Configure->PixelsPerScanLine;
-  if (Destination > Source) {
+  if (Width == Configure->PixelsPerScanLine) {
     //
-    // Copy from last line to avoid source is corrupted by copying
+    // Full lines are contiguous, CopyMem () handles the overlap of the source
+    // and the destination.
     //
-    Source += Height * LineStride;
-    Destination += Height * LineStride;
-    LineStride = -LineStride;
-  }
+    CopyMem (Destination, Source, WidthInBytes * Height);
+  } else {
+    if (Destination > Source) {
+      //
+      // Copy from last line to avoid source is corrupted by copying
+      //
+      Source += (Height - 1) * LineStride;
+      Destination += (Height - 1) * LineStride;
+      LineStride = -LineStride;
+    }
 
-  while (Height-- > 0) {
-    CopyMem (Destination, Source, WidthInBytes);
+    for (Index = 0; Index < Height; Index++) {
+      CopyMem (Destination, Source, WidthInBytes);
 
-    Source += LineStride;
-    Destination += LineStride;
+      Source += LineStride;
+      Destination += LineStride;
+    }
   }
 
+  FrameBufferBltLibFlushShadow (Configure, DestinationX, DestinationY, Width, Height);
+
   return RETURN_SUCCESS;
 }
 
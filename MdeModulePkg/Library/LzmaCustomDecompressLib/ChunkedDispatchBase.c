@@ -0,0 +1,59 @@
+/** @file
+  LZMA chunked decompression workers for the serial library instance.
+  All chunks are decompressed by the calling processor.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaChunkedDecompressLibInternal.h"
+
+/**
+  Returns the number of processors which may decompress chunks at the same time,
+  including the calling processor.
+
+  @param[in]  ChunkCount  The number of chunks to decompress.
+
+  @return The number of workers, in the range 1 to LZMA_CHUNKED_MAX_WORKERS.
+
+**/
+UINT32
+LzmaChunkedGetWorkerCount (
+  IN UINT32  ChunkCount
+  )
+{
+  return 1;
+}
+
+/**
+  Returns the largest number of workers LzmaChunkedGetWorkerCount() may return
+  for ChunkCount chunks, whichever processors are available.
+
+  @param[in]  ChunkCount  The number of chunks to decompress.
+
+  @return The largest number of workers, in the range 1 to LZMA_CHUNKED_MAX_WORKERS.
+
+**/
+UINT32
+LzmaChunkedGetMaxWorkerCount (
+  IN UINT32  ChunkCount
+  )
+{
+  return 1;
+}
+
+/**
+  Starts the other workers on Context and waits for them to finish.
+
+  There are no other workers in this library instance.
+
+  @param[in, out]  Context  The chunked decompression state.
+
+**/
+VOID
+LzmaChunkedStartWorkers (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context
+  )
+{
+}
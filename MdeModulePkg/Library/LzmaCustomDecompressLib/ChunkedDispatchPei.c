@@ -0,0 +1,160 @@
+/** @file
+  LZMA chunked decompression workers for the PEI library instance.
+  The application processors are started through EFI_PEI_MP_SERVICES_PPI
+  to decompress chunks in parallel. Without the PPI, or when the processors
+  can not be started, all chunks are decompressed by the calling processor.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaChunkedDecompressLibInternal.h"
+#include <Ppi/MpServices.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+
+/**
+  Returns the number of processors which may decompress chunks at the same time,
+  including the calling processor.
+
+  @param[in]  ChunkCount  The number of chunks to decompress.
+
+  @return The number of workers, in the range 1 to LZMA_CHUNKED_MAX_WORKERS.
+
+**/
+UINT32
+LzmaChunkedGetWorkerCount (
+  IN UINT32  ChunkCount
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  UINTN                    NumberOfProcessors;
+  UINTN                    NumberOfEnabledProcessors;
+
+  if (ChunkCount <= 1) {
+    return 1;
+  }
+
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiMpServicesPpiGuid,
+             0,
+             NULL,
+             (VOID **) &MpServices
+             );
+  if (EFI_ERROR (Status)) {
+    return 1;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         GetPeiServicesTablePointer (),
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors == 0)) {
+    return 1;
+  }
+
+  NumberOfEnabledProcessors = MIN (NumberOfEnabledProcessors, ChunkCount);
+  return (UINT32) MIN (NumberOfEnabledProcessors, LZMA_CHUNKED_MAX_WORKERS);
+}
+
+/**
+  Returns the largest number of workers LzmaChunkedGetWorkerCount() may return
+  for ChunkCount chunks, whichever processors are available.
+
+  The MP Services PPI may be installed, or processors enabled, between GetInfo
+  and the extraction, so this doesn't depend on them.
+
+  @param[in]  ChunkCount  The number of chunks to decompress.
+
+  @return The largest number of workers, in the range 1 to LZMA_CHUNKED_MAX_WORKERS.
+
+**/
+UINT32
+LzmaChunkedGetMaxWorkerCount (
+  IN UINT32  ChunkCount
+  )
+{
+  if (ChunkCount <= 1) {
+    return 1;
+  }
+
+  return MIN (ChunkCount, LZMA_CHUNKED_MAX_WORKERS);
+}
+
+/**
+  Procedure run by the application processors.
+
+  Claims a scratch slot and decompresses chunks with it. The processors which
+  don't get a slot return at once.
+
+  @param[in, out]  Buffer  Pointer to the LZMA_CHUNKED_CONTEXT.
+
+**/
+VOID
+EFIAPI
+LzmaChunkedApProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_CHUNKED_CONTEXT  *Context;
+  UINT32                Slot;
+
+  Context = (LZMA_CHUNKED_CONTEXT *) Buffer;
+
+  Slot = InterlockedIncrement (&Context->NextWorker);
+  if (Slot >= Context->WorkerCount) {
+    return;
+  }
+
+  LzmaChunkedDecodeChunks (Context, Context->Scratch + (UINTN) Slot * Context->ScratchSize);
+}
+
+/**
+  Starts the other workers on Context and waits for them to finish.
+
+  @param[in, out]  Context  The chunked decompression state.
+
+**/
+VOID
+LzmaChunkedStartWorkers (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  if (Context->WorkerCount <= 1) {
+    return;
+  }
+
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiMpServicesPpiGuid,
+             0,
+             NULL,
+             (VOID **) &MpServices
+             );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  //
+  // StartupAllAPs() returns after all APs have finished. Chunks which were
+  // not handled by any AP, e.g. because they could not be started, are left
+  // for the calling processor.
+  //
+  Status = MpServices->StartupAllAPs (
+                         GetPeiServicesTablePointer (),
+                         MpServices,
+                         LzmaChunkedApProcedure,
+                         FALSE,
+                         0,
+                         Context
+                         );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "LzmaChunked: StartupAllAPs - %r, decompressing on the BSP only\n", Status));
+  }
+}
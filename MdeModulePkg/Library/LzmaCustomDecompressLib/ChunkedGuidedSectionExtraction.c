@@ -0,0 +1,342 @@
+/** @file
+  LZMA Chunked Decompress GUIDed Section Extraction Library.
+  The data of the section is split into chunks which were compressed
+  independently, so that they can be decompressed by several processors
+  at the same time. It wraps Lzma decompress interfaces to GUIDed Section
+  Extraction interfaces and registers them into GUIDed handler table.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaChunkedDecompressLibInternal.h"
+
+/**
+  Validates the header of LZMA chunked data and initializes the decompression state.
+
+  @param[in]  Source      The LZMA chunked data.
+  @param[in]  SourceSize  The size, in bytes, of the LZMA chunked data.
+  @param[out] Context     The decompression state to initialize.
+
+  @retval  RETURN_SUCCESS            The header is valid.
+  @retval  RETURN_INVALID_PARAMETER  The data is not in a valid LZMA chunked format.
+
+**/
+RETURN_STATUS
+LzmaChunkedParseHeader (
+  IN  CONST VOID            *Source,
+  IN  UINTN                 SourceSize,
+  OUT LZMA_CHUNKED_CONTEXT  *Context
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  UINT32                     DestinationSize;
+
+  if (SourceSize < sizeof (LZMA_CHUNKED_HEADER)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Header = (CONST LZMA_CHUNKED_HEADER *) Source;
+  if ((Header->Signature != LZMA_CHUNKED_SIGNATURE) ||
+      (Header->ChunkSize == 0) ||
+      (Header->UncompressedSize > MAX_UINT32) ||
+      (Header->ChunkCount != (UINT32) DivU64x32 (Header->UncompressedSize + Header->ChunkSize - 1, Header->ChunkSize)) ||
+      (SourceSize - sizeof (LZMA_CHUNKED_HEADER)) / sizeof (UINT32) <= Header->ChunkCount) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Context, sizeof (*Context));
+  Context->Source           = (CONST UINT8 *) Source;
+  Context->SourceSize       = SourceSize;
+  Context->ChunkOffset      = (CONST UINT32 *) (Header + 1);
+  Context->ChunkSize        = Header->ChunkSize;
+  Context->ChunkCount       = Header->ChunkCount;
+  Context->UncompressedSize = (UINT32) Header->UncompressedSize;
+
+  if (Context->ChunkCount != 0) {
+    if ((Context->ChunkOffset[0] > SourceSize) ||
+        (SourceSize - Context->ChunkOffset[0] < LZMA_CHUNK_HEADER_SIZE)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    LzmaUefiDecompressGetInfo (
+      Context->Source + Context->ChunkOffset[0],
+      (UINT32) (SourceSize - Context->ChunkOffset[0]),
+      &DestinationSize,
+      &Context->ScratchSize
+      );
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses chunks of Context until there are none left or one fails.
+
+  This function may run on several processors at the same time. It must not
+  use any PEI or DXE services.
+
+  @param[in, out]  Context  The chunked decompression state.
+  @param[in]       Scratch  The scratch buffer of this worker, of Context->ScratchSize bytes.
+
+**/
+VOID
+LzmaChunkedDecodeChunks (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN     VOID                  *Scratch
+  )
+{
+  UINT32         Index;
+  UINT32         Start;
+  UINT32         End;
+  UINT32         Expected;
+  UINT32         DestinationSize;
+  UINT32         ScratchSize;
+  RETURN_STATUS  Status;
+
+  while (Context->Failed == 0) {
+    Index = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Index >= Context->ChunkCount) {
+      break;
+    }
+
+    Start    = Context->ChunkOffset[Index];
+    End      = Context->ChunkOffset[Index + 1];
+    Expected = MIN (Context->ChunkSize, Context->UncompressedSize - Index * Context->ChunkSize);
+    if ((End > Context->SourceSize) || (Start > End) || (End - Start < LZMA_CHUNK_HEADER_SIZE)) {
+      Context->Failed = 1;
+      break;
+    }
+
+    LzmaUefiDecompressGetInfo (Context->Source + Start, End - Start, &DestinationSize, &ScratchSize);
+    if ((DestinationSize != Expected) || (ScratchSize > Context->ScratchSize)) {
+      Context->Failed = 1;
+      break;
+    }
+
+    Status = LzmaUefiDecompress (
+               Context->Source + Start,
+               End - Start,
+               Context->Destination + (UINTN) Index * Context->ChunkSize,
+               Scratch
+               );
+    if (RETURN_ERROR (Status)) {
+      Context->Failed = 1;
+      break;
+    }
+  }
+}
+
+/**
+  Examines a GUIDed section and returns the size of the decoded buffer and the
+  size of an scratch buffer required to actually decode the data in a GUIDed section.
+
+  Examines a GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports,
+  then RETURN_UNSUPPORTED is returned.
+  If the required information can not be retrieved from InputSection,
+  then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports,
+  then the size required to hold the decoded buffer is returned in OututBufferSize,
+  the size of an optional scratch buffer is returned in ScratchSize, and the Attributes field
+  from EFI_GUID_DEFINED_SECTION header of InputSection is returned in SectionAttribute.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBufferSize is NULL, then ASSERT().
+  If ScratchBufferSize is NULL, then ASSERT().
+  If SectionAttribute is NULL, then ASSERT().
+
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section. See the Attributes
+                                 field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  LZMA_CHUNKED_CONTEXT  Context;
+  RETURN_STATUS         Status;
+
+  ASSERT (InputSection != NULL);
+  ASSERT (OutputBufferSize != NULL);
+  ASSERT (ScratchBufferSize != NULL);
+  ASSERT (SectionAttribute != NULL);
+
+  if (IS_SECTION2 (InputSection)) {
+    if (!CompareGuid (
+        &gLzmaChunkedCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    *SectionAttribute = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->Attributes;
+
+    Status = LzmaChunkedParseHeader (
+               (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
+               SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
+               &Context
+               );
+  } else {
+    if (!CompareGuid (
+        &gLzmaChunkedCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    *SectionAttribute = ((EFI_GUID_DEFINED_SECTION *) InputSection)->Attributes;
+
+    Status = LzmaChunkedParseHeader (
+               (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
+               SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
+               &Context
+               );
+  }
+
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  *OutputBufferSize  = Context.UncompressedSize;
+  *ScratchBufferSize = Context.ScratchSize * LzmaChunkedGetMaxWorkerCount (Context.ChunkCount);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress a LZMA chunked GUIDed section into a caller allocated output buffer.
+
+  Decodes the GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports, then RETURN_UNSUPPORTED is returned.
+  If the data in InputSection can not be decoded, then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports, then InputSection
+  is decoded into the buffer specified by OutputBuffer and the authentication status of this
+  decode operation is returned in AuthenticationStatus.  If the decoded buffer is identical to the
+  data in InputSection, then OutputBuffer is set to point at the data in InputSection.  Otherwise,
+  the decoded data will be placed in caller allocated buffer specified by OutputBuffer.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBuffer is NULL, then ASSERT().
+  If ScratchBuffer is NULL and this decode operation requires a scratch buffer, then ASSERT().
+  If AuthenticationStatus is NULL, then ASSERT().
+
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer that may be required by this function
+                            as a scratch buffer to perform the decode operation.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+                            See the definition of authentication status in the EFI_PEI_GUIDED_SECTION_EXTRACTION_PPI
+                            section of the PI Specification. EFI_AUTH_STATUS_PLATFORM_OVERRIDE must
+                            never be set by this handler.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer,        OPTIONAL
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  EFI_GUID              *InputGuid;
+  VOID                  *Source;
+  UINTN                 SourceSize;
+  RETURN_STATUS         Status;
+  LZMA_CHUNKED_CONTEXT  Context;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+
+  if (IS_SECTION2 (InputSection)) {
+    InputGuid  = &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid);
+    Source     = (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset;
+    SourceSize = SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset;
+  } else {
+    InputGuid  = &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid);
+    Source     = (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset;
+    SourceSize = SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset;
+  }
+
+  if (!CompareGuid (&gLzmaChunkedCustomDecompressGuid, InputGuid)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Authentication is set to Zero, which may be ignored.
+  //
+  *AuthenticationStatus = 0;
+
+  Status = LzmaChunkedParseHeader (Source, SourceSize, &Context);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+  if (Context.ChunkCount == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  ASSERT (ScratchBuffer != NULL);
+  Context.Destination = (UINT8 *) *OutputBuffer;
+  Context.Scratch     = (UINT8 *) ScratchBuffer;
+
+  //
+  // The scratch buffer was sized by GetInfo for LzmaChunkedGetMaxWorkerCount()
+  // slots. Never start more workers than that, whatever processors have
+  // become available since.
+  //
+  Context.WorkerCount = MIN (
+                          LzmaChunkedGetWorkerCount (Context.ChunkCount),
+                          LzmaChunkedGetMaxWorkerCount (Context.ChunkCount)
+                          );
+
+  //
+  // The other workers use scratch slots 1 .. WorkerCount - 1, slot 0 is used
+  // here for the chunks they left over.
+  //
+  LzmaChunkedStartWorkers (&Context);
+  LzmaChunkedDecodeChunks (&Context, Context.Scratch);
+
+  if (Context.Failed != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  return RETURN_SUCCESS;
+}
+
+/**
+  Register LzmaChunkedGuidedSectionGetInfo and LzmaChunkedGuidedSectionExtraction
+  handlers with LzmaChunkedCustomDecompressGuid.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+LzmaChunkedDecompressLibConstructor (
+  VOID
+  )
+{
+  return ExtractGuidedSectionRegisterHandlers (
+          &gLzmaChunkedCustomDecompressGuid,
+          LzmaChunkedGuidedSectionGetInfo,
+          LzmaChunkedGuidedSectionExtraction
+          );
+}
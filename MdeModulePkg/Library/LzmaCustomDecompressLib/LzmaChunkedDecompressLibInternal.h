@@ -0,0 +1,110 @@
+/** @file
+  Internal definitions shared by the LZMA chunked decompress library instances.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __LZMA_CHUNKED_DECOMPRESS_LIB_INTERNAL_H__
+#define __LZMA_CHUNKED_DECOMPRESS_LIB_INTERNAL_H__
+
+#include "LzmaDecompressLibInternal.h"
+#include <Library/SynchronizationLib.h>
+
+///
+/// Upper limit of the processors decompressing chunks at the same time.
+/// Each of them needs its own scratch buffer.
+///
+#define LZMA_CHUNKED_MAX_WORKERS  16
+
+///
+/// Size of the header of each chunk: the LZMA properties and the 64-bit
+/// uncompressed size.
+///
+#define LZMA_CHUNK_HEADER_SIZE    (5 + 8)
+
+///
+/// State of one chunked decompression, shared by all processors working on it.
+///
+typedef struct {
+  CONST UINT8       *Source;
+  UINTN             SourceSize;
+  CONST UINT32      *ChunkOffset;
+  UINT32            ChunkSize;
+  UINT32            ChunkCount;
+  UINT32            UncompressedSize;
+  UINT8             *Destination;
+  UINT8             *Scratch;
+  UINT32            ScratchSize;
+  UINT32            WorkerCount;
+  volatile UINT32   NextWorker;
+  volatile UINT32   NextChunk;
+  volatile UINT32   Failed;
+} LZMA_CHUNKED_CONTEXT;
+
+/**
+  Returns the number of processors which may decompress chunks at the same time,
+  including the calling processor.
+
+  @param[in]  ChunkCount  The number of chunks to decompress.
+
+  @return The number of workers, in the range 1 to LZMA_CHUNKED_MAX_WORKERS.
+
+**/
+UINT32
+LzmaChunkedGetWorkerCount (
+  IN UINT32  ChunkCount
+  );
+
+/**
+  Returns the largest number of workers LzmaChunkedGetWorkerCount() may return
+  for ChunkCount chunks, whichever processors are available.
+
+  The scratch buffer has one slot per worker. It is sized in GetInfo with this
+  value, which does not change if processors become available before the
+  extraction.
+
+  @param[in]  ChunkCount  The number of chunks to decompress.
+
+  @return The largest number of workers, in the range 1 to LZMA_CHUNKED_MAX_WORKERS.
+
+**/
+UINT32
+LzmaChunkedGetMaxWorkerCount (
+  IN UINT32  ChunkCount
+  );
+
+/**
+  Starts the other workers on Context and waits for them to finish.
+
+  Each worker claims a scratch slot by incrementing Context->NextWorker, and
+  then calls LzmaChunkedDecodeChunks(). Slot 0 belongs to the calling processor,
+  which runs LzmaChunkedDecodeChunks() itself once this function returns, so
+  nothing needs to be done if no other processor is available.
+
+  @param[in, out]  Context  The chunked decompression state.
+
+**/
+VOID
+LzmaChunkedStartWorkers (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context
+  );
+
+/**
+  Decompresses chunks of Context until there are none left or one fails.
+
+  This function may run on several processors at the same time. It must not
+  use any PEI or DXE services.
+
+  @param[in, out]  Context  The chunked decompression state.
+  @param[in]       Scratch  The scratch buffer of this worker, of Context->ScratchSize bytes.
+
+**/
+VOID
+LzmaChunkedDecodeChunks (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN     VOID                  *Scratch
+  );
+
+#endif
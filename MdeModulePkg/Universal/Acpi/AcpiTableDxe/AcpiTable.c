@@ -67,6 +67,8 @@ InitializeAcpiTableDxe (
                     &PrivateData->AcpiTableProtocol,
                     &gEfiAcpiSdtProtocolGuid,
                     &mPrivateData->AcpiSdtProtocol,
+                    &gEdkiiAcpiTableBatchProtocolGuid,
+                    &PrivateData->AcpiTableBatchProtocol,
                     NULL
                     );
   } else {
@@ -74,6 +76,8 @@ InitializeAcpiTableDxe (
                     &mHandle,
                     &gEfiAcpiTableProtocolGuid,
                     &PrivateData->AcpiTableProtocol,
+                    &gEdkiiAcpiTableBatchProtocolGuid,
+                    &PrivateData->AcpiTableBatchProtocol,
                     NULL
                     );
   }
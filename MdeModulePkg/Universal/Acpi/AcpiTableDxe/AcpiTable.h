@@ -15,6 +15,7 @@
 #include <Protocol/AcpiTable.h>
 #include <Guid/Acpi.h>
 #include <Protocol/AcpiSystemDescriptionTable.h>
+#include <Protocol/AcpiTableBatch.h>
 
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
@@ -24,6 +25,7 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // Statements that include other files
@@ -110,6 +112,9 @@ typedef struct {
   EFI_ACPI_TABLE_PROTOCOL                       AcpiTableProtocol;
   EFI_ACPI_SDT_PROTOCOL                         AcpiSdtProtocol;
   LIST_ENTRY                                    NotifyList;
+  EDKII_ACPI_TABLE_BATCH_PROTOCOL               AcpiTableBatchProtocol;
+  UINTN                                         BatchDepth;             // Nesting level of the current batch
+  BOOLEAN                                       PublishPending;         // Tables changed in the current batch
 } EFI_ACPI_TABLE_INSTANCE;
 
 //
@@ -122,6 +127,16 @@ typedef struct {
       EFI_ACPI_TABLE_SIGNATURE \
       )
 
+//
+// ACPI table batch protocol instance containing record macro
+//
+#define EFI_ACPI_TABLE_INSTANCE_FROM_BATCH(a) \
+  CR (a, \
+      EFI_ACPI_TABLE_INSTANCE, \
+      AcpiTableBatchProtocol, \
+      EFI_ACPI_TABLE_SIGNATURE \
+      )
+
 //
 // Protocol Constructor functions
 //
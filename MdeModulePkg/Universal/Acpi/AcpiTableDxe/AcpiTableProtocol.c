@@ -178,6 +178,31 @@ PublishTables (
   return EFI_SUCCESS;
 }
 
+/**
+  Publish the ACPI tables after they have changed, unless a batch of table
+  installations is in progress. In that case they are published when the
+  batch is committed.
+
+  @param  AcpiTableInstance  Instance of the protocol.
+  @param  Version            Version(s) to publish.
+
+  @return EFI_SUCCESS  The function completed successfully.
+  @return EFI_ABORTED  The function could not complete successfully.
+
+**/
+EFI_STATUS
+PublishChangedTables (
+  IN EFI_ACPI_TABLE_INSTANCE              *AcpiTableInstance,
+  IN EFI_ACPI_TABLE_VERSION               Version
+  )
+{
+  if (AcpiTableInstance->BatchDepth != 0) {
+    AcpiTableInstance->PublishPending = TRUE;
+    return EFI_SUCCESS;
+  }
+
+  return PublishTables (AcpiTableInstance, Version);
+}
 
 /**
   Installs an ACPI table into the RSDT/XSDT.
@@ -228,6 +253,12 @@ InstallAcpiTable (
   //
   AcpiTableInstance = EFI_ACPI_TABLE_INSTANCE_FROM_THIS (This);
 
+  //
+  // The time spent installing the ACPI tables is the sum of the
+  // "AcpiTableInstall" and "AcpiTableCommitBatch" measurements.
+  //
+  PERF_INMODULE_BEGIN ("AcpiTableInstall");
+
   //
   // Install the ACPI table
   //
@@ -241,13 +272,15 @@ InstallAcpiTable (
              TableKey
              );
   if (!EFI_ERROR (Status)) {
-    Status = PublishTables (
+    Status = PublishChangedTables (
                AcpiTableInstance,
                Version
                );
   }
   FreePool (AcpiTableBufferConst);
 
+  PERF_INMODULE_END ("AcpiTableInstall");
+
   //
   // Add a new table successfully, notify registed callback
   //
@@ -302,7 +335,7 @@ UninstallAcpiTable (
              TableKey
              );
   if (!EFI_ERROR (Status)) {
-    Status = PublishTables (
+    Status = PublishChangedTables (
                AcpiTableInstance,
                Version
                );
@@ -319,6 +352,7 @@ UninstallAcpiTable (
   If the number of APCI tables exceeds the preallocated max table number, enlarge the table buffer.
 
   @param  AcpiTableInstance       ACPI table protocol instance data structure.
+  @param  NewMaxTableNumber       The new max table number, greater than mEfiAcpiMaxNumTables.
 
   @return EFI_SUCCESS             reallocate the table beffer successfully.
   @return EFI_OUT_OF_RESOURCES    Unable to allocate required resources.
@@ -326,10 +360,10 @@ UninstallAcpiTable (
 **/
 EFI_STATUS
 ReallocateAcpiTableBuffer (
-  IN EFI_ACPI_TABLE_INSTANCE                   *AcpiTableInstance
+  IN EFI_ACPI_TABLE_INSTANCE                   *AcpiTableInstance,
+  IN UINTN                                     NewMaxTableNumber
   )
 {
-  UINTN                    NewMaxTableNumber;
   UINTN                    TotalSize;
   UINT8                    *Pointer;
   EFI_PHYSICAL_ADDRESS     PageAddress;
@@ -337,12 +371,10 @@ ReallocateAcpiTableBuffer (
   EFI_STATUS               Status;
   UINT64                   CurrentData;
 
+  ASSERT (NewMaxTableNumber > mEfiAcpiMaxNumTables);
+
   CopyMem (&TempPrivateData, AcpiTableInstance, sizeof (EFI_ACPI_TABLE_INSTANCE));
   //
-  // Enlarge the max table number from mEfiAcpiMaxNumTables to mEfiAcpiMaxNumTables + EFI_ACPI_MAX_NUM_TABLES
-  //
-  NewMaxTableNumber = mEfiAcpiMaxNumTables + EFI_ACPI_MAX_NUM_TABLES;
-  //
   // Create RSDT, XSDT structures and allocate buffers.
   //
   TotalSize = sizeof (EFI_ACPI_DESCRIPTION_HEADER) +         // for ACPI 2.0/3.0 XSDT
@@ -428,6 +460,127 @@ ReallocateAcpiTableBuffer (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the max table number to enlarge the table buffer to when it is full.
+
+  Within a batch of table installations, the size of the table buffer is
+  doubled so that installing many tables only reallocates it a few times.
+
+  @param  AcpiTableInstance       ACPI table protocol instance data structure.
+
+  @return The new max table number.
+
+**/
+UINTN
+GetNextMaxTableNumber (
+  IN EFI_ACPI_TABLE_INSTANCE                   *AcpiTableInstance
+  )
+{
+  if (AcpiTableInstance->BatchDepth != 0) {
+    return mEfiAcpiMaxNumTables * 2;
+  }
+
+  return mEfiAcpiMaxNumTables + EFI_ACPI_MAX_NUM_TABLES;
+}
+
+/**
+  Starts a batch of ACPI table installations.
+
+  Batches may be nested. The tables are published when the outermost batch is
+  committed.
+
+  @param  This                  A pointer to the EDKII_ACPI_TABLE_BATCH_PROTOCOL instance.
+  @param  TableCount            The number of tables the caller expects to
+                                install in the batch, used to reserve the
+                                RSDT/XSDT entries at once. 0 if unknown.
+
+  @retval EFI_SUCCESS           The batch is started.
+  @retval EFI_OUT_OF_RESOURCES  The RSDT/XSDT entries can't be reserved. The
+                                batch is not started.
+
+**/
+EFI_STATUS
+EFIAPI
+AcpiTableBeginBatch (
+  IN EDKII_ACPI_TABLE_BATCH_PROTOCOL   *This,
+  IN UINTN                             TableCount
+  )
+{
+  EFI_ACPI_TABLE_INSTANCE   *AcpiTableInstance;
+  EFI_STATUS                Status;
+  UINTN                     TableNumber;
+
+  AcpiTableInstance = EFI_ACPI_TABLE_INSTANCE_FROM_BATCH (This);
+
+  //
+  // Reserve the RSDT/XSDT entries for all the tables of the batch now,
+  // in multiples of EFI_ACPI_MAX_NUM_TABLES.
+  //
+  TableNumber = MAX (AcpiTableInstance->NumberOfTableEntries1, AcpiTableInstance->NumberOfTableEntries3) + TableCount;
+  if (TableNumber > mEfiAcpiMaxNumTables) {
+    TableNumber = ((TableNumber + EFI_ACPI_MAX_NUM_TABLES - 1) / EFI_ACPI_MAX_NUM_TABLES) * EFI_ACPI_MAX_NUM_TABLES;
+    Status = ReallocateAcpiTableBuffer (AcpiTableInstance, TableNumber);
+    if (EFI_ERROR (Status)) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    //
+    // The RSDP now points to the new RSDT/XSDT. Update its checksum now, as it
+    // may already be published, and publish it again when the batch is
+    // committed.
+    //
+    ChecksumCommonTables (AcpiTableInstance);
+    AcpiTableInstance->PublishPending = TRUE;
+  }
+
+  AcpiTableInstance->BatchDepth++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Ends a batch of ACPI table installations. When the outermost batch ends,
+  the RSDP, RSDT and XSDT are checksummed and the RSDP is installed in the
+  EFI System Table.
+
+  @param  This                  A pointer to the EDKII_ACPI_TABLE_BATCH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The batch is ended.
+  @retval EFI_NOT_STARTED       No batch is in progress.
+  @retval EFI_ABORTED           The tables can't be published.
+
+**/
+EFI_STATUS
+EFIAPI
+AcpiTableCommitBatch (
+  IN EDKII_ACPI_TABLE_BATCH_PROTOCOL   *This
+  )
+{
+  EFI_ACPI_TABLE_INSTANCE   *AcpiTableInstance;
+  EFI_STATUS                Status;
+
+  AcpiTableInstance = EFI_ACPI_TABLE_INSTANCE_FROM_BATCH (This);
+
+  if (AcpiTableInstance->BatchDepth == 0) {
+    return EFI_NOT_STARTED;
+  }
+
+  AcpiTableInstance->BatchDepth--;
+  if ((AcpiTableInstance->BatchDepth != 0) || !AcpiTableInstance->PublishPending) {
+    return EFI_SUCCESS;
+  }
+
+  PERF_INMODULE_BEGIN ("AcpiTableCommitBatch");
+
+  AcpiTableInstance->PublishPending = FALSE;
+  Status = PublishTables (
+             AcpiTableInstance,
+             PcdGet32 (PcdAcpiExposedTableVersions)
+             );
+
+  PERF_INMODULE_END ("AcpiTableCommitBatch");
+  return Status;
+}
+
 /**
   This function adds an ACPI table to the table list.  It will detect FACS and
   allocate the correct type of memory and properly align the table.
@@ -939,7 +1092,7 @@ AddTableToList (
       // If the table number exceed the gEfiAcpiMaxNumTables, enlarge the table buffer
       //
       if (AcpiTableInstance->NumberOfTableEntries1 >= mEfiAcpiMaxNumTables) {
-        Status = ReallocateAcpiTableBuffer (AcpiTableInstance);
+        Status = ReallocateAcpiTableBuffer (AcpiTableInstance, GetNextMaxTableNumber (AcpiTableInstance));
         ASSERT_EFI_ERROR (Status);
       }
       CurrentRsdtEntry = (UINT32 *)
@@ -972,7 +1125,7 @@ AddTableToList (
       // If the table number exceed the gEfiAcpiMaxNumTables, enlarge the table buffer
       //
       if (AcpiTableInstance->NumberOfTableEntries3 >= mEfiAcpiMaxNumTables) {
-        Status = ReallocateAcpiTableBuffer (AcpiTableInstance);
+        Status = ReallocateAcpiTableBuffer (AcpiTableInstance, GetNextMaxTableNumber (AcpiTableInstance));
         ASSERT_EFI_ERROR (Status);
       }
 
@@ -1032,7 +1185,12 @@ AddTableToList (
     }
   }
 
-  ChecksumCommonTables (AcpiTableInstance);
+  //
+  // The common tables are checksummed once when a batch is committed.
+  //
+  if (AcpiTableInstance->BatchDepth == 0) {
+    ChecksumCommonTables (AcpiTableInstance);
+  }
   return EFI_SUCCESS;
 }
 
@@ -1682,6 +1840,9 @@ AcpiTableAcpiTableConstructor (
   AcpiTableInstance->AcpiTableProtocol.InstallAcpiTable   = InstallAcpiTable;
   AcpiTableInstance->AcpiTableProtocol.UninstallAcpiTable = UninstallAcpiTable;
 
+  AcpiTableInstance->AcpiTableBatchProtocol.BeginBatch    = AcpiTableBeginBatch;
+  AcpiTableInstance->AcpiTableBatchProtocol.CommitBatch   = AcpiTableCommitBatch;
+
   if (FeaturePcdGet (PcdInstallAcpiSdtProtocol)) {
     SdtAcpiTableAcpiSdtConstructor (AcpiTableInstance);
   }
@@ -635,6 +635,10 @@ Error:
       FreePool (Private->LineBuffer);
     }
 
+    if (Private->ShadowBuffer != NULL) {
+      FreePool (Private->ShadowBuffer);
+    }
+
     if (Private->ModeData != NULL) {
       FreePool (Private->ModeData);
     }
@@ -723,6 +727,10 @@ GraphicsConsoleControllerDriverStop (
       FreePool (Private->LineBuffer);
     }
 
+    if (Private->ShadowBuffer != NULL) {
+      FreePool (Private->ShadowBuffer);
+    }
+
     if (Private->ModeData != NULL) {
       FreePool (Private->ModeData);
     }
@@ -940,6 +948,7 @@ GraphicsConsoleConOutOutputString (
   Private   = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
   GraphicsOutput = Private->GraphicsOutput;
   UgaDraw   = Private->UgaDraw;
+  Private->OutputStringDepth++;
 
   MaxColumn = Private->ModeData[Mode].Columns;
   MaxRow    = Private->ModeData[Mode].Rows;
@@ -997,6 +1006,13 @@ GraphicsConsoleConOutOutputString (
       // down one row.
       //
       if (This->Mode->CursorRow == (INT32) (MaxRow - 1)) {
+        //
+        // The screen is scrolled as it is, with the pixels other users of the
+        // display may have drawn in the text area, so the text drawn in the
+        // shadow buffer has to reach the screen first.
+        //
+        FlushShadowBuffer (This);
+
         if (GraphicsOutput != NULL) {
           //
           // Scroll Screen Up One Row
@@ -1154,6 +1170,11 @@ GraphicsConsoleConOutOutputString (
 
   FlushCursor (This);
 
+  Private->OutputStringDepth--;
+  if (Private->OutputStringDepth == 0) {
+    FlushShadowBuffer (This);
+  }
+
   if (Warning) {
     Status = EFI_WARN_UNKNOWN_GLYPH;
   }
@@ -1300,6 +1321,7 @@ GraphicsConsoleConOutSetMode (
   GRAPHICS_CONSOLE_DEV            *Private;
   GRAPHICS_CONSOLE_MODE_DATA      *ModeData;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *NewLineBuffer;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL   *NewShadowBuffer;
   UINT32                          HorizontalResolution;
   UINT32                          VerticalResolution;
   EFI_GRAPHICS_OUTPUT_PROTOCOL    *GraphicsOutput;
@@ -1313,6 +1335,7 @@ GraphicsConsoleConOutSetMode (
   Private   = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
   GraphicsOutput = Private->GraphicsOutput;
   UgaDraw   = Private->UgaDraw;
+  NewShadowBuffer = NULL;
 
   //
   // Make sure the requested mode number is supported
@@ -1351,6 +1374,7 @@ GraphicsConsoleConOutSetMode (
     FlushCursor (This);
 
     FreePool (Private->LineBuffer);
+    Private->LineBuffer = NULL;
   }
 
   //
@@ -1372,6 +1396,19 @@ GraphicsConsoleConOutSetMode (
   //
   Private->LineBuffer = NewLineBuffer;
 
+  //
+  // Attempt to allocate a shadow buffer of the text area for the requested
+  // mode number. It's black like the display cleared below.
+  //
+  NewShadowBuffer = AllocateZeroPool (
+                      sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL) *
+                      ModeData->Columns * EFI_GLYPH_WIDTH * ModeData->Rows * EFI_GLYPH_HEIGHT
+                      );
+  if (NewShadowBuffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
   if (GraphicsOutput != NULL) {
     if (ModeData->GopModeNumber != GraphicsOutput->Mode->Mode) {
       //
@@ -1451,6 +1488,18 @@ GraphicsConsoleConOutSetMode (
   //
   // The new mode is valid, so commit the mode change
   //
+  if (Private->ShadowBuffer != NULL) {
+    FreePool (Private->ShadowBuffer);
+  }
+  Private->ShadowBuffer = NewShadowBuffer;
+  Private->ShadowWidth  = ModeData->Columns * EFI_GLYPH_WIDTH;
+  Private->ShadowHeight = ModeData->Rows * EFI_GLYPH_HEIGHT;
+  Private->DirtyLeft    = 0;
+  Private->DirtyTop     = 0;
+  Private->DirtyRight   = 0;
+  Private->DirtyBottom  = 0;
+  NewShadowBuffer       = NULL;
+
   This->Mode->Mode = (INT32) ModeNumber;
 
   //
@@ -1461,9 +1510,15 @@ GraphicsConsoleConOutSetMode (
 
   FlushCursor (This);
 
+  FlushShadowBuffer (This);
+
   Status = EFI_SUCCESS;
 
 Done:
+  if (NewShadowBuffer != NULL) {
+    FreePool (NewShadowBuffer);
+  }
+
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
@@ -1510,6 +1565,8 @@ GraphicsConsoleConOutSetAttribute (
 
   FlushCursor (This);
 
+  FlushShadowBuffer (This);
+
   gBS->RestoreTPL (OldTpl);
 
   return EFI_SUCCESS;
@@ -1589,11 +1646,21 @@ GraphicsConsoleConOutClearScreen (
     Status = EFI_UNSUPPORTED;
   }
 
+  //
+  // The text drawn in the shadow buffer and not flushed yet is cleared too.
+  //
+  Private->DirtyLeft   = 0;
+  Private->DirtyTop    = 0;
+  Private->DirtyRight  = 0;
+  Private->DirtyBottom = 0;
+
   This->Mode->CursorColumn  = 0;
   This->Mode->CursorRow     = 0;
 
   FlushCursor (This);
 
+  FlushShadowBuffer (This);
+
   gBS->RestoreTPL (OldTpl);
 
   return Status;
@@ -1663,6 +1730,8 @@ GraphicsConsoleConOutSetCursorPosition (
 
   FlushCursor (This);
 
+  FlushShadowBuffer (This);
+
 Done:
   gBS->RestoreTPL (OldTpl);
 
@@ -1708,6 +1777,8 @@ GraphicsConsoleConOutEnableCursor (
 
   FlushCursor (This);
 
+  FlushShadowBuffer (This);
+
   gBS->RestoreTPL (OldTpl);
   return EFI_SUCCESS;
 }
@@ -1742,6 +1813,9 @@ GetTextColors (
 /**
   Draw Unicode string on the Graphics Console device's screen.
 
+  The string is drawn in the shadow buffer, and is copied to the screen by
+  FlushShadowBuffer().
+
   @param  This                  Protocol instance pointer.
   @param  UnicodeWeight         One Unicode string to be displayed.
   @param  Count                 The count of Unicode string.
@@ -1764,18 +1838,25 @@ DrawUnicodeWeightAtCursorN (
   EFI_IMAGE_OUTPUT                  *Blt;
   EFI_STRING                        String;
   EFI_FONT_DISPLAY_INFO             *FontInfo;
-  EFI_UGA_DRAW_PROTOCOL             *UgaDraw;
   EFI_HII_ROW_INFO                  *RowInfoArray;
   UINTN                             RowInfoArraySize;
+  UINTN                             GlyphX;
+  UINTN                             GlyphY;
 
   Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+  if ((Private->GraphicsOutput == NULL) && !FeaturePcdGet (PcdUgaConsumeSupport)) {
+    return EFI_UNSUPPORTED;
+  }
+  ASSERT (Private->ShadowBuffer != NULL);
+
   Blt = (EFI_IMAGE_OUTPUT *) AllocateZeroPool (sizeof (EFI_IMAGE_OUTPUT));
   if (Blt == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Blt->Width        = (UINT16) (Private->ModeData[This->Mode->Mode].GopWidth);
-  Blt->Height       = (UINT16) (Private->ModeData[This->Mode->Mode].GopHeight);
+  Blt->Width        = (UINT16) (Private->ShadowWidth);
+  Blt->Height       = (UINT16) (Private->ShadowHeight);
+  Blt->Image.Bitmap = Private->ShadowBuffer;
 
   String = AllocateCopyPool ((Count + 1) * sizeof (CHAR16), UnicodeWeight);
   if (String == NULL) {
@@ -1798,95 +1879,41 @@ DrawUnicodeWeightAtCursorN (
   //
   GetTextColors (This, &FontInfo->ForegroundColor, &FontInfo->BackgroundColor);
 
-  if (Private->GraphicsOutput != NULL) {
-    //
-    // If Graphics Output protocol exists, using HII Font protocol to draw.
-    //
-    Blt->Image.Screen = Private->GraphicsOutput;
-
-    Status = mHiiFont->StringToImage (
-                         mHiiFont,
-                         EFI_HII_IGNORE_IF_NO_GLYPH | EFI_HII_DIRECT_TO_SCREEN | EFI_HII_IGNORE_LINE_BREAK,
-                         String,
-                         FontInfo,
-                         &Blt,
-                         This->Mode->CursorColumn * EFI_GLYPH_WIDTH + Private->ModeData[This->Mode->Mode].DeltaX,
-                         This->Mode->CursorRow * EFI_GLYPH_HEIGHT + Private->ModeData[This->Mode->Mode].DeltaY,
-                         NULL,
-                         NULL,
-                         NULL
-                         );
+  GlyphX = This->Mode->CursorColumn * EFI_GLYPH_WIDTH;
+  GlyphY = This->Mode->CursorRow * EFI_GLYPH_HEIGHT;
+
+  RowInfoArray = NULL;
+  Status = mHiiFont->StringToImage (
+                        mHiiFont,
+                        EFI_HII_IGNORE_IF_NO_GLYPH | EFI_HII_IGNORE_LINE_BREAK,
+                        String,
+                        FontInfo,
+                        &Blt,
+                        GlyphX,
+                        GlyphY,
+                        &RowInfoArray,
+                        &RowInfoArraySize,
+                        NULL
+                        );
 
-  } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
+  if (!EFI_ERROR (Status)) {
     //
-    // If Graphics Output protocol cannot be found and PcdUgaConsumeSupport enabled,
-    // using UGA Draw protocol to draw.
+    // Line breaks are handled by caller of DrawUnicodeWeightAtCursorN, so the updated parameter RowInfoArraySize by StringToImage will
+    // always be 1 or 0 (if there is no valid Unicode Char can be printed). ASSERT here to make sure.
     //
-    ASSERT (Private->UgaDraw!= NULL);
-
-    UgaDraw = Private->UgaDraw;
+    ASSERT (RowInfoArraySize <= 1);
 
-    Blt->Image.Bitmap = AllocateZeroPool (Blt->Width * Blt->Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-    if (Blt->Image.Bitmap == NULL) {
-      FreePool (Blt);
-      FreePool (String);
-      return EFI_OUT_OF_RESOURCES;
+    if (RowInfoArraySize != 0) {
+      MarkShadowBufferDirty (Private, GlyphX, GlyphY, RowInfoArray[0].LineWidth, RowInfoArray[0].LineHeight);
     }
-
-    RowInfoArray = NULL;
-    //
-    //  StringToImage only support blt'ing image to device using GOP protocol. If GOP is not supported in this platform,
-    //  we ask StringToImage to print the string to blt buffer, then blt to device using UgaDraw.
-    //
-    Status = mHiiFont->StringToImage (
-                          mHiiFont,
-                          EFI_HII_IGNORE_IF_NO_GLYPH | EFI_HII_IGNORE_LINE_BREAK,
-                          String,
-                          FontInfo,
-                          &Blt,
-                          This->Mode->CursorColumn * EFI_GLYPH_WIDTH + Private->ModeData[This->Mode->Mode].DeltaX,
-                          This->Mode->CursorRow * EFI_GLYPH_HEIGHT + Private->ModeData[This->Mode->Mode].DeltaY,
-                          &RowInfoArray,
-                          &RowInfoArraySize,
-                          NULL
-                          );
-
-    if (!EFI_ERROR (Status)) {
-      //
-      // Line breaks are handled by caller of DrawUnicodeWeightAtCursorN, so the updated parameter RowInfoArraySize by StringToImage will
-      // always be 1 or 0 (if there is no valid Unicode Char can be printed). ASSERT here to make sure.
-      //
-      ASSERT (RowInfoArraySize <= 1);
-
-      Status = UgaDraw->Blt (
-                          UgaDraw,
-                          (EFI_UGA_PIXEL *) Blt->Image.Bitmap,
-                          EfiUgaBltBufferToVideo,
-                          This->Mode->CursorColumn * EFI_GLYPH_WIDTH  + Private->ModeData[This->Mode->Mode].DeltaX,
-                          (This->Mode->CursorRow) * EFI_GLYPH_HEIGHT + Private->ModeData[This->Mode->Mode].DeltaY,
-                          This->Mode->CursorColumn * EFI_GLYPH_WIDTH  + Private->ModeData[This->Mode->Mode].DeltaX,
-                          (This->Mode->CursorRow) * EFI_GLYPH_HEIGHT + Private->ModeData[This->Mode->Mode].DeltaY,
-                          RowInfoArray[0].LineWidth,
-                          RowInfoArray[0].LineHeight,
-                          Blt->Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
-                          );
-    }
-
-    FreePool (RowInfoArray);
-    FreePool (Blt->Image.Bitmap);
-  } else {
-    Status = EFI_UNSUPPORTED;
   }
 
-  if (Blt != NULL) {
-    FreePool (Blt);
-  }
-  if (String != NULL) {
-    FreePool (String);
-  }
-  if (FontInfo != NULL) {
-    FreePool (FontInfo);
+  if (RowInfoArray != NULL) {
+    FreePool (RowInfoArray);
   }
+  FreePool (Blt);
+  FreePool (String);
+  FreePool (FontInfo);
   return Status;
 }
 
@@ -1898,6 +1925,9 @@ DrawUnicodeWeightAtCursorN (
      i) If the cursor shows on screen, it will be erased.
     ii) If the cursor does not show on screen, it will be shown.
 
+  The cursor is drawn in the shadow buffer, and is copied to the screen by
+  FlushShadowBuffer().
+
   @param  This                  Protocol instance pointer.
 
   @retval EFI_SUCCESS           The cursor is erased successfully.
@@ -1910,13 +1940,12 @@ FlushCursor (
 {
   GRAPHICS_CONSOLE_DEV                *Private;
   EFI_SIMPLE_TEXT_OUTPUT_MODE         *CurrentMode;
-  INTN                                GlyphX;
-  INTN                                GlyphY;
-  EFI_GRAPHICS_OUTPUT_PROTOCOL        *GraphicsOutput;
-  EFI_UGA_DRAW_PROTOCOL               *UgaDraw;
+  GRAPHICS_CONSOLE_MODE_DATA          *ModeData;
+  UINTN                               GlyphX;
+  UINTN                               GlyphY;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION Foreground;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION Background;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION BltChar[EFI_GLYPH_HEIGHT][EFI_GLYPH_WIDTH];
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *BltChar;
   UINTN                               PosX;
   UINTN                               PosY;
 
@@ -1927,43 +1956,63 @@ FlushCursor (
   }
 
   Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
-  GraphicsOutput = Private->GraphicsOutput;
-  UgaDraw = Private->UgaDraw;
+  if (Private->ShadowBuffer == NULL) {
+    return EFI_SUCCESS;
+  }
 
   //
   // In this driver, only narrow character was supported.
   //
+  GlyphX  = CurrentMode->CursorColumn * EFI_GLYPH_WIDTH;
+  GlyphY  = CurrentMode->CursorRow * EFI_GLYPH_HEIGHT;
+
   //
-  // Blt a character to the screen
+  // The cursor may be right after the last column, out of the text area.
   //
-  GlyphX  = (CurrentMode->CursorColumn * EFI_GLYPH_WIDTH) + Private->ModeData[CurrentMode->Mode].DeltaX;
-  GlyphY  = (CurrentMode->CursorRow * EFI_GLYPH_HEIGHT) + Private->ModeData[CurrentMode->Mode].DeltaY;
-  if (GraphicsOutput != NULL) {
-    GraphicsOutput->Blt (
-              GraphicsOutput,
-              (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) BltChar,
-              EfiBltVideoToBltBuffer,
-              GlyphX,
-              GlyphY,
-              0,
-              0,
-              EFI_GLYPH_WIDTH,
-              EFI_GLYPH_HEIGHT,
-              EFI_GLYPH_WIDTH * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
-              );
-  } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
-    UgaDraw->Blt (
-              UgaDraw,
-              (EFI_UGA_PIXEL *) (UINTN) BltChar,
-              EfiUgaVideoToBltBuffer,
-              GlyphX,
-              GlyphY,
-              0,
-              0,
-              EFI_GLYPH_WIDTH,
-              EFI_GLYPH_HEIGHT,
-              EFI_GLYPH_WIDTH * sizeof (EFI_UGA_PIXEL)
-              );
+  if ((GlyphX + EFI_GLYPH_WIDTH > Private->ShadowWidth) ||
+      (GlyphY + EFI_GLYPH_HEIGHT > Private->ShadowHeight)) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Unless the cell is drawn in the shadow buffer and not flushed yet, take
+  // it from the screen, where other users of the display may have drawn.
+  //
+  if ((GlyphX < Private->DirtyLeft) || (GlyphX + EFI_GLYPH_WIDTH > Private->DirtyRight) ||
+      (GlyphY < Private->DirtyTop) || (GlyphY + EFI_GLYPH_HEIGHT > Private->DirtyBottom)) {
+    if ((GlyphX < Private->DirtyRight) && (GlyphX + EFI_GLYPH_WIDTH > Private->DirtyLeft) &&
+        (GlyphY < Private->DirtyBottom) && (GlyphY + EFI_GLYPH_HEIGHT > Private->DirtyTop)) {
+      FlushShadowBuffer (This);
+    }
+
+    ModeData = &(Private->ModeData[CurrentMode->Mode]);
+    if (Private->GraphicsOutput != NULL) {
+      Private->GraphicsOutput->Blt (
+                                 Private->GraphicsOutput,
+                                 Private->ShadowBuffer,
+                                 EfiBltVideoToBltBuffer,
+                                 ModeData->DeltaX + GlyphX,
+                                 ModeData->DeltaY + GlyphY,
+                                 GlyphX,
+                                 GlyphY,
+                                 EFI_GLYPH_WIDTH,
+                                 EFI_GLYPH_HEIGHT,
+                                 Private->ShadowWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+                                 );
+    } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
+      Private->UgaDraw->Blt (
+                          Private->UgaDraw,
+                          (EFI_UGA_PIXEL *) Private->ShadowBuffer,
+                          EfiUgaVideoToBltBuffer,
+                          ModeData->DeltaX + GlyphX,
+                          ModeData->DeltaY + GlyphY,
+                          GlyphX,
+                          GlyphY,
+                          EFI_GLYPH_WIDTH,
+                          EFI_GLYPH_HEIGHT,
+                          Private->ShadowWidth * sizeof (EFI_UGA_PIXEL)
+                          );
+    }
   }
 
   GetTextColors (This, &Foreground.Pixel, &Background.Pixel);
@@ -1972,42 +2021,136 @@ FlushCursor (
   // Convert Monochrome bitmap of the Glyph to BltBuffer structure
   //
   for (PosY = 0; PosY < EFI_GLYPH_HEIGHT; PosY++) {
+    BltChar = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *) &Private->ShadowBuffer[(GlyphY + PosY) * Private->ShadowWidth + GlyphX];
     for (PosX = 0; PosX < EFI_GLYPH_WIDTH; PosX++) {
       if ((mCursorGlyph.GlyphCol1[PosY] & (BIT0 << PosX)) != 0) {
-        BltChar[PosY][EFI_GLYPH_WIDTH - PosX - 1].Raw ^= Foreground.Raw;
+        BltChar[EFI_GLYPH_WIDTH - PosX - 1].Raw ^= Foreground.Raw;
       }
     }
   }
 
-  if (GraphicsOutput != NULL) {
-    GraphicsOutput->Blt (
-              GraphicsOutput,
-              (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *) BltChar,
-              EfiBltBufferToVideo,
-              0,
-              0,
-              GlyphX,
-              GlyphY,
-              EFI_GLYPH_WIDTH,
-              EFI_GLYPH_HEIGHT,
-              EFI_GLYPH_WIDTH * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
-              );
+  MarkShadowBufferDirty (Private, GlyphX, GlyphY, EFI_GLYPH_WIDTH, EFI_GLYPH_HEIGHT);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Add a rectangle of the shadow buffer to its dirty rectangle.
+
+  The dirty rectangle only ever covers pixels drawn by the console, which
+  are copied to the screen as they are. The pixels around them may have been
+  drawn by other users of the display, so when the rectangle can't just be
+  extended to cover the new one, it is flushed first.
+
+  @param  Private               Graphics Console device.
+  @param  X                     Left of the rectangle in the text area.
+  @param  Y                     Top of the rectangle in the text area.
+  @param  Width                 Width of the rectangle.
+  @param  Height                Height of the rectangle.
+
+**/
+VOID
+MarkShadowBufferDirty (
+  IN  GRAPHICS_CONSOLE_DEV             *Private,
+  IN  UINTN                            X,
+  IN  UINTN                            Y,
+  IN  UINTN                            Width,
+  IN  UINTN                            Height
+  )
+{
+  if ((X >= Private->ShadowWidth) || (Y >= Private->ShadowHeight) || (Width == 0) || (Height == 0)) {
+    return;
+  }
+
+  Width  = MIN (Width, Private->ShadowWidth - X);
+  Height = MIN (Height, Private->ShadowHeight - Y);
+
+  if (Private->DirtyRight != 0) {
+    if ((X >= Private->DirtyLeft) && (X + Width <= Private->DirtyRight) &&
+        (Y >= Private->DirtyTop) && (Y + Height <= Private->DirtyBottom)) {
+      return;
+    }
+
+    //
+    // The text of a row is drawn from left to right, in cells of the same height.
+    //
+    if ((Y == Private->DirtyTop) && (Y + Height == Private->DirtyBottom) &&
+        (X <= Private->DirtyRight) && (X + Width >= Private->DirtyLeft)) {
+      Private->DirtyLeft  = MIN (Private->DirtyLeft, X);
+      Private->DirtyRight = MAX (Private->DirtyRight, X + Width);
+      return;
+    }
+
+    FlushShadowBuffer (&Private->SimpleTextOutput);
+  }
+
+  Private->DirtyLeft   = X;
+  Private->DirtyTop    = Y;
+  Private->DirtyRight  = X + Width;
+  Private->DirtyBottom = Y + Height;
+}
+
+/**
+  Copy the dirty rectangle of the shadow buffer to the screen.
+
+  @param  This                  Protocol instance pointer.
+
+  @retval EFI_SUCCESS           The screen is up to date.
+  @retval Others                The Blt() of the screen failed.
+
+**/
+EFI_STATUS
+FlushShadowBuffer (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
+  )
+{
+  EFI_STATUS                    Status;
+  GRAPHICS_CONSOLE_DEV          *Private;
+  GRAPHICS_CONSOLE_MODE_DATA    *ModeData;
+
+  Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+  if ((Private->ShadowBuffer == NULL) || (Private->DirtyRight == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  ModeData = &(Private->ModeData[This->Mode->Mode]);
+
+  if (Private->GraphicsOutput != NULL) {
+    Status = Private->GraphicsOutput->Blt (
+                                        Private->GraphicsOutput,
+                                        Private->ShadowBuffer,
+                                        EfiBltBufferToVideo,
+                                        Private->DirtyLeft,
+                                        Private->DirtyTop,
+                                        ModeData->DeltaX + Private->DirtyLeft,
+                                        ModeData->DeltaY + Private->DirtyTop,
+                                        Private->DirtyRight - Private->DirtyLeft,
+                                        Private->DirtyBottom - Private->DirtyTop,
+                                        Private->ShadowWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+                                        );
   } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
-    UgaDraw->Blt (
-              UgaDraw,
-              (EFI_UGA_PIXEL *) (UINTN) BltChar,
-              EfiUgaBltBufferToVideo,
-              0,
-              0,
-              GlyphX,
-              GlyphY,
-              EFI_GLYPH_WIDTH,
-              EFI_GLYPH_HEIGHT,
-              EFI_GLYPH_WIDTH * sizeof (EFI_UGA_PIXEL)
-              );
+    Status = Private->UgaDraw->Blt (
+                                 Private->UgaDraw,
+                                 (EFI_UGA_PIXEL *) Private->ShadowBuffer,
+                                 EfiUgaBltBufferToVideo,
+                                 Private->DirtyLeft,
+                                 Private->DirtyTop,
+                                 ModeData->DeltaX + Private->DirtyLeft,
+                                 ModeData->DeltaY + Private->DirtyTop,
+                                 Private->DirtyRight - Private->DirtyLeft,
+                                 Private->DirtyBottom - Private->DirtyTop,
+                                 Private->ShadowWidth * sizeof (EFI_UGA_PIXEL)
+                                 );
+  } else {
+    Status = EFI_UNSUPPORTED;
   }
 
-  return EFI_SUCCESS;
+  Private->DirtyLeft   = 0;
+  Private->DirtyTop    = 0;
+  Private->DirtyRight  = 0;
+  Private->DirtyBottom = 0;
+
+  return Status;
 }
 
 /**
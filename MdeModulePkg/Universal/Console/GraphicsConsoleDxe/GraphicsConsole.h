@@ -65,6 +65,23 @@ typedef struct {
   EFI_SIMPLE_TEXT_OUTPUT_MODE      SimpleTextOutputMode;
   GRAPHICS_CONSOLE_MODE_DATA       *ModeData;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL    *LineBuffer;
+  //
+  // The text is drawn in ShadowBuffer, and the dirty rectangle of ShadowBuffer
+  // is copied to the screen by FlushShadowBuffer(). The rest of ShadowBuffer
+  // may not match the screen, the screen is scrolled and cleared directly.
+  //
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    *ShadowBuffer;
+  UINTN                            ShadowWidth;
+  UINTN                            ShadowHeight;
+  UINTN                            DirtyLeft;
+  UINTN                            DirtyTop;
+  UINTN                            DirtyRight;
+  UINTN                            DirtyBottom;
+  //
+  // OutputString() calls itself for line wrap and backspace. Only the
+  // outermost call flushes the shadow buffer.
+  //
+  UINTN                            OutputStringDepth;
 } GRAPHICS_CONSOLE_DEV;
 
 #define GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS(a) \
@@ -564,6 +581,44 @@ FlushCursor (
   IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
   );
 
+/**
+  Add a rectangle of the shadow buffer to its dirty rectangle.
+
+  The dirty rectangle only ever covers pixels drawn by the console, which
+  are copied to the screen as they are. The pixels around them may have been
+  drawn by other users of the display, so when the rectangle can't just be
+  extended to cover the new one, it is flushed first.
+
+  @param  Private               Graphics Console device.
+  @param  X                     Left of the rectangle in the text area.
+  @param  Y                     Top of the rectangle in the text area.
+  @param  Width                 Width of the rectangle.
+  @param  Height                Height of the rectangle.
+
+**/
+VOID
+MarkShadowBufferDirty (
+  IN  GRAPHICS_CONSOLE_DEV             *Private,
+  IN  UINTN                            X,
+  IN  UINTN                            Y,
+  IN  UINTN                            Width,
+  IN  UINTN                            Height
+  );
+
+/**
+  Copy the dirty rectangle of the shadow buffer to the screen.
+
+  @param  This                  Protocol instance pointer.
+
+  @retval EFI_SUCCESS           The screen is up to date.
+  @retval Others                The Blt() of the screen failed.
+
+**/
+EFI_STATUS
+FlushShadowBuffer (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
+  );
+
 /**
   Check if the current specific mode supported the user defined resolution
   for the Graphics Console device based on Graphics Output Protocol.
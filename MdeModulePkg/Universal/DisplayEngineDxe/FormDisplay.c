@@ -104,6 +104,14 @@ DISPLAY_HIGHLIGHT_MENU_INFO   gHighligthMenuInfo = {0};
 BOOLEAN                       mIsFirstForm = TRUE;
 FORM_ENTRY_INFO               gOldFormEntry = {0};
 
+//
+// The menu options painted from each row of the statement area. A menu option
+// is only painted again when it differs from the one painted on its row.
+//
+MENU_PAINT_INFO               *mMenuPaintInfo = NULL;
+UINTN                         mMenuPaintInfoCount = 0;
+BOOLEAN                       mMenuPaintInfoValid = FALSE;
+
 //
 // Browser Global Strings
 //
@@ -2344,6 +2352,201 @@ FxConfirmPopup (
   return RetVal;
 }
 
+/**
+  Forget the menu options painted on the screen, so that they are all painted
+  again. Called when something else is painted over the form.
+
+**/
+VOID
+InvalidateMenuPaintInfo (
+  VOID
+  )
+{
+  if (mMenuPaintInfo != NULL) {
+    ZeroMem (mMenuPaintInfo, mMenuPaintInfoCount * sizeof (MENU_PAINT_INFO));
+  }
+}
+
+/**
+  Forget the menu options painted on some rows of the screen.
+
+  @param  Row                      The first row.
+  @param  Count                    The number of rows.
+
+**/
+VOID
+ClearMenuPaintInfo (
+  IN UINTN                           Row,
+  IN UINTN                           Count
+  )
+{
+  for (; (Count > 0) && (Row < mMenuPaintInfoCount); Row++, Count--) {
+    mMenuPaintInfo[Row].Key = 0;
+  }
+}
+
+/**
+  Get the checksum of a string painted on the screen.
+
+  @param  String                   The string, may be NULL.
+
+  @return The checksum.
+
+**/
+UINT32
+GetPaintStringKey (
+  IN CHAR16                          *String
+  )
+{
+  if (String == NULL) {
+    return 0;
+  }
+
+  return CalculateCrc32 (String, StrSize (String));
+}
+
+/**
+  Get the key of a menu option, which changes whenever the menu option is
+  painted differently.
+
+  @param  MenuOption               The menu option.
+  @param  OptionString             The option string of the menu option.
+  @param  SkipWidth                The skip width between the left to the start of the prompt.
+  @param  BeginCol                 The begin column for one menu.
+  @param  SkipLine                 The skip line for this menu.
+  @param  BottomRow                The bottom row for this form.
+  @param  Highlight                Whether this menu will be highlight.
+
+  @return The key, never zero.
+
+**/
+UINT32
+GetMenuPaintKey (
+  IN UI_MENU_OPTION                  *MenuOption,
+  IN CHAR16                          *OptionString,
+  IN UINTN                           SkipWidth,
+  IN UINTN                           BeginCol,
+  IN UINTN                           SkipLine,
+  IN UINTN                           BottomRow,
+  IN BOOLEAN                         Highlight
+  )
+{
+  UINTN                           Data[15];
+  CHAR16                          *TextTwo;
+  UINT32                          Key;
+
+  TextTwo = NULL;
+  if ((MenuOption->ThisTag->OpCode->OpCode == EFI_IFR_TEXT_OP) && (((EFI_IFR_TEXT*)MenuOption->ThisTag->OpCode)->TextTwo != 0)) {
+    TextTwo = GetToken (((EFI_IFR_TEXT*)MenuOption->ThisTag->OpCode)->TextTwo, gFormData->HiiHandle);
+  }
+
+  Data[0]  = MenuOption->Row;
+  Data[1]  = MenuOption->Col;
+  Data[2]  = MenuOption->OptCol;
+  Data[3]  = MenuOption->Skip;
+  Data[4]  = MenuOption->ThisTag->OpCode->OpCode;
+  Data[5]  = MenuOption->GrayOut;
+  Data[6]  = SkipWidth;
+  Data[7]  = BeginCol;
+  Data[8]  = SkipLine;
+  Data[9]  = BottomRow;
+  Data[10] = Highlight;
+  Data[11] = ((UINTN) gPromptBlockWidth << 16) | gOptionBlockWidth;
+  Data[12] = GetPaintStringKey (MenuOption->Description);
+  Data[13] = GetPaintStringKey (OptionString);
+  Data[14] = GetPaintStringKey (TextTwo);
+
+  if (TextTwo != NULL) {
+    FreePool (TextTwo);
+  }
+
+  Key = CalculateCrc32 (Data, sizeof (Data));
+  return (Key == 0) ? 1 : Key;
+}
+
+/**
+  Check whether a menu option is painted on its row already, and restore the
+  number of lines it took then.
+
+  @param  MenuOption               The menu option.
+  @param  Key                      The key of the menu option.
+
+  @retval TRUE                     The menu option doesn't need to be painted.
+  @retval FALSE                    The menu option needs to be painted.
+
+**/
+BOOLEAN
+IsMenuPainted (
+  IN OUT UI_MENU_OPTION              *MenuOption,
+  IN     UINT32                      Key
+  )
+{
+  if ((MenuOption->Row >= mMenuPaintInfoCount) || (mMenuPaintInfo[MenuOption->Row].Key != Key)) {
+    return FALSE;
+  }
+
+  MenuOption->Skip = mMenuPaintInfo[MenuOption->Row].Skip;
+  return TRUE;
+}
+
+/**
+  Record a menu option painted on the screen.
+
+  @param  MenuOption               The menu option.
+  @param  Key                      The key of the menu option.
+
+**/
+VOID
+SaveMenuPaintInfo (
+  IN UI_MENU_OPTION                  *MenuOption,
+  IN UINT32                          Key
+  )
+{
+  if (MenuOption->Row >= mMenuPaintInfoCount) {
+    return;
+  }
+
+  //
+  // The menu option covers the menu options painted from its other rows.
+  //
+  if (MenuOption->Skip > 1) {
+    ClearMenuPaintInfo (MenuOption->Row + 1, MenuOption->Skip - 1);
+  }
+
+  mMenuPaintInfo[MenuOption->Row].Key  = Key;
+  mMenuPaintInfo[MenuOption->Row].Skip = MenuOption->Skip;
+}
+
+/**
+  Prepare the paint info of the menu options for a display of a form.
+
+  @param  Reuse                    Whether the menu options painted by the
+                                   previous display of the form are still on
+                                   the screen.
+
+**/
+VOID
+PrepareMenuPaintInfo (
+  IN BOOLEAN                         Reuse
+  )
+{
+  if (mMenuPaintInfoCount != gStatementDimensions.BottomRow + 1) {
+    if (mMenuPaintInfo != NULL) {
+      FreePool (mMenuPaintInfo);
+    }
+    mMenuPaintInfoCount = 0;
+    mMenuPaintInfo      = AllocateZeroPool ((gStatementDimensions.BottomRow + 1) * sizeof (MENU_PAINT_INFO));
+    if (mMenuPaintInfo != NULL) {
+      mMenuPaintInfoCount = gStatementDimensions.BottomRow + 1;
+    }
+    return;
+  }
+
+  if (!Reuse) {
+    InvalidateMenuPaintInfo ();
+  }
+}
+
 /**
   Print string for this menu option.
 
@@ -2388,6 +2591,7 @@ DisplayOneMenu (
   UINTN                           OptionLineNum;
   CHAR16                          AdjustValue;
   UINTN                           MaxRow;
+  UINT32                          PaintKey;
 
   Statement = MenuOption->ThisTag;
   Temp      = SkipLine;
@@ -2412,14 +2616,27 @@ DisplayOneMenu (
     return Status;
   }
 
-  if (OptionString != NULL) {
-    if (Statement->OpCode->OpCode == EFI_IFR_DATE_OP || Statement->OpCode->OpCode == EFI_IFR_TIME_OP) {
-      //
-      // Adjust option string for date/time opcode.
-      //
-      ProcessStringForDateTime(MenuOption, OptionString, UpdateCol);
+  if ((OptionString != NULL) &&
+      (Statement->OpCode->OpCode == EFI_IFR_DATE_OP || Statement->OpCode->OpCode == EFI_IFR_TIME_OP)) {
+    //
+    // Adjust option string for date/time opcode.
+    //
+    ProcessStringForDateTime(MenuOption, OptionString, UpdateCol);
+  }
+
+  //
+  // Skip the menu if it is on the screen already, e.g. when the form is
+  // displayed again for the refresh of another question.
+  //
+  PaintKey = GetMenuPaintKey (MenuOption, OptionString, SkipWidth, BeginCol, SkipLine, BottomRow, Highlight);
+  if (IsMenuPainted (MenuOption, PaintKey)) {
+    if (OptionString != NULL) {
+      FreePool (OptionString);
     }
+    return EFI_SUCCESS;
+  }
 
+  if (OptionString != NULL) {
     Width       = (UINT16) gOptionBlockWidth - 1;
     Row         = MenuOption->Row;
     GlyphWidth  = 1;
@@ -2589,6 +2806,8 @@ DisplayOneMenu (
     }
   }
 
+  SaveMenuPaintInfo (MenuOption, PaintKey);
+
   return EFI_SUCCESS;
 }
 
@@ -2656,6 +2875,7 @@ UiDisplayMenu (
   UI_EVENT_TYPE                   EventType;
   BOOLEAN                         SkipHighLight;
   EFI_HII_VALUE                   *StatementValue;
+  BOOLEAN                         MenuPainted;
 
   EventType           = UIEventNone;
   Status              = EFI_SUCCESS;
@@ -2679,6 +2899,7 @@ UiDisplayMenu (
   DownArrow           = FALSE;
   SkipValue           = 0;
   SkipHighLight       = FALSE;
+  MenuPainted         = FALSE;
 
   NextMenuOption      = NULL;
   SavedMenuOption     = NULL;
@@ -2732,6 +2953,15 @@ UiDisplayMenu (
       ControlFlag = CfRefreshHighLight;
 
       if (Repaint) {
+        //
+        // Only the first paint may skip the menus painted by the previous
+        // display of the form, a later paint follows an input or a pop-up.
+        //
+        if (MenuPainted) {
+          InvalidateMenuPaintInfo ();
+        }
+        MenuPainted = TRUE;
+
         //
         // Display menu
         //
@@ -2838,6 +3068,7 @@ UiDisplayMenu (
         // 3. Menus in this form may not cover all form, clean the remain field.
         //
         while (Row <= BottomRow) {
+          ClearMenuPaintInfo (Row, 1);
           if ((FormData->Attribute & HII_DISPLAY_MODAL) != 0) {
             PrintStringAtWithWidth(gStatementDimensions.LeftColumn + gModalSkipColumn, Row++, L"", gStatementDimensions.RightColumn - gStatementDimensions.LeftColumn - 2 * gModalSkipColumn);
           } else {
@@ -3178,6 +3409,10 @@ UiDisplayMenu (
         gMisMatch = TRUE;
         gUserInput->Action = BROWSER_ACTION_NONE;
         ControlFlag = CfExit;
+        //
+        // Nothing is painted over the form before it is displayed again.
+        //
+        mMenuPaintInfoValid = TRUE;
         break;
       }
 
@@ -4037,6 +4272,7 @@ FormDisplay (
   )
 {
   EFI_STATUS  Status;
+  BOOLEAN     ReuseMenuPaint;
 
   ASSERT (FormData != NULL);
   if (FormData == NULL) {
@@ -4046,6 +4282,9 @@ FormDisplay (
   gUserInput = UserInputData;
   gFormData  = FormData;
 
+  ReuseMenuPaint      = mMenuPaintInfoValid;
+  mMenuPaintInfoValid = FALSE;
+
   //
   // Process the status info first.
   //
@@ -4089,6 +4328,10 @@ FormDisplay (
     mStatementLayoutIsChanged = FALSE;
   }
 
+  PrepareMenuPaintInfo (
+    (BOOLEAN) (ReuseMenuPaint && !mStatementLayoutIsChanged && ((FormData->Attribute & HII_DISPLAY_MODAL) == 0))
+    );
+
   Status = UiDisplayMenu(FormData);
 
   //
@@ -4255,5 +4498,9 @@ UnloadDisplayEngine (
     FreePool (gHighligthMenuInfo.TOSOpCode);
   }
 
+  if (mMenuPaintInfo != NULL) {
+    FreePool (mMenuPaintInfo);
+  }
+
   return EFI_SUCCESS;
 }
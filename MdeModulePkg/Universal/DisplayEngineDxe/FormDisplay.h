@@ -279,6 +279,14 @@ typedef struct {
 
 #define MENU_OPTION_FROM_LINK(a)  CR (a, UI_MENU_OPTION, Link, UI_MENU_OPTION_SIGNATURE)
 
+//
+// The menu option painted from a row of the screen.
+//
+typedef struct {
+  UINT32                  Key;            // Checksum of what is painted, zero if unknown
+  UINTN                   Skip;           // Number of lines of the painted menu option
+} MENU_PAINT_INFO;
+
 #define USER_SELECTABLE_OPTION_OK_WIDTH           StrLen (gOkOption)
 #define USER_SELECTABLE_OPTION_OK_CAL_WIDTH       (StrLen (gOkOption) + StrLen (gCancelOption))
 #define USER_SELECTABLE_OPTION_YES_NO_WIDTH       (StrLen (gYesOption) + StrLen (gNoOption))
@@ -711,6 +719,16 @@ UpdateHighlightMenuInfo (
   IN  UINTN                           SkipValue
   );
 
+/**
+  Forget the menu options painted on the screen, so that they are all painted
+  again. Called when something else is painted over the form.
+
+**/
+VOID
+InvalidateMenuPaintInfo (
+  VOID
+  );
+
 /**
   Displays a popup window.
 
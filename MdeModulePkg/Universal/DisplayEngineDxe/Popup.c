@@ -691,6 +691,7 @@ CreatePopup (
   CopyMem (&SavedConsoleMode, ConOut->Mode, sizeof (SavedConsoleMode));
   ConOut->EnableCursor (ConOut, FALSE);
   ConOut->SetAttribute (ConOut, GetPopupColor ());
+  InvalidateMenuPaintInfo ();
 
   CalculatePopupPosition (PopupType, &gPopupDimensions);
 
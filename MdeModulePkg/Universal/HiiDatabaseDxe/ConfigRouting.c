@@ -10,6 +10,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "HiiDatabase.h"
 extern HII_DATABASE_PRIVATE_DATA mPrivate;
 
+//
+// PlatformLang when the cached default strings were generated. The defaults of
+// string questions are taken in this language.
+//
+CHAR8                            *mConfigDefaultCacheLanguage = NULL;
+
 /**
   Calculate the number of Unicode characters of the incoming Configuration string,
   not including NULL terminator.
@@ -3987,7 +3993,8 @@ GenerateAltConfigResp (
 
 /**
   This function gets the full request string and full default value string by
-  parsing IFR data in HII form packages.
+  parsing IFR data in HII form packages. It's the uncached worker of
+  GetFullStringFromHiiFormPackages ().
 
   When Request points to NULL string, the request string and default value string
   for each varstore in form package will return.
@@ -4029,8 +4036,7 @@ GenerateAltConfigResp (
 
 **/
 EFI_STATUS
-EFIAPI
-GetFullStringFromHiiFormPackages (
+ParseFullStringFromHiiFormPackages (
   IN     HII_DATABASE_RECORD        *DataBaseRecord,
   IN     EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
   IN OUT EFI_STRING                 *Request,
@@ -4295,6 +4301,308 @@ Done:
   return Status;
 }
 
+/**
+  Drop the request and default strings cached for a package list.
+
+  It must be called whenever a package or a string of the package list changes.
+
+  @param  PackageList            The package list instance.
+
+**/
+VOID
+FreeConfigDefaultCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList
+  )
+{
+  HII_CONFIG_DEFAULT_CACHE     *Cache;
+
+  while (!IsListEmpty (&PackageList->ConfigDefaultCache)) {
+    Cache = CR (PackageList->ConfigDefaultCache.ForwardLink, HII_CONFIG_DEFAULT_CACHE, Entry, HII_CONFIG_DEFAULT_CACHE_SIGNATURE);
+    RemoveEntryList (&Cache->Entry);
+    FreePool (Cache->DevicePath);
+    if (Cache->Request != NULL) {
+      FreePool (Cache->Request);
+    }
+    if (Cache->FullRequest != NULL) {
+      FreePool (Cache->FullRequest);
+    }
+    if (Cache->DefaultAltCfgResp != NULL) {
+      FreePool (Cache->DefaultAltCfgResp);
+    }
+    FreePool (Cache);
+  }
+  PackageList->ConfigDefaultCacheCount = 0;
+}
+
+/**
+  Drop the strings cached for all the package lists if PlatformLang has
+  changed since they were generated.
+
+**/
+VOID
+CheckConfigDefaultCacheLanguage (
+  VOID
+  )
+{
+  CHAR8                        *PlatformLanguage;
+  CHAR8                        *Language;
+  LIST_ENTRY                   *Link;
+  HII_DATABASE_RECORD          *DataBaseRecord;
+
+  GetEfiGlobalVariable2 (L"PlatformLang", (VOID**)&PlatformLanguage, NULL);
+  Language = (PlatformLanguage != NULL) ? PlatformLanguage : "";
+
+  if ((mConfigDefaultCacheLanguage == NULL) || (AsciiStrCmp (mConfigDefaultCacheLanguage, Language) != 0)) {
+    for (Link = mPrivate.DatabaseList.ForwardLink; Link != &mPrivate.DatabaseList; Link = Link->ForwardLink) {
+      DataBaseRecord = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+      FreeConfigDefaultCache (DataBaseRecord->PackageList);
+    }
+
+    if (mConfigDefaultCacheLanguage != NULL) {
+      FreePool (mConfigDefaultCacheLanguage);
+    }
+    mConfigDefaultCacheLanguage = AllocateCopyPool (AsciiStrSize (Language), Language);
+  }
+
+  if (PlatformLanguage != NULL) {
+    FreePool (PlatformLanguage);
+  }
+}
+
+/**
+  Find the strings cached for a request of a package list.
+
+  @param  PackageList            The package list instance.
+  @param  DevicePath             Device Path which Hii Config Access Protocol is registered.
+  @param  Request                The request string, or NULL.
+
+  @return The cached strings, or NULL if the request isn't cached.
+
+**/
+HII_CONFIG_DEFAULT_CACHE *
+FindConfigDefaultCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList,
+  IN EFI_DEVICE_PATH_PROTOCOL            *DevicePath,
+  IN EFI_STRING                          Request OPTIONAL
+  )
+{
+  LIST_ENTRY                   *Link;
+  HII_CONFIG_DEFAULT_CACHE     *Cache;
+  UINTN                        DevicePathSize;
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  for (Link = PackageList->ConfigDefaultCache.ForwardLink; Link != &PackageList->ConfigDefaultCache; Link = Link->ForwardLink) {
+    Cache = CR (Link, HII_CONFIG_DEFAULT_CACHE, Entry, HII_CONFIG_DEFAULT_CACHE_SIGNATURE);
+    if ((Request == NULL) != (Cache->Request == NULL)) {
+      continue;
+    }
+    if ((Request != NULL) && (StrCmp (Request, Cache->Request) != 0)) {
+      continue;
+    }
+    if ((GetDevicePathSize (Cache->DevicePath) != DevicePathSize) ||
+        (CompareMem (Cache->DevicePath, DevicePath, DevicePathSize) != 0)) {
+      continue;
+    }
+
+    //
+    // Keep the most recently used one at the head.
+    //
+    RemoveEntryList (&Cache->Entry);
+    InsertHeadList (&PackageList->ConfigDefaultCache, &Cache->Entry);
+    return Cache;
+  }
+
+  return NULL;
+}
+
+/**
+  Cache the strings generated for a request of a package list. The least
+  recently used entry is dropped when the cache is full.
+
+  @param  PackageList            The package list instance.
+  @param  DevicePath             Device Path which Hii Config Access Protocol is registered.
+  @param  Request                The request string passed in, or NULL. The
+                                 buffer is owned by the cache on return.
+  @param  FullRequest            The full request string, or NULL.
+  @param  DefaultAltCfgResp      The default value string, or NULL.
+
+**/
+VOID
+AddConfigDefaultCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList,
+  IN EFI_DEVICE_PATH_PROTOCOL            *DevicePath,
+  IN EFI_STRING                          Request           OPTIONAL,
+  IN EFI_STRING                          FullRequest       OPTIONAL,
+  IN EFI_STRING                          DefaultAltCfgResp OPTIONAL
+  )
+{
+  HII_CONFIG_DEFAULT_CACHE     *Cache;
+
+  if (PackageList->ConfigDefaultCacheCount >= HII_CONFIG_DEFAULT_CACHE_MAX) {
+    Cache = CR (PackageList->ConfigDefaultCache.BackLink, HII_CONFIG_DEFAULT_CACHE, Entry, HII_CONFIG_DEFAULT_CACHE_SIGNATURE);
+    RemoveEntryList (&Cache->Entry);
+    PackageList->ConfigDefaultCacheCount--;
+  } else {
+    Cache = AllocateZeroPool (sizeof (HII_CONFIG_DEFAULT_CACHE));
+    if (Cache == NULL) {
+      if (Request != NULL) {
+        FreePool (Request);
+      }
+      return;
+    }
+    Cache->Signature = HII_CONFIG_DEFAULT_CACHE_SIGNATURE;
+  }
+
+  //
+  // Release the strings of the reused entry.
+  //
+  if (Cache->DevicePath != NULL) {
+    FreePool (Cache->DevicePath);
+  }
+  if (Cache->Request != NULL) {
+    FreePool (Cache->Request);
+  }
+  if (Cache->FullRequest != NULL) {
+    FreePool (Cache->FullRequest);
+  }
+  if (Cache->DefaultAltCfgResp != NULL) {
+    FreePool (Cache->DefaultAltCfgResp);
+  }
+
+  Cache->Request           = Request;
+  Cache->DevicePath        = DuplicateDevicePath (DevicePath);
+  Cache->FullRequest       = (FullRequest == NULL) ? NULL : AllocateCopyPool (StrSize (FullRequest), FullRequest);
+  Cache->DefaultAltCfgResp = (DefaultAltCfgResp == NULL) ? NULL : AllocateCopyPool (StrSize (DefaultAltCfgResp), DefaultAltCfgResp);
+  if ((Cache->DevicePath == NULL) ||
+      ((FullRequest != NULL) && (Cache->FullRequest == NULL)) ||
+      ((DefaultAltCfgResp != NULL) && (Cache->DefaultAltCfgResp == NULL))) {
+    //
+    // Link it first, so that FreeConfigDefaultCache () can release it.
+    //
+    InsertHeadList (&PackageList->ConfigDefaultCache, &Cache->Entry);
+    FreeConfigDefaultCache (PackageList);
+    return;
+  }
+
+  InsertHeadList (&PackageList->ConfigDefaultCache, &Cache->Entry);
+  PackageList->ConfigDefaultCacheCount++;
+}
+
+/**
+  This function gets the full request string and full default value string by
+  parsing IFR data in HII form packages.
+
+  The strings generated for a request are cached in the package list, so that
+  the form packages are only parsed again after the package list or PlatformLang
+  is changed. The parameters and return values are the same as the ones of
+  ParseFullStringFromHiiFormPackages ().
+
+  @param  DataBaseRecord         The DataBaseRecord instance contains the found Hii handle and package.
+  @param  DevicePath             Device Path which Hii Config Access Protocol is registered.
+  @param  Request                Pointer to a null-terminated Unicode string in
+                                 <ConfigRequest> format, or to NULL.
+  @param  AltCfgResp             Pointer to a null-terminated Unicode string in
+                                 <ConfigAltResp> format, or to NULL.
+  @param  PointerProgress        Optional parameter, it can be NULL.
+
+  @retval EFI_SUCCESS            The Results string is set to the full request string.
+                                 And AltCfgResp contains all default value string.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory for the return string.
+  @retval EFI_NOT_FOUND          The varstore (Guid and Name) in Request string
+                                 can't be found in Form package.
+  @retval EFI_NOT_FOUND          HiiPackage can't be got on the input HiiHandle.
+  @retval EFI_INVALID_PARAMETER  Request points to NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+GetFullStringFromHiiFormPackages (
+  IN     HII_DATABASE_RECORD        *DataBaseRecord,
+  IN     EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN OUT EFI_STRING                 *Request,
+  IN OUT EFI_STRING                 *AltCfgResp,
+  OUT    EFI_STRING                 *PointerProgress OPTIONAL
+  )
+{
+  EFI_STATUS                   Status;
+  HII_CONFIG_DEFAULT_CACHE     *Cache;
+  EFI_STRING                   RequestCopy;
+  EFI_STRING                   FullRequest;
+  EFI_STRING                   DefaultAltCfgResp;
+  BOOLEAN                      CanCache;
+
+  if (DataBaseRecord == NULL || DevicePath == NULL || Request == NULL || AltCfgResp == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CheckConfigDefaultCacheLanguage ();
+
+  DefaultAltCfgResp = NULL;
+  Cache = FindConfigDefaultCache (DataBaseRecord->PackageList, DevicePath, *Request);
+  if (Cache == NULL) {
+    //
+    // Keep the request passed in as the key, the worker may replace it.
+    //
+    RequestCopy = NULL;
+    CanCache    = TRUE;
+    if (*Request != NULL) {
+      RequestCopy = AllocateCopyPool (StrSize (*Request), *Request);
+      CanCache    = (BOOLEAN) (RequestCopy != NULL);
+    }
+
+    Status = ParseFullStringFromHiiFormPackages (DataBaseRecord, DevicePath, Request, &DefaultAltCfgResp, PointerProgress);
+    if (EFI_ERROR (Status) || !CanCache) {
+      if (RequestCopy != NULL) {
+        FreePool (RequestCopy);
+      }
+    } else {
+      AddConfigDefaultCache (DataBaseRecord->PackageList, DevicePath, RequestCopy, *Request, DefaultAltCfgResp);
+    }
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  } else {
+    //
+    // Return the cached strings as if they had just been generated.
+    //
+    if ((Cache->FullRequest != NULL) &&
+        ((*Request == NULL) || (StrCmp (*Request, Cache->FullRequest) != 0))) {
+      FullRequest = AllocateCopyPool (StrSize (Cache->FullRequest), Cache->FullRequest);
+      if (FullRequest == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      if (*Request != NULL) {
+        FreePool (*Request);
+      }
+      *Request = FullRequest;
+    }
+
+    if (Cache->DefaultAltCfgResp != NULL) {
+      DefaultAltCfgResp = AllocateCopyPool (StrSize (Cache->DefaultAltCfgResp), Cache->DefaultAltCfgResp);
+      if (DefaultAltCfgResp == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+
+    if (PointerProgress != NULL) {
+      *PointerProgress = (*Request == NULL) ? NULL : *Request + StrLen (*Request);
+    }
+  }
+
+  //
+  // Merge string into the input AltCfgResp if the input *AltCfgResp is not NULL.
+  //
+  Status = EFI_SUCCESS;
+  if (*AltCfgResp != NULL && DefaultAltCfgResp != NULL) {
+    Status = MergeDefaultString (AltCfgResp, DefaultAltCfgResp);
+    FreePool (DefaultAltCfgResp);
+  } else if (*AltCfgResp == NULL) {
+    *AltCfgResp = DefaultAltCfgResp;
+  }
+
+  return Status;
+}
+
 /**
   This function gets the full request resp string by
   parsing IFR data in HII form packages.
@@ -73,6 +73,7 @@ GenerateHiiDatabaseRecord (
   InitializeListHead (&PackageList->StringPkgHdr);
   InitializeListHead (&PackageList->FontPkgHdr);
   InitializeListHead (&PackageList->SimpleFontPkgHdr);
+  InitializeListHead (&PackageList->ConfigDefaultCache);
   PackageList->ImagePkg      = NULL;
   PackageList->DevicePathPkg = NULL;
 
@@ -2972,6 +2973,11 @@ AddPackages (
   SimpleFontPackage     = NULL;
   KeyboardLayoutPackage = NULL;
 
+  //
+  // The request and default strings generated from the old packages are stale.
+  //
+  FreeConfigDefaultCache (DatabaseRecord->PackageList);
+
   //
   // Process the package list header
   //
@@ -3677,6 +3683,7 @@ HiiRemovePackageList (
 
       HiiHandle->Signature = 0;
       FreePool (HiiHandle);
+      FreeConfigDefaultCache (Node->PackageList);
       FreePool (Node->PackageList);
       FreePool (Node);
 
@@ -270,8 +270,32 @@ typedef struct _HII_DATABASE_PACKAGE_LIST_INSTANCE {
   HII_IMAGE_PACKAGE_INSTANCE            *ImagePkg;
   LIST_ENTRY                            SimpleFontPkgHdr;
   UINT8                                 *DevicePathPkg;
+  LIST_ENTRY                            ConfigDefaultCache;
+  UINTN                                 ConfigDefaultCacheCount;
 } HII_DATABASE_PACKAGE_LIST_INSTANCE;
 
+#define HII_CONFIG_DEFAULT_CACHE_SIGNATURE  SIGNATURE_32 ('h','c','d','c')
+
+//
+// Max number of requests whose strings are cached for one package list.
+//
+#define HII_CONFIG_DEFAULT_CACHE_MAX        8
+
+//
+// The <ConfigRequest> and the default <ConfigAltResp> generated from the IFR
+// of a package list for one request. They are kept until a package or a string
+// of the package list is changed, so that ExtractConfig() and ExportConfig()
+// don't parse the form packages again.
+//
+typedef struct {
+  UINTN                                 Signature;
+  LIST_ENTRY                            Entry;
+  EFI_DEVICE_PATH_PROTOCOL              *DevicePath;
+  EFI_STRING                            Request;            // The request passed in, NULL for the first varstore
+  EFI_STRING                            FullRequest;        // The request with the elements found in IFR
+  EFI_STRING                            DefaultAltCfgResp;  // NULL if there is no default
+} HII_CONFIG_DEFAULT_CACHE;
+
 #define HII_HANDLE_SIGNATURE            SIGNATURE_32 ('h','i','h','l')
 
 typedef struct {
@@ -421,6 +445,19 @@ IsHiiHandleValid (
   EFI_HII_HANDLE Handle
   );
 
+/**
+  Drop the request and default strings cached for a package list.
+
+  It must be called whenever a package or a string of the package list changes.
+
+  @param  PackageList            The package list instance.
+
+**/
+VOID
+FreeConfigDefaultCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList
+  );
+
 
 /**
   This function checks whether EFI_FONT_INFO exists in current database. If
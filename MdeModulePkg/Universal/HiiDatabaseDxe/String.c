@@ -1206,6 +1206,8 @@ HiiNewString (
 
   EfiAcquireLock (&mHiiDatabaseLock);
 
+  FreeConfigDefaultCache (PackageListNode);
+
   Status = EFI_SUCCESS;
   NewStringPackageCreated = FALSE;
   NewStringId   = 0;
@@ -1749,6 +1751,11 @@ HiiSetString (
   }
 
   if (PackageListNode != NULL) {
+    //
+    // String defaults and the names of name/value questions may change.
+    //
+    FreeConfigDefaultCache (PackageListNode);
+
     for (Link =  PackageListNode->StringPkgHdr.ForwardLink;
          Link != &PackageListNode->StringPkgHdr;
          Link =  Link->ForwardLink
@@ -2560,6 +2560,7 @@ EvaluateExpression (
 
   ASSERT (Expression != NULL);
   Expression->Result.Type = EFI_IFR_TYPE_OTHER;
+  Expression->ResultValid = FALSE;
 
   Link = GetFirstNode (&Expression->OpCodeListHead);
   while (!IsNull (&Expression->OpCodeListHead, Link)) {
@@ -3619,6 +3620,811 @@ Done:
   return Status;
 }
 
+/**
+  Check whether the result of an expression opcode only depends on its
+  operands and on the value of the Question it refers to.
+
+  @param  OpCode                 The expression opcode.
+
+  @retval TRUE                   The result only depends on these values.
+  @retval FALSE                  The result may also depend on storage,
+                                 strings, other expressions or system state.
+
+**/
+BOOLEAN
+IsTrackableExpressionOpCode (
+  IN EXPRESSION_OPCODE  *OpCode
+  )
+{
+  switch (OpCode->Operand) {
+  case EFI_IFR_EQ_ID_VAL_OP:
+  case EFI_IFR_EQ_ID_ID_OP:
+  case EFI_IFR_EQ_ID_VAL_LIST_OP:
+  case EFI_IFR_QUESTION_REF1_OP:
+  case EFI_IFR_DUP_OP:
+  case EFI_IFR_TRUE_OP:
+  case EFI_IFR_FALSE_OP:
+  case EFI_IFR_ONE_OP:
+  case EFI_IFR_ONES_OP:
+  case EFI_IFR_UINT8_OP:
+  case EFI_IFR_UINT16_OP:
+  case EFI_IFR_UINT32_OP:
+  case EFI_IFR_UINT64_OP:
+  case EFI_IFR_UNDEFINED_OP:
+  case EFI_IFR_VERSION_OP:
+  case EFI_IFR_ZERO_OP:
+  case EFI_IFR_NOT_OP:
+  case EFI_IFR_TO_BOOLEAN_OP:
+  case EFI_IFR_BITWISE_NOT_OP:
+  case EFI_IFR_ADD_OP:
+  case EFI_IFR_SUBTRACT_OP:
+  case EFI_IFR_MULTIPLY_OP:
+  case EFI_IFR_DIVIDE_OP:
+  case EFI_IFR_MODULO_OP:
+  case EFI_IFR_BITWISE_AND_OP:
+  case EFI_IFR_BITWISE_OR_OP:
+  case EFI_IFR_SHIFT_LEFT_OP:
+  case EFI_IFR_SHIFT_RIGHT_OP:
+  case EFI_IFR_AND_OP:
+  case EFI_IFR_OR_OP:
+  case EFI_IFR_EQUAL_OP:
+  case EFI_IFR_NOT_EQUAL_OP:
+  case EFI_IFR_GREATER_EQUAL_OP:
+  case EFI_IFR_GREATER_THAN_OP:
+  case EFI_IFR_LESS_EQUAL_OP:
+  case EFI_IFR_LESS_THAN_OP:
+  case EFI_IFR_CONDITIONAL_OP:
+    return TRUE;
+
+  default:
+    return FALSE;
+  }
+}
+
+/**
+  Find the Question an expression refers to, the same way as IdToQuestion(),
+  if a change of its value can be detected from its HiiValue.
+
+  @param  FormSet                The formset which contains this form.
+  @param  Form                   The form which contains the expression.
+  @param  QuestionId             Id of the Question.
+
+  @retval Pointer                The Question.
+  @retval NULL                   The Question is not found, its value isn't
+                                 held in its HiiValue, or IdToQuestion() reads
+                                 it from the storage each time.
+
+**/
+FORM_BROWSER_STATEMENT *
+IdToDependencyQuestion (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form,
+  IN UINT16                QuestionId
+  )
+{
+  LIST_ENTRY              *Link;
+  FORM_BROWSER_STATEMENT  *Question;
+
+  Question = IdToQuestion2 (Form, QuestionId);
+  if (Question == NULL) {
+    Link = GetFirstNode (&FormSet->FormListHead);
+    while (!IsNull (&FormSet->FormListHead, Link)) {
+      Question = IdToQuestion2 (FORM_BROWSER_FORM_FROM_LINK (Link), QuestionId);
+      if (Question != NULL) {
+        break;
+      }
+
+      Link = GetNextNode (&FormSet->FormListHead, Link);
+    }
+
+    if ((Question == NULL) ||
+        ((Question->Storage != NULL) && (Question->Storage->Type == EFI_HII_VARSTORE_EFI_VARIABLE))) {
+      return NULL;
+    }
+  }
+
+  switch (Question->HiiValue.Type) {
+  case EFI_IFR_TYPE_BOOLEAN:
+  case EFI_IFR_TYPE_NUM_SIZE_8:
+  case EFI_IFR_TYPE_NUM_SIZE_16:
+  case EFI_IFR_TYPE_NUM_SIZE_32:
+  case EFI_IFR_TYPE_NUM_SIZE_64:
+  case EFI_IFR_TYPE_DATE:
+  case EFI_IFR_TYPE_TIME:
+    return Question;
+
+  default:
+    return NULL;
+  }
+}
+
+/**
+  Get the number of operands an operator of a tracked expression pops from
+  the expression stack.
+
+  @param  Operand                The IFR opcode of the operator.
+
+  @return The number of operands, or 0 if Operand isn't such an operator.
+
+**/
+UINT8
+GetExpressionOperandCount (
+  IN UINT8  Operand
+  )
+{
+  switch (Operand) {
+  case EFI_IFR_NOT_OP:
+  case EFI_IFR_TO_BOOLEAN_OP:
+  case EFI_IFR_BITWISE_NOT_OP:
+    return 1;
+
+  case EFI_IFR_ADD_OP:
+  case EFI_IFR_SUBTRACT_OP:
+  case EFI_IFR_MULTIPLY_OP:
+  case EFI_IFR_DIVIDE_OP:
+  case EFI_IFR_MODULO_OP:
+  case EFI_IFR_BITWISE_AND_OP:
+  case EFI_IFR_BITWISE_OR_OP:
+  case EFI_IFR_SHIFT_LEFT_OP:
+  case EFI_IFR_SHIFT_RIGHT_OP:
+  case EFI_IFR_AND_OP:
+  case EFI_IFR_OR_OP:
+  case EFI_IFR_EQUAL_OP:
+  case EFI_IFR_NOT_EQUAL_OP:
+  case EFI_IFR_GREATER_EQUAL_OP:
+  case EFI_IFR_GREATER_THAN_OP:
+  case EFI_IFR_LESS_EQUAL_OP:
+  case EFI_IFR_LESS_THAN_OP:
+    return 2;
+
+  case EFI_IFR_CONDITIONAL_OP:
+    return 3;
+
+  default:
+    return 0;
+  }
+}
+
+/**
+  Compute the result of an operator of a compiled expression, the same way as
+  EvaluateExpression().
+
+  The operands of a compiled expression are never strings nor buffers, so
+  there's no memory to free.
+
+  @param  HiiHandle              The HII handle of the formset.
+  @param  Operand                The IFR opcode of the operator.
+  @param  Data                   The operands, in the order they were pushed.
+  @param  Value                  The result.
+
+  @retval EFI_SUCCESS            The result is computed.
+  @retval Others                 The operands can't be compared.
+
+**/
+EFI_STATUS
+ComputeExpressionOperator (
+  IN  EFI_HII_HANDLE  HiiHandle,
+  IN  UINT8           Operand,
+  IN  EFI_HII_VALUE   *Data,
+  OUT EFI_HII_VALUE   *Value
+  )
+{
+  EFI_STATUS  Status;
+  INTN        Result;
+  UINT64      Data1;
+  UINT64      Data2;
+  UINT32      TempValue;
+
+  ZeroMem (Value, sizeof (EFI_HII_VALUE));
+  Value->Type = EFI_IFR_TYPE_BOOLEAN;
+
+  switch (Operand) {
+  case EFI_IFR_NOT_OP:
+    if (Data[0].Type != EFI_IFR_TYPE_BOOLEAN) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+    Value->Value.b = (BOOLEAN) (!Data[0].Value.b);
+    break;
+
+  case EFI_IFR_TO_BOOLEAN_OP:
+    if (Data[0].Type <= EFI_IFR_TYPE_DATE) {
+      Value->Value.b = (BOOLEAN) (HiiValueToUINT64 (&Data[0]) != 0);
+    } else {
+      CopyMem (Value, &Data[0], sizeof (EFI_HII_VALUE));
+    }
+    break;
+
+  case EFI_IFR_BITWISE_NOT_OP:
+    if (Data[0].Type > EFI_IFR_TYPE_DATE) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+    Value->Type = EFI_IFR_TYPE_NUM_SIZE_64;
+    Value->Value.u64 = ~ HiiValueToUINT64 (&Data[0]);
+    break;
+
+  case EFI_IFR_ADD_OP:
+  case EFI_IFR_SUBTRACT_OP:
+  case EFI_IFR_MULTIPLY_OP:
+  case EFI_IFR_DIVIDE_OP:
+  case EFI_IFR_MODULO_OP:
+  case EFI_IFR_BITWISE_AND_OP:
+  case EFI_IFR_BITWISE_OR_OP:
+  case EFI_IFR_SHIFT_LEFT_OP:
+  case EFI_IFR_SHIFT_RIGHT_OP:
+    if ((Data[0].Type > EFI_IFR_TYPE_DATE) || (Data[1].Type > EFI_IFR_TYPE_DATE)) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+
+    Data1 = HiiValueToUINT64 (&Data[0]);
+    Data2 = HiiValueToUINT64 (&Data[1]);
+    Value->Type = EFI_IFR_TYPE_NUM_SIZE_64;
+
+    switch (Operand) {
+    case EFI_IFR_ADD_OP:
+      Value->Value.u64 = Data1 + Data2;
+      break;
+
+    case EFI_IFR_SUBTRACT_OP:
+      Value->Value.u64 = Data1 - Data2;
+      break;
+
+    case EFI_IFR_MULTIPLY_OP:
+      Value->Value.u64 = MultU64x32 (Data1, (UINT32) Data2);
+      break;
+
+    case EFI_IFR_DIVIDE_OP:
+      Value->Value.u64 = DivU64x32 (Data1, (UINT32) Data2);
+      break;
+
+    case EFI_IFR_MODULO_OP:
+      DivU64x32Remainder (Data1, (UINT32) Data2, &TempValue);
+      Value->Value.u64 = TempValue;
+      break;
+
+    case EFI_IFR_BITWISE_AND_OP:
+      Value->Value.u64 = Data1 & Data2;
+      break;
+
+    case EFI_IFR_BITWISE_OR_OP:
+      Value->Value.u64 = Data1 | Data2;
+      break;
+
+    case EFI_IFR_SHIFT_LEFT_OP:
+      Value->Value.u64 = LShiftU64 (Data1, (UINTN) Data2);
+      break;
+
+    default:
+      Value->Value.u64 = RShiftU64 (Data1, (UINTN) Data2);
+      break;
+    }
+    break;
+
+  case EFI_IFR_AND_OP:
+  case EFI_IFR_OR_OP:
+    if ((Data[0].Type != EFI_IFR_TYPE_BOOLEAN) || (Data[1].Type != EFI_IFR_TYPE_BOOLEAN)) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+
+    if (Operand == EFI_IFR_AND_OP) {
+      Value->Value.b = (BOOLEAN) (Data[0].Value.b && Data[1].Value.b);
+    } else {
+      Value->Value.b = (BOOLEAN) (Data[0].Value.b || Data[1].Value.b);
+    }
+    break;
+
+  case EFI_IFR_EQUAL_OP:
+  case EFI_IFR_NOT_EQUAL_OP:
+  case EFI_IFR_GREATER_EQUAL_OP:
+  case EFI_IFR_GREATER_THAN_OP:
+  case EFI_IFR_LESS_EQUAL_OP:
+  case EFI_IFR_LESS_THAN_OP:
+    if ((Data[0].Type > EFI_IFR_TYPE_BOOLEAN && Data[0].Type != EFI_IFR_TYPE_STRING && !IsTypeInBuffer (&Data[0])) ||
+        (Data[1].Type > EFI_IFR_TYPE_BOOLEAN && Data[1].Type != EFI_IFR_TYPE_STRING && !IsTypeInBuffer (&Data[1]))) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+
+    Status = CompareHiiValue (&Data[0], &Data[1], &Result, HiiHandle);
+    if (Status == EFI_UNSUPPORTED) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    switch (Operand) {
+    case EFI_IFR_EQUAL_OP:
+      Value->Value.b = (BOOLEAN) (Result == 0);
+      break;
+
+    case EFI_IFR_NOT_EQUAL_OP:
+      Value->Value.b = (BOOLEAN) (Result != 0);
+      break;
+
+    case EFI_IFR_GREATER_EQUAL_OP:
+      Value->Value.b = (BOOLEAN) (Result >= 0);
+      break;
+
+    case EFI_IFR_GREATER_THAN_OP:
+      Value->Value.b = (BOOLEAN) (Result > 0);
+      break;
+
+    case EFI_IFR_LESS_EQUAL_OP:
+      Value->Value.b = (BOOLEAN) (Result <= 0);
+      break;
+
+    default:
+      Value->Value.b = (BOOLEAN) (Result < 0);
+      break;
+    }
+    break;
+
+  case EFI_IFR_CONDITIONAL_OP:
+    if (Data[0].Type != EFI_IFR_TYPE_BOOLEAN) {
+      Value->Type = EFI_IFR_TYPE_UNDEFINED;
+      break;
+    }
+    CopyMem (Value, Data[0].Value.b ? &Data[2] : &Data[1], sizeof (EFI_HII_VALUE));
+    break;
+
+  default:
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Compile a tracked expression to a list of instructions.
+
+  The instructions refer to the Questions directly instead of looking up their
+  Ids, and an operator whose operands are all constants is replaced by its
+  result. The instructions use a fixed size value stack. If the expression
+  can't be compiled, Expression->Instruction is left NULL and the expression
+  is evaluated by EvaluateExpression().
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Form                   Form associated with this expression.
+  @param  Expression             Expression to compile.
+
+**/
+VOID
+CompileExpression (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form,
+  IN OUT FORM_EXPRESSION   *Expression
+  )
+{
+  LIST_ENTRY              *Link;
+  EXPRESSION_OPCODE       *OpCode;
+  EXPRESSION_INSTRUCTION  *InstructionList;
+  EXPRESSION_INSTRUCTION  *Instruction;
+  BOOLEAN                 Constant[COMPILED_EXPRESSION_STACK_SIZE];
+  EFI_HII_VALUE           Data[3];
+  EFI_HII_VALUE           Value;
+  UINTN                   Count;
+  UINTN                   Depth;
+  UINTN                   Index;
+  UINT8                   OperandCount;
+
+  Count = 0;
+  Link = GetFirstNode (&Expression->OpCodeListHead);
+  while (!IsNull (&Expression->OpCodeListHead, Link)) {
+    Count++;
+    Link = GetNextNode (&Expression->OpCodeListHead, Link);
+  }
+
+  InstructionList = AllocateZeroPool (Count * sizeof (EXPRESSION_INSTRUCTION));
+  if (InstructionList == NULL) {
+    return;
+  }
+
+  Count = 0;
+  Depth = 0;
+  Link = GetFirstNode (&Expression->OpCodeListHead);
+  while (!IsNull (&Expression->OpCodeListHead, Link)) {
+    OpCode = EXPRESSION_OPCODE_FROM_LINK (Link);
+    Link = GetNextNode (&Expression->OpCodeListHead, Link);
+
+    Instruction = &InstructionList[Count];
+    ZeroMem (Instruction, sizeof (EXPRESSION_INSTRUCTION));
+
+    switch (OpCode->Operand) {
+    case EFI_IFR_EQ_ID_VAL_OP:
+      Instruction->Type     = ExpressionInstructionEqIdVal;
+      Instruction->Question = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId);
+      CopyMem (&Instruction->Value, &OpCode->Value, sizeof (EFI_HII_VALUE));
+      break;
+
+    case EFI_IFR_EQ_ID_ID_OP:
+      Instruction->Type      = ExpressionInstructionEqIdId;
+      Instruction->Question  = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId);
+      Instruction->Question2 = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId2);
+      if (Instruction->Question2 == NULL) {
+        goto Error;
+      }
+      break;
+
+    case EFI_IFR_EQ_ID_VAL_LIST_OP:
+      Instruction->Type     = ExpressionInstructionEqIdValList;
+      Instruction->Question = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId);
+      Instruction->OpCode   = OpCode;
+      break;
+
+    case EFI_IFR_QUESTION_REF1_OP:
+      Instruction->Type     = ExpressionInstructionPushQuestion;
+      Instruction->Question = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId);
+      break;
+
+    case EFI_IFR_DUP_OP:
+      if (Depth == 0) {
+        goto Error;
+      }
+
+      if (Constant[Depth - 1]) {
+        //
+        // The constant on top of the stack is pushed by the previous instruction.
+        //
+        Instruction->Type = ExpressionInstructionPushValue;
+        CopyMem (&Instruction->Value, &InstructionList[Count - 1].Value, sizeof (EFI_HII_VALUE));
+      } else {
+        Instruction->Type = ExpressionInstructionDup;
+      }
+      break;
+
+    case EFI_IFR_TRUE_OP:
+    case EFI_IFR_FALSE_OP:
+    case EFI_IFR_ONE_OP:
+    case EFI_IFR_ONES_OP:
+    case EFI_IFR_UINT8_OP:
+    case EFI_IFR_UINT16_OP:
+    case EFI_IFR_UINT32_OP:
+    case EFI_IFR_UINT64_OP:
+    case EFI_IFR_UNDEFINED_OP:
+    case EFI_IFR_VERSION_OP:
+    case EFI_IFR_ZERO_OP:
+      Instruction->Type = ExpressionInstructionPushValue;
+      CopyMem (&Instruction->Value, &OpCode->Value, sizeof (EFI_HII_VALUE));
+      break;
+
+    default:
+      OperandCount = GetExpressionOperandCount (OpCode->Operand);
+      if ((OperandCount == 0) || (Depth < OperandCount)) {
+        goto Error;
+      }
+
+      Depth -= OperandCount;
+      Instruction->Type         = ExpressionInstructionOperator;
+      Instruction->Operand      = OpCode->Operand;
+      Instruction->OperandCount = OperandCount;
+
+      //
+      // Constant operands are pushed by the previous instructions. Replace them
+      // with the result, unless one is undefined, as the evaluation stops there.
+      //
+      for (Index = 0; Index < OperandCount; Index++) {
+        if (!Constant[Depth + Index] ||
+            (InstructionList[Count - OperandCount + Index].Value.Type == EFI_IFR_TYPE_UNDEFINED)) {
+          break;
+        }
+        CopyMem (&Data[Index], &InstructionList[Count - OperandCount + Index].Value, sizeof (EFI_HII_VALUE));
+      }
+
+      if ((Index == OperandCount) &&
+          !EFI_ERROR (ComputeExpressionOperator (FormSet->HiiHandle, OpCode->Operand, Data, &Value))) {
+        Count -= OperandCount;
+        Instruction = &InstructionList[Count];
+        ZeroMem (Instruction, sizeof (EXPRESSION_INSTRUCTION));
+        Instruction->Type = ExpressionInstructionPushValue;
+        CopyMem (&Instruction->Value, &Value, sizeof (EFI_HII_VALUE));
+      }
+      break;
+    }
+
+    if ((Instruction->Type != ExpressionInstructionPushValue) &&
+        (Instruction->Type != ExpressionInstructionDup) &&
+        (Instruction->Type != ExpressionInstructionOperator) &&
+        (Instruction->Question == NULL)) {
+      goto Error;
+    }
+
+    if (Depth == COMPILED_EXPRESSION_STACK_SIZE) {
+      goto Error;
+    }
+    Constant[Depth++] = (BOOLEAN) (Instruction->Type == ExpressionInstructionPushValue);
+    Count++;
+  }
+
+  //
+  // After evaluating an expression, there should be only one value left on the stack
+  //
+  if (Depth != 1) {
+    goto Error;
+  }
+
+  Expression->Instruction      = InstructionList;
+  Expression->InstructionCount = Count;
+  return;
+
+Error:
+  FreePool (InstructionList);
+}
+
+/**
+  Evaluate the result of a compiled expression.
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Expression             Expression to be evaluated.
+
+  @retval EFI_SUCCESS            The expression evaluated successfuly
+  @retval Others                 The values of the Questions can't be compared.
+
+**/
+EFI_STATUS
+EvaluateCompiledExpression (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN OUT FORM_EXPRESSION   *Expression
+  )
+{
+  EFI_STATUS              Status;
+  EXPRESSION_INSTRUCTION  *Instruction;
+  EFI_HII_VALUE           Stack[COMPILED_EXPRESSION_STACK_SIZE];
+  EFI_HII_VALUE           Data;
+  EFI_HII_VALUE           *Value;
+  UINTN                   Depth;
+  UINTN                   Index;
+  UINT16                  ListIndex;
+  INTN                    Result;
+
+  Expression->Result.Type = EFI_IFR_TYPE_OTHER;
+  Expression->ResultValid = FALSE;
+
+  Depth = 0;
+  for (Index = 0; Index < Expression->InstructionCount; Index++) {
+    Instruction = &Expression->Instruction[Index];
+
+    ZeroMem (&Data, sizeof (EFI_HII_VALUE));
+    Value = &Data;
+    Value->Type = EFI_IFR_TYPE_BOOLEAN;
+
+    switch (Instruction->Type) {
+    case ExpressionInstructionPushValue:
+      Value = &Instruction->Value;
+      break;
+
+    case ExpressionInstructionPushQuestion:
+      Value = &Instruction->Question->HiiValue;
+      break;
+
+    case ExpressionInstructionEqIdVal:
+    case ExpressionInstructionEqIdId:
+      if (Instruction->Type == ExpressionInstructionEqIdVal) {
+        Status = CompareHiiValue (&Instruction->Question->HiiValue, &Instruction->Value, &Result, NULL);
+      } else {
+        Status = CompareHiiValue (&Instruction->Question->HiiValue, &Instruction->Question2->HiiValue, &Result, FormSet->HiiHandle);
+      }
+      if (Status == EFI_UNSUPPORTED) {
+        Value->Type = EFI_IFR_TYPE_UNDEFINED;
+        break;
+      }
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+      Value->Value.b = (BOOLEAN) (Result == 0);
+      break;
+
+    case ExpressionInstructionEqIdValList:
+      Value->Value.b = FALSE;
+      for (ListIndex = 0; ListIndex < Instruction->OpCode->ListLength; ListIndex++) {
+        if (Instruction->Question->HiiValue.Value.u16 == Instruction->OpCode->ValueList[ListIndex]) {
+          Value->Value.b = TRUE;
+          break;
+        }
+      }
+      break;
+
+    case ExpressionInstructionDup:
+      Value = &Stack[Depth - 1];
+      break;
+
+    default:
+      Depth -= Instruction->OperandCount;
+      Status = ComputeExpressionOperator (FormSet->HiiHandle, Instruction->Operand, &Stack[Depth], Value);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+      break;
+    }
+
+    //
+    // An undefined value is the result of the expression
+    //
+    if (Value->Type == EFI_IFR_TYPE_UNDEFINED) {
+      CopyMem (&Expression->Result, Value, sizeof (EFI_HII_VALUE));
+      return EFI_SUCCESS;
+    }
+
+    CopyMem (&Stack[Depth++], Value, sizeof (EFI_HII_VALUE));
+  }
+
+  CopyMem (&Expression->Result, &Stack[0], sizeof (EFI_HII_VALUE));
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the Questions the result of an expression depends on.
+
+  Only an expression made of constants, operators and Question values is
+  tracked, and compiled. Any other expression is marked volatile.
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Form                   Form associated with this expression.
+  @param  Expression             Expression to check.
+
+**/
+VOID
+InitializeExpressionDependency (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form,
+  IN OUT FORM_EXPRESSION   *Expression
+  )
+{
+  LIST_ENTRY              *Link;
+  EXPRESSION_OPCODE       *OpCode;
+  FORM_BROWSER_STATEMENT  *Question;
+  UINTN                   Count;
+
+  Expression->DependencyState = ExpressionDependencyVolatile;
+
+  Count = 0;
+  Link = GetFirstNode (&Expression->OpCodeListHead);
+  while (!IsNull (&Expression->OpCodeListHead, Link)) {
+    OpCode = EXPRESSION_OPCODE_FROM_LINK (Link);
+    Link = GetNextNode (&Expression->OpCodeListHead, Link);
+
+    if (!IsTrackableExpressionOpCode (OpCode)) {
+      return;
+    }
+
+    switch (OpCode->Operand) {
+    case EFI_IFR_EQ_ID_ID_OP:
+      Count += 2;
+      break;
+
+    case EFI_IFR_EQ_ID_VAL_OP:
+    case EFI_IFR_EQ_ID_VAL_LIST_OP:
+    case EFI_IFR_QUESTION_REF1_OP:
+      Count++;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  if (Count != 0) {
+    Expression->Dependency      = AllocatePool (Count * sizeof (FORM_BROWSER_STATEMENT *));
+    Expression->DependencyValue = AllocateZeroPool (Count * sizeof (EFI_HII_VALUE));
+    if (Expression->Dependency == NULL || Expression->DependencyValue == NULL) {
+      goto Error;
+    }
+  }
+
+  Expression->DependencyCount = 0;
+  Link = GetFirstNode (&Expression->OpCodeListHead);
+  while (!IsNull (&Expression->OpCodeListHead, Link)) {
+    OpCode = EXPRESSION_OPCODE_FROM_LINK (Link);
+    Link = GetNextNode (&Expression->OpCodeListHead, Link);
+
+    switch (OpCode->Operand) {
+    case EFI_IFR_EQ_ID_ID_OP:
+      Question = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId2);
+      if (Question == NULL) {
+        goto Error;
+      }
+      Expression->Dependency[Expression->DependencyCount++] = Question;
+      //
+      // Fall through to the first Question
+      //
+    case EFI_IFR_EQ_ID_VAL_OP:
+    case EFI_IFR_EQ_ID_VAL_LIST_OP:
+    case EFI_IFR_QUESTION_REF1_OP:
+      Question = IdToDependencyQuestion (FormSet, Form, OpCode->QuestionId);
+      if (Question == NULL) {
+        goto Error;
+      }
+      Expression->Dependency[Expression->DependencyCount++] = Question;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  Expression->DependencyState = ExpressionDependencyTracked;
+  CompileExpression (FormSet, Form, Expression);
+  return;
+
+Error:
+  if (Expression->Dependency != NULL) {
+    FreePool (Expression->Dependency);
+    Expression->Dependency = NULL;
+  }
+  if (Expression->DependencyValue != NULL) {
+    FreePool (Expression->DependencyValue);
+    Expression->DependencyValue = NULL;
+  }
+  Expression->DependencyCount = 0;
+}
+
+/**
+  Evaluate the result of a HII expression, unless the values of the Questions
+  it depends on are unchanged since its last evaluation.
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Form                   Form associated with this expression.
+  @param  Expression             Expression to be evaluated.
+
+  @retval EFI_SUCCESS            The expression result is up to date.
+  @retval Others                 The expression evaluation failed, see
+                                 EvaluateExpression().
+
+**/
+EFI_STATUS
+RefreshExpressionResult (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form,
+  IN OUT FORM_EXPRESSION   *Expression
+  )
+{
+  EFI_STATUS              Status;
+  UINTN                   Index;
+  FORM_BROWSER_STATEMENT  *Question;
+
+  if (Expression->DependencyState == ExpressionDependencyUnknown) {
+    InitializeExpressionDependency (FormSet, Form, Expression);
+  }
+
+  if (Expression->DependencyState == ExpressionDependencyVolatile) {
+    return EvaluateExpression (FormSet, Form, Expression);
+  }
+
+  if (Expression->ResultValid) {
+    for (Index = 0; Index < Expression->DependencyCount; Index++) {
+      Question = Expression->Dependency[Index];
+      if ((Question->HiiValue.Type != Expression->DependencyValue[Index].Type) ||
+          (CompareMem (&Question->HiiValue.Value, &Expression->DependencyValue[Index].Value, sizeof (EFI_IFR_TYPE_VALUE)) != 0)) {
+        break;
+      }
+    }
+
+    if (Index == Expression->DependencyCount) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (Expression->Instruction != NULL) {
+    Status = EvaluateCompiledExpression (FormSet, Expression);
+  } else {
+    Status = EvaluateExpression (FormSet, Form, Expression);
+  }
+  if (EFI_ERROR (Status) || (Expression->Result.Type == EFI_IFR_TYPE_BUFFER)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < Expression->DependencyCount; Index++) {
+    CopyMem (&Expression->DependencyValue[Index], &Expression->Dependency[Index]->HiiValue, sizeof (EFI_HII_VALUE));
+  }
+  Expression->ResultValid = TRUE;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Check whether the result is TRUE or FALSE.
 
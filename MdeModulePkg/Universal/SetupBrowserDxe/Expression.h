@@ -218,6 +218,26 @@ EvaluateExpression (
   IN FORM_BROWSER_FORM     *Form,
   IN OUT FORM_EXPRESSION   *Expression
   );
+
+/**
+  Evaluate the result of a HII expression, unless the values of the Questions
+  it depends on are unchanged since its last evaluation.
+
+  @param  FormSet                FormSet associated with this expression.
+  @param  Form                   Form associated with this expression.
+  @param  Expression             Expression to be evaluated.
+
+  @retval EFI_SUCCESS            The expression result is up to date.
+  @retval Others                 The expression evaluation failed, see
+                                 EvaluateExpression().
+
+**/
+EFI_STATUS
+RefreshExpressionResult (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form,
+  IN OUT FORM_EXPRESSION   *Expression
+  );
 /**
   Return the result of the expression list. Check the expression list and
   return the highest priority express result.
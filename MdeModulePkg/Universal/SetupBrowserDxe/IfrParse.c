@@ -731,6 +731,18 @@ DestroyExpression (
     }
   }
 
+  if (Expression->Dependency != NULL) {
+    FreePool (Expression->Dependency);
+  }
+
+  if (Expression->DependencyValue != NULL) {
+    FreePool (Expression->DependencyValue);
+  }
+
+  if (Expression->Instruction != NULL) {
+    FreePool (Expression->Instruction);
+  }
+
   //
   // Free this Expression
   //
@@ -87,7 +87,11 @@ EvaluateFormExpressions (
       continue;
     }
 
-    Status = EvaluateExpression (FormSet, Form, Expression);
+    //
+    // Skip the expressions whose Questions keep their values, e.g. when only
+    // the highlight moves or a refresh Question is updated.
+    //
+    Status = RefreshExpressionResult (FormSet, Form, Expression);
     if (EFI_ERROR (Status)) {
       return Status;
     }
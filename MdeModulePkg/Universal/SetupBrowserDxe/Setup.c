@@ -45,6 +45,8 @@ LIST_ENTRY      gBrowserFormSetList = INITIALIZE_LIST_HEAD_VARIABLE (gBrowserFor
 LIST_ENTRY      gBrowserHotKeyList  = INITIALIZE_LIST_HEAD_VARIABLE (gBrowserHotKeyList);
 LIST_ENTRY      gBrowserStorageList = INITIALIZE_LIST_HEAD_VARIABLE (gBrowserStorageList);
 LIST_ENTRY      gBrowserSaveFailFormSetList = INITIALIZE_LIST_HEAD_VARIABLE (gBrowserSaveFailFormSetList);
+LIST_ENTRY      mFormSetCacheList = INITIALIZE_LIST_HEAD_VARIABLE (mFormSetCacheList);
+UINTN           mFormSetCacheCount = 0;
 
 BOOLEAN               mSystemSubmit = FALSE;
 BOOLEAN               gResetRequiredFormLevel;
@@ -514,9 +516,6 @@ SendForm (
     }
 
     do {
-      FormSet = AllocateZeroPool (sizeof (FORM_BROWSER_FORMSET));
-      ASSERT (FormSet != NULL);
-
       //
       // Validate the HiiHandle
       // if validate failed, find the first validate parent HiiHandle.
@@ -526,12 +525,19 @@ SendForm (
       }
 
       //
-      // Initialize internal data structures of FormSet
+      // Reuse the FormSet parsed by a previous display of this formset, or
+      // initialize internal data structures of FormSet
       //
-      Status = InitializeFormSet (Selection->Handle, &Selection->FormSetGuid, FormSet);
-      if (EFI_ERROR (Status) || IsListEmpty (&FormSet->FormListHead)) {
-        DestroyFormSet (FormSet);
-        break;
+      FormSet = GetCachedFormSet (Selection->Handle, &Selection->FormSetGuid);
+      if (FormSet == NULL) {
+        FormSet = AllocateZeroPool (sizeof (FORM_BROWSER_FORMSET));
+        ASSERT (FormSet != NULL);
+
+        Status = InitializeFormSet (Selection->Handle, &Selection->FormSetGuid, FormSet);
+        if (EFI_ERROR (Status) || IsListEmpty (&FormSet->FormListHead)) {
+          DestroyFormSet (FormSet);
+          break;
+        }
       }
       Selection->FormSet = FormSet;
       mSystemLevelFormSet = FormSet;
@@ -561,7 +567,7 @@ SendForm (
       if (!IsNvUpdateRequiredForFormSet (FormSet)) {
         CleanBrowserStorage(FormSet);
         RemoveEntryList (&FormSet->Link);
-        DestroyFormSet (FormSet);
+        CacheFormSet (FormSet);
       }
 
       if (EFI_ERROR (Status)) {
@@ -1362,6 +1368,282 @@ ConfigRespToStorage (
   return Status;
 }
 
+/**
+  Get the block config access protocol of the driver which owns a buffer storage.
+
+  @param  Storage                The buffer storage.
+
+  @return The protocol, or NULL if the driver doesn't produce it.
+
+**/
+EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL *
+GetConfigAccessBlock (
+  IN BROWSER_STORAGE         *Storage
+  )
+{
+  EFI_STATUS                              Status;
+  EFI_HANDLE                              DriverHandle;
+  EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL  *ConfigAccessBlock;
+
+  Status = mHiiDatabase->GetPackageListHandle (mHiiDatabase, Storage->HiiHandle, &DriverHandle);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Status = gBS->HandleProtocol (DriverHandle, &gEdkiiHiiConfigAccessBlockProtocolGuid, (VOID **) &ConfigAccessBlock);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  return ConfigAccessBlock;
+}
+
+/**
+  Convert the <RequestElement>s of a buffer storage <ConfigRequest> to blocks.
+
+  @param  Storage                The buffer storage.
+  @param  ConfigRequest          The <ConfigRequest> string.
+  @param  Blocks                 The returned blocks. The caller frees it.
+  @param  BlockCount             The number of entries in Blocks.
+
+  @retval EFI_SUCCESS            The blocks are returned.
+  @retval EFI_NOT_FOUND          There is no <RequestElement>.
+  @retval EFI_INVALID_PARAMETER  A block lies outside the storage.
+  @retval EFI_OUT_OF_RESOURCES   No enough memory.
+
+**/
+EFI_STATUS
+ConfigRequestToBlocks (
+  IN  BROWSER_STORAGE         *Storage,
+  IN  CHAR16                  *ConfigRequest,
+  OUT EDKII_HII_CONFIG_BLOCK  **Blocks,
+  OUT UINTN                   *BlockCount
+  )
+{
+  CHAR16                      *StrPtr;
+  UINTN                       Count;
+  UINTN                       Offset;
+  UINTN                       Width;
+
+  Count = 0;
+  for (StrPtr = StrStr (ConfigRequest, L"&OFFSET="); StrPtr != NULL; StrPtr = StrStr (StrPtr + 1, L"&OFFSET=")) {
+    Count++;
+  }
+  if (Count == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Blocks = AllocatePool (Count * sizeof (EDKII_HII_CONFIG_BLOCK));
+  if (*Blocks == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Count = 0;
+  for (StrPtr = StrStr (ConfigRequest, L"&OFFSET="); StrPtr != NULL; StrPtr = StrStr (StrPtr, L"&OFFSET=")) {
+    StrPtr += StrLen (L"&OFFSET=");
+    Offset = StrHexToUintn (StrPtr);
+    StrPtr = StrStr (StrPtr, L"&WIDTH=");
+    if (StrPtr == NULL) {
+      FreePool (*Blocks);
+      return EFI_INVALID_PARAMETER;
+    }
+    StrPtr += StrLen (L"&WIDTH=");
+    Width = StrHexToUintn (StrPtr);
+    if ((Offset + Width) > Storage->Size) {
+      FreePool (*Blocks);
+      return EFI_INVALID_PARAMETER;
+    }
+
+    (*Blocks)[Count].Offset = (UINT16) Offset;
+    (*Blocks)[Count].Width  = (UINT16) Width;
+    Count++;
+  }
+
+  *BlockCount = Count;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the settings of a buffer storage into its edit copy as binary data,
+  without building and parsing a <ConfigResp>.
+
+  EFI variable buffer storages are read from the variable. Buffer storages are
+  read through EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL of their driver.
+
+  @param  Storage                The buffer storage.
+
+  @retval EFI_SUCCESS            The edit copy is filled.
+  @retval Others                 The settings have to be requested through
+                                 the HII Config Routing protocol.
+
+**/
+EFI_STATUS
+BlockToStorage (
+  IN BROWSER_STORAGE         *Storage
+  )
+{
+  EFI_STATUS                              Status;
+  EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL  *ConfigAccessBlock;
+  EDKII_HII_CONFIG_BLOCK                  Block;
+  UINT8                                   *Buffer;
+  UINTN                                   BufferSize;
+
+  Buffer            = NULL;
+  ConfigAccessBlock = NULL;
+
+  switch (Storage->Type) {
+  case EFI_HII_VARSTORE_EFI_VARIABLE_BUFFER:
+    //
+    // The variable may be larger than the varstore the formset knows about.
+    //
+    BufferSize = 0;
+    Status = gRT->GetVariable (Storage->Name, &Storage->Guid, NULL, &BufferSize, NULL);
+    if (Status != EFI_BUFFER_TOO_SMALL) {
+      return EFI_NOT_FOUND;
+    }
+    if (BufferSize < Storage->Size) {
+      return EFI_BAD_BUFFER_SIZE;
+    }
+    break;
+
+  case EFI_HII_VARSTORE_BUFFER:
+    ConfigAccessBlock = GetConfigAccessBlock (Storage);
+    if (ConfigAccessBlock == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+    BufferSize = Storage->Size;
+    break;
+
+  default:
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Read into a scratch buffer, so that the edit copy is left untouched for
+  // the Config Routing path if anything fails.
+  //
+  Buffer = AllocateZeroPool (BufferSize);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (ConfigAccessBlock == NULL) {
+    Status = gRT->GetVariable (Storage->Name, &Storage->Guid, NULL, &BufferSize, Buffer);
+  } else {
+    Block.Offset = 0;
+    Block.Width  = Storage->Size;
+    Status = ConfigAccessBlock->ExtractBlocks (ConfigAccessBlock, &Storage->Guid, Storage->Name, 1, &Block, Buffer, BufferSize);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    CopyMem (Storage->EditBuffer, Buffer, Storage->Size);
+  }
+
+  FreePool (Buffer);
+  return Status;
+}
+
+/**
+  Send the settings of a buffer storage edit copy as binary data, without
+  building and parsing a <ConfigResp>.
+
+  EFI variable buffer storages are written to the variable. Buffer storages are
+  written through EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL of their driver.
+
+  @param  Storage                The buffer storage.
+  @param  ConfigRequest          The <ConfigRequest> of the settings to send.
+
+  @retval EFI_SUCCESS            The settings are sent.
+  @retval Others                 The settings have to be sent through the
+                                 HII Config Routing protocol.
+
+**/
+EFI_STATUS
+StorageToBlock (
+  IN BROWSER_STORAGE         *Storage,
+  IN CHAR16                  *ConfigRequest
+  )
+{
+  EFI_STATUS                              Status;
+  EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL  *ConfigAccessBlock;
+  EDKII_HII_CONFIG_BLOCK                  *Blocks;
+  UINTN                                   BlockCount;
+  UINTN                                   Index;
+  UINT8                                   *Buffer;
+  UINTN                                   BufferSize;
+
+  if ((Storage->Type != EFI_HII_VARSTORE_BUFFER) &&
+      (Storage->Type != EFI_HII_VARSTORE_EFI_VARIABLE_BUFFER)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ConfigAccessBlock = NULL;
+  if (Storage->Type == EFI_HII_VARSTORE_BUFFER) {
+    ConfigAccessBlock = GetConfigAccessBlock (Storage);
+    if (ConfigAccessBlock == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  Status = ConfigRequestToBlocks (Storage, ConfigRequest, &Blocks, &BlockCount);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (ConfigAccessBlock != NULL) {
+    Status = ConfigAccessBlock->RouteBlocks (
+                                  ConfigAccessBlock,
+                                  &Storage->Guid,
+                                  Storage->Name,
+                                  BlockCount,
+                                  Blocks,
+                                  Storage->EditBuffer,
+                                  Storage->Size
+                                  );
+    FreePool (Blocks);
+    return Status;
+  }
+
+  //
+  // Update the requested blocks in the current variable data, the bytes
+  // beyond the varstore are kept.
+  //
+  Buffer     = NULL;
+  BufferSize = 0;
+  Status = gRT->GetVariable (Storage->Name, &Storage->Guid, NULL, &BufferSize, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    Status = EFI_NOT_FOUND;
+    goto Done;
+  }
+  if (BufferSize < Storage->Size) {
+    Status = EFI_BAD_BUFFER_SIZE;
+    goto Done;
+  }
+
+  Buffer = AllocatePool (BufferSize);
+  if (Buffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+  Status = gRT->GetVariable (Storage->Name, &Storage->Guid, NULL, &BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  for (Index = 0; Index < BlockCount; Index++) {
+    CopyMem (Buffer + Blocks[Index].Offset, Storage->EditBuffer + Blocks[Index].Offset, Blocks[Index].Width);
+  }
+
+  Status = gRT->SetVariable (Storage->Name, &Storage->Guid, Storage->Attributes, BufferSize, Buffer);
+
+Done:
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+  FreePool (Blocks);
+  return Status;
+}
+
 /**
   Get bit field value from the buffer and then set the value for the question.
   Note: Data type UINT32 can cover all the bit field value.
@@ -3341,6 +3623,14 @@ SubmitForForm (
       continue;
     }
 
+    //
+    // Send the settings as binary data when possible, skipping the <ConfigResp>.
+    //
+    if (!EFI_ERROR (StorageToBlock (ConfigInfo->Storage, ConfigInfo->ConfigRequest))) {
+      SynchronizeStorage (ConfigInfo->Storage, ConfigInfo->ConfigRequest, TRUE);
+      continue;
+    }
+
     //
     // 1. Prepare <ConfigResp>
     //
@@ -3509,6 +3799,14 @@ SubmitForFormSet (
       continue;
     }
 
+    //
+    // Send the settings as binary data when possible, skipping the <ConfigResp>.
+    //
+    if (!EFI_ERROR (StorageToBlock (Storage, FormSetStorage->ConfigRequest))) {
+      SynchronizeStorage (Storage, FormSetStorage->ConfigRequest, TRUE);
+      continue;
+    }
+
     //
     // 1. Prepare <ConfigResp>
     //
@@ -5553,6 +5851,16 @@ LoadStorage (
       return;
   }
 
+  PERF_INMODULE_BEGIN ("LoadStorage");
+
+  //
+  // Read the settings as binary data when possible, skipping the <ConfigResp>.
+  //
+  if ((Storage->BrowserStorage->Type != EFI_HII_VARSTORE_NAME_VALUE) &&
+      !EFI_ERROR (BlockToStorage (Storage->BrowserStorage))) {
+    goto Synchronize;
+  }
+
   if (Storage->BrowserStorage->Type != EFI_HII_VARSTORE_NAME_VALUE) {
     //
     // Create the config request string to get all fields for this storage.
@@ -5600,6 +5908,13 @@ LoadStorage (
     FreePool (Result);
   }
 
+  if (Storage->BrowserStorage->Type != EFI_HII_VARSTORE_NAME_VALUE) {
+    if (ConfigRequest != NULL) {
+      FreePool (ConfigRequest);
+    }
+  }
+
+Synchronize:
   Storage->BrowserStorage->ConfigRequest = AllocateCopyPool (StrSize (Storage->ConfigRequest), Storage->ConfigRequest);
 
   //
@@ -5607,11 +5922,7 @@ LoadStorage (
   //
   SynchronizeStorage(Storage->BrowserStorage, NULL, TRUE);
 
-  if (Storage->BrowserStorage->Type != EFI_HII_VARSTORE_NAME_VALUE) {
-    if (ConfigRequest != NULL) {
-      FreePool (ConfigRequest);
-    }
-  }
+  PERF_INMODULE_END ("LoadStorage");
 }
 
 /**
@@ -5917,6 +6228,48 @@ GetIfrBinaryData (
 }
 
 
+/**
+  Retrieve the driver handle and the ConfigAccess Protocol of a FormSet.
+
+  @param  FormSet                FormSet data structure.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The package list of the FormSet has no driver
+                                 handle.
+
+**/
+EFI_STATUS
+InitializeFormSetDriver (
+  IN OUT FORM_BROWSER_FORMSET          *FormSet
+  )
+{
+  EFI_STATUS                Status;
+  EFI_HANDLE                DriverHandle;
+
+  //
+  // Retrieve ConfigAccess Protocol associated with this HiiPackageList
+  //
+  Status = mHiiDatabase->GetPackageListHandle (mHiiDatabase, FormSet->HiiHandle, &DriverHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  FormSet->DriverHandle = DriverHandle;
+  Status = gBS->HandleProtocol (
+                  DriverHandle,
+                  &gEfiHiiConfigAccessProtocolGuid,
+                  (VOID **) &FormSet->ConfigAccess
+                  );
+  if (EFI_ERROR (Status)) {
+    //
+    // Configuration Driver don't attach ConfigAccess protocol to its HII package
+    // list, then there will be no configuration action required
+    //
+    FormSet->ConfigAccess = NULL;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize the internal data structure of a FormSet.
 
@@ -5940,7 +6293,6 @@ InitializeFormSet (
   )
 {
   EFI_STATUS                Status;
-  EFI_HANDLE                DriverHandle;
 
   Status = GetIfrBinaryData (Handle, FormSetGuid, &FormSet->IfrBinaryLength, &FormSet->IfrBinaryData);
   if (EFI_ERROR (Status)) {
@@ -5952,33 +6304,141 @@ InitializeFormSet (
   CopyMem (&FormSet->Guid, FormSetGuid, sizeof (EFI_GUID));
   FormSet->QuestionInited = FALSE;
 
-  //
-  // Retrieve ConfigAccess Protocol associated with this HiiPackageList
-  //
-  Status = mHiiDatabase->GetPackageListHandle (mHiiDatabase, Handle, &DriverHandle);
+  Status = InitializeFormSetDriver (FormSet);
   if (EFI_ERROR (Status)) {
     return Status;
   }
-  FormSet->DriverHandle = DriverHandle;
-  Status = gBS->HandleProtocol (
-                  DriverHandle,
-                  &gEfiHiiConfigAccessProtocolGuid,
-                  (VOID **) &FormSet->ConfigAccess
-                  );
+
+  //
+  // Parse the IFR binary OpCodes
+  //
+  Status = ParseOpCodes (FormSet);
+
+  return Status;
+}
+
+/**
+  Get a FormSet kept by CacheFormSet(), if its IFR binary is unchanged.
+
+  @param  Handle                 PackageList Handle
+  @param  FormSetGuid            On input, GUID or class GUID of a formset. If not
+                                 specified (NULL or zero GUID), take the first
+                                 FormSet found in package list.
+                                 On output, GUID of the formset found.
+
+  @return The FormSet, ready to be displayed like a FormSet returned by
+          InitializeFormSet(), or NULL if the formset isn't cached.
+
+**/
+FORM_BROWSER_FORMSET *
+GetCachedFormSet (
+  IN     EFI_HII_HANDLE                Handle,
+  IN OUT EFI_GUID                      *FormSetGuid
+  )
+{
+  EFI_STATUS                Status;
+  LIST_ENTRY                *Link;
+  FORM_BROWSER_FORMSET      *FormSet;
+  FORM_BROWSER_FORM         *Form;
+  EFI_GUID                  Guid;
+  UINTN                     BinaryLength;
+  UINT8                     *BinaryData;
+
+  //
+  // Only export the package list when a formset of it is cached.
+  //
+  Link = GetFirstNode (&mFormSetCacheList);
+  while (!IsNull (&mFormSetCacheList, Link)) {
+    FormSet = FORM_BROWSER_FORMSET_FROM_LINK (Link);
+    if (FormSet->HiiHandle == Handle) {
+      break;
+    }
+    Link = GetNextNode (&mFormSetCacheList, Link);
+  }
+  if (IsNull (&mFormSetCacheList, Link)) {
+    return NULL;
+  }
+
+  CopyGuid (&Guid, FormSetGuid);
+  Status = GetIfrBinaryData (Handle, &Guid, &BinaryLength, &BinaryData);
   if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  FormSet = NULL;
+  Link = GetFirstNode (&mFormSetCacheList);
+  while (!IsNull (&mFormSetCacheList, Link)) {
+    FormSet = FORM_BROWSER_FORMSET_FROM_LINK (Link);
+    Link = GetNextNode (&mFormSetCacheList, Link);
+
+    if ((FormSet->HiiHandle != Handle) || !CompareGuid (&FormSet->Guid, &Guid)) {
+      FormSet = NULL;
+      continue;
+    }
+
+    RemoveEntryList (&FormSet->Link);
+    InitializeListHead (&FormSet->Link);
+    mFormSetCacheCount--;
+
     //
-    // Configuration Driver don't attach ConfigAccess protocol to its HII package
-    // list, then there will be no configuration action required
+    // The package list may have been updated since the FormSet was parsed.
     //
-    FormSet->ConfigAccess = NULL;
+    if ((FormSet->IfrBinaryLength != BinaryLength) ||
+        (CompareMem (FormSet->IfrBinaryData, BinaryData, BinaryLength) != 0) ||
+        EFI_ERROR (InitializeFormSetDriver (FormSet))) {
+      DestroyFormSet (FormSet);
+      FormSet = NULL;
+    }
+    break;
+  }
+
+  FreePool (BinaryData);
+  if (FormSet == NULL) {
+    return NULL;
   }
 
   //
-  // Parse the IFR binary OpCodes
+  // Reset the FormSet to its state after parsing, the Question values are
+  // loaded again when the FormSet is displayed.
   //
-  Status = ParseOpCodes (FormSet);
+  FormSet->QuestionInited = FALSE;
+  Link = GetFirstNode (&FormSet->FormListHead);
+  while (!IsNull (&FormSet->FormListHead, Link)) {
+    Form = FORM_BROWSER_FORM_FROM_LINK (Link);
+    Link = GetNextNode (&FormSet->FormListHead, Link);
 
-  return Status;
+    UiFreeMenuList (&Form->FormViewListHead);
+  }
+
+  CopyGuid (FormSetGuid, &Guid);
+  return FormSet;
+}
+
+/**
+  Keep a FormSet without pending changes, so that the next display of the
+  formset doesn't parse its IFR binary again. The least recently cached
+  FormSet is destroyed when the cache is full.
+
+  @param  FormSet                FormSet data structure, not in any list.
+
+**/
+VOID
+CacheFormSet (
+  IN FORM_BROWSER_FORMSET              *FormSet
+  )
+{
+  FORM_BROWSER_FORMSET      *OldFormSet;
+
+  InsertHeadList (&mFormSetCacheList, &FormSet->Link);
+  mFormSetCacheCount++;
+
+  while (mFormSetCacheCount > FORMSET_CACHE_MAX_COUNT) {
+    OldFormSet = FORM_BROWSER_FORMSET_FROM_LINK (GetPreviousNode (&mFormSetCacheList, &mFormSetCacheList));
+    RemoveEntryList (&OldFormSet->Link);
+    mFormSetCacheCount--;
+
+    DestroyFormSet (OldFormSet);
+  }
 }
 
 
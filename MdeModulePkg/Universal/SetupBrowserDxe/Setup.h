@@ -27,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/UserManager.h>
 #include <Protocol/DevicePathFromText.h>
 #include <Protocol/RegularExpressionProtocol.h>
+#include <Protocol/HiiConfigAccessBlock.h>
 
 #include <Guid/MdeModuleHii.h>
 #include <Guid/HiiPlatformSetupFormset.h>
@@ -45,6 +46,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PcdLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/UefiLib.h>
+#include <Library/PerformanceLib.h>
 
 
 //
@@ -71,6 +73,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define EXPRESSION_STACK_SIZE_INCREMENT    0x100
 
+//
+// Number of parsed formsets kept for the next display of the same formset
+//
+#define FORMSET_CACHE_MAX_COUNT            8
+
+//
+// Size of the value stack of a compiled expression
+//
+#define COMPILED_EXPRESSION_STACK_SIZE     16
+
 #define EFI_IFR_SPECIFICATION_VERSION  (UINT16) (((EFI_SYSTEM_TABLE_REVISION >> 16) << 8) | (((EFI_SYSTEM_TABLE_REVISION & 0xFFFF) / 10) << 4) | ((EFI_SYSTEM_TABLE_REVISION & 0xFFFF) % 10))
 
 
@@ -217,6 +229,38 @@ typedef struct {
 
 #define EXPRESSION_OPCODE_FROM_LINK(a)  CR (a, EXPRESSION_OPCODE, Link, EXPRESSION_OPCODE_SIGNATURE)
 
+typedef struct _FORM_BROWSER_STATEMENT FORM_BROWSER_STATEMENT;
+
+typedef enum {
+  ExpressionDependencyUnknown = 0,   // Not checked yet
+  ExpressionDependencyTracked,       // Result only changes with the values of the Dependency questions
+  ExpressionDependencyVolatile       // Result must be evaluated each time
+} EXPRESSION_DEPENDENCY;
+
+typedef enum {
+  ExpressionInstructionPushValue,    // Push Value
+  ExpressionInstructionPushQuestion, // Push the value of Question
+  ExpressionInstructionEqIdVal,      // Compare the value of Question with Value
+  ExpressionInstructionEqIdId,       // Compare the values of Question and Question2
+  ExpressionInstructionEqIdValList,  // Look for the value of Question in the list of OpCode
+  ExpressionInstructionDup,          // Push the value on top of the stack
+  ExpressionInstructionOperator      // Replace the operands on top of the stack with the result of Operand
+} EXPRESSION_INSTRUCTION_TYPE;
+
+//
+// Instruction of an expression compiled from its opcodes, with the Questions
+// resolved and the operators of constant operands folded
+//
+typedef struct {
+  EXPRESSION_INSTRUCTION_TYPE  Type;
+  UINT8                        Operand;     // IFR opcode of ExpressionInstructionOperator
+  UINT8                        OperandCount;
+  EXPRESSION_OPCODE            *OpCode;     // For ExpressionInstructionEqIdValList
+  FORM_BROWSER_STATEMENT       *Question;
+  FORM_BROWSER_STATEMENT       *Question2;
+  EFI_HII_VALUE                Value;
+} EXPRESSION_INSTRUCTION;
+
 #define FORM_EXPRESSION_SIGNATURE  SIGNATURE_32 ('F', 'E', 'X', 'P')
 
 typedef struct {
@@ -234,6 +278,14 @@ typedef struct {
   EFI_IFR_OP_HEADER *OpCode;         // Save the opcode buffer.
 
   LIST_ENTRY        OpCodeListHead;  // OpCodes consist of this expression (EXPRESSION_OPCODE)
+
+  EXPRESSION_DEPENDENCY   DependencyState;
+  BOOLEAN                 ResultValid;       // Result is evaluated from DependencyValue
+  UINTN                   DependencyCount;
+  FORM_BROWSER_STATEMENT  **Dependency;      // Questions the Result depends on
+  EFI_HII_VALUE           *DependencyValue;  // Values of the Dependency questions when Result was evaluated
+  UINTN                   InstructionCount;
+  EXPRESSION_INSTRUCTION  *Instruction;      // Compiled form of a tracked expression, or NULL
 } FORM_EXPRESSION;
 
 #define FORM_EXPRESSION_FROM_LINK(a)  CR (a, FORM_EXPRESSION, Link, FORM_EXPRESSION_SIGNATURE)
@@ -292,8 +344,6 @@ typedef enum {
   ExpressOption
 } EXPRESS_LEVEL;
 
-typedef struct _FORM_BROWSER_STATEMENT FORM_BROWSER_STATEMENT;
-
 #define FORM_BROWSER_STATEMENT_SIGNATURE  SIGNATURE_32 ('F', 'S', 'T', 'A')
 
 struct _FORM_BROWSER_STATEMENT{
@@ -919,6 +969,38 @@ InitializeFormSet (
   OUT FORM_BROWSER_FORMSET             *FormSet
   );
 
+/**
+  Get a FormSet kept by CacheFormSet(), if its IFR binary is unchanged.
+
+  @param  Handle                 PackageList Handle
+  @param  FormSetGuid            On input, GUID or class GUID of a formset. If not
+                                 specified (NULL or zero GUID), take the first
+                                 FormSet found in package list.
+                                 On output, GUID of the formset found.
+
+  @return The FormSet, ready to be displayed like a FormSet returned by
+          InitializeFormSet(), or NULL if the formset isn't cached.
+
+**/
+FORM_BROWSER_FORMSET *
+GetCachedFormSet (
+  IN     EFI_HII_HANDLE                Handle,
+  IN OUT EFI_GUID                      *FormSetGuid
+  );
+
+/**
+  Keep a FormSet without pending changes, so that the next display of the
+  formset doesn't parse its IFR binary again. The least recently cached
+  FormSet is destroyed when the cache is full.
+
+  @param  FormSet                FormSet data structure, not in any list.
+
+**/
+VOID
+CacheFormSet (
+  IN FORM_BROWSER_FORMSET              *FormSet
+  );
+
 /**
   Reset Questions to their initial value or default value in a Form, Formset or System.
 
@@ -1026,6 +1108,46 @@ ConfigRespToStorage (
   IN CHAR16                  *ConfigResp
   );
 
+/**
+  Read the settings of a buffer storage into its edit copy as binary data,
+  without building and parsing a <ConfigResp>.
+
+  EFI variable buffer storages are read from the variable. Buffer storages are
+  read through EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL of their driver.
+
+  @param  Storage                The buffer storage.
+
+  @retval EFI_SUCCESS            The edit copy is filled.
+  @retval Others                 The settings have to be requested through
+                                 the HII Config Routing protocol.
+
+**/
+EFI_STATUS
+BlockToStorage (
+  IN BROWSER_STORAGE         *Storage
+  );
+
+/**
+  Send the settings of a buffer storage edit copy as binary data, without
+  building and parsing a <ConfigResp>.
+
+  EFI variable buffer storages are written to the variable. Buffer storages are
+  written through EDKII_HII_CONFIG_ACCESS_BLOCK_PROTOCOL of their driver.
+
+  @param  Storage                The buffer storage.
+  @param  ConfigRequest          The <ConfigRequest> of the settings to send.
+
+  @retval EFI_SUCCESS            The settings are sent.
+  @retval Others                 The settings have to be sent through the
+                                 HII Config Routing protocol.
+
+**/
+EFI_STATUS
+StorageToBlock (
+  IN BROWSER_STORAGE         *Storage,
+  IN CHAR16                  *ConfigRequest
+  );
+
 /**
   Fill storage's edit copy with settings requested from Configuration Driver.
 
@@ -240,7 +240,7 @@ GetSmbiosStructureSize (
 
   Determin whether an SmbiosHandle has already in use.
 
-  @param Head        Pointer to the beginning of SMBIOS structure.
+  @param Private     The SMBIOS instance.
   @param Handle      A unique handle will be assigned to the SMBIOS record.
 
   @retval TRUE       Smbios handle already in use.
@@ -250,21 +250,148 @@ GetSmbiosStructureSize (
 BOOLEAN
 EFIAPI
 CheckSmbiosHandleExistance (
-  IN  LIST_ENTRY           *Head,
+  IN  SMBIOS_INSTANCE      *Private,
   IN  EFI_SMBIOS_HANDLE    Handle
   )
 {
-  LIST_ENTRY              *Link;
-  SMBIOS_HANDLE_ENTRY     *HandleEntry;
+  return (BOOLEAN) ((Private->AllocatedHandleBitmap[Handle / 32] & ((UINT32) 1 << (Handle % 32))) != 0);
+}
+
+/**
+
+  Mark an SmbiosHandle as in use.
+
+  @param Private     The SMBIOS instance.
+  @param Handle      The handle assigned to an SMBIOS record.
+
+**/
+VOID
+AllocateSmbiosHandle (
+  IN  SMBIOS_INSTANCE      *Private,
+  IN  EFI_SMBIOS_HANDLE    Handle
+  )
+{
+  Private->AllocatedHandleBitmap[Handle / 32] |= ((UINT32) 1 << (Handle % 32));
+  if (Handle == Private->FirstFreeHandle) {
+    Private->FirstFreeHandle++;
+  }
+}
+
+/**
+
+  Mark an SmbiosHandle as not used.
+
+  @param Private     The SMBIOS instance.
+  @param Handle      The handle of the SMBIOS record removed.
+
+**/
+VOID
+FreeSmbiosHandle (
+  IN  SMBIOS_INSTANCE      *Private,
+  IN  EFI_SMBIOS_HANDLE    Handle
+  )
+{
+  Private->AllocatedHandleBitmap[Handle / 32] &= ~((UINT32) 1 << (Handle % 32));
+  if (Handle < Private->FirstFreeHandle) {
+    Private->FirstFreeHandle = Handle;
+  }
+}
+
+/**
+
+  Find the SMBIOS entry holding the record of an SmbiosHandle.
+
+  @param Private     The SMBIOS instance.
+  @param Handle      The handle of the SMBIOS record.
+
+  @return The SMBIOS entry, or NULL if no record has this handle.
+
+**/
+EFI_SMBIOS_ENTRY *
+FindSmbiosEntry (
+  IN  SMBIOS_INSTANCE      *Private,
+  IN  EFI_SMBIOS_HANDLE    Handle
+  )
+{
+  LIST_ENTRY               *Link;
+  LIST_ENTRY               *Head;
+  EFI_SMBIOS_ENTRY         *SmbiosEntry;
+  EFI_SMBIOS_TABLE_HEADER  *Record;
 
+  Head = &Private->HandleHashHead[SMBIOS_HANDLE_HASH (Handle)];
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK(Link);
-    if (HandleEntry->SmbiosHandle == Handle) {
-      return TRUE;
+    SmbiosEntry = SMBIOS_ENTRY_FROM_HANDLE_LINK (Link);
+    Record = (EFI_SMBIOS_TABLE_HEADER *) (SmbiosEntry->RecordHeader + 1);
+    if (Record->Handle == Handle) {
+      return SmbiosEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+
+  Add or subtract the size of an SMBIOS record to or from the length of the
+  tables it is in, and mark these tables as changed.
+
+  @param Private     The SMBIOS instance.
+  @param SmbiosEntry The SMBIOS entry holding the record.
+  @param Add         TRUE if the record enters the tables, FALSE if it leaves them.
+
+**/
+VOID
+UpdateSmbiosTableLength (
+  IN  SMBIOS_INSTANCE      *Private,
+  IN  EFI_SMBIOS_ENTRY     *SmbiosEntry,
+  IN  BOOLEAN              Add
+  )
+{
+  UINTN                    StructureSize;
+
+  StructureSize = SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
+
+  if (SmbiosEntry->Smbios32BitTable) {
+    if (Add) {
+      Private->Smbios32BitTableLength += StructureSize;
+    } else {
+      Private->Smbios32BitTableLength -= StructureSize;
+    }
+    Private->Smbios32BitTableDirty = TRUE;
+  }
+
+  if (SmbiosEntry->Smbios64BitTable) {
+    if (Add) {
+      Private->Smbios64BitTableLength += StructureSize;
+    } else {
+      Private->Smbios64BitTableLength -= StructureSize;
     }
+    Private->Smbios64BitTableDirty = TRUE;
   }
+}
+
+/**
 
-  return FALSE;
+  Publish the SMBIOS tables that have changed, unless it is deferred until
+  Ready To Boot.
+
+  @param Private     The SMBIOS instance.
+
+**/
+VOID
+PublishChangedSmbiosTables (
+  IN  SMBIOS_INSTANCE      *Private
+  )
+{
+  if (!Private->DeferTableConstruction) {
+    //
+    // Some UEFI drivers (such as network) need some information in SMBIOS table.
+    // Here we create SMBIOS table and publish it in
+    // configuration table, so other UEFI drivers can get SMBIOS table from
+    // configuration table without depending on PI SMBIOS protocol.
+    //
+    SmbiosTableConstruction (Private->Smbios32BitTableDirty, Private->Smbios64BitTableDirty);
+  }
 }
 
 /**
@@ -307,20 +434,30 @@ GetAvailableSmbiosHandle (
   IN OUT   EFI_SMBIOS_HANDLE     *Handle
   )
 {
-  LIST_ENTRY              *Head;
   SMBIOS_INSTANCE         *Private;
   EFI_SMBIOS_HANDLE       MaxSmbiosHandle;
-  EFI_SMBIOS_HANDLE       AvailableHandle;
+  UINTN                   AvailableHandle;
 
   GetMaxSmbiosHandle(This, &MaxSmbiosHandle);
 
   Private = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head = &Private->AllocatedHandleListHead;
-  for (AvailableHandle = 0; AvailableHandle < MaxSmbiosHandle; AvailableHandle++) {
-    if (!CheckSmbiosHandleExistance(Head, AvailableHandle)) {
-      *Handle = AvailableHandle;
+  AvailableHandle = Private->FirstFreeHandle;
+  while (AvailableHandle < MaxSmbiosHandle) {
+    if (Private->AllocatedHandleBitmap[AvailableHandle / 32] == MAX_UINT32) {
+      //
+      // Skip 32 handles in use at once.
+      //
+      AvailableHandle = (AvailableHandle | 31) + 1;
+      continue;
+    }
+
+    if (!CheckSmbiosHandleExistance (Private, (EFI_SMBIOS_HANDLE) AvailableHandle)) {
+      Private->FirstFreeHandle = AvailableHandle;
+      *Handle = (EFI_SMBIOS_HANDLE) AvailableHandle;
       return EFI_SUCCESS;
     }
+
+    AvailableHandle++;
   }
 
   return EFI_OUT_OF_RESOURCES;
@@ -361,11 +498,9 @@ SmbiosAdd (
   UINTN                       StructureSize;
   UINTN                       NumberOfStrings;
   EFI_STATUS                  Status;
-  LIST_ENTRY                  *Head;
   SMBIOS_INSTANCE             *Private;
   EFI_SMBIOS_ENTRY            *SmbiosEntry;
   EFI_SMBIOS_HANDLE           MaxSmbiosHandle;
-  SMBIOS_HANDLE_ENTRY         *HandleEntry;
   EFI_SMBIOS_RECORD_HEADER    *InternalRecord;
   BOOLEAN                     Smbios32BitTable;
   BOOLEAN                     Smbios64BitTable;
@@ -378,8 +513,7 @@ SmbiosAdd (
   //
   // Check whether SmbiosHandle is already in use
   //
-  Head = &Private->AllocatedHandleListHead;
-  if (*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED && CheckSmbiosHandleExistance(Head, *SmbiosHandle)) {
+  if (*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED && CheckSmbiosHandleExistance (Private, *SmbiosHandle)) {
     return EFI_ALREADY_STARTED;
   }
 
@@ -418,8 +552,7 @@ SmbiosAdd (
     // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
     // which is a WORD field limited to 65,535 bytes. So the max size of 32-bit table should not exceed 65,535 bytes.
     //
-    if ((EntryPointStructure != NULL) &&
-        (EntryPointStructure->TableLength + StructureSize > SMBIOS_TABLE_MAX_LENGTH)) {
+    if (Private->Smbios32BitTableLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_TABLE_MAX_LENGTH) {
       DEBUG ((EFI_D_INFO, "SmbiosAdd: Total length exceeds max 32-bit table length with type = %d size = 0x%x\n", Record->Type, StructureSize));
     } else {
       Smbios32BitTable = TRUE;
@@ -435,8 +568,7 @@ SmbiosAdd (
     // For SMBIOS 64-bit table, Structure table maximum size in SMBIOS 3.0 (64-bit) Entry Point
     // is a DWORD field limited to 0xFFFFFFFF bytes. So the max size of 64-bit table should not exceed 0xFFFFFFFF bytes.
     //
-    if ((Smbios30EntryPointStructure != NULL) &&
-        (Smbios30EntryPointStructure->TableMaximumSize + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH)) {
+    if (Private->Smbios64BitTableLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH) {
       DEBUG ((EFI_D_INFO, "SmbiosAdd: Total length exceeds max 64-bit table length with type = %d size = 0x%x\n", Record->Type, StructureSize));
     } else {
       DEBUG ((EFI_D_INFO, "SmbiosAdd: Smbios type %d with size 0x%x is added to 64-bit table\n", Record->Type, StructureSize));
@@ -470,18 +602,8 @@ SmbiosAdd (
     EfiReleaseLock (&Private->DataLock);
     return EFI_OUT_OF_RESOURCES;
   }
-  HandleEntry = AllocateZeroPool (sizeof(SMBIOS_HANDLE_ENTRY));
-  if (HandleEntry == NULL) {
-    EfiReleaseLock (&Private->DataLock);
-    return EFI_OUT_OF_RESOURCES;
-  }
 
-  //
-  // Build Handle Entry and insert into linked list
-  //
-  HandleEntry->Signature     = SMBIOS_HANDLE_ENTRY_SIGNATURE;
-  HandleEntry->SmbiosHandle  = *SmbiosHandle;
-  InsertTailList(&Private->AllocatedHandleListHead, &HandleEntry->Link);
+  AllocateSmbiosHandle (Private, *SmbiosHandle);
 
   InternalRecord  = (EFI_SMBIOS_RECORD_HEADER *) (SmbiosEntry + 1);
   Raw     = (VOID *) (InternalRecord + 1);
@@ -508,12 +630,13 @@ SmbiosAdd (
   ((EFI_SMBIOS_TABLE_HEADER*)Raw)->Handle = *SmbiosHandle;
 
   //
-  // Some UEFI drivers (such as network) need some information in SMBIOS table.
-  // Here we create SMBIOS table and publish it in
-  // configuration table, so other UEFI drivers can get SMBIOS table from
-  // configuration table without depending on PI SMBIOS protocol.
+  // Index the record by handle and by type
   //
-  SmbiosTableConstruction (Smbios32BitTable, Smbios64BitTable);
+  InsertTailList (&Private->HandleHashHead[SMBIOS_HANDLE_HASH (*SmbiosHandle)], &SmbiosEntry->HandleLink);
+  InsertTailList (&Private->TypeListHead[Record->Type], &SmbiosEntry->TypeLink);
+
+  UpdateSmbiosTableLength (Private, SmbiosEntry, TRUE);
+  PublishChangedSmbiosTables (Private);
 
   //
   // Leave critical section
@@ -550,6 +673,7 @@ SmbiosUpdateString (
   UINTN                     StrIndex;
   UINTN                     TargetStrOffset;
   UINTN                     NewEntrySize;
+  UINTN                     NewStructureSize;
   CHAR8                     *StrStart;
   VOID                      *Raw;
   LIST_ENTRY                *Link;
@@ -614,9 +738,9 @@ SmbiosUpdateString (
     return Status;
   }
 
-  Head = &Private->DataListHead;
+  Head = &Private->HandleHashHead[SMBIOS_HANDLE_HASH (*SmbiosHandle)];
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK(Link);
+    SmbiosEntry = SMBIOS_ENTRY_FROM_HANDLE_LINK (Link);
     Record = (EFI_SMBIOS_TABLE_HEADER*)(SmbiosEntry->RecordHeader + 1);
 
     if (Record->Handle == *SmbiosHandle) {
@@ -660,17 +784,23 @@ SmbiosUpdateString (
       TargetStrLen = AsciiStrLen(StrStart);
       if (InputStrLen == TargetStrLen) {
         AsciiStrCpyS(StrStart, TargetStrLen + 1, String);
-        //
-        // Some UEFI drivers (such as network) need some information in SMBIOS table.
-        // Here we create SMBIOS table and publish it in
-        // configuration table, so other UEFI drivers can get SMBIOS table from
-        // configuration table without depending on PI SMBIOS protocol.
-        //
-        SmbiosTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
+        if (SmbiosEntry->Smbios32BitTable) {
+          Private->Smbios32BitTableDirty = TRUE;
+        }
+        if (SmbiosEntry->Smbios64BitTable) {
+          Private->Smbios64BitTableDirty = TRUE;
+        }
+        PublishChangedSmbiosTables (Private);
         EfiReleaseLock (&Private->DataLock);
         return EFI_SUCCESS;
       }
 
+      //
+      // Take the record out of the table lengths, it's added back with its new size.
+      //
+      UpdateSmbiosTableLength (Private, SmbiosEntry, FALSE);
+      NewStructureSize = SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER) + InputStrLen - TargetStrLen;
+
       SmbiosEntry->Smbios32BitTable = FALSE;
       SmbiosEntry->Smbios64BitTable = FALSE;
       if ((This->MajorVersion < 0x3) ||
@@ -678,8 +808,7 @@ SmbiosUpdateString (
         //
         // 32-bit table is produced, check the valid length.
         //
-        if ((EntryPointStructure != NULL) &&
-            (EntryPointStructure->TableLength + InputStrLen - TargetStrLen > SMBIOS_TABLE_MAX_LENGTH)) {
+        if (Private->Smbios32BitTableLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + NewStructureSize > SMBIOS_TABLE_MAX_LENGTH) {
           //
           // The length of the entire structure table (including all strings) must be reported
           // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
@@ -696,8 +825,7 @@ SmbiosUpdateString (
         //
         // 64-bit table is produced, check the valid length.
         //
-        if ((Smbios30EntryPointStructure != NULL) &&
-            (Smbios30EntryPointStructure->TableMaximumSize + InputStrLen - TargetStrLen > SMBIOS_3_0_TABLE_MAX_LENGTH)) {
+        if (Private->Smbios64BitTableLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + NewStructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH) {
           DEBUG ((EFI_D_INFO, "SmbiosUpdateString: Total length exceeds max 64-bit table length\n"));
         } else {
           DEBUG ((EFI_D_INFO, "SmbiosUpdateString: New smbios record add to 64-bit table\n"));
@@ -718,6 +846,7 @@ SmbiosUpdateString (
       ResizedSmbiosEntry = AllocateZeroPool (NewEntrySize);
 
       if (ResizedSmbiosEntry == NULL) {
+        UpdateSmbiosTableLength (Private, SmbiosEntry, TRUE);
         EfiReleaseLock (&Private->DataLock);
         return EFI_OUT_OF_RESOURCES;
       }
@@ -751,20 +880,20 @@ SmbiosUpdateString (
       ResizedSmbiosEntry->RecordSize   = NewEntrySize;
       ResizedSmbiosEntry->Smbios32BitTable = SmbiosEntry->Smbios32BitTable;
       ResizedSmbiosEntry->Smbios64BitTable = SmbiosEntry->Smbios64BitTable;
-      InsertTailList (Link->ForwardLink, &ResizedSmbiosEntry->Link);
+      InsertTailList (SmbiosEntry->Link.ForwardLink, &ResizedSmbiosEntry->Link);
+      InsertTailList (SmbiosEntry->TypeLink.ForwardLink, &ResizedSmbiosEntry->TypeLink);
+      InsertTailList (Head, &ResizedSmbiosEntry->HandleLink);
 
       //
       // Remove old record
       //
-      RemoveEntryList(Link);
+      RemoveEntryList (&SmbiosEntry->Link);
+      RemoveEntryList (&SmbiosEntry->TypeLink);
+      RemoveEntryList (&SmbiosEntry->HandleLink);
       FreePool(SmbiosEntry);
-      //
-      // Some UEFI drivers (such as network) need some information in SMBIOS table.
-      // Here we create SMBIOS table and publish it in
-      // configuration table, so other UEFI drivers can get SMBIOS table from
-      // configuration table without depending on PI SMBIOS protocol.
-      //
-      SmbiosTableConstruction (ResizedSmbiosEntry->Smbios32BitTable, ResizedSmbiosEntry->Smbios64BitTable);
+
+      UpdateSmbiosTableLength (Private, ResizedSmbiosEntry, TRUE);
+      PublishChangedSmbiosTables (Private);
       EfiReleaseLock (&Private->DataLock);
       return EFI_SUCCESS;
     }
@@ -797,7 +926,6 @@ SmbiosRemove (
   EFI_SMBIOS_HANDLE          MaxSmbiosHandle;
   SMBIOS_INSTANCE            *Private;
   EFI_SMBIOS_ENTRY           *SmbiosEntry;
-  SMBIOS_HANDLE_ENTRY        *HandleEntry;
   EFI_SMBIOS_TABLE_HEADER    *Record;
 
   //
@@ -818,33 +946,21 @@ SmbiosRemove (
     return Status;
   }
 
-  Head = &Private->DataListHead;
+  Head = &Private->HandleHashHead[SMBIOS_HANDLE_HASH (SmbiosHandle)];
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK(Link);
+    SmbiosEntry = SMBIOS_ENTRY_FROM_HANDLE_LINK (Link);
     Record = (EFI_SMBIOS_TABLE_HEADER*)(SmbiosEntry->RecordHeader + 1);
     if (Record->Handle == SmbiosHandle) {
       //
-      // Remove specified smobios record from DataList
+      // Remove specified smobios record from DataList and the indexes
       //
-      RemoveEntryList(Link);
+      RemoveEntryList (&SmbiosEntry->Link);
+      RemoveEntryList (&SmbiosEntry->TypeLink);
+      RemoveEntryList (&SmbiosEntry->HandleLink);
       //
-      // Remove this handle from AllocatedHandleList
-      //
-      Head = &Private->AllocatedHandleListHead;
-      for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-        HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK(Link);
-        if (HandleEntry->SmbiosHandle == SmbiosHandle) {
-          RemoveEntryList(Link);
-          FreePool(HandleEntry);
-          break;
-        }
-      }
-      //
-      // Some UEFI drivers (such as network) need some information in SMBIOS table.
-      // Here we create SMBIOS table and publish it in
-      // configuration table, so other UEFI drivers can get SMBIOS table from
-      // configuration table without depending on PI SMBIOS protocol.
+      // Release this handle
       //
+      FreeSmbiosHandle (Private, SmbiosHandle);
       if (SmbiosEntry->Smbios32BitTable) {
         DEBUG ((EFI_D_INFO, "SmbiosRemove: remove from 32-bit table\n"));
       }
@@ -854,7 +970,8 @@ SmbiosRemove (
       //
       // Update the whole SMBIOS table again based on which table the removed SMBIOS record is in.
       //
-      SmbiosTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
+      UpdateSmbiosTableLength (Private, SmbiosEntry, FALSE);
+      PublishChangedSmbiosTables (Private);
       FreePool(SmbiosEntry);
       EfiReleaseLock (&Private->DataLock);
       return EFI_SUCCESS;
@@ -897,65 +1014,70 @@ SmbiosGetNext (
   OUT EFI_HANDLE                    *ProducerHandle OPTIONAL
   )
 {
-  BOOLEAN                  StartPointFound;
   LIST_ENTRY               *Link;
   LIST_ENTRY               *Head;
   SMBIOS_INSTANCE          *Private;
   EFI_SMBIOS_ENTRY         *SmbiosEntry;
+  EFI_SMBIOS_ENTRY         *NextSmbiosEntry;
   EFI_SMBIOS_TABLE_HEADER  *SmbiosTableHeader;
 
   if (SmbiosHandle == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  StartPointFound = FALSE;
   Private = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK(Link);
-    SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER*)(SmbiosEntry->RecordHeader + 1);
-
-    //
-    // If SmbiosHandle is 0xFFFE, the first matched SMBIOS record handle will be returned
-    //
-    if (*SmbiosHandle == SMBIOS_HANDLE_PI_RESERVED) {
-      if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
-        continue;
-      }
 
-      *SmbiosHandle = SmbiosTableHeader->Handle;
-      *Record =SmbiosTableHeader;
-      if (ProducerHandle != NULL) {
-        *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
-      }
-      return EFI_SUCCESS;
+  //
+  // If SmbiosHandle is 0xFFFE, the first matched SMBIOS record handle will be returned.
+  // Otherwise start this round search from the next SMBIOS handle.
+  //
+  SmbiosEntry = NULL;
+  SmbiosTableHeader = NULL;
+  if (*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED) {
+    SmbiosEntry = FindSmbiosEntry (Private, *SmbiosHandle);
+    if (SmbiosEntry == NULL) {
+      *SmbiosHandle = SMBIOS_HANDLE_PI_RESERVED;
+      return EFI_NOT_FOUND;
     }
+    SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER*)(SmbiosEntry->RecordHeader + 1);
+  }
 
+  NextSmbiosEntry = NULL;
+  if ((Type != NULL) && ((SmbiosEntry == NULL) || (*Type == SmbiosTableHeader->Type))) {
     //
-    // Start this round search from the next SMBIOS handle
+    // The next record of this type is the next one on the list of the type.
     //
-    if (!StartPointFound && (*SmbiosHandle == SmbiosTableHeader->Handle)) {
-      StartPointFound = TRUE;
-      continue;
+    Head = &Private->TypeListHead[*Type];
+    Link = (SmbiosEntry == NULL) ? Head->ForwardLink : SmbiosEntry->TypeLink.ForwardLink;
+    if (Link != Head) {
+      NextSmbiosEntry = SMBIOS_ENTRY_FROM_TYPE_LINK (Link);
     }
-
-    if (StartPointFound) {
-      if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
-        continue;
+  } else {
+    Head = &Private->DataListHead;
+    Link = (SmbiosEntry == NULL) ? Head->ForwardLink : SmbiosEntry->Link.ForwardLink;
+    for (; Link != Head; Link = Link->ForwardLink) {
+      SmbiosEntry = SMBIOS_ENTRY_FROM_LINK(Link);
+      SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER*)(SmbiosEntry->RecordHeader + 1);
+      if ((Type == NULL) || (*Type == SmbiosTableHeader->Type)) {
+        NextSmbiosEntry = SmbiosEntry;
+        break;
       }
+    }
+  }
 
-      *SmbiosHandle = SmbiosTableHeader->Handle;
-      *Record = SmbiosTableHeader;
-      if (ProducerHandle != NULL) {
-        *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
-      }
+  if (NextSmbiosEntry == NULL) {
+    *SmbiosHandle = SMBIOS_HANDLE_PI_RESERVED;
+    return EFI_NOT_FOUND;
+  }
 
-      return EFI_SUCCESS;
-    }
+  SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER*)(NextSmbiosEntry->RecordHeader + 1);
+  *SmbiosHandle = SmbiosTableHeader->Handle;
+  *Record = SmbiosTableHeader;
+  if (ProducerHandle != NULL) {
+    *ProducerHandle = NextSmbiosEntry->RecordHeader->ProducerHandle;
   }
 
-  *SmbiosHandle = SMBIOS_HANDLE_PI_RESERVED;
-  return EFI_NOT_FOUND;
+  return EFI_SUCCESS;
 
 }
 
@@ -1034,7 +1156,6 @@ SmbiosCreateTable (
 {
   UINT8                           *BufferPointer;
   UINTN                           RecordSize;
-  UINTN                           NumOfStr;
   EFI_STATUS                      Status;
   EFI_SMBIOS_HANDLE               SmbiosHandle;
   EFI_SMBIOS_PROTOCOL             *SmbiosProtocol;
@@ -1105,7 +1226,7 @@ SmbiosCreateTable (
     Status = GetNextSmbiosRecord (SmbiosProtocol, &CurrentSmbiosEntry, &SmbiosRecord);
 
     if ((Status == EFI_SUCCESS) && (CurrentSmbiosEntry->Smbios32BitTable)) {
-      GetSmbiosStructureSize(SmbiosProtocol, SmbiosRecord, &RecordSize, &NumOfStr);
+      RecordSize = CurrentSmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
       //
       // Record NumberOfSmbiosStructures, TableLength and MaxStructureSize
       //
@@ -1178,7 +1299,7 @@ SmbiosCreateTable (
     Status = GetNextSmbiosRecord (SmbiosProtocol, &CurrentSmbiosEntry, &SmbiosRecord);
 
     if ((Status == EFI_SUCCESS) && (CurrentSmbiosEntry->Smbios32BitTable)) {
-      GetSmbiosStructureSize(SmbiosProtocol, SmbiosRecord, &RecordSize, &NumOfStr);
+      RecordSize = CurrentSmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
       CopyMem (BufferPointer, SmbiosRecord, RecordSize);
       BufferPointer = BufferPointer + RecordSize;
     }
@@ -1226,7 +1347,6 @@ SmbiosCreate64BitTable (
 {
   UINT8                           *BufferPointer;
   UINTN                           RecordSize;
-  UINTN                           NumOfStr;
   EFI_STATUS                      Status;
   EFI_SMBIOS_HANDLE               SmbiosHandle;
   EFI_SMBIOS_PROTOCOL             *SmbiosProtocol;
@@ -1282,7 +1402,7 @@ SmbiosCreate64BitTable (
     Status = GetNextSmbiosRecord (SmbiosProtocol, &CurrentSmbiosEntry, &SmbiosRecord);
 
     if ((Status == EFI_SUCCESS) && (CurrentSmbiosEntry->Smbios64BitTable)) {
-      GetSmbiosStructureSize(SmbiosProtocol, SmbiosRecord, &RecordSize, &NumOfStr);
+      RecordSize = CurrentSmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
       //
       // Record TableMaximumSize
       //
@@ -1349,7 +1469,7 @@ SmbiosCreate64BitTable (
       //
       // This record can be added to 64-bit table
       //
-      GetSmbiosStructureSize(SmbiosProtocol, SmbiosRecord, &RecordSize, &NumOfStr);
+      RecordSize = CurrentSmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
       CopyMem (BufferPointer, SmbiosRecord, RecordSize);
       BufferPointer = BufferPointer + RecordSize;
     }
@@ -1381,8 +1501,11 @@ SmbiosCreate64BitTable (
   @param  Smbios32BitTable    The flag to update 32-bit table.
   @param  Smbios64BitTable    The flag to update 64-bit table.
 
+  @retval EFI_SUCCESS           The tables are installed.
+  @retval EFI_OUT_OF_RESOURCES  A table can't be created.
+
 **/
-VOID
+EFI_STATUS
 EFIAPI
 SmbiosTableConstruction (
   BOOLEAN     Smbios32BitTable,
@@ -1392,11 +1515,17 @@ SmbiosTableConstruction (
   UINT8       *Eps;
   UINT8       *Eps64Bit;
   EFI_STATUS  Status;
+  EFI_STATUS  ReturnStatus;
+
+  ReturnStatus = EFI_SUCCESS;
 
   if (Smbios32BitTable) {
     Status = SmbiosCreateTable ((VOID **) &Eps);
     if (!EFI_ERROR (Status)) {
       gBS->InstallConfigurationTable (&gEfiSmbiosTableGuid, Eps);
+      mPrivateData.Smbios32BitTableDirty = FALSE;
+    } else {
+      ReturnStatus = Status;
     }
   }
 
@@ -1404,8 +1533,73 @@ SmbiosTableConstruction (
     Status = SmbiosCreate64BitTable ((VOID **) &Eps64Bit);
     if (!EFI_ERROR (Status)) {
       gBS->InstallConfigurationTable (&gEfiSmbios3TableGuid, Eps64Bit);
+      mPrivateData.Smbios64BitTableDirty = FALSE;
+    } else {
+      ReturnStatus = Status;
     }
   }
+
+  return ReturnStatus;
+}
+
+/**
+  Builds the SMBIOS tables changed since they were last published and installs
+  them in the EFI System Table.
+
+  @param  This                  A pointer to the EDKII_SMBIOS_FLUSH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The SMBIOS tables in the EFI System Table are up to date.
+  @retval EFI_OUT_OF_RESOURCES  A table can't be built for lack of resources.
+  @retval EFI_ACCESS_DENIED     The SMBIOS records are being updated.
+
+**/
+EFI_STATUS
+EFIAPI
+SmbiosFlush (
+  IN EDKII_SMBIOS_FLUSH_PROTOCOL   *This
+  )
+{
+  EFI_STATUS                Status;
+  SMBIOS_INSTANCE           *Private;
+
+  Private = SMBIOS_INSTANCE_FROM_FLUSH (This);
+  //
+  // Enter into critical section
+  //
+  Status = EfiAcquireLockOrFail (&Private->DataLock);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SmbiosTableConstruction (Private->Smbios32BitTableDirty, Private->Smbios64BitTableDirty);
+
+  //
+  // Leave critical section
+  //
+  EfiReleaseLock (&Private->DataLock);
+  return Status;
+}
+
+/**
+  Ready To Boot event notification. Publish the SMBIOS tables built from all
+  the records added so far, and stop deferring the construction of the tables
+  for the records changed later.
+
+  @param  Event      The event whose notification function is being invoked.
+  @param  Context    The pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+SmbiosReadyToBootNotify (
+  IN EFI_EVENT      Event,
+  IN VOID           *Context
+  )
+{
+  mPrivateData.DeferTableConstruction = FALSE;
+  SmbiosFlush (&mPrivateData.SmbiosFlush);
+
+  gBS->CloseEvent (Event);
 }
 
 /**
@@ -1427,6 +1621,8 @@ SmbiosDriverEntryPoint (
   )
 {
   EFI_STATUS            Status;
+  EFI_EVENT             ReadyToBootEvent;
+  UINTN                 Index;
 
   mPrivateData.Signature                = SMBIOS_INSTANCE_SIGNATURE;
   mPrivateData.Smbios.Add               = SmbiosAdd;
@@ -1435,20 +1631,45 @@ SmbiosDriverEntryPoint (
   mPrivateData.Smbios.GetNext           = SmbiosGetNext;
   mPrivateData.Smbios.MajorVersion      = (UINT8) (PcdGet16 (PcdSmbiosVersion) >> 8);
   mPrivateData.Smbios.MinorVersion      = (UINT8) (PcdGet16 (PcdSmbiosVersion) & 0x00ff);
+  mPrivateData.SmbiosFlush.Flush        = SmbiosFlush;
 
   InitializeListHead (&mPrivateData.DataListHead);
-  InitializeListHead (&mPrivateData.AllocatedHandleListHead);
+  for (Index = 0; Index < SMBIOS_HANDLE_HASH_SIZE; Index++) {
+    InitializeListHead (&mPrivateData.HandleHashHead[Index]);
+  }
+  for (Index = 0; Index <= MAX_UINT8; Index++) {
+    InitializeListHead (&mPrivateData.TypeListHead[Index]);
+  }
   EfiInitializeLock (&mPrivateData.DataLock, TPL_NOTIFY);
 
+  if (FeaturePcdGet (PcdSmbiosDeferTableConstruction)) {
+    //
+    // Build the tables once when all the records are in. The notification runs
+    // at TPL_NOTIFY to publish the tables before the other Ready To Boot
+    // handlers read them.
+    //
+    Status = EfiCreateEventReadyToBootEx (
+               TPL_NOTIFY,
+               SmbiosReadyToBootNotify,
+               NULL,
+               &ReadyToBootEvent
+               );
+    if (!EFI_ERROR (Status)) {
+      mPrivateData.DeferTableConstruction = TRUE;
+    }
+  }
+
   //
   // Make a new handle and install the protocol
   //
   mPrivateData.Handle = NULL;
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &mPrivateData.Handle,
                   &gEfiSmbiosProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &mPrivateData.Smbios
+                  &mPrivateData.Smbios,
+                  &gEdkiiSmbiosFlushProtocolGuid,
+                  &mPrivateData.SmbiosFlush,
+                  NULL
                   );
 
   return Status;
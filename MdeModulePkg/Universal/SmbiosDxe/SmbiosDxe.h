@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <PiDxe.h>
 
 #include <Protocol/Smbios.h>
+#include <Protocol/SmbiosFlush.h>
 #include <IndustryStandard/SmBios.h>
 #include <Guid/EventGroup.h>
 #include <Guid/SmBios.h>
@@ -25,6 +26,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/PcdLib.h>
 
+//
+// Number of buckets of the hash table to look up SMBIOS records by handle.
+//
+#define SMBIOS_HANDLE_HASH_SIZE  0x100
+
+#define SMBIOS_HANDLE_HASH(Handle)  ((UINTN) (Handle) & (SMBIOS_HANDLE_HASH_SIZE - 1))
+
 #define SMBIOS_INSTANCE_SIGNATURE SIGNATURE_32 ('S', 'B', 'i', 's')
 typedef struct {
   UINT32                Signature;
@@ -33,6 +41,7 @@ typedef struct {
   // Produced protocol
   //
   EFI_SMBIOS_PROTOCOL   Smbios;
+  EDKII_SMBIOS_FLUSH_PROTOCOL  SmbiosFlush;
   //
   // Updates to record list must be locked.
   //
@@ -42,12 +51,41 @@ typedef struct {
   //
   LIST_ENTRY            DataListHead;
   //
-  // List of allocated SMBIOS handle.
+  // Bitmap of allocated SMBIOS handles, one bit per handle.
+  //
+  UINT32                AllocatedHandleBitmap[(MAX_UINT16 + 1) / 32];
+  //
+  // No handle below this one is free.
+  //
+  UINTN                 FirstFreeHandle;
+  //
+  // EFI_SMBIOS_ENTRY structures hashed by handle, linked by HandleLink.
+  //
+  LIST_ENTRY            HandleHashHead[SMBIOS_HANDLE_HASH_SIZE];
   //
-  LIST_ENTRY            AllocatedHandleListHead;
+  // EFI_SMBIOS_ENTRY structures of each type, linked by TypeLink in the
+  // order of DataListHead.
+  //
+  LIST_ENTRY            TypeListHead[MAX_UINT8 + 1];
+  //
+  // Total size of the records in the 32-bit and 64-bit tables, without the
+  // End-Of-Table structure.
+  //
+  UINTN                 Smbios32BitTableLength;
+  UINTN                 Smbios64BitTableLength;
+  //
+  // Tables changed since they were last published.
+  //
+  BOOLEAN               Smbios32BitTableDirty;
+  BOOLEAN               Smbios64BitTableDirty;
+  //
+  // Publishing the tables is deferred until Ready To Boot or a flush.
+  //
+  BOOLEAN               DeferTableConstruction;
 } SMBIOS_INSTANCE;
 
 #define SMBIOS_INSTANCE_FROM_THIS(this)  CR (this, SMBIOS_INSTANCE, Smbios, SMBIOS_INSTANCE_SIGNATURE)
+#define SMBIOS_INSTANCE_FROM_FLUSH(this)  CR (this, SMBIOS_INSTANCE, SmbiosFlush, SMBIOS_INSTANCE_SIGNATURE)
 
 //
 // SMBIOS record Header
@@ -74,6 +112,8 @@ typedef struct {
 typedef struct {
   UINT32                    Signature;
   LIST_ENTRY                Link;
+  LIST_ENTRY                HandleLink;
+  LIST_ENTRY                TypeLink;
   EFI_SMBIOS_RECORD_HEADER  *RecordHeader;
   UINTN                     RecordSize;
   //
@@ -84,23 +124,8 @@ typedef struct {
 } EFI_SMBIOS_ENTRY;
 
 #define SMBIOS_ENTRY_FROM_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, Link, EFI_SMBIOS_ENTRY_SIGNATURE)
-
-//
-// Private data to contain the Smbios handle that already allocated.
-//
-#define SMBIOS_HANDLE_ENTRY_SIGNATURE  SIGNATURE_32 ('S', 'h', 'r', 'd')
-
-typedef struct {
-  UINT32               Signature;
-  LIST_ENTRY           Link;
-  //
-  // Filter driver will register what record guid filter should be used.
-  //
-  EFI_SMBIOS_HANDLE    SmbiosHandle;
-
-} SMBIOS_HANDLE_ENTRY;
-
-#define SMBIOS_HANDLE_ENTRY_FROM_LINK(link)  CR (link, SMBIOS_HANDLE_ENTRY, Link, SMBIOS_HANDLE_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_HANDLE_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, HandleLink, EFI_SMBIOS_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_TYPE_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, TypeLink, EFI_SMBIOS_ENTRY_SIGNATURE)
 
 typedef struct {
   EFI_SMBIOS_TABLE_HEADER  Header;
@@ -113,12 +138,32 @@ typedef struct {
   @param  Smbios32BitTable    The flag to update 32-bit table.
   @param  Smbios64BitTable    The flag to update 64-bit table.
 
+  @retval EFI_SUCCESS           The tables are installed.
+  @retval EFI_OUT_OF_RESOURCES  A table can't be created.
+
 **/
-VOID
+EFI_STATUS
 EFIAPI
 SmbiosTableConstruction (
   BOOLEAN     Smbios32BitTable,
   BOOLEAN     Smbios64BitTable
   );
 
+/**
+  Builds the SMBIOS tables changed since they were last published and installs
+  them in the EFI System Table.
+
+  @param  This                  A pointer to the EDKII_SMBIOS_FLUSH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The SMBIOS tables in the EFI System Table are up to date.
+  @retval EFI_OUT_OF_RESOURCES  A table can't be built for lack of resources.
+  @retval EFI_ACCESS_DENIED     The SMBIOS records are being updated.
+
+**/
+EFI_STATUS
+EFIAPI
+SmbiosFlush (
+  IN EDKII_SMBIOS_FLUSH_PROTOCOL   *This
+  );
+
 #endif
@@ -147,6 +147,15 @@
 ///
 #define HTTP_HEADER_TRANSFER_ENCODING  "Transfer-Encoding"
 
+///
+/// Connection Header
+/// The Connection general-header field allows the sender to specify options
+/// that are desired for that particular connection. The "close" option
+/// signals that the connection will be closed after completion of the response.
+///
+#define HTTP_HEADER_CONNECTION         "Connection"
+#define HTTP_CONNECTION_CLOSE          "close"
+
 
 ///
 /// User Agent Request Header
@@ -0,0 +1,395 @@
+/** @file
+  Pool of idle HTTP connections shared by the HTTP instances of a HTTP service.
+
+  HTTP boot and firmware update clients often create a HTTP instance per
+  object to download, so the TCP connection to the server was set up and torn
+  down for each object even though the server keeps it open. When a HTTP
+  instance is reset or destroyed, its connection is moved to this pool if it
+  can be reused, and the next HTTP instance requesting the same host and port
+  takes it over instead of connecting again.
+
+  Only plain HTTP connections are pooled. HTTPS connections are bound to the
+  TLS child of their HTTP instance; TlsDxe resumes their TLS session instead.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpDriver.h"
+
+/**
+  Close a pooled connection and release its TCP child.
+
+  @param[in]  HttpService        The HTTP service private data.
+  @param[in]  Entry              The pooled connection.
+
+**/
+VOID
+HttpConnPoolDestroyEntry (
+  IN  HTTP_SERVICE          *HttpService,
+  IN  HTTP_CONN_POOL_ENTRY  *Entry
+  )
+{
+  RemoveEntryList (&Entry->Link);
+  HttpService->ConnPoolCount--;
+
+  //
+  // Resetting the TCP instance aborts the connection.
+  //
+  if (!Entry->LocalAddressIsIPv6) {
+    Entry->Tcp4->Configure (Entry->Tcp4, NULL);
+
+    gBS->CloseProtocol (
+           Entry->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Entry->TcpChildHandle
+      );
+  } else {
+    Entry->Tcp6->Configure (Entry->Tcp6, NULL);
+
+    gBS->CloseProtocol (
+           Entry->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      Entry->TcpChildHandle
+      );
+  }
+
+  FreePool (Entry->RemoteHost);
+  FreePool (Entry);
+}
+
+/**
+  Check whether the TCP connection of a pooled connection is still established.
+
+  The server may close an idle connection at any time.
+
+  @param[in]  Entry              The pooled connection.
+
+  @retval TRUE                   The connection is established.
+  @retval FALSE                  The connection is closed or closing.
+
+**/
+BOOLEAN
+HttpConnPoolIsEstablished (
+  IN  HTTP_CONN_POOL_ENTRY  *Entry
+  )
+{
+  EFI_STATUS                Status;
+  EFI_TCP4_CONNECTION_STATE Tcp4State;
+  EFI_TCP6_CONNECTION_STATE Tcp6State;
+
+  if (!Entry->LocalAddressIsIPv6) {
+    Status = Entry->Tcp4->GetModeData (Entry->Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN) (!EFI_ERROR (Status) && Tcp4State == Tcp4StateEstablished);
+  } else {
+    Status = Entry->Tcp6->GetModeData (Entry->Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN) (!EFI_ERROR (Status) && Tcp6State == Tcp6StateEstablished);
+  }
+}
+
+/**
+  Move the connection of a HTTP instance to the connection pool of its
+  service, so that it can be reused by another HTTP instance.
+
+  Only an idle, established HTTP connection which the server keeps open is
+  pooled. On success, the TCP child is detached from the HTTP instance.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval TRUE                   The connection is pooled.
+  @retval FALSE                  The connection can't be reused.
+
+**/
+BOOLEAN
+HttpConnPoolPut (
+  IN  HTTP_PROTOCOL        *HttpInstance
+  )
+{
+  HTTP_SERVICE             *HttpService;
+  HTTP_CONN_POOL_ENTRY     *Entry;
+
+  HttpService = HttpInstance->Service;
+
+  //
+  // The connection can only be reused if the last response has been read
+  // completely and no request is outstanding.
+  //
+  if (HttpInstance->UseHttps ||
+      HttpInstance->ConnectionClose ||
+      (HttpInstance->State != HTTP_STATE_TCP_CONNECTED) ||
+      (HttpInstance->RemoteHost == NULL) ||
+      (HttpInstance->MsgParser != NULL) ||
+      (HttpInstance->CacheBody != NULL) ||
+      !NetMapIsEmpty (&HttpInstance->TxTokens) ||
+      !NetMapIsEmpty (&HttpInstance->RxTokens)) {
+    return FALSE;
+  }
+
+  Entry = AllocateZeroPool (sizeof (HTTP_CONN_POOL_ENTRY));
+  if (Entry == NULL) {
+    return FALSE;
+  }
+
+  Entry->LocalAddressIsIPv6 = HttpInstance->LocalAddressIsIPv6;
+  Entry->RemotePort         = HttpInstance->RemotePort;
+  Entry->Tcp4               = HttpInstance->Tcp4;
+  Entry->Tcp6               = HttpInstance->Tcp6;
+  CopyMem (&Entry->IPv4Node, &HttpInstance->IPv4Node, sizeof (Entry->IPv4Node));
+  CopyMem (&Entry->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Entry->Ipv6Node));
+  if (!Entry->LocalAddressIsIPv6) {
+    Entry->TcpChildHandle = HttpInstance->Tcp4ChildHandle;
+  } else {
+    Entry->TcpChildHandle = HttpInstance->Tcp6ChildHandle;
+  }
+
+  if ((Entry->TcpChildHandle == NULL) || !HttpConnPoolIsEstablished (Entry)) {
+    FreePool (Entry);
+    return FALSE;
+  }
+
+  Entry->RemoteHost = AllocateCopyPool (AsciiStrSize (HttpInstance->RemoteHost), HttpInstance->RemoteHost);
+  if (Entry->RemoteHost == NULL) {
+    FreePool (Entry);
+    return FALSE;
+  }
+
+  //
+  // The TCP child stays opened by the driver for the controller, only the
+  // open for the HTTP child goes away with it.
+  //
+  if (!Entry->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           Entry->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    gBS->CloseProtocol (
+           Entry->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CLOSED;
+
+  if (HttpService->ConnPoolCount == HTTP_CONN_POOL_SIZE) {
+    //
+    // Close the connection idle for the longest time.
+    //
+    HttpConnPoolDestroyEntry (
+      HttpService,
+      BASE_CR (GetFirstNode (&HttpService->ConnPool), HTTP_CONN_POOL_ENTRY, Link)
+      );
+  }
+
+  InsertTailList (&HttpService->ConnPool, &Entry->Link);
+  HttpService->ConnPoolCount++;
+
+  DEBUG ((DEBUG_INFO, "HttpDxe: Pooled the connection to %a:%d.\n", Entry->RemoteHost, Entry->RemotePort));
+
+  return TRUE;
+}
+
+/**
+  Take over a pooled connection to the remote host and port of a HTTP
+  instance.
+
+  On success, the TCP child of the HTTP instance is destroyed and replaced
+  by the one of the pooled connection, which is already connected.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval TRUE                   A pooled connection is taken over.
+  @retval FALSE                  No pooled connection can be used.
+
+**/
+BOOLEAN
+HttpConnPoolTake (
+  IN  HTTP_PROTOCOL        *HttpInstance
+  )
+{
+  HTTP_SERVICE             *HttpService;
+  HTTP_CONN_POOL_ENTRY     *Entry;
+  LIST_ENTRY               *Link;
+  LIST_ENTRY               *NextLink;
+  EFI_STATUS               Status;
+  VOID                     *Interface;
+
+  HttpService = HttpInstance->Service;
+
+  if (HttpInstance->UseHttps || (HttpInstance->RemoteHost == NULL)) {
+    return FALSE;
+  }
+
+  NET_LIST_FOR_EACH_SAFE (Link, NextLink, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_POOL_ENTRY, Link);
+
+    if ((Entry->LocalAddressIsIPv6 != HttpInstance->LocalAddressIsIPv6) ||
+        (Entry->RemotePort != HttpInstance->RemotePort) ||
+        (AsciiStriCmp (Entry->RemoteHost, HttpInstance->RemoteHost) != 0)) {
+      continue;
+    }
+
+    //
+    // The local address and port must be the ones the HTTP instance is
+    // configured with.
+    //
+    if ((!Entry->LocalAddressIsIPv6 &&
+         CompareMem (&Entry->IPv4Node, &HttpInstance->IPv4Node, sizeof (Entry->IPv4Node)) != 0) ||
+        (Entry->LocalAddressIsIPv6 &&
+         CompareMem (&Entry->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Entry->Ipv6Node)) != 0)) {
+      continue;
+    }
+
+    if (!HttpConnPoolIsEstablished (Entry)) {
+      HttpConnPoolDestroyEntry (HttpService, Entry);
+      continue;
+    }
+
+    if (!Entry->LocalAddressIsIPv6) {
+      Status = gBS->OpenProtocol (
+                      Entry->TcpChildHandle,
+                      &gEfiTcp4ProtocolGuid,
+                      (VOID **) &Interface,
+                      HttpService->Ip4DriverBindingHandle,
+                      HttpInstance->Handle,
+                      EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                      );
+    } else {
+      Status = gBS->OpenProtocol (
+                      Entry->TcpChildHandle,
+                      &gEfiTcp6ProtocolGuid,
+                      (VOID **) &Interface,
+                      HttpService->Ip6DriverBindingHandle,
+                      HttpInstance->Handle,
+                      EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                      );
+    }
+
+    if (EFI_ERROR (Status)) {
+      HttpConnPoolDestroyEntry (HttpService, Entry);
+      continue;
+    }
+
+    //
+    // Replace the unconnected TCP child of the HTTP instance.
+    //
+    if (!Entry->LocalAddressIsIPv6) {
+      if (HttpInstance->Tcp4ChildHandle != NULL) {
+        gBS->CloseProtocol (
+               HttpInstance->Tcp4ChildHandle,
+               &gEfiTcp4ProtocolGuid,
+               HttpService->Ip4DriverBindingHandle,
+               HttpService->ControllerHandle
+               );
+
+        gBS->CloseProtocol (
+               HttpInstance->Tcp4ChildHandle,
+               &gEfiTcp4ProtocolGuid,
+               HttpService->Ip4DriverBindingHandle,
+               HttpInstance->Handle
+               );
+
+        NetLibDestroyServiceChild (
+          HttpService->ControllerHandle,
+          HttpService->Ip4DriverBindingHandle,
+          &gEfiTcp4ServiceBindingProtocolGuid,
+          HttpInstance->Tcp4ChildHandle
+          );
+      }
+
+      HttpInstance->Tcp4ChildHandle = Entry->TcpChildHandle;
+      HttpInstance->Tcp4            = Entry->Tcp4;
+    } else {
+      if (HttpInstance->Tcp6ChildHandle != NULL) {
+        gBS->CloseProtocol (
+               HttpInstance->Tcp6ChildHandle,
+               &gEfiTcp6ProtocolGuid,
+               HttpService->Ip6DriverBindingHandle,
+               HttpService->ControllerHandle
+               );
+
+        gBS->CloseProtocol (
+               HttpInstance->Tcp6ChildHandle,
+               &gEfiTcp6ProtocolGuid,
+               HttpService->Ip6DriverBindingHandle,
+               HttpInstance->Handle
+               );
+
+        NetLibDestroyServiceChild (
+          HttpService->ControllerHandle,
+          HttpService->Ip6DriverBindingHandle,
+          &gEfiTcp6ServiceBindingProtocolGuid,
+          HttpInstance->Tcp6ChildHandle
+          );
+      }
+
+      HttpInstance->Tcp6ChildHandle = Entry->TcpChildHandle;
+      HttpInstance->Tcp6            = Entry->Tcp6;
+    }
+
+    HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+    HttpService->ConnectionsTaken++;
+
+    DEBUG ((DEBUG_INFO, "HttpDxe: Reusing the pooled connection to %a:%d.\n", Entry->RemoteHost, Entry->RemotePort));
+
+    RemoveEntryList (&Entry->Link);
+    HttpService->ConnPoolCount--;
+    FreePool (Entry->RemoteHost);
+    FreePool (Entry);
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Close and release the pooled connections of a HTTP service.
+
+  @param[in]  HttpService        The HTTP service private data.
+  @param[in]  UsingIpv6          If TRUE, release the TCP6 connections, otherwise
+                                 release the TCP4 connections.
+
+**/
+VOID
+HttpConnPoolFlush (
+  IN  HTTP_SERVICE         *HttpService,
+  IN  BOOLEAN              UsingIpv6
+  )
+{
+  HTTP_CONN_POOL_ENTRY     *Entry;
+  LIST_ENTRY               *Link;
+  LIST_ENTRY               *NextLink;
+
+  NET_LIST_FOR_EACH_SAFE (Link, NextLink, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_POOL_ENTRY, Link);
+    if (Entry->LocalAddressIsIPv6 == UsingIpv6) {
+      HttpConnPoolDestroyEntry (HttpService, Entry);
+    }
+  }
+}
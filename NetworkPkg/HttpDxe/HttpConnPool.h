@@ -0,0 +1,84 @@
+/** @file
+  The header file of the pool of idle HTTP connections shared by the HTTP
+  instances of a HTTP service.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EFI_HTTP_CONN_POOL_H__
+#define __EFI_HTTP_CONN_POOL_H__
+
+//
+// Max number of idle connections kept by a HTTP service.
+//
+#define HTTP_CONN_POOL_SIZE          4
+
+///
+/// An idle persistent connection left by a HTTP instance, which the next
+/// HTTP instance requesting the same server can take over.
+///
+typedef struct {
+  LIST_ENTRY                    Link;
+  BOOLEAN                       LocalAddressIsIPv6;
+  EFI_HANDLE                    TcpChildHandle;
+  EFI_TCP4_PROTOCOL             *Tcp4;
+  EFI_TCP6_PROTOCOL             *Tcp6;
+  CHAR8                         *RemoteHost;
+  UINT16                        RemotePort;
+  EFI_HTTPv4_ACCESS_POINT       IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT       Ipv6Node;
+} HTTP_CONN_POOL_ENTRY;
+
+/**
+  Move the connection of a HTTP instance to the connection pool of its
+  service, so that it can be reused by another HTTP instance.
+
+  Only an idle, established HTTP connection which the server keeps open is
+  pooled. On success, the TCP child is detached from the HTTP instance.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval TRUE                   The connection is pooled.
+  @retval FALSE                  The connection can't be reused.
+
+**/
+BOOLEAN
+HttpConnPoolPut (
+  IN  HTTP_PROTOCOL        *HttpInstance
+  );
+
+/**
+  Take over a pooled connection to the remote host and port of a HTTP
+  instance.
+
+  On success, the TCP child of the HTTP instance is destroyed and replaced
+  by the one of the pooled connection, which is already connected.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval TRUE                   A pooled connection is taken over.
+  @retval FALSE                  No pooled connection can be used.
+
+**/
+BOOLEAN
+HttpConnPoolTake (
+  IN  HTTP_PROTOCOL        *HttpInstance
+  );
+
+/**
+  Close and release the pooled connections of a HTTP service.
+
+  @param[in]  HttpService        The HTTP service private data.
+  @param[in]  UsingIpv6          If TRUE, release the TCP6 connections, otherwise
+                                 release the TCP4 connections.
+
+**/
+VOID
+HttpConnPoolFlush (
+  IN  HTTP_SERVICE         *HttpService,
+  IN  BOOLEAN              UsingIpv6
+  );
+
+#endif
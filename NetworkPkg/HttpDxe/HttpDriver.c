@@ -67,6 +67,7 @@ HttpCreateService (
   HttpService->ControllerHandle = Controller;
   HttpService->ChildrenNumber = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->ConnPool);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -90,6 +91,9 @@ HttpCleanService (
   if (HttpService == NULL) {
     return ;
   }
+
+  HttpConnPoolFlush (HttpService, UsingIpv6);
+
   if (!UsingIpv6) {
     if (HttpService->Tcp4ChildHandle != NULL) {
       gBS->CloseProtocol (
@@ -441,6 +441,7 @@ EfiHttpRequest (
     } else {
       if ((HttpInstance->RemotePort == RemotePort) &&
           (AsciiStrCmp (HttpInstance->RemoteHost, HostName) == 0) &&
+          !HttpInstance->ConnectionClose &&
           (!HttpInstance->UseHttps || (HttpInstance->UseHttps &&
                                        !TlsConfigure &&
                                        HttpInstance->TlsSessionState == EfiTlsSessionDataTransferring))) {
@@ -556,13 +557,22 @@ EfiHttpRequest (
 
     if (HttpInstance->UseHttps && !TlsConfigure) {
       Status = TlsCloseSession (HttpInstance);
-      if (EFI_ERROR (Status)) {
+      if (EFI_ERROR (Status) && !HttpInstance->ConnectionClose) {
         goto Error1;
       }
 
       TlsCloseTxRxEvent (HttpInstance);
+
+      //
+      // Configure the TLS session again for the new connection, which
+      // recreates the TLS TX/RX events and sets the new host to verify.
+      // TlsDxe resumes the session established with that host before.
+      //
+      TlsConfigure = TRUE;
     }
 
+    HttpInstance->ConnectionClose = FALSE;
+
     HttpCloseConnection (HttpInstance);
     EfiHttpCancel (This, NULL);
   }
@@ -656,6 +666,13 @@ EfiHttpRequest (
     goto Error5;
   }
 
+  if (!Configure && !ReConfigure && (Request != NULL)) {
+    HttpInstance->Service->ConnectionsReused++;
+    if (NetMapGetCount (&HttpInstance->TxTokens) > 1) {
+      HttpInstance->Service->RequestsPipelined++;
+    }
+  }
+
   DispatchDpc ();
 
   if (HostName != NULL) {
@@ -983,6 +1000,7 @@ HttpResponseWorker (
   HTTP_TOKEN_WRAP               *ValueInItem;
   UINTN                         HdrLen;
   NET_FRAGMENT                  Fragment;
+  EFI_HTTP_HEADER               *Header;
 
   if (Wrap == NULL || Wrap->HttpInstance == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -1185,6 +1203,23 @@ HttpResponseWorker (
       FreePool (HttpHeaders);
       HttpHeaders = NULL;
 
+      //
+      // Check whether the server keeps the connection open for the next request.
+      //
+      Header = HttpFindHeader (HttpMsg->HeaderCount, HttpMsg->Headers, HTTP_HEADER_CONNECTION);
+      if ((Header != NULL) && (AsciiStriCmp (Header->FieldValue, HTTP_CONNECTION_CLOSE) == 0)) {
+        HttpInstance->ConnectionClose = TRUE;
+      }
+
+      //
+      // The response to the first outstanding request is received, send the
+      // requests held behind it.
+      //
+      if ((ValueInItem != NULL) &&
+          !HttpInstance->ConnectionClose &&
+          (HttpMsg->Data.Response->StatusCode != HTTP_STATUS_100_CONTINUE)) {
+        NetMapIterate (&HttpInstance->TxTokens, HttpTcpTransmit, NULL);
+      }
 
       //
       // Init message-body parser by header information.
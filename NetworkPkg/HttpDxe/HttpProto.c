@@ -835,6 +835,24 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL          *HttpInstance
   )
 {
+  HTTP_SERVICE               *HttpService;
+
+  HttpService = HttpInstance->Service;
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpDxe: %d connections opened, %d requests sent on reused connections, %d connections taken from the pool, %d requests pipelined.\n",
+    HttpService->ConnectionsOpened,
+    HttpService->ConnectionsReused,
+    HttpService->ConnectionsTaken,
+    HttpService->RequestsPipelined
+    ));
+
+  //
+  // Keep an idle connection for the next HTTP instance talking to the same
+  // server, instead of closing it.
+  //
+  HttpConnPoolPut (HttpInstance);
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -994,6 +1012,7 @@ HttpCreateConnection (
 
   if (!EFI_ERROR (Status)) {
     HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+    HttpInstance->Service->ConnectionsOpened++;
   }
 
   return Status;
@@ -1413,6 +1432,25 @@ HttpInitSession (
     }
   }
 
+  //
+  // Take over an idle connection to the same server left by another HTTP
+  // instance, if any. It is already configured and connected.
+  //
+  if (Configure && !HttpInstance->UseHttps && HttpConnPoolTake (HttpInstance)) {
+    HttpCloseTcpConnCloseEvent (HttpInstance);
+    Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = HttpCreateTcpTxEvent (Wrap);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Configure = FALSE;
+  }
+
   if (!HttpInstance->LocalAddressIsIPv6) {
     //
     // Configure TCP instance.
@@ -1610,6 +1648,8 @@ HttpTransmitTcp (
     }
   }
 
+  Wrap->TcpWrap.IsTxStarted = TRUE;
+
   return Status;
 
 ON_ERROR:
@@ -1665,14 +1705,37 @@ HttpTokenExist (
 }
 
 /**
-  Check whether the HTTP message associated with Tx4Token or Tx6Token is already sent out.
+  Check whether a request with the given method may be followed by other
+  requests on the connection before its response is received.
+
+  Only the requests which are safe to retry are pipelined, as HTTP/1.1
+  requires (RFC 7230, section 6.3.2).
+
+  @param[in]  Method             The HTTP method of the request.
+
+  @retval TRUE                   Other requests may be sent behind it.
+  @retval FALSE                  Its response must be received first.
+
+**/
+BOOLEAN
+HttpIsPipelineSafe (
+  IN EFI_HTTP_METHOD        Method
+  )
+{
+  return (BOOLEAN) (Method == HttpMethodGet || Method == HttpMethodHead);
+}
+
+/**
+  Check whether a new HTTP message can be sent right behind the HTTP message
+  associated with Tx4Token or Tx6Token, without waiting for its response.
 
   @param[in]  Map                The container of Tx4Token or Tx6Token.
   @param[in]  Item               Current item to check against.
   @param[in]  Context            The Token to check againist.
 
-  @retval EFI_NOT_READY          The HTTP message is still queued in the list.
-  @retval EFI_SUCCESS            The HTTP message has been sent out.
+  @retval EFI_NOT_READY          The HTTP message is still queued in the list,
+                                 or its response must be received first.
+  @retval EFI_SUCCESS            The HTTP message has been handed to TCP.
 
 **/
 EFI_STATUS
@@ -1687,7 +1750,7 @@ HttpTcpNotReady (
 
   ValueInItem = (HTTP_TOKEN_WRAP *) Item->Value;
 
-  if (!ValueInItem->TcpWrap.IsTxDone) {
+  if (!ValueInItem->TcpWrap.IsTxStarted || !HttpIsPipelineSafe (ValueInItem->TcpWrap.Method)) {
     return EFI_NOT_READY;
   }
 
@@ -1702,6 +1765,8 @@ HttpTcpNotReady (
   @param[in]  Context            The Token to check againist.
 
   @retval EFI_OUT_OF_RESOURCES   Failed to allocate resources.
+  @retval EFI_NOT_READY          The HTTP message is already handed to TCP, and
+                                 the following ones must wait for its response.
   @retval EFI_SUCCESS            The HTTP message is queued into TCP transmit
                                  queue.
 
@@ -1724,7 +1789,15 @@ HttpTcpTransmit (
   RequestMsg = NULL;
 
   ValueInItem = (HTTP_TOKEN_WRAP *) Item->Value;
-  if (ValueInItem->TcpWrap.IsTxDone) {
+  if (ValueInItem->TcpWrap.IsTxStarted) {
+    //
+    // Stop at a request which can't be pipelined, the requests queued behind
+    // it are sent once its response is received.
+    //
+    if (!HttpIsPipelineSafe (ValueInItem->TcpWrap.Method)) {
+      return EFI_NOT_READY;
+    }
+
     return EFI_SUCCESS;
   }
 
@@ -1765,7 +1838,19 @@ HttpTcpTransmit (
              (UINT8*) RequestMsg,
              RequestMsgSize
              );
-  FreePool (RequestMsg);
+
+  //
+  // The plain HTTP request message is transmitted in place, and freed when
+  // the transmit completes.
+  //
+  if (EFI_ERROR (Status) || ValueInItem->HttpInstance->UseHttps) {
+    FreePool (RequestMsg);
+  }
+
+  if (!EFI_ERROR (Status) && (&Item->Link != GetFirstNode (&Map->Used))) {
+    ValueInItem->HttpInstance->Service->RequestsPipelined++;
+  }
+
   return Status;
 }
 
@@ -61,6 +61,20 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                    ChildrenList;
   UINTN                         ChildrenNumber;
   INTN                          State;
+
+  //
+  // Idle connections left by the HTTP instances, see HttpConnPool.c.
+  //
+  LIST_ENTRY                    ConnPool;
+  UINTN                         ConnPoolCount;
+
+  //
+  // Connection reuse statistics.
+  //
+  UINT32                        ConnectionsOpened;
+  UINT32                        ConnectionsReused;
+  UINT32                        ConnectionsTaken;
+  UINT32                        RequestsPipelined;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -72,6 +86,7 @@ typedef struct {
   EFI_TCP4_RECEIVE_DATA         Rx4Data;
   EFI_TCP6_IO_TOKEN             Rx6Token;
   EFI_TCP6_RECEIVE_DATA         Rx6Data;
+  BOOLEAN                       IsTxStarted;
   BOOLEAN                       IsTxDone;
   BOOLEAN                       IsRxDone;
   UINTN                         BodyLen;
@@ -167,6 +182,12 @@ typedef struct _HTTP_PROTOCOL {
 
   CHAR8                         *Url;
 
+  //
+  // The server asked to close the connection after the last response
+  // ("Connection: close"), so it can't be reused by the next request.
+  //
+  BOOLEAN                       ConnectionClose;
+
   //
   // Https Support
   //
@@ -469,14 +490,31 @@ HttpTokenExist (
   );
 
 /**
-  Check whether the HTTP message associated with TxToken or Tx6Token is already sent out.
+  Check whether a request with the given method may be followed by other
+  requests on the connection before its response is received.
+
+  @param[in]  Method             The HTTP method of the request.
+
+  @retval TRUE                   Other requests may be sent behind it.
+  @retval FALSE                  Its response must be received first.
+
+**/
+BOOLEAN
+HttpIsPipelineSafe (
+  IN EFI_HTTP_METHOD        Method
+  );
+
+/**
+  Check whether a new HTTP message can be sent right behind the HTTP message
+  associated with TxToken or Tx6Token, without waiting for its response.
 
   @param[in]  Map                The container of TxToken.
   @param[in]  Item               Current item to check against.
   @param[in]  Context            The Token to check againist.
 
-  @retval EFI_NOT_READY          The HTTP message is still queued in the list.
-  @retval EFI_SUCCESS            The HTTP message has been sent out.
+  @retval EFI_NOT_READY          The HTTP message is still queued in the list,
+                                 or its response must be received first.
+  @retval EFI_SUCCESS            The HTTP message has been handed to TCP.
 
 **/
 EFI_STATUS
@@ -515,6 +553,8 @@ HttpInitSession (
   @param[in]  Context            The Token to check againist.
 
   @retval EFI_OUT_OF_RESOURCES   Failed to allocate resources.
+  @retval EFI_NOT_READY          The HTTP message is already handed to TCP, and
+                                 the following ones must wait for its response.
   @retval EFI_SUCCESS            The HTTP message is queued into TCP transmit
                                  queue.
 
@@ -630,11 +630,27 @@ TlsConfigureSession (
   HttpInstance->TlsConfigData.SessionState        = EfiTlsSessionNotStarted;
 
   //
+  // EfiTlsSessionState,
   // EfiTlsConnectionEnd,
   // EfiTlsVerifyMethod,
-  // EfiTlsVerifyHost,
-  // EfiTlsSessionState
+  // EfiTlsVerifyHost
+  //
+  // The session state goes first, since the TLS child may be reused from a
+  // previous connection and the others can only be set on a session that
+  // is not started.
   //
+  Status = HttpInstance->Tls->SetSessionData (
+                                HttpInstance->Tls,
+                                EfiTlsSessionState,
+                                &(HttpInstance->TlsConfigData.SessionState),
+                                sizeof (EFI_TLS_SESSION_STATE)
+                                );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpInstance->TlsSessionState = EfiTlsSessionNotStarted;
+
   Status = HttpInstance->Tls->SetSessionData (
                                 HttpInstance->Tls,
                                 EfiTlsConnectionEnd,
@@ -665,13 +681,17 @@ TlsConfigureSession (
     return Status;
   }
 
+  //
+  // The port lets TlsDxe resume the session established with the same
+  // server before. Other TLS drivers may not know it.
+  //
   Status = HttpInstance->Tls->SetSessionData (
                                 HttpInstance->Tls,
-                                EfiTlsSessionState,
-                                &(HttpInstance->TlsConfigData.SessionState),
-                                sizeof (EFI_TLS_SESSION_STATE)
+                                EdkiiTlsPeerPort,
+                                &HttpInstance->RemotePort,
+                                sizeof (UINT16)
                                 );
-  if (EFI_ERROR (Status)) {
+  if (EFI_ERROR (Status) && Status != EFI_UNSUPPORTED) {
     return Status;
   }
 
@@ -0,0 +1,122 @@
+/** @file
+  PXE Base Code MTFTP Stream protocol is produced by the PXE Base Code driver
+  on the same handles as EFI_PXE_BASE_CODE_PROTOCOL.
+
+  EFI_PXE_BASE_CODE_PROTOCOL.Mtftp() downloads one file at a time into a
+  buffer large enough for the whole file. This protocol downloads several
+  files from a TFTP server at the same time, each over its own MTFTP session,
+  and hands the data of every file to a consumer function as it arrives, so
+  it can be hashed, decompressed or copied to its final location without
+  buffering the file first.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __PXE_BC_MTFTP_STREAM_H__
+#define __PXE_BC_MTFTP_STREAM_H__
+
+#include <Protocol/PxeBaseCode.h>
+
+#define EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL_GUID \
+  { \
+    0x7d7e2c83, 0xef40, 0x4740, { 0x98, 0xd4, 0x52, 0xd5, 0x5e, 0xfe, 0x8f, 0xa7 } \
+  }
+
+#define EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL;
+
+/**
+  Consumes the next part of a file being downloaded.
+
+  The parts of a file are passed in order, without holes, and each part is
+  passed once. Parts of different files may be interleaved.
+
+  @param  Context               The context of the file, see EDKII_PXE_BC_MTFTP_STREAM_FILE.
+  @param  Offset                The offset of Data in the file.
+  @param  Data                  The data. It is only valid during the call.
+  @param  DataLength            The size, in bytes, of Data.
+
+  @retval EFI_SUCCESS           The data is consumed, the download continues.
+  @retval Others                The download of this file is aborted with this
+                                status. The downloads of the other files continue.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PXE_BC_MTFTP_STREAM_CONSUMER)(
+  IN VOID                                *Context,
+  IN UINT64                              Offset,
+  IN VOID                                *Data,
+  IN UINTN                               DataLength
+  );
+
+///
+/// A file to download.
+///
+typedef struct {
+  ///
+  /// The null-terminated ASCII name of the file on the server.
+  ///
+  UINT8                                  *Filename;
+  ///
+  /// The function receiving the data of the file.
+  ///
+  EDKII_PXE_BC_MTFTP_STREAM_CONSUMER     Consumer;
+  VOID                                   *Context;
+  ///
+  /// Returns the number of bytes passed to Consumer.
+  ///
+  UINT64                                 FileSize;
+  ///
+  /// Returns the result of the download of this file.
+  ///
+  EFI_STATUS                             Status;
+} EDKII_PXE_BC_MTFTP_STREAM_FILE;
+
+/**
+  Downloads files from a TFTP server, handing their data to consumer functions
+  as it is received.
+
+  Up to an implementation defined number of files are downloaded at the same
+  time. The function returns when the downloads of all the files have either
+  completed or failed. The PXE Base Code protocol must have been started.
+
+  @param  This                  A pointer to the EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL instance.
+  @param  ServerIp              The TFTP server IP address.
+  @param  BlockSize             The requested block size, or NULL for the default.
+  @param  FileCount             The number of entries in Files.
+  @param  Files                 The files to download.
+
+  @retval EFI_SUCCESS           All the files are downloaded.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_STARTED       The PXE Base Code protocol is in the stopped state.
+  @retval EFI_OUT_OF_RESOURCES  Resources could not be allocated.
+  @retval Others                The download of at least one file failed, the
+                                status of the first one failing is returned.
+                                Files[].Status tells which ones.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PXE_BC_MTFTP_STREAM_READ_FILES)(
+  IN     EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL  *This,
+  IN     EFI_IP_ADDRESS                      *ServerIp,
+  IN     UINTN                               *BlockSize  OPTIONAL,
+  IN     UINTN                               FileCount,
+  IN OUT EDKII_PXE_BC_MTFTP_STREAM_FILE      *Files
+  );
+
+struct _EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL {
+  ///
+  /// Protocol revision of this implementation
+  ///
+  UINT64                                     Revision;
+  EDKII_PXE_BC_MTFTP_STREAM_READ_FILES       ReadFiles;
+};
+
+extern EFI_GUID gEdkiiPxeBcMtftpStreamProtocolGuid;
+
+#endif
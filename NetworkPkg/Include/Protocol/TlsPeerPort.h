@@ -0,0 +1,26 @@
+/** @file
+  EDK II extension of the EFI TLS Protocol session data types.
+
+  EFI_TLS_PROTOCOL knows the host name of the peer from EfiTlsVerifyHost, but
+  not the port it is connected to. TlsDxe only resumes a session established
+  with a previous connection to the same host and port, so a consumer that
+  wants its sessions to be resumed sets the port with EdkiiTlsPeerPort, along
+  with the other session configuration data.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_TLS_PEER_PORT_H__
+#define __EDKII_TLS_PEER_PORT_H__
+
+#include <Protocol/Tls.h>
+
+///
+/// The port of the peer, a UINT16 in host byte order. It can only be set by
+/// SetSessionData(), while the session is not started.
+///
+#define EdkiiTlsPeerPort  ((EFI_TLS_SESSION_DATA_TYPE) 0x80000000)
+
+#endif
@@ -60,6 +60,12 @@ TlsConfigurationSetData (
   switch (DataType) {
   case EfiTlsConfigDataTypeCACertificate:
     Status = TlsSetCaCertificate (Instance->TlsConn, Data, DataSize);
+
+    //
+    // The CA certificates are shared by all the children of the service,
+    // and the sessions cached for the previous ones won't be resumed.
+    //
+    TlsFlushSessionCache (Instance->Service);
     break;
   case EfiTlsConfigDataTypeHostPublicCert:
     Status = TlsSetHostPublicCert (Instance->TlsConn, Data, DataSize);
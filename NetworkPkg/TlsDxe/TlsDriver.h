@@ -26,6 +26,11 @@
 
 #define TLS_INSTANCE_SIGNATURE   SIGNATURE_32 ('T', 'L', 'S', 'I')
 
+//
+// Number of servers whose TLS session is kept for resumption.
+//
+#define TLS_SESSION_CACHE_SIZE   8
+
 ///
 /// TLS Service Data
 ///
@@ -36,6 +41,18 @@ typedef struct _TLS_SERVICE  TLS_SERVICE;
 ///
 typedef struct _TLS_INSTANCE TLS_INSTANCE;
 
+///
+/// Session established with a server, to be resumed by the next connection.
+/// A session is only resumed by a connection to the same host and port,
+/// verifying the peer the same way against the same CA certificates.
+///
+typedef struct {
+  CHAR8                           *HostName;
+  UINT16                          Port;
+  EFI_TLS_VERIFY                  VerifyMethod;
+  UINT8                           CaDigest[SHA256_DIGEST_SIZE];
+  VOID                            *Session;
+} TLS_SESSION_CACHE_ENTRY;
 
 struct _TLS_SERVICE {
   UINT32                          Signature;
@@ -56,6 +73,20 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Sessions of the last servers connected to, see TLS_SESSION_CACHE_ENTRY, so
+  // that a new connection to the same server can resume the session instead of
+  // doing a full handshake.
+  //
+  TLS_SESSION_CACHE_ENTRY         SessionCache[TLS_SESSION_CACHE_SIZE];
+  UINTN                           SessionCacheNext;
+
+  //
+  // Number of handshakes completed by the children of this service.
+  //
+  UINT32                          FullHandshakes;
+  UINT32                          ResumedHandshakes;
 };
 
 struct _TLS_INSTANCE {
@@ -77,6 +108,14 @@ struct _TLS_INSTANCE {
   // per established connection.
   //
   VOID                            *TlsConn;
+
+  //
+  // Host name set by EfiTlsVerifyHost and port set by EdkiiTlsPeerPort, which
+  // identify the server in the session cache.
+  //
+  CHAR8                           *HostName;
+  UINT16                          PeerPort;
+  BOOLEAN                         PeerPortValid;
 };
 
 
@@ -347,3 +347,248 @@ ERROR:
   return Status;
 }
 
+
+/**
+  Get the session cache key of the connection of a TLS instance.
+
+  Only the sessions of the connections which verify the peer certificate
+  against the CA certificates, for a known host and port, are cached: a
+  resumed session skips the verification, so it must not be resumed by a
+  connection that would have verified the peer differently.
+
+  @param[in]   TlsInstance   The pointer to the TLS instance.
+  @param[out]  Key           The key. Its HostName points to the one of
+                             the TLS instance, and its Session is NULL.
+
+  @retval TRUE               The key is returned.
+  @retval FALSE              The session of the TLS instance isn't cached.
+
+**/
+BOOLEAN
+TlsGetSessionCacheKey (
+  IN     TLS_INSTANCE                  *TlsInstance,
+     OUT TLS_SESSION_CACHE_ENTRY       *Key
+  )
+{
+  UINTN                     DigestSize;
+
+  if (TlsInstance->HostName == NULL || !TlsInstance->PeerPortValid) {
+    return FALSE;
+  }
+
+  Key->VerifyMethod = TlsGetVerify (TlsInstance->TlsConn);
+  if ((Key->VerifyMethod & EFI_TLS_VERIFY_PEER) == 0) {
+    return FALSE;
+  }
+
+  DigestSize = sizeof (Key->CaDigest);
+  if (EFI_ERROR (TlsGetCaCertificateDigest (TlsInstance->TlsConn, Key->CaDigest, &DigestSize))) {
+    return FALSE;
+  }
+
+  Key->HostName = TlsInstance->HostName;
+  Key->Port     = TlsInstance->PeerPort;
+  Key->Session  = NULL;
+  return TRUE;
+}
+
+/**
+  Find the session cache entry matching a key.
+
+  @param[in]  Service        The TLS service data.
+  @param[in]  Key            The key returned by TlsGetSessionCacheKey().
+
+  @return The index of the entry, or TLS_SESSION_CACHE_SIZE if the key isn't
+          in the cache.
+
+**/
+UINTN
+TlsFindCachedSession (
+  IN     TLS_SERVICE                   *Service,
+  IN     TLS_SESSION_CACHE_ENTRY       *Key
+  )
+{
+  TLS_SESSION_CACHE_ENTRY   *Entry;
+  UINTN                     Index;
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    Entry = &Service->SessionCache[Index];
+    if (Entry->HostName != NULL &&
+        Entry->Port == Key->Port &&
+        Entry->VerifyMethod == Key->VerifyMethod &&
+        CompareMem (Entry->CaDigest, Key->CaDigest, sizeof (Key->CaDigest)) == 0 &&
+        AsciiStrCmp (Entry->HostName, Key->HostName) == 0) {
+      break;
+    }
+  }
+
+  return Index;
+}
+
+/**
+  Release a session cache entry.
+
+  @param[in]  Entry          The session cache entry.
+
+**/
+VOID
+TlsFreeCachedSession (
+  IN     TLS_SESSION_CACHE_ENTRY       *Entry
+  )
+{
+  if (Entry->HostName != NULL) {
+    FreePool (Entry->HostName);
+    Entry->HostName = NULL;
+  }
+
+  if (Entry->Session != NULL) {
+    TlsFreeSession (Entry->Session);
+    Entry->Session = NULL;
+  }
+}
+
+/**
+  Set the session cached for the server of the TLS instance, so that the
+  handshake about to start resumes it.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsResumeCachedSession (
+  IN     TLS_INSTANCE                  *TlsInstance
+  )
+{
+  TLS_SERVICE               *Service;
+  TLS_SESSION_CACHE_ENTRY   Key;
+  UINTN                     Index;
+
+  if (!TlsGetSessionCacheKey (TlsInstance, &Key)) {
+    return;
+  }
+
+  Service = TlsInstance->Service;
+  Index   = TlsFindCachedSession (Service, &Key);
+  if (Index == TLS_SESSION_CACHE_SIZE) {
+    return;
+  }
+
+  //
+  // A session which can't be resumed won't ever be. The handshake may also
+  // be started already, e.g. if the ClientHello didn't fit the buffer of the
+  // first call to BuildResponsePacket().
+  //
+  if (TlsSetSession (TlsInstance->TlsConn, Service->SessionCache[Index].Session) == EFI_UNSUPPORTED) {
+    TlsFreeCachedSession (&Service->SessionCache[Index]);
+  }
+}
+
+/**
+  Count the handshake just completed by the TLS instance, and cache the
+  session it established with its server.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsCacheSession (
+  IN     TLS_INSTANCE                  *TlsInstance
+  )
+{
+  TLS_SERVICE               *Service;
+  TLS_SESSION_CACHE_ENTRY   *Entry;
+  TLS_SESSION_CACHE_ENTRY   Key;
+  BOOLEAN                   Resumed;
+  VOID                      *Session;
+  UINTN                     Index;
+
+  Service = TlsInstance->Service;
+  Resumed = TlsSessionReused (TlsInstance->TlsConn);
+  if (Resumed) {
+    Service->ResumedHandshakes++;
+  } else {
+    Service->FullHandshakes++;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "TlsDxe: %a handshake with %a, %d full and %d resumed handshakes in total.\n",
+    Resumed ? "Resumed" : "Full",
+    (TlsInstance->HostName != NULL) ? TlsInstance->HostName : "peer",
+    Service->FullHandshakes,
+    Service->ResumedHandshakes
+    ));
+
+  if (!TlsGetSessionCacheKey (TlsInstance, &Key)) {
+    return;
+  }
+
+  Session = TlsGetSession (TlsInstance->TlsConn);
+  if (Session == NULL) {
+    return;
+  }
+
+  Index = TlsFindCachedSession (Service, &Key);
+  if (Index < TLS_SESSION_CACHE_SIZE) {
+    Entry = &Service->SessionCache[Index];
+    TlsFreeSession (Entry->Session);
+  } else {
+    //
+    // Replace the entry of the server connected to the longest time ago.
+    //
+    Entry = &Service->SessionCache[Service->SessionCacheNext];
+    Service->SessionCacheNext = (Service->SessionCacheNext + 1) % TLS_SESSION_CACHE_SIZE;
+    TlsFreeCachedSession (Entry);
+
+    CopyMem (Entry, &Key, sizeof (Key));
+    Entry->HostName = AllocateCopyPool (AsciiStrSize (Key.HostName), Key.HostName);
+    if (Entry->HostName == NULL) {
+      TlsFreeSession (Session);
+      return;
+    }
+  }
+
+  Entry->Session = Session;
+}
+
+/**
+  Drop the session cached for the server of the TLS instance.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsDropCachedSession (
+  IN     TLS_INSTANCE                  *TlsInstance
+  )
+{
+  TLS_SESSION_CACHE_ENTRY   Key;
+  UINTN                     Index;
+
+  if (!TlsGetSessionCacheKey (TlsInstance, &Key)) {
+    return;
+  }
+
+  Index = TlsFindCachedSession (TlsInstance->Service, &Key);
+  if (Index < TLS_SESSION_CACHE_SIZE) {
+    TlsFreeCachedSession (&TlsInstance->Service->SessionCache[Index]);
+  }
+}
+
+/**
+  Drop all the sessions cached by the TLS service.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsFlushSessionCache (
+  IN     TLS_SERVICE                   *Service
+  )
+{
+  UINTN                     Index;
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    TlsFreeCachedSession (&Service->SessionCache[Index]);
+  }
+}
@@ -28,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #include <Protocol/Tls.h>
 #include <Protocol/TlsConfig.h>
+#include <Protocol/TlsPeerPort.h>
 
 #include <IndustryStandard/Tls1.h>
 
@@ -86,6 +87,52 @@ TlsDecryptPacket (
   IN     UINT32                        *FragmentCount
   );
 
+/**
+  Set the session cached for the server of the TLS instance, so that the
+  handshake about to start resumes it.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsResumeCachedSession (
+  IN     TLS_INSTANCE                  *TlsInstance
+  );
+
+/**
+  Count the handshake just completed by the TLS instance, and cache the
+  session it established with its server.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsCacheSession (
+  IN     TLS_INSTANCE                  *TlsInstance
+  );
+
+/**
+  Drop the session cached for the server of the TLS instance.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsDropCachedSession (
+  IN     TLS_INSTANCE                  *TlsInstance
+  );
+
+/**
+  Drop all the sessions cached by the TLS service.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsFlushSessionCache (
+  IN     TLS_SERVICE                   *Service
+  );
+
 /**
   Set TLS session data.
 
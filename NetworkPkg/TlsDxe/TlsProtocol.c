@@ -80,6 +80,17 @@ TlsSetSessionData (
     goto ON_EXIT;
   }
 
+  if (DataType == EdkiiTlsPeerPort) {
+    if (DataSize != sizeof (UINT16)) {
+      Status = EFI_INVALID_PARAMETER;
+      goto ON_EXIT;
+    }
+
+    Instance->PeerPort      = *(UINT16 *) Data;
+    Instance->PeerPortValid = TRUE;
+    goto ON_EXIT;
+  }
+
   switch (DataType) {
   //
   // Session Configuration
@@ -184,7 +195,21 @@ TlsSetSessionData (
       goto ON_EXIT;
     }
 
+    if (Instance->HostName != NULL) {
+      FreePool (Instance->HostName);
+      Instance->HostName = NULL;
+    }
+
     Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    //
+    // Keep the host name for the session cache. A failed allocation only
+    // costs a full handshake.
+    //
+    Instance->HostName = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
 
     break;
   case EfiTlsSessionID:
@@ -205,6 +230,21 @@ TlsSetSessionData (
       goto ON_EXIT;
     }
 
+    if (*(EFI_TLS_SESSION_STATE *) Data == EfiTlsSessionNotStarted &&
+        Instance->TlsSessionState != EfiTlsSessionNotStarted) {
+      //
+      // A new session is started on the TLS object of a previous one, e.g. to
+      // reconnect to the server. Discard the previous session state, the
+      // port of the peer is set again for the new connection.
+      //
+      Status = TlsReset (Instance->TlsConn);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      Instance->PeerPortValid = FALSE;
+    }
+
     Instance->TlsSessionState = *(EFI_TLS_SESSION_STATE *) Data;
     break;
   //
@@ -471,8 +511,11 @@ TlsBuildResponsePacket (
     switch (Instance->TlsSessionState) {
     case EfiTlsSessionNotStarted:
       //
-      // ClientHello.
+      // ClientHello. The session configuration is complete now, resume the
+      // session established with the same server before, if any.
       //
+      TlsResumeCachedSession (Instance);
+
       Status = TlsDoHandshake (
                  Instance->TlsConn,
                  NULL,
@@ -556,11 +599,19 @@ TlsBuildResponsePacket (
                  BufferSize
                  );
       if (EFI_ERROR (Status)) {
+        if (Status != EFI_BUFFER_TOO_SMALL) {
+          //
+          // Don't try to resume a session with a host that failed the handshake.
+          //
+          TlsDropCachedSession (Instance);
+        }
+
         goto ON_EXIT;
       }
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsCacheSession (Instance);
       }
     } else {
       //
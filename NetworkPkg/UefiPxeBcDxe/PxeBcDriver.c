@@ -246,6 +246,8 @@ PxeBcDestroyIp4Children (
            &Private->Ip4Nic->LoadFile,
            &gEfiPxeBaseCodeProtocolGuid,
            &Private->PxeBc,
+           &gEdkiiPxeBcMtftpStreamProtocolGuid,
+           &Private->MtftpStream,
            NULL
            );
     FreePool (Private->Ip4Nic->DevicePath);
@@ -407,6 +409,8 @@ PxeBcDestroyIp6Children (
            &Private->Ip6Nic->LoadFile,
            &gEfiPxeBaseCodeProtocolGuid,
            &Private->PxeBc,
+           &gEdkiiPxeBcMtftpStreamProtocolGuid,
+           &Private->MtftpStream,
            NULL
            );
     FreePool (Private->Ip6Nic->DevicePath);
@@ -786,6 +790,8 @@ PxeBcCreateIp4Children (
                   &Private->Ip4Nic->LoadFile,
                   &gEfiPxeBaseCodeProtocolGuid,
                   &Private->PxeBc,
+                  &gEdkiiPxeBcMtftpStreamProtocolGuid,
+                  &Private->MtftpStream,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -1129,6 +1135,8 @@ PxeBcCreateIp6Children (
                   &Private->Ip6Nic->LoadFile,
                   &gEfiPxeBaseCodeProtocolGuid,
                   &Private->PxeBc,
+                  &gEdkiiPxeBcMtftpStreamProtocolGuid,
+                  &Private->MtftpStream,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -1410,6 +1418,12 @@ PxeBcStart (
       sizeof (EFI_PXE_BASE_CODE_PROTOCOL)
       );
 
+    CopyMem (
+      &Private->MtftpStream,
+      &gPxeBcMtftpStreamTemplate,
+      sizeof (EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL)
+      );
+
     Private->Signature          = PXEBC_PRIVATE_DATA_SIGNATURE;
     Private->Controller         = ControllerHandle;
     Private->Image              = This->ImageHandle;
@@ -2199,6 +2199,146 @@ EFI_PXE_BASE_CODE_PROTOCOL  gPxeBcProtocolTemplate = {
 };
 
 
+/**
+  Downloads files from a TFTP server, handing their data to consumer functions
+  as it is received.
+
+  Up to PXE_MTFTP_STREAM_MAX_SESSIONS files are downloaded at the same time,
+  each over its own MTFTP session. The function returns when the downloads of
+  all the files have either completed or failed.
+
+  @param[in]      This          Pointer to the EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL instance.
+  @param[in]      ServerIp      The TFTP server IP address.
+  @param[in]      BlockSize     The requested block size, or NULL for the default.
+  @param[in]      FileCount     The number of entries in Files.
+  @param[in, out] Files         The files to download.
+
+  @retval EFI_SUCCESS           All the files are downloaded.
+  @retval EFI_INVALID_PARAMETER One or more parameters are invalid.
+  @retval EFI_NOT_STARTED       The PXE Base Code Protocol is in the stopped state.
+  @retval EFI_OUT_OF_RESOURCES  Resources could not be allocated.
+  @retval Others                The status of the first file failing.
+
+**/
+EFI_STATUS
+EFIAPI
+EfiPxeBcMtftpStreamReadFiles (
+  IN     EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL  *This,
+  IN     EFI_IP_ADDRESS                      *ServerIp,
+  IN     UINTN                               *BlockSize  OPTIONAL,
+  IN     UINTN                               FileCount,
+  IN OUT EDKII_PXE_BC_MTFTP_STREAM_FILE      *Files
+  )
+{
+  PXEBC_PRIVATE_DATA              *Private;
+  EFI_PXE_BASE_CODE_MODE          *Mode;
+  EFI_MTFTP4_CONFIG_DATA          Mtftp4Config;
+  EFI_MTFTP6_CONFIG_DATA          Mtftp6Config;
+  VOID                            *Config;
+  EFI_STATUS                      Status;
+  EFI_PXE_BASE_CODE_IP_FILTER     IpFilter;
+  UINTN                           WindowSize;
+  UINTN                           Index;
+
+  if ((This == NULL) ||
+      (ServerIp == NULL) ||
+      (FileCount == 0) ||
+      (Files == NULL) ||
+      ((BlockSize != NULL) && (*BlockSize < PXE_MTFTP_DEFAULT_BLOCK_SIZE))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < FileCount; Index++) {
+    if ((Files[Index].Filename == NULL) || (Files[Index].Consumer == NULL)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Private = PXEBC_PRIVATE_DATA_FROM_MTFTP_STREAM (This);
+  Mode    = Private->PxeBc.Mode;
+
+  if (!Mode->Started) {
+    return EFI_NOT_STARTED;
+  }
+
+  //
+  // Get PcdPxeTftpWindowSize.
+  //
+  WindowSize = (UINTN) PcdGet64 (PcdPxeTftpWindowSize);
+
+  if (Mode->UsingIpv6) {
+    if (!NetIp6IsValidUnicast (&ServerIp->v6)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    ZeroMem (&Mtftp6Config, sizeof (EFI_MTFTP6_CONFIG_DATA));
+    Config                         = &Mtftp6Config;
+    Mtftp6Config.TimeoutValue      = PXEBC_MTFTP_TIMEOUT;
+    Mtftp6Config.TryCount          = PXEBC_MTFTP_RETRIES;
+    CopyMem (&Mtftp6Config.StationIp, &Private->StationIp.v6, sizeof (EFI_IPv6_ADDRESS));
+    CopyMem (&Mtftp6Config.ServerIp, &ServerIp->v6, sizeof (EFI_IPv6_ADDRESS));
+    //
+    // Stop Udp6Read instance
+    //
+    Private->Udp6Read->Configure (Private->Udp6Read, NULL);
+  } else {
+    if (IP4_IS_UNSPECIFIED (NTOHL (ServerIp->Addr[0])) || IP4_IS_LOCAL_BROADCAST (NTOHL (ServerIp->Addr[0]))) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    ZeroMem (&Mtftp4Config, sizeof (EFI_MTFTP4_CONFIG_DATA));
+    Config                         = &Mtftp4Config;
+    Mtftp4Config.UseDefaultSetting = FALSE;
+    Mtftp4Config.TimeoutValue      = PXEBC_MTFTP_TIMEOUT;
+    Mtftp4Config.TryCount          = PXEBC_MTFTP_RETRIES;
+    CopyMem (&Mtftp4Config.StationIp, &Private->StationIp.v4, sizeof (EFI_IPv4_ADDRESS));
+    CopyMem (&Mtftp4Config.SubnetMask, &Private->SubnetMask.v4, sizeof (EFI_IPv4_ADDRESS));
+    CopyMem (&Mtftp4Config.GatewayIp, &Private->GatewayIp.v4, sizeof (EFI_IPv4_ADDRESS));
+    CopyMem (&Mtftp4Config.ServerIp, &ServerIp->v4, sizeof (EFI_IPv4_ADDRESS));
+    //
+    // Stop Udp4Read instance
+    //
+    Private->Udp4Read->Configure (Private->Udp4Read, NULL);
+  }
+
+  Mode->TftpErrorReceived = FALSE;
+  Mode->IcmpErrorReceived = FALSE;
+
+  Status = PxeBcTftpStreamFiles (
+             Private,
+             Config,
+             BlockSize,
+             (WindowSize > 1) ? &WindowSize : NULL,
+             FileCount,
+             Files
+             );
+
+  if (Status == EFI_ICMP_ERROR) {
+    Mode->IcmpErrorReceived = TRUE;
+  }
+
+  //
+  // Reconfigure the UDP instance with the default configuration.
+  //
+  if (Mode->UsingIpv6) {
+    Private->Udp6Read->Configure (Private->Udp6Read, &Private->Udp6CfgData);
+  } else {
+    Private->Udp4Read->Configure (Private->Udp4Read, &Private->Udp4CfgData);
+  }
+
+  ZeroMem (&IpFilter, sizeof (EFI_PXE_BASE_CODE_IP_FILTER));
+  IpFilter.Filters = EFI_PXE_BASE_CODE_IP_FILTER_STATION_IP;
+  Private->PxeBc.SetIpFilter (&Private->PxeBc, &IpFilter);
+
+  return Status;
+}
+
+EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL  gPxeBcMtftpStreamTemplate = {
+  EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL_REVISION,
+  EfiPxeBcMtftpStreamReadFiles
+};
+
+
 /**
   Callback function that is invoked when the PXE Base Code Protocol is about to transmit, has
   received, or is waiting to receive a packet.
@@ -32,6 +32,7 @@
 #include <Protocol/PxeBaseCode.h>
 #include <Protocol/LoadFile.h>
 #include <Protocol/PxeBaseCodeCallBack.h>
+#include <Protocol/PxeBcMtftpStream.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/AdapterInformation.h>
@@ -76,6 +77,7 @@ typedef struct _PXEBC_VIRTUAL_NIC   PXEBC_VIRTUAL_NIC;
 #define PXEBC_VIRTUAL_NIC_SIGNATURE           SIGNATURE_32 ('P', 'X', 'E', 'V')
 #define PXEBC_PRIVATE_DATA_FROM_PXEBC(a)      CR (a, PXEBC_PRIVATE_DATA, PxeBc, PXEBC_PRIVATE_DATA_SIGNATURE)
 #define PXEBC_PRIVATE_DATA_FROM_ID(a)         CR (a, PXEBC_PRIVATE_DATA, Id, PXEBC_PRIVATE_DATA_SIGNATURE)
+#define PXEBC_PRIVATE_DATA_FROM_MTFTP_STREAM(a) CR (a, PXEBC_PRIVATE_DATA, MtftpStream, PXEBC_PRIVATE_DATA_SIGNATURE)
 #define PXEBC_VIRTUAL_NIC_FROM_LOADFILE(a)    CR (a, PXEBC_VIRTUAL_NIC, LoadFile, PXEBC_VIRTUAL_NIC_SIGNATURE)
 
 #define PXE_ENABLED                           0x01
@@ -140,6 +142,7 @@ struct _PXEBC_PRIVATE_DATA {
 
   EFI_NETWORK_INTERFACE_IDENTIFIER_PROTOCOL *Nii;
   EFI_PXE_BASE_CODE_PROTOCOL                PxeBc;
+  EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL        MtftpStream;
   EFI_PXE_BASE_CODE_CALLBACK_PROTOCOL       LoadFileCallback;
   EFI_PXE_BASE_CODE_CALLBACK_PROTOCOL       *PxeBcCallback;
   EFI_DEVICE_PATH_PROTOCOL                  *DevicePath;
@@ -222,6 +225,7 @@ struct _PXEBC_PRIVATE_DATA {
 };
 
 extern EFI_PXE_BASE_CODE_PROTOCOL           gPxeBcProtocolTemplate;
+extern EDKII_PXE_BC_MTFTP_STREAM_PROTOCOL   gPxeBcMtftpStreamTemplate;
 extern EFI_PXE_BASE_CODE_CALLBACK_PROTOCOL  gPxeBcCallBackTemplate;
 extern EFI_LOAD_FILE_PROTOCOL               gLoadFileProtocolTemplate;
 
@@ -1185,3 +1185,476 @@ PxeBcTftpReadDirectory (
   }
 }
 
+
+/**
+  This is a callback function when packets are received in Mtftp4 driver for
+  a file downloaded with the MTFTP Stream protocol.
+
+  The data blocks are passed to the consumer of the file. Unicast downloads
+  save the blocks in order, so they arrive here in order and only once.
+
+  @param[in]  This           Pointer to EFI_MTFTP4_PROTOCOL.
+  @param[in]  Token          Pointer to EFI_MTFTP4_TOKEN.
+  @param[in]  PacketLen      Length of EFI_MTFTP4_PACKET.
+  @param[in]  Packet         Pointer to EFI_MTFTP4_PACKET to be checked.
+
+  @retval EFI_SUCCESS    The current operation succeeded.
+  @retval EFI_ABORTED    Abort the current transfer process.
+
+**/
+EFI_STATUS
+EFIAPI
+PxeBcMtftp4StreamCheckPacket (
+  IN EFI_MTFTP4_PROTOCOL        *This,
+  IN EFI_MTFTP4_TOKEN           *Token,
+  IN UINT16                     PacketLen,
+  IN EFI_MTFTP4_PACKET          *Packet
+  )
+{
+  PXEBC_MTFTP_STREAM            *Stream;
+  EDKII_PXE_BC_MTFTP_STREAM_FILE *File;
+  UINTN                         DataLen;
+  EFI_STATUS                    Status;
+
+  Stream = (PXEBC_MTFTP_STREAM *) Token->Context;
+  File   = Stream->File;
+
+  if (NTOHS (Packet->OpCode) == EFI_MTFTP4_OPCODE_ERROR) {
+    Stream->Private->Mode.TftpErrorReceived   = TRUE;
+    Stream->Private->Mode.TftpError.ErrorCode = (UINT8) Packet->Error.ErrorCode;
+    AsciiStrnCpyS (
+      Stream->Private->Mode.TftpError.ErrorString,
+      PXE_MTFTP_ERROR_STRING_LENGTH,
+      (CHAR8 *) Packet->Error.ErrorMessage,
+      PXE_MTFTP_ERROR_STRING_LENGTH - 1
+      );
+    Stream->Private->Mode.TftpError.ErrorString[PXE_MTFTP_ERROR_STRING_LENGTH - 1] = '\0';
+    return EFI_SUCCESS;
+  }
+
+  if (NTOHS (Packet->OpCode) != EFI_MTFTP4_OPCODE_DATA) {
+    return EFI_SUCCESS;
+  }
+
+  DataLen = PacketLen - OFFSET_OF (EFI_MTFTP4_DATA_HEADER, Data);
+  if (DataLen == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = File->Consumer (File->Context, File->FileSize, Packet->Data.Data, DataLen);
+  if (EFI_ERROR (Status)) {
+    File->Status = Status;
+    return EFI_ABORTED;
+  }
+
+  File->FileSize += DataLen;
+  return EFI_SUCCESS;
+}
+
+
+/**
+  This is a callback function when packets are received in Mtftp6 driver for
+  a file downloaded with the MTFTP Stream protocol.
+
+  The data blocks are passed to the consumer of the file. Unicast downloads
+  save the blocks in order, so they arrive here in order and only once.
+
+  @param[in]  This           Pointer to EFI_MTFTP6_PROTOCOL.
+  @param[in]  Token          Pointer to EFI_MTFTP6_TOKEN.
+  @param[in]  PacketLen      Length of EFI_MTFTP6_PACKET.
+  @param[in]  Packet         Pointer to EFI_MTFTP6_PACKET to be checked.
+
+  @retval EFI_SUCCESS    The current operation succeeded.
+  @retval EFI_ABORTED    Abort the current transfer process.
+
+**/
+EFI_STATUS
+EFIAPI
+PxeBcMtftp6StreamCheckPacket (
+  IN EFI_MTFTP6_PROTOCOL        *This,
+  IN EFI_MTFTP6_TOKEN           *Token,
+  IN UINT16                     PacketLen,
+  IN EFI_MTFTP6_PACKET          *Packet
+  )
+{
+  PXEBC_MTFTP_STREAM            *Stream;
+  EDKII_PXE_BC_MTFTP_STREAM_FILE *File;
+  UINTN                         DataLen;
+  EFI_STATUS                    Status;
+
+  Stream = (PXEBC_MTFTP_STREAM *) Token->Context;
+  File   = Stream->File;
+
+  if (NTOHS (Packet->OpCode) == EFI_MTFTP6_OPCODE_ERROR) {
+    Stream->Private->Mode.TftpErrorReceived   = TRUE;
+    Stream->Private->Mode.TftpError.ErrorCode = (UINT8) Packet->Error.ErrorCode;
+    AsciiStrnCpyS (
+      Stream->Private->Mode.TftpError.ErrorString,
+      PXE_MTFTP_ERROR_STRING_LENGTH,
+      (CHAR8 *) Packet->Error.ErrorMessage,
+      PXE_MTFTP_ERROR_STRING_LENGTH - 1
+      );
+    Stream->Private->Mode.TftpError.ErrorString[PXE_MTFTP_ERROR_STRING_LENGTH - 1] = '\0';
+    return EFI_SUCCESS;
+  }
+
+  if (NTOHS (Packet->OpCode) != EFI_MTFTP6_OPCODE_DATA) {
+    return EFI_SUCCESS;
+  }
+
+  DataLen = PacketLen - OFFSET_OF (EFI_MTFTP6_DATA_HEADER, Data);
+  if (DataLen == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = File->Consumer (File->Context, File->FileSize, Packet->Data.Data, DataLen);
+  if (EFI_ERROR (Status)) {
+    File->Status = Status;
+    return EFI_ABORTED;
+  }
+
+  File->FileSize += DataLen;
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Release the MTFTP session of a file downloaded with the MTFTP Stream
+  protocol, and record the result of the download.
+
+  @param[in]  Stream         Pointer to the MTFTP session.
+
+**/
+VOID
+PxeBcMtftpStreamStop (
+  IN PXEBC_MTFTP_STREAM         *Stream
+  )
+{
+  PXEBC_PRIVATE_DATA            *Private;
+  EFI_STATUS                    Status;
+
+  Private = Stream->Private;
+
+  if (Stream->IsStarted) {
+    //
+    // Keep the error returned by the consumer, if it aborted the download.
+    //
+    Status = Private->PxeBc.Mode->UsingIpv6 ? Stream->Token6.Status : Stream->Token4.Status;
+    if (!EFI_ERROR (Stream->File->Status)) {
+      Stream->File->Status = Status;
+    }
+    Stream->IsStarted = FALSE;
+  }
+
+  if (Stream->Mtftp4 != NULL) {
+    Stream->Mtftp4->Configure (Stream->Mtftp4, NULL);
+    gBS->CloseProtocol (
+           Stream->MtftpChild,
+           &gEfiMtftp4ProtocolGuid,
+           Private->Image,
+           Private->Controller
+           );
+    Stream->Mtftp4 = NULL;
+  }
+
+  if (Stream->Mtftp6 != NULL) {
+    Stream->Mtftp6->Configure (Stream->Mtftp6, NULL);
+    gBS->CloseProtocol (
+           Stream->MtftpChild,
+           &gEfiMtftp6ProtocolGuid,
+           Private->Image,
+           Private->Controller
+           );
+    Stream->Mtftp6 = NULL;
+  }
+
+  if (Stream->MtftpChild != NULL) {
+    NetLibDestroyServiceChild (
+      Private->Controller,
+      Private->Image,
+      Private->PxeBc.Mode->UsingIpv6 ? &gEfiMtftp6ServiceBindingProtocolGuid : &gEfiMtftp4ServiceBindingProtocolGuid,
+      Stream->MtftpChild
+      );
+    Stream->MtftpChild = NULL;
+  }
+
+  if (Stream->Token4.Event != NULL) {
+    gBS->CloseEvent (Stream->Token4.Event);
+    Stream->Token4.Event = NULL;
+  }
+
+  if (Stream->Token6.Event != NULL) {
+    gBS->CloseEvent (Stream->Token6.Event);
+    Stream->Token6.Event = NULL;
+  }
+
+  Stream->IsDone = TRUE;
+}
+
+
+/**
+  Create an MTFTP session for a file downloaded with the MTFTP Stream protocol,
+  and send the read request of the file.
+
+  @param[in]  Stream         Pointer to the MTFTP session.
+  @param[in]  Config         Pointer to EFI_MTFTP4_CONFIG_DATA or EFI_MTFTP6_CONFIG_DATA.
+  @param[in]  BlockSize      Pointer to required block size.
+  @param[in]  WindowSize     Pointer to required window size.
+
+  @retval EFI_SUCCESS        The read request is sent.
+  @retval Others             The download can't be started.
+
+**/
+EFI_STATUS
+PxeBcMtftpStreamStart (
+  IN PXEBC_MTFTP_STREAM         *Stream,
+  IN VOID                       *Config,
+  IN UINTN                      *BlockSize,
+  IN UINTN                      *WindowSize
+  )
+{
+  PXEBC_PRIVATE_DATA            *Private;
+  BOOLEAN                       UsingIpv6;
+  UINT32                        OptCnt;
+  EFI_STATUS                    Status;
+
+  Private   = Stream->Private;
+  UsingIpv6 = Private->PxeBc.Mode->UsingIpv6;
+  OptCnt    = 0;
+
+  Status = NetLibCreateServiceChild (
+             Private->Controller,
+             Private->Image,
+             UsingIpv6 ? &gEfiMtftp6ServiceBindingProtocolGuid : &gEfiMtftp4ServiceBindingProtocolGuid,
+             &Stream->MtftpChild
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (UsingIpv6) {
+    Status = gBS->OpenProtocol (
+                    Stream->MtftpChild,
+                    &gEfiMtftp6ProtocolGuid,
+                    (VOID **) &Stream->Mtftp6,
+                    Private->Image,
+                    Private->Controller,
+                    EFI_OPEN_PROTOCOL_BY_DRIVER
+                    );
+  } else {
+    Status = gBS->OpenProtocol (
+                    Stream->MtftpChild,
+                    &gEfiMtftp4ProtocolGuid,
+                    (VOID **) &Stream->Mtftp4,
+                    Private->Image,
+                    Private->Controller,
+                    EFI_OPEN_PROTOCOL_BY_DRIVER
+                    );
+  }
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (UsingIpv6) {
+    ((EFI_MTFTP6_CONFIG_DATA *) Config)->InitialServerPort = PXEBC_BS_DOWNLOAD_PORT;
+
+    Status = Stream->Mtftp6->Configure (Stream->Mtftp6, Config);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (BlockSize != NULL) {
+      Stream->ReqOpt6[OptCnt].OptionStr = (UINT8 *) mMtftpOptions[PXE_MTFTP_OPTION_BLKSIZE_INDEX];
+      Stream->ReqOpt6[OptCnt].ValueStr  = Stream->BlksizeBuf;
+      PxeBcUintnToAscDec (*BlockSize, Stream->ReqOpt6[OptCnt].ValueStr, sizeof (Stream->BlksizeBuf));
+      OptCnt++;
+    }
+
+    if (WindowSize != NULL) {
+      Stream->ReqOpt6[OptCnt].OptionStr = (UINT8 *) mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+      Stream->ReqOpt6[OptCnt].ValueStr  = Stream->WindowsizeBuf;
+      PxeBcUintnToAscDec (*WindowSize, Stream->ReqOpt6[OptCnt].ValueStr, sizeof (Stream->WindowsizeBuf));
+      OptCnt++;
+    }
+
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    PxeBcCommonNotify,
+                    &Stream->IsDone,
+                    &Stream->Token6.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Stream->Token6.Status          = EFI_SUCCESS;
+    Stream->Token6.OverrideData    = NULL;
+    Stream->Token6.Filename        = Stream->File->Filename;
+    Stream->Token6.ModeStr         = NULL;
+    Stream->Token6.OptionCount     = OptCnt;
+    Stream->Token6.OptionList      = Stream->ReqOpt6;
+    Stream->Token6.Context         = Stream;
+    Stream->Token6.BufferSize      = 0;
+    Stream->Token6.Buffer          = NULL;
+    Stream->Token6.CheckPacket     = PxeBcMtftp6StreamCheckPacket;
+    Stream->Token6.TimeoutCallback = NULL;
+    Stream->Token6.PacketNeeded    = NULL;
+
+    Status = Stream->Mtftp6->ReadFile (Stream->Mtftp6, &Stream->Token6);
+  } else {
+    ((EFI_MTFTP4_CONFIG_DATA *) Config)->InitialServerPort = PXEBC_BS_DOWNLOAD_PORT;
+
+    Status = Stream->Mtftp4->Configure (Stream->Mtftp4, Config);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (BlockSize != NULL) {
+      Stream->ReqOpt4[OptCnt].OptionStr = (UINT8 *) mMtftpOptions[PXE_MTFTP_OPTION_BLKSIZE_INDEX];
+      Stream->ReqOpt4[OptCnt].ValueStr  = Stream->BlksizeBuf;
+      PxeBcUintnToAscDec (*BlockSize, Stream->ReqOpt4[OptCnt].ValueStr, sizeof (Stream->BlksizeBuf));
+      OptCnt++;
+    }
+
+    if (WindowSize != NULL) {
+      Stream->ReqOpt4[OptCnt].OptionStr = (UINT8 *) mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+      Stream->ReqOpt4[OptCnt].ValueStr  = Stream->WindowsizeBuf;
+      PxeBcUintnToAscDec (*WindowSize, Stream->ReqOpt4[OptCnt].ValueStr, sizeof (Stream->WindowsizeBuf));
+      OptCnt++;
+    }
+
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    PxeBcCommonNotify,
+                    &Stream->IsDone,
+                    &Stream->Token4.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Stream->Token4.Status          = EFI_SUCCESS;
+    Stream->Token4.OverrideData    = NULL;
+    Stream->Token4.Filename        = Stream->File->Filename;
+    Stream->Token4.ModeStr         = NULL;
+    Stream->Token4.OptionCount     = OptCnt;
+    Stream->Token4.OptionList      = Stream->ReqOpt4;
+    Stream->Token4.Context         = Stream;
+    Stream->Token4.BufferSize      = 0;
+    Stream->Token4.Buffer          = NULL;
+    Stream->Token4.CheckPacket     = PxeBcMtftp4StreamCheckPacket;
+    Stream->Token4.TimeoutCallback = NULL;
+    Stream->Token4.PacketNeeded    = NULL;
+
+    Status = Stream->Mtftp4->ReadFile (Stream->Mtftp4, &Stream->Token4);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Stream->IsStarted = TRUE;
+  }
+
+  return Status;
+}
+
+
+/**
+  This function is a wrapper to download several files at the same time using
+  TFTP, handing their data to the consumer functions of the files.
+
+  Every file is downloaded over its own MTFTP session, so that the server
+  sends the next window of a file while the blocks of the others are being
+  consumed. At most PXE_MTFTP_STREAM_MAX_SESSIONS sessions are open at a time.
+
+  @param[in]       Private        Pointer to PxeBc private data.
+  @param[in]       Config         Pointer to config data.
+  @param[in]       BlockSize      Pointer to required block size.
+  @param[in]       WindowSize     Pointer to required window size.
+  @param[in]       FileCount      Number of files to download.
+  @param[in, out]  Files          The files to download.
+
+  @retval EFI_SUCCESS            All the files are downloaded.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the sessions.
+  @retval Others                 The status of the first file failing.
+
+**/
+EFI_STATUS
+PxeBcTftpStreamFiles (
+  IN     PXEBC_PRIVATE_DATA               *Private,
+  IN     VOID                             *Config,
+  IN     UINTN                            *BlockSize,
+  IN     UINTN                            *WindowSize,
+  IN     UINTN                            FileCount,
+  IN OUT EDKII_PXE_BC_MTFTP_STREAM_FILE   *Files
+  )
+{
+  PXEBC_MTFTP_STREAM                      *Streams;
+  UINTN                                   Next;
+  UINTN                                   Active;
+  UINTN                                   Index;
+  EFI_STATUS                              Status;
+
+  Streams = AllocateZeroPool (FileCount * sizeof (PXEBC_MTFTP_STREAM));
+  if (Streams == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < FileCount; Index++) {
+    Streams[Index].Private = Private;
+    Streams[Index].File    = &Files[Index];
+    Files[Index].FileSize  = 0;
+    Files[Index].Status    = EFI_SUCCESS;
+  }
+
+  Next   = 0;
+  Active = 0;
+
+  while ((Next < FileCount) || (Active != 0)) {
+    //
+    // Start the next files while there are free sessions.
+    //
+    while ((Next < FileCount) && (Active < PXE_MTFTP_STREAM_MAX_SESSIONS)) {
+      Status = PxeBcMtftpStreamStart (&Streams[Next], Config, BlockSize, WindowSize);
+      if (EFI_ERROR (Status)) {
+        Files[Next].Status = Status;
+        PxeBcMtftpStreamStop (&Streams[Next]);
+      } else {
+        Active++;
+      }
+      Next++;
+    }
+
+    //
+    // Poll the sessions in progress, and release the ones completed.
+    //
+    for (Index = 0; Index < Next; Index++) {
+      if (!Streams[Index].IsStarted) {
+        continue;
+      }
+
+      if (!Streams[Index].IsDone) {
+        if (Streams[Index].Mtftp6 != NULL) {
+          Streams[Index].Mtftp6->Poll (Streams[Index].Mtftp6);
+        } else {
+          Streams[Index].Mtftp4->Poll (Streams[Index].Mtftp4);
+        }
+      }
+
+      if (Streams[Index].IsDone) {
+        PxeBcMtftpStreamStop (&Streams[Index]);
+        Active--;
+      }
+    }
+  }
+
+  FreePool (Streams);
+
+  for (Index = 0; Index < FileCount; Index++) {
+    if (EFI_ERROR (Files[Index].Status)) {
+      return Files[Index].Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
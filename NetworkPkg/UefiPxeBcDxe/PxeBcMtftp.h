@@ -20,6 +20,26 @@
 
 #define PXE_MTFTP_ERROR_STRING_LENGTH      127   // refer to definition of struct EFI_PXE_BASE_CODE_TFTP_ERROR.
 #define PXE_MTFTP_DEFAULT_BLOCK_SIZE       512   // refer to rfc-1350.
+#define PXE_MTFTP_STREAM_MAX_SESSIONS      4     // max files downloaded at the same time.
+
+//
+// An MTFTP session downloading one file for the MTFTP Stream protocol.
+//
+typedef struct {
+  PXEBC_PRIVATE_DATA                *Private;
+  EDKII_PXE_BC_MTFTP_STREAM_FILE    *File;
+  EFI_HANDLE                        MtftpChild;
+  EFI_MTFTP4_PROTOCOL               *Mtftp4;
+  EFI_MTFTP6_PROTOCOL               *Mtftp6;
+  EFI_MTFTP4_TOKEN                  Token4;
+  EFI_MTFTP6_TOKEN                  Token6;
+  EFI_MTFTP4_OPTION                 ReqOpt4[2];
+  EFI_MTFTP6_OPTION                 ReqOpt6[2];
+  UINT8                             BlksizeBuf[10];
+  UINT8                             WindowsizeBuf[10];
+  BOOLEAN                           IsStarted;
+  BOOLEAN                           IsDone;
+} PXEBC_MTFTP_STREAM;
 
 
 /**
@@ -135,4 +155,31 @@ PxeBcTftpReadDirectory (
   IN OUT UINT64                        *BufferSize,
   IN     BOOLEAN                       DontUseBuffer
   );
+
+
+/**
+  This function is a wrapper to download several files at the same time using
+  TFTP, handing their data to the consumer functions of the files.
+
+  @param[in]       Private        Pointer to PxeBc private data.
+  @param[in]       Config         Pointer to config data.
+  @param[in]       BlockSize      Pointer to required block size.
+  @param[in]       WindowSize     Pointer to required window size.
+  @param[in]       FileCount      Number of files to download.
+  @param[in, out]  Files          The files to download.
+
+  @retval EFI_SUCCESS            All the files are downloaded.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the sessions.
+  @retval Others                 The status of the first file failing.
+
+**/
+EFI_STATUS
+PxeBcTftpStreamFiles (
+  IN     PXEBC_PRIVATE_DATA               *Private,
+  IN     VOID                             *Config,
+  IN     UINTN                            *BlockSize,
+  IN     UINTN                            *WindowSize,
+  IN     UINTN                            FileCount,
+  IN OUT EDKII_PXE_BC_MTFTP_STREAM_FILE   *Files
+  );
 #endif
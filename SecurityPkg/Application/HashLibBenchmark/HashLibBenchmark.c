@@ -0,0 +1,165 @@
+/** @file
+  A shell application that measures the time HashLib takes to hash and extend
+  data into 1, 2 and 4 PCR banks.
+
+  The banks are selected by changing PcdTpm2HashMask while the application
+  runs, so only the hash algorithms active on the platform can be measured.
+  The measurements are extended into the debug PCR (16).
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
+#include <Library/HashLib.h>
+
+#define BENCHMARK_BUFFER_SIZE   SIZE_16MB
+#define BENCHMARK_UPDATE_SIZE   SIZE_1MB
+#define BENCHMARK_PCR_INDEX     16
+
+typedef struct {
+  UINTN   BankCount;
+  UINT32  HashMask;
+} HASH_BENCHMARK_CONFIG;
+
+HASH_BENCHMARK_CONFIG mBenchmarkConfig[] = {
+  { 1, HASH_ALG_SHA256 },
+  { 2, HASH_ALG_SHA1 | HASH_ALG_SHA256 },
+  { 4, HASH_ALG_SHA1 | HASH_ALG_SHA256 | HASH_ALG_SHA384 | HASH_ALG_SHA512 }
+};
+
+/**
+  Hash a buffer with HashLib and extend it into the debug PCR, and return the
+  time it takes.
+
+  @param[in]  Buffer        The data to be measured.
+  @param[in]  BufferSize    Size of Buffer in bytes.
+  @param[out] ElapsedTime   The time the measurement takes, in nanoseconds.
+
+  @retval EFI_SUCCESS       The data is measured.
+  @retval Others            HashLib fails to measure the data.
+**/
+EFI_STATUS
+MeasureBuffer (
+  IN  UINT8    *Buffer,
+  IN  UINTN    BufferSize,
+  OUT UINT64   *ElapsedTime
+  )
+{
+  EFI_STATUS          Status;
+  HASH_HANDLE         HashHandle;
+  TPML_DIGEST_VALUES  DigestList;
+  UINTN               Offset;
+  UINT64              Start;
+  UINT64              End;
+  UINT64              StartValue;
+  UINT64              EndValue;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  Start  = GetPerformanceCounter ();
+  Status = HashStart (&HashHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Offset = 0; Offset < BufferSize; Offset += BENCHMARK_UPDATE_SIZE) {
+    HashUpdate (HashHandle, Buffer + Offset, MIN (BufferSize - Offset, BENCHMARK_UPDATE_SIZE));
+  }
+
+  Status = HashCompleteAndExtend (HashHandle, BENCHMARK_PCR_INDEX, NULL, 0, &DigestList);
+  End    = GetPerformanceCounter ();
+
+  //
+  // Some performance counters count down.
+  //
+  if (EndValue < StartValue) {
+    *ElapsedTime = GetTimeInNanoSecond (Start - End);
+  } else {
+    *ElapsedTime = GetTimeInNanoSecond (End - Start);
+  }
+
+  return Status;
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the application.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Buffer;
+  UINT32      ActiveHashMask;
+  UINT32      SupportedHashMask;
+  UINTN       Index;
+  UINT64      ElapsedTime;
+
+  Buffer = AllocatePool (BENCHMARK_BUFFER_SIZE);
+  if (Buffer == NULL) {
+    Print (L"HashLibBenchmark: Out of resources.\n");
+    return EFI_OUT_OF_RESOURCES;
+  }
+  SetMem (Buffer, BENCHMARK_BUFFER_SIZE, 0x5A);
+
+  //
+  // Only the algorithms active when this application was loaded are
+  // registered to HashLib.
+  //
+  ActiveHashMask    = PcdGet32 (PcdTpm2HashMask);
+  SupportedHashMask = PcdGet32 (PcdTcg2HashAlgorithmBitmap) & ActiveHashMask;
+
+  Print (L"Measuring %d MB into PCR %d, %d MB per HashUpdate()\n", BENCHMARK_BUFFER_SIZE / SIZE_1MB, BENCHMARK_PCR_INDEX, BENCHMARK_UPDATE_SIZE / SIZE_1MB);
+  Print (L"Banks  HashMask  Time (us/MB)\n");
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkConfig); Index++) {
+    if ((mBenchmarkConfig[Index].HashMask & SupportedHashMask) != mBenchmarkConfig[Index].HashMask) {
+      Print (L"%5d  0x%08x  Skipped, not all the banks are active\n", mBenchmarkConfig[Index].BankCount, mBenchmarkConfig[Index].HashMask);
+      continue;
+    }
+
+    Status = PcdSet32S (PcdTpm2HashMask, mBenchmarkConfig[Index].HashMask);
+    if (EFI_ERROR (Status)) {
+      Print (L"HashLibBenchmark: Failed to set PcdTpm2HashMask - %r\n", Status);
+      break;
+    }
+
+    Status = MeasureBuffer (Buffer, BENCHMARK_BUFFER_SIZE, &ElapsedTime);
+    if (EFI_ERROR (Status)) {
+      Print (L"%5d  0x%08x  Failed - %r\n", mBenchmarkConfig[Index].BankCount, mBenchmarkConfig[Index].HashMask, Status);
+      continue;
+    }
+
+    Print (
+      L"%5d  0x%08x  %ld\n",
+      mBenchmarkConfig[Index].BankCount,
+      mBenchmarkConfig[Index].HashMask,
+      DivU64x32 (ElapsedTime, 1000 * (BENCHMARK_BUFFER_SIZE / SIZE_1MB))
+      );
+  }
+
+  PcdSet32S (PcdTpm2HashMask, ActiveHashMask);
+  FreePool (Buffer);
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,64 @@
+/** @file
+  PE image digest cache protocol.
+
+  The image verification handler calculates the Authenticode digest of every
+  PE/COFF image it checks. This protocol lets the measurement code reuse those
+  digests instead of hashing the same image buffer again.
+
+  The digests of an image are published once it passes verification, and are
+  handed out once, to the measurement of the same image by the Security2
+  handlers. They are only returned for a buffer holding exactly the image that
+  was verified, and are dropped after that one use, when the image is loaded
+  or rejected, and when the next image is verified.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __PE_IMAGE_DIGEST_CACHE_H__
+#define __PE_IMAGE_DIGEST_CACHE_H__
+
+#include <IndustryStandard/Tpm20.h>
+
+// {D084C742-E407-49BE-8642-3B8420534DEF}
+#define EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL_GUID \
+  {0xd084c742, 0xe407, 0x49be, {0x86, 0x42, 0x3b, 0x84, 0x20, 0x53, 0x4d, 0xef}}
+
+typedef struct _EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL;
+
+/**
+  Get the Authenticode digests of a PE/COFF image that has just been verified.
+
+  The cached digests are dropped by this call, whether it succeeds or not.
+  Requesting an algorithm that is not cached also tells the producer that the
+  caller wants it, so it may be calculated in the same pass for later images.
+
+  @param[in]      This        Pointer to the EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL instance.
+  @param[in]      ImageBase   Start address of the image buffer.
+  @param[in]      ImageSize   Size of the image buffer in bytes.
+  @param[in, out] DigestList  On input, count and the hashAlg of each entry give the
+                              digests to get. On output, the digests are filled in.
+
+  @retval EFI_SUCCESS             All the digests are returned.
+  @retval EFI_NOT_FOUND           The buffer doesn't hold the verified image, or at
+                                  least one of the digests isn't cached.
+  @retval EFI_INVALID_PARAMETER   ImageBase or DigestList is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PE_IMAGE_DIGEST_CACHE_GET_DIGESTS) (
+  IN     EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *This,
+  IN     VOID                                  *ImageBase,
+  IN     UINTN                                 ImageSize,
+  IN OUT TPML_DIGEST_VALUES                    *DigestList
+  );
+
+struct _EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL {
+  EDKII_PE_IMAGE_DIGEST_CACHE_GET_DIGESTS   GetDigests;
+};
+
+extern EFI_GUID gEdkiiPeImageDigestCacheProtocolGuid;
+
+#endif
@@ -0,0 +1,302 @@
+/** @file
+  Cache of the Authenticode digests of the image being authenticated.
+
+  The Security2 handlers for verification and measurement both hash the same
+  image buffer with the Authenticode layout. The digests calculated here are
+  published through EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL so the image doesn't
+  have to be hashed again when it is measured after it is verified.
+
+  The cache only holds the digests of one image. They are published when the
+  image passes verification, together with a copy of the image, and are only
+  handed out for a buffer with exactly the same content. They are dropped after
+  they are handed out once, when the next image is verified, when the image is
+  rejected, and when the image is loaded.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+PE_IMAGE_DIGEST_CACHE  mPeImageDigestCache;
+
+//
+// Hash algorithms asked for through the protocol, (1 << HASHALG_xxx).
+//
+UINT32                 mPeImageDigestWanted = 0;
+
+VOID                   *mLoadedImageRegistration;
+
+/**
+  Get the Authenticode digests of a PE/COFF image that has just been verified.
+
+  @param[in]      This        Pointer to the EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL instance.
+  @param[in]      ImageBase   Start address of the image buffer.
+  @param[in]      ImageSize   Size of the image buffer in bytes.
+  @param[in, out] DigestList  On input, count and the hashAlg of each entry give the
+                              digests to get. On output, the digests are filled in.
+
+  @retval EFI_SUCCESS             All the digests are returned.
+  @retval EFI_NOT_FOUND           The buffer doesn't hold the verified image, or at
+                                  least one of the digests isn't cached.
+  @retval EFI_INVALID_PARAMETER   ImageBase or DigestList is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageDigestCacheGetDigests (
+  IN     EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *This,
+  IN     VOID                                  *ImageBase,
+  IN     UINTN                                 ImageSize,
+  IN OUT TPML_DIGEST_VALUES                    *DigestList
+  )
+{
+  UINT32                                       Index;
+  UINT32                                       HashAlg;
+  BOOLEAN                                      Found;
+
+  if ((ImageBase == NULL) || (DigestList == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Only the image that passed verification gets its digests, not another
+  // one loaded in the same buffer since.
+  //
+  Found = (BOOLEAN) ((mPeImageDigestCache.ImageCopy != NULL) &&
+                     (mPeImageDigestCache.ImageBase == ImageBase) &&
+                     (mPeImageDigestCache.ImageSize == ImageSize) &&
+                     (DigestList->count <= HASH_COUNT) &&
+                     (CompareMem (ImageBase, mPeImageDigestCache.ImageCopy, ImageSize) == 0));
+
+  for (Index = 0; (Index < DigestList->count) && (Index < HASH_COUNT); Index++) {
+    switch (DigestList->digests[Index].hashAlg) {
+    case TPM_ALG_SHA1:
+      HashAlg = HASHALG_SHA1;
+      break;
+
+    case TPM_ALG_SHA256:
+      HashAlg = HASHALG_SHA256;
+      break;
+
+    case TPM_ALG_SHA384:
+      HashAlg = HASHALG_SHA384;
+      break;
+
+    case TPM_ALG_SHA512:
+      HashAlg = HASHALG_SHA512;
+      break;
+
+    default:
+      Found = FALSE;
+      continue;
+    }
+
+    //
+    // Remember the algorithm, so it is calculated along with the one needed
+    // for verification for the next images.
+    //
+    mPeImageDigestWanted |= (1 << HashAlg);
+
+    if (!Found || ((mPeImageDigestCache.ValidMask & (1 << HashAlg)) == 0)) {
+      Found = FALSE;
+      continue;
+    }
+
+    CopyMem (&DigestList->digests[Index].digest, mPeImageDigestCache.Digest[HashAlg], mHash[HashAlg].DigestLength);
+  }
+
+  //
+  // The digests serve the measurement of this one image only.
+  //
+  InvalidatePeImageDigests ();
+
+  return Found ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  mPeImageDigestCacheProtocol = {
+  PeImageDigestCacheGetDigests
+};
+
+/**
+  Drop all the cached digests.
+
+**/
+VOID
+InvalidatePeImageDigests (
+  VOID
+  )
+{
+  if (mPeImageDigestCache.ImageCopy != NULL) {
+    FreePool (mPeImageDigestCache.ImageCopy);
+  }
+  ZeroMem (&mPeImageDigestCache, sizeof (mPeImageDigestCache));
+}
+
+/**
+  Get a cached Authenticode digest of an image.
+
+  @param[in]  ImageBase         Start address of the image buffer.
+  @param[in]  ImageSize         Size of the image buffer in bytes.
+  @param[in]  HashAlg           Hash algorithm type, HASHALG_xxx.
+  @param[out] Digest            Buffer to receive the digest. If it's NULL,
+                                only the presence of the digest is checked.
+
+  @retval TRUE                  The digest is cached.
+  @retval FALSE                 The digest isn't cached.
+
+**/
+BOOLEAN
+GetPeImageDigest (
+  IN  UINT8             *ImageBase,
+  IN  UINTN             ImageSize,
+  IN  UINT32            HashAlg,
+  OUT UINT8             *Digest       OPTIONAL
+  )
+{
+  if ((HashAlg >= HASHALG_MAX) ||
+      (mPeImageDigestCache.ImageBase != ImageBase) ||
+      (mPeImageDigestCache.ImageSize != ImageSize) ||
+      ((mPeImageDigestCache.ValidMask & (1 << HashAlg)) == 0)) {
+    return FALSE;
+  }
+
+  if (Digest != NULL) {
+    CopyMem (Digest, mPeImageDigestCache.Digest[HashAlg], mHash[HashAlg].DigestLength);
+  }
+  return TRUE;
+}
+
+/**
+  Cache an Authenticode digest of an image.
+
+  Digests of any other image are dropped.
+
+  @param[in]  ImageBase         Start address of the image buffer.
+  @param[in]  ImageSize         Size of the image buffer in bytes.
+  @param[in]  HashAlg           Hash algorithm type, HASHALG_xxx.
+  @param[in]  Digest            The digest.
+
+**/
+VOID
+SetPeImageDigest (
+  IN UINT8              *ImageBase,
+  IN UINTN              ImageSize,
+  IN UINT32             HashAlg,
+  IN UINT8              *Digest
+  )
+{
+  if (HashAlg >= HASHALG_MAX) {
+    return;
+  }
+
+  if ((mPeImageDigestCache.ImageBase != ImageBase) ||
+      (mPeImageDigestCache.ImageSize != ImageSize)) {
+    InvalidatePeImageDigests ();
+    mPeImageDigestCache.ImageBase = ImageBase;
+    mPeImageDigestCache.ImageSize = ImageSize;
+  }
+
+  CopyMem (mPeImageDigestCache.Digest[HashAlg], Digest, mHash[HashAlg].DigestLength);
+  mPeImageDigestCache.ValidMask |= (1 << HashAlg);
+}
+
+/**
+  Publish the digests of the image that has just passed verification, for
+  its measurement to get them through the digest cache protocol.
+
+  A copy of the image is kept, so that the digests are only handed out for a
+  buffer with the same content. Nothing is kept if no consumer has asked for
+  a digest yet.
+
+**/
+VOID
+PublishPeImageDigests (
+  VOID
+  )
+{
+  if ((mPeImageDigestWanted == 0) ||
+      (mPeImageDigestCache.ValidMask == 0) ||
+      (mPeImageDigestCache.ImageCopy != NULL)) {
+    return;
+  }
+
+  mPeImageDigestCache.ImageCopy = AllocateCopyPool (
+                                    mPeImageDigestCache.ImageSize,
+                                    mPeImageDigestCache.ImageBase
+                                    );
+  if (mPeImageDigestCache.ImageCopy == NULL) {
+    InvalidatePeImageDigests ();
+  }
+}
+
+/**
+  Get the hash algorithms that the consumers of the digest cache protocol
+  have asked for.
+
+  @return Bit (1 << HASHALG_xxx) is set for every algorithm asked for.
+
+**/
+UINT32
+GetWantedPeImageDigests (
+  VOID
+  )
+{
+  return mPeImageDigestWanted;
+}
+
+/**
+  Notification function of the Loaded Image protocol installation.
+
+  The image being authenticated has been loaded, so its buffer may be freed.
+
+  @param[in]  Event     Event whose notification function is being invoked.
+  @param[in]  Context   Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+OnLoadedImageInstalled (
+  IN EFI_EVENT          Event,
+  IN VOID               *Context
+  )
+{
+  InvalidatePeImageDigests ();
+}
+
+/**
+  Install the digest cache protocol, so that the measurement of an image can
+  reuse the digests calculated for its verification.
+
+  @retval EFI_SUCCESS           The protocol is installed.
+  @retval Others                The protocol can't be installed.
+
+**/
+EFI_STATUS
+InstallPeImageDigestCache (
+  VOID
+  )
+{
+  EFI_HANDLE            Handle;
+  EFI_EVENT             Event;
+
+  Event = EfiCreateProtocolNotifyEvent (
+            &gEfiLoadedImageProtocolGuid,
+            TPL_CALLBACK,
+            OnLoadedImageInstalled,
+            NULL,
+            &mLoadedImageRegistration
+            );
+  if (Event == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Handle = NULL;
+  return gBS->InstallProtocolInterface (
+                &Handle,
+                &gEdkiiPeImageDigestCacheProtocolGuid,
+                EFI_NATIVE_INTERFACE,
+                &mPeImageDigestCacheProtocol
+                );
+}
@@ -68,6 +68,19 @@ HASH_TABLE mHash[] = {
 
 EFI_STRING mHashTypeStr;
 
+//
+// Signature types of the X.509 certificate hashes in dbx, and the hash
+// algorithms used to calculate them.
+//
+struct {
+  EFI_GUID   *SignatureType;
+  UINT32     HashAlg;
+} mCertHashType[] = {
+  { &gEfiCertX509Sha256Guid, HASHALG_SHA256 },
+  { &gEfiCertX509Sha384Guid, HASHALG_SHA384 },
+  { &gEfiCertX509Sha512Guid, HASHALG_SHA512 }
+};
+
 /**
   SecureBoot Hook for processing image verification.
 
@@ -266,6 +279,46 @@ GetImageType (
   return IMAGE_UNKNOWN;
 }
 
+/**
+  Update the hash contexts of all the algorithms an image is hashed with.
+
+  The data is fed in chunks, so that each chunk is still in the CPU cache
+  when it is hashed by the next algorithm.
+
+  @param[in]  HashCtx     Hash contexts indexed by hash algorithm type, NULL
+                          for the algorithms not calculated.
+  @param[in]  Data        Pointer to the data to be hashed.
+  @param[in]  DataSize    Size of Data in bytes.
+
+  @retval TRUE            Successfully hash the data.
+  @retval FALSE           Fail in hash the data.
+
+**/
+BOOLEAN
+HashPeImageUpdate (
+  IN VOID               **HashCtx,
+  IN UINT8              *Data,
+  IN UINTN              DataSize
+  )
+{
+  UINTN                 ChunkSize;
+  UINT32                HashIndex;
+
+  while (DataSize > 0) {
+    ChunkSize = MIN (DataSize, HASH_CHUNK_SIZE);
+    for (HashIndex = 0; HashIndex < HASHALG_MAX; HashIndex++) {
+      if ((HashCtx[HashIndex] != NULL) &&
+          !mHash[HashIndex].HashUpdate (HashCtx[HashIndex], Data, ChunkSize)) {
+        return FALSE;
+      }
+    }
+    Data     += ChunkSize;
+    DataSize -= ChunkSize;
+  }
+
+  return TRUE;
+}
+
 /**
   Calculate hash of Pe/Coff image based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A
@@ -277,6 +330,9 @@ GetImageType (
   Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
   its caller function DxeImageVerificationHandler().
 
+  The image is hashed with all the algorithms wanted by the digest cache
+  consumers in the same pass, and the digests are cached for them.
+
   @param[in]    HashAlg   Hash algorithm type.
 
   @retval TRUE            Successfully hash image.
@@ -290,8 +346,10 @@ HashPeImage (
 {
   BOOLEAN                   Status;
   EFI_IMAGE_SECTION_HEADER  *Section;
-  VOID                      *HashCtx;
-  UINTN                     CtxSize;
+  VOID                      *HashCtx[HASHALG_MAX];
+  UINT32                    HashMask;
+  UINT32                    HashIndex;
+  UINT8                     Digest[MAX_DIGEST_SIZE];
   UINT8                     *HashBase;
   UINTN                     HashSize;
   UINTN                     SumOfBytesHashed;
@@ -301,7 +359,7 @@ HashPeImage (
   UINT32                    CertSize;
   UINT32                    NumberOfRvaAndSizes;
 
-  HashCtx       = NULL;
+  ZeroMem (HashCtx, sizeof (HashCtx));
   SectionHeader = NULL;
   Status        = FALSE;
 
@@ -340,20 +398,36 @@ HashPeImage (
   }
 
   mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize   = mHash[HashAlg].GetContextSize();
 
-  HashCtx = AllocatePool (CtxSize);
-  if (HashCtx == NULL) {
-    return FALSE;
+  //
+  // The image may have been hashed with this algorithm already, e.g. for
+  // another signature of the image.
+  //
+  if (GetPeImageDigest (mImageBase, mImageSize, HashAlg, mImageDigest)) {
+    return TRUE;
   }
 
   // 1.  Load the image header into memory.
 
-  // 2.  Initialize a SHA hash context.
-  Status = mHash[HashAlg].HashInit(HashCtx);
+  // 2.  Initialize a SHA hash context, for each algorithm not cached yet.
+  HashMask = GetWantedPeImageDigests () | (1 << HashAlg);
+  for (HashIndex = 0; HashIndex < HASHALG_MAX; HashIndex++) {
+    if (((HashMask & (1 << HashIndex)) == 0) ||
+        (mHash[HashIndex].GetContextSize == NULL) ||
+        GetPeImageDigest (mImageBase, mImageSize, HashIndex, NULL)) {
+      continue;
+    }
 
-  if (!Status) {
-    goto Done;
+    HashCtx[HashIndex] = AllocatePool (mHash[HashIndex].GetContextSize ());
+    if (HashCtx[HashIndex] == NULL) {
+      Status = FALSE;
+      goto Done;
+    }
+
+    Status = mHash[HashIndex].HashInit (HashCtx[HashIndex]);
+    if (!Status) {
+      goto Done;
+    }
   }
 
   //
@@ -386,7 +460,7 @@ HashPeImage (
     goto Done;
   }
 
-  Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+  Status  = HashPeImageUpdate (HashCtx, HashBase, HashSize);
   if (!Status) {
     goto Done;
   }
@@ -414,7 +488,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -438,7 +512,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -463,7 +537,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -536,7 +610,7 @@ HashPeImage (
     HashBase  = mImageBase + Section->PointerToRawData;
     HashSize  = (UINTN) Section->SizeOfRawData;
 
-    Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+    Status  = HashPeImageUpdate (HashCtx, HashBase, HashSize);
     if (!Status) {
       goto Done;
     }
@@ -572,7 +646,7 @@ HashPeImage (
     if (mImageSize > CertSize + SumOfBytesHashed) {
       HashSize = (UINTN) (mImageSize - CertSize - SumOfBytesHashed);
 
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -582,11 +656,27 @@ HashPeImage (
     }
   }
 
-  Status  = mHash[HashAlg].HashFinal(HashCtx, mImageDigest);
+  for (HashIndex = 0; HashIndex < HASHALG_MAX; HashIndex++) {
+    if (HashCtx[HashIndex] == NULL) {
+      continue;
+    }
+
+    Status = mHash[HashIndex].HashFinal (HashCtx[HashIndex], Digest);
+    if (!Status) {
+      goto Done;
+    }
+
+    SetPeImageDigest (mImageBase, mImageSize, HashIndex, Digest);
+    if (HashIndex == HashAlg) {
+      CopyMem (mImageDigest, Digest, mImageDigestSize);
+    }
+  }
 
 Done:
-  if (HashCtx != NULL) {
-    FreePool (HashCtx);
+  for (HashIndex = 0; HashIndex < HASHALG_MAX; HashIndex++) {
+    if (HashCtx[HashIndex] != NULL) {
+      FreePool (HashCtx[HashIndex]);
+    }
   }
   if (SectionHeader != NULL) {
     FreePool (SectionHeader);
@@ -818,8 +908,6 @@ AddImageExeInfo (
 
   @param[in]  Certificate       Pointer to X.509 Certificate that is searched for.
   @param[in]  CertSize          Size of X.509 Certificate.
-  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
-  @param[in]  SignatureListSize Size of Signature List.
   @param[out] RevocationTime    Return the time that the certificate was revoked.
 
   @return TRUE   The certificate hash is found in the forbidden database.
@@ -830,33 +918,29 @@ BOOLEAN
 IsCertHashFoundInDatabase (
   IN  UINT8               *Certificate,
   IN  UINTN               CertSize,
-  IN  EFI_SIGNATURE_LIST  *SignatureList,
-  IN  UINTN               SignatureListSize,
   OUT EFI_TIME            *RevocationTime
   )
 {
-  BOOLEAN             IsFound;
-  BOOLEAN             Status;
-  EFI_SIGNATURE_LIST  *DbxList;
-  UINTN               DbxSize;
-  EFI_SIGNATURE_DATA  *CertHash;
-  UINTN               CertHashCount;
-  UINTN               Index;
-  UINT32              HashAlg;
-  VOID                *HashCtx;
-  UINT8               CertDigest[MAX_DIGEST_SIZE];
-  UINT8               *DbxCertHash;
-  UINTN               SiglistHeaderSize;
-  UINT8               *TBSCert;
-  UINTN               TBSCertSize;
+  BOOLEAN               IsFound;
+  BOOLEAN               Status;
+  SIGNATURE_DATABASE    *Dbx;
+  SIGNATURE_HASH_ENTRY  *DbxCertHash;
+  UINTN                 Index;
+  UINT32                HashAlg;
+  VOID                  *HashCtx;
+  UINT8                 CertDigest[MAX_DIGEST_SIZE];
+  UINT8                 *TBSCert;
+  UINTN                 TBSCertSize;
 
   IsFound  = FALSE;
-  DbxList  = SignatureList;
-  DbxSize  = SignatureListSize;
   HashCtx  = NULL;
-  HashAlg  = HASHALG_MAX;
 
-  if ((RevocationTime == NULL) || (DbxList == NULL)) {
+  if (RevocationTime == NULL) {
+    return FALSE;
+  }
+
+  Dbx = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1);
+  if (Dbx->HashCount == 0) {
     return FALSE;
   }
 
@@ -867,27 +951,20 @@ IsCertHashFoundInDatabase (
     return FALSE;
   }
 
-  while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
+  for (Index = 0; Index < ARRAY_SIZE (mCertHashType); Index++) {
     //
-    // Determine Hash Algorithm of Certificate in the forbidden database.
+    // Only hash the TBSCertificate with the algorithms used in the forbidden database.
     //
-    if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha256Guid)) {
-      HashAlg = HASHALG_SHA256;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha384Guid)) {
-      HashAlg = HASHALG_SHA384;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha512Guid)) {
-      HashAlg = HASHALG_SHA512;
-    } else {
-      DbxSize -= DbxList->SignatureListSize;
-      DbxList  = (EFI_SIGNATURE_LIST *) ((UINT8 *) DbxList + DbxList->SignatureListSize);
+    if (FindSignatureHash (Dbx, mCertHashType[Index].SignatureType, NULL, 0) == NULL) {
       continue;
     }
 
     //
     // Calculate the hash value of current TBSCertificate for comparision.
     //
+    HashAlg = mCertHashType[Index].HashAlg;
     if (mHash[HashAlg].GetContextSize == NULL) {
-      goto Done;
+      continue;
     }
     ZeroMem (CertDigest, MAX_DIGEST_SIZE);
     HashCtx = AllocatePool (mHash[HashAlg].GetContextSize ());
@@ -906,32 +983,22 @@ IsCertHashFoundInDatabase (
     if (!Status) {
       goto Done;
     }
+    FreePool (HashCtx);
+    HashCtx = NULL;
 
-    SiglistHeaderSize = sizeof (EFI_SIGNATURE_LIST) + DbxList->SignatureHeaderSize;
-    CertHash          = (EFI_SIGNATURE_DATA *) ((UINT8 *) DbxList + SiglistHeaderSize);
-    CertHashCount     = (DbxList->SignatureListSize - SiglistHeaderSize) / DbxList->SignatureSize;
-    for (Index = 0; Index < CertHashCount; Index++) {
+    DbxCertHash = FindSignatureHash (Dbx, mCertHashType[Index].SignatureType, CertDigest, mHash[HashAlg].DigestLength);
+    if (DbxCertHash != NULL) {
       //
-      // Iterate each Signature Data Node within this CertList for verify.
+      // Hash of Certificate is found in forbidden database.
       //
-      DbxCertHash = CertHash->SignatureData;
-      if (CompareMem (DbxCertHash, CertDigest, mHash[HashAlg].DigestLength) == 0) {
-        //
-        // Hash of Certificate is found in forbidden database.
-        //
-        IsFound = TRUE;
+      IsFound = TRUE;
 
-        //
-        // Return the revocation time.
-        //
-        CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
-        goto Done;
-      }
-      CertHash = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertHash + DbxList->SignatureSize);
+      //
+      // Return the revocation time.
+      //
+      CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash->Signature->SignatureData + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
+      goto Done;
     }
-
-    DbxSize -= DbxList->SignatureListSize;
-    DbxList  = (EFI_SIGNATURE_LIST *) ((UINT8 *) DbxList + DbxList->SignatureListSize);
   }
 
 Done:
@@ -962,76 +1029,27 @@ IsSignatureFoundInDatabase (
   IN UINTN              SignatureSize
   )
 {
-  EFI_STATUS          Status;
-  EFI_SIGNATURE_LIST  *CertList;
-  EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
-  BOOLEAN             IsFound;
-
-  //
-  // Read signature database variable.
-  //
-  IsFound   = FALSE;
-  Data      = NULL;
-  DataSize  = 0;
-  Status    = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  SIGNATURE_DATABASE    *Database;
+  SIGNATURE_HASH_ENTRY  *Cert;
+
+  Database = GetSignatureDatabase (VariableName);
+  if (Database == NULL) {
     return FALSE;
   }
 
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
+  Cert = FindSignatureHash (Database, CertType, Signature, SignatureSize);
+  if (Cert == NULL) {
     return FALSE;
   }
 
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
   //
-  // Enumerate all signature data in SigDB to check if signature exists for executable.
+  // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
   //
-  CertList = (EFI_SIGNATURE_LIST *) Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-    Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-    if ((CertList->SignatureSize == sizeof(EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid(&CertList->SignatureType, CertType))) {
-      for (Index = 0; Index < CertCount; Index++) {
-        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
-          //
-          // Find the signature in database.
-          //
-          IsFound = TRUE;
-          //
-          // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
-          //
-          if (StrCmp(VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
-            SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
-          }
-          break;
-        }
-
-        Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
-      }
-
-      if (IsFound) {
-        break;
-      }
-    }
-
-    DataSize -= CertList->SignatureListSize;
-    CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+  if (StrCmp(VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+    SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, Cert->SignatureSize, Cert->Signature);
   }
 
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
-  return IsFound;
+  return TRUE;
 }
 
 /**
@@ -1108,28 +1126,12 @@ PassTimestampCheck (
   IN EFI_TIME               *RevocationTime
   )
 {
-  EFI_STATUS                Status;
-  BOOLEAN                   VerifyStatus;
-  EFI_SIGNATURE_LIST        *CertList;
-  EFI_SIGNATURE_DATA        *Cert;
-  UINT8                     *DbtData;
-  UINTN                     DbtDataSize;
+  SIGNATURE_DATABASE        *Dbt;
   UINT8                     *RootCert;
   UINTN                     RootCertSize;
   UINTN                     Index;
-  UINTN                     CertCount;
   EFI_TIME                  SigningTime;
 
-  //
-  // Variable Initialization
-  //
-  VerifyStatus      = FALSE;
-  DbtData           = NULL;
-  CertList          = NULL;
-  Cert              = NULL;
-  RootCert          = NULL;
-  RootCertSize      = 0;
-
   //
   // If RevocationTime is zero, the certificate shall be considered to always be revoked.
   //
@@ -1141,56 +1143,27 @@ PassTimestampCheck (
   // RevocationTime is non-zero, the certificate should be considered to be revoked from that time and onwards.
   // Using the dbt to get the trusted TSA certificates.
   //
-  DbtDataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    goto Done;
-  }
-  DbtData = (UINT8 *) AllocateZeroPool (DbtDataSize);
-  if (DbtData == NULL) {
-    goto Done;
-  }
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, (VOID *) DbtData);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
-  CertList = (EFI_SIGNATURE_LIST *) DbtData;
-  while ((DbtDataSize > 0) && (DbtDataSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-      for (Index = 0; Index < CertCount; Index++) {
-        //
-        // Iterate each Signature Data Node within this CertList for verify.
-        //
-        RootCert     = Cert->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
-        //
-        // Get the signing time if the timestamp signature is valid.
-        //
-        if (ImageTimestampVerify (AuthData, AuthDataSize, RootCert, RootCertSize, &SigningTime)) {
-          //
-          // The signer signature is valid only when the signing time is earlier than revocation time.
-          //
-          if (IsValidSignatureByTimestamp (&SigningTime, RevocationTime)) {
-            VerifyStatus = TRUE;
-            goto Done;
-          }
-        }
-        Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
+  Dbt = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE2);
+  for (Index = 0; Index < Dbt->CertCount; Index++) {
+    //
+    // Iterate each X.509 certificate in dbt for verify.
+    //
+    RootCert     = Dbt->Certs[Index].Signature->SignatureData;
+    RootCertSize = Dbt->Certs[Index].CertSize;
+    //
+    // Get the signing time if the timestamp signature is valid.
+    //
+    if (ImageTimestampVerify (AuthData, AuthDataSize, RootCert, RootCertSize, &SigningTime)) {
+      //
+      // The signer signature is valid only when the signing time is earlier than revocation time.
+      //
+      if (IsValidSignatureByTimestamp (&SigningTime, RevocationTime)) {
+        return TRUE;
       }
     }
-    DbtDataSize -= CertList->SignatureListSize;
-    CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
   }
 
-Done:
-  if (DbtData != NULL) {
-    FreePool (DbtData);
-  }
-
-  return VerifyStatus;
+  return FALSE;
 }
 
 /**
@@ -1210,16 +1183,10 @@ IsForbiddenByDbx (
   IN UINTN                  AuthDataSize
   )
 {
-  EFI_STATUS                Status;
   BOOLEAN                   IsForbidden;
-  UINT8                     *Data;
-  UINTN                     DataSize;
-  EFI_SIGNATURE_LIST        *CertList;
-  UINTN                     CertListSize;
-  EFI_SIGNATURE_DATA        *CertData;
+  SIGNATURE_DATABASE        *Dbx;
   UINT8                     *RootCert;
   UINTN                     RootCertSize;
-  UINTN                     CertCount;
   UINTN                     Index;
   UINT8                     *CertBuffer;
   UINTN                     BufferLength;
@@ -1234,9 +1201,6 @@ IsForbiddenByDbx (
   // Variable Initialization
   //
   IsForbidden       = FALSE;
-  Data              = NULL;
-  CertList          = NULL;
-  CertData          = NULL;
   RootCert          = NULL;
   RootCertSize      = 0;
   Cert              = NULL;
@@ -1248,18 +1212,8 @@ IsForbiddenByDbx (
   //
   // The image will not be forbidden if dbx can't be got.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return IsForbidden;
-  }
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *) Data);
-  if (EFI_ERROR (Status)) {
+  Dbx = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1);
+  if (Dbx->DataSize == 0) {
     return IsForbidden;
   }
 
@@ -1267,42 +1221,28 @@ IsForbiddenByDbx (
   // Verify image signature with RAW X509 certificates in DBX database.
   // If passed, the image will be forbidden.
   //
-  CertList     = (EFI_SIGNATURE_LIST *) Data;
-  CertListSize = DataSize;
-  while ((CertListSize > 0) && (CertListSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      CertData  = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-      for (Index = 0; Index < CertCount; Index++) {
-        //
-        // Iterate each Signature Data Node within this CertList for verify.
-        //
-        RootCert     = CertData->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
-
-        //
-        // Call AuthenticodeVerify library to Verify Authenticode struct.
-        //
-        IsForbidden = AuthenticodeVerify (
-                        AuthData,
-                        AuthDataSize,
-                        RootCert,
-                        RootCertSize,
-                        mImageDigest,
-                        mImageDigestSize
-                        );
-        if (IsForbidden) {
-          DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
-          goto Done;
-        }
+  for (Index = 0; Index < Dbx->CertCount; Index++) {
+    //
+    // Iterate each X.509 certificate in dbx for verify.
+    //
+    RootCert     = Dbx->Certs[Index].Signature->SignatureData;
+    RootCertSize = Dbx->Certs[Index].CertSize;
 
-        CertData = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertData + CertList->SignatureSize);
-      }
+    //
+    // Call AuthenticodeVerify library to Verify Authenticode struct.
+    //
+    IsForbidden = AuthenticodeVerify (
+                    AuthData,
+                    AuthDataSize,
+                    RootCert,
+                    RootCertSize,
+                    mImageDigest,
+                    mImageDigestSize
+                    );
+    if (IsForbidden) {
+      DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
+      goto Done;
     }
-
-    CertListSize -= CertList->SignatureListSize;
-    CertList      = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
   }
 
   //
@@ -1340,7 +1280,7 @@ IsForbiddenByDbx (
     //
     CertPtr = CertPtr + sizeof (UINT32) + CertSize;
 
-    if (IsCertHashFoundInDatabase (Cert, CertSize, (EFI_SIGNATURE_LIST *)Data, DataSize, &RevocationTime)) {
+    if (IsCertHashFoundInDatabase (Cert, CertSize, &RevocationTime)) {
       //
       // Check the timestamp signature and signing time to determine if the image can be trusted.
       //
@@ -1359,10 +1299,6 @@ IsForbiddenByDbx (
   }
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
@@ -1386,119 +1322,62 @@ IsAllowedByDb (
   IN UINTN              AuthDataSize
   )
 {
-  EFI_STATUS                Status;
   BOOLEAN                   VerifyStatus;
-  EFI_SIGNATURE_LIST        *CertList;
-  EFI_SIGNATURE_DATA        *CertData;
-  UINTN                     DataSize;
-  UINT8                     *Data;
+  SIGNATURE_DATABASE        *Db;
+  SIGNATURE_CERT_ENTRY      *CertData;
   UINT8                     *RootCert;
   UINTN                     RootCertSize;
   UINTN                     Index;
-  UINTN                     CertCount;
-  UINTN                     DbxDataSize;
-  UINT8                     *DbxData;
   EFI_TIME                  RevocationTime;
 
-  Data              = NULL;
-  CertList          = NULL;
   CertData          = NULL;
   RootCert          = NULL;
-  DbxData           = NULL;
   RootCertSize      = 0;
   VerifyStatus      = FALSE;
 
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status == EFI_BUFFER_TOO_SMALL) {
-    Data = (UINT8 *) AllocateZeroPool (DataSize);
-    if (Data == NULL) {
-      return VerifyStatus;
-    }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *) Data);
-    if (EFI_ERROR (Status)) {
-      goto Done;
-    }
-
+  //
+  // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
+  //
+  Db = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE);
+  for (Index = 0; Index < Db->CertCount; Index++) {
     //
-    // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
+    // Iterate each X.509 certificate in db for verify.
     //
-    CertList = (EFI_SIGNATURE_LIST *) Data;
-    while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-      if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-        CertData  = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-        CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-        for (Index = 0; Index < CertCount; Index++) {
-          //
-          // Iterate each Signature Data Node within this CertList for verify.
-          //
-          RootCert     = CertData->SignatureData;
-          RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
+    CertData     = &Db->Certs[Index];
+    RootCert     = CertData->Signature->SignatureData;
+    RootCertSize = CertData->CertSize;
 
-          //
-          // Call AuthenticodeVerify library to Verify Authenticode struct.
-          //
-          VerifyStatus = AuthenticodeVerify (
-                           AuthData,
-                           AuthDataSize,
-                           RootCert,
-                           RootCertSize,
-                           mImageDigest,
-                           mImageDigestSize
-                           );
-          if (VerifyStatus) {
-            //
-            // Here We still need to check if this RootCert's Hash is revoked
-            //
-            Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-            if (Status == EFI_BUFFER_TOO_SMALL) {
-              goto Done;
-            }
-            DbxData = (UINT8 *) AllocateZeroPool (DbxDataSize);
-            if (DbxData == NULL) {
-              goto Done;
-            }
-
-            Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *) DbxData);
-            if (EFI_ERROR (Status)) {
-              goto Done;
-            }
-
-            if (IsCertHashFoundInDatabase (RootCert, RootCertSize, (EFI_SIGNATURE_LIST *)DbxData, DbxDataSize, &RevocationTime)) {
-              //
-              // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
-              //
-              VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
-              if (!VerifyStatus) {
-                DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
-              }
-            }
-
-            goto Done;
-          }
-
-          CertData = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertData + CertList->SignatureSize);
+    //
+    // Call AuthenticodeVerify library to Verify Authenticode struct.
+    //
+    VerifyStatus = AuthenticodeVerify (
+                     AuthData,
+                     AuthDataSize,
+                     RootCert,
+                     RootCertSize,
+                     mImageDigest,
+                     mImageDigestSize
+                     );
+    if (VerifyStatus) {
+      //
+      // Here We still need to check if this RootCert's Hash is revoked
+      //
+      if (IsCertHashFoundInDatabase (RootCert, RootCertSize, &RevocationTime)) {
+        //
+        // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
+        //
+        VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
+        if (!VerifyStatus) {
+          DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
         }
       }
 
-      DataSize -= CertList->SignatureListSize;
-      CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+      break;
     }
   }
 
-Done:
-
   if (VerifyStatus) {
-    SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
-  }
-
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-  if (DbxData != NULL) {
-    FreePool (DbxData);
+    SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertData->SignatureList->SignatureSize, CertData->Signature);
   }
 
   return VerifyStatus;
@@ -1590,6 +1469,10 @@ DxeImageVerificationHandler (
   Status            = EFI_ACCESS_DENIED;
   VerifyStatus      = EFI_ACCESS_DENIED;
 
+  //
+  // Digests cached for the previous image must not be used for this one.
+  //
+  InvalidatePeImageDigests ();
 
   //
   // Check the image type and get policy setting.
@@ -1651,6 +1534,11 @@ DxeImageVerificationHandler (
   }
   FreePool (SecureBoot);
 
+  //
+  // db, dbx and dbt may have been updated since the last image was verified.
+  //
+  InvalidateSignatureDatabases ();
+
   //
   // Read the Dos header.
   //
@@ -1742,8 +1630,10 @@ DxeImageVerificationHandler (
 
     if (IsSignatureFoundInDatabase (EFI_IMAGE_SECURITY_DATABASE, mImageDigest, &mCertType, mImageDigestSize)) {
       //
-      // Image Hash is in allowed database (DB).
+      // Image Hash is in allowed database (DB). Let the measurement of the
+      // image use its digests.
       //
+      PublishPeImageDigests ();
       return EFI_SUCCESS;
     }
 
@@ -1850,6 +1740,10 @@ DxeImageVerificationHandler (
   }
 
   if (!EFI_ERROR (VerifyStatus)) {
+    //
+    // Let the measurement of the image use its digests.
+    //
+    PublishPeImageDigests ();
     return EFI_SUCCESS;
   } else {
     Status = EFI_ACCESS_DENIED;
@@ -1874,6 +1768,11 @@ DxeImageVerificationHandler (
 
 Done:
   if (Status != EFI_SUCCESS) {
+    //
+    // The image won't be measured, drop its digests.
+    //
+    InvalidatePeImageDigests ();
+
     //
     // Policy decides to defer or reject the image; add its information in image executable information table.
     //
@@ -1955,6 +1854,12 @@ DxeImageVerificationLibConstructor (
     &Event
     );
 
+  //
+  // Share the image digests with the measurement of the image. Verification
+  // still works without it, so the error is ignored.
+  //
+  InstallPeImageDigestCache ();
+
   return RegisterSecurity2Handler (
           DxeImageVerificationHandler,
           EFI_AUTH_OPERATION_VERIFY_IMAGE | EFI_AUTH_OPERATION_IMAGE_REQUIRED
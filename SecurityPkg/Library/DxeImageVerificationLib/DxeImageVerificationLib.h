@@ -28,6 +28,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/BlockIo.h>
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/VariableWrite.h>
+#include <Protocol/LoadedImage.h>
+#include <Protocol/PeImageDigestCache.h>
 #include <Guid/ImageAuthentication.h>
 #include <Guid/AuthenticatedVariableFormat.h>
 #include <IndustryStandard/PeImage.h>
@@ -73,6 +75,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
 #define MAX_DIGEST_SIZE    SHA512_DIGEST_SIZE
+
+//
+// Size of the chunks an image is hashed in when it is hashed with several
+// algorithms at once
+//
+#define HASH_CHUNK_SIZE    SIZE_64KB
 //
 //
 // PKCS7 Certificate definition
@@ -198,4 +206,213 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+extern HASH_TABLE          mHash[];
+
+//
+// Signature entry in a signature database that is looked up by value,
+// i.e. an image hash or a certificate hash.
+//
+typedef struct {
+  EFI_GUID                 *SignatureType;
+  EFI_SIGNATURE_DATA       *Signature;
+  //
+  // Size of the EFI_SIGNATURE_DATA, including SignatureOwner
+  //
+  UINT32                   SignatureSize;
+  //
+  // Leading bytes of SignatureData that identify the entry. For the
+  // EFI_CERT_X509_SHAxxx types the revocation time that follows the
+  // digest isn't part of the key.
+  //
+  UINT32                   KeySize;
+} SIGNATURE_HASH_ENTRY;
+
+//
+// X.509 certificate entry in a signature database.
+//
+typedef struct {
+  EFI_SIGNATURE_LIST       *SignatureList;
+  EFI_SIGNATURE_DATA       *Signature;
+  UINTN                    CertSize;
+} SIGNATURE_CERT_ENTRY;
+
+//
+// Parsed copy of a signature database variable (db, dbx or dbt).
+//
+typedef struct {
+  CHAR16                   *VariableName;
+  //
+  // TRUE if Data has been checked against the variable for the image
+  // being verified.
+  //
+  BOOLEAN                  Checked;
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  //
+  // Hash entries sorted by type, key size and key.
+  //
+  SIGNATURE_HASH_ENTRY     *Hashes;
+  UINTN                    HashCount;
+  //
+  // Certificate entries in the order they appear in the variable.
+  //
+  SIGNATURE_CERT_ENTRY     *Certs;
+  UINTN                    CertCount;
+} SIGNATURE_DATABASE;
+
+/**
+  Mark all the cached signature databases as unchecked, so that each of them
+  is compared with its variable again the next time it is used.
+
+  It is called once for every image to be verified, as the databases may be
+  updated between two images.
+
+**/
+VOID
+InvalidateSignatureDatabases (
+  VOID
+  );
+
+/**
+  Get the cached signature database of a variable.
+
+  If the database hasn't been checked since the last call to
+  InvalidateSignatureDatabases(), the variable is read and the cache is
+  rebuilt when the variable content is different from the cached copy.
+
+  @param[in]  VariableName      Name of the signature database variable,
+                                EFI_IMAGE_SECURITY_DATABASE, EFI_IMAGE_SECURITY_DATABASE1
+                                or EFI_IMAGE_SECURITY_DATABASE2.
+
+  @return The signature database. It's empty if the variable can't be got.
+  @retval NULL                  VariableName isn't a signature database variable.
+
+**/
+SIGNATURE_DATABASE *
+GetSignatureDatabase (
+  IN CHAR16             *VariableName
+  );
+
+/**
+  Find a hash entry in a signature database by binary search.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     Type of the signature list the entry is in.
+  @param[in]  Key               The hash to search for. If it's NULL, any entry
+                                of SignatureType matches.
+  @param[in]  KeySize           Size of Key in bytes. Ignored if Key is NULL.
+
+  @return The matched entry, or NULL if it's not found.
+
+**/
+SIGNATURE_HASH_ENTRY *
+FindSignatureHash (
+  IN SIGNATURE_DATABASE *Database,
+  IN EFI_GUID           *SignatureType,
+  IN UINT8              *Key,          OPTIONAL
+  IN UINTN              KeySize
+  );
+
+//
+// Authenticode digests of the image being authenticated.
+//
+typedef struct {
+  UINT8                    *ImageBase;
+  UINTN                    ImageSize;
+  //
+  // Copy of the image, taken when it passes verification. The digests are
+  // only handed out through the protocol while it is set.
+  //
+  UINT8                    *ImageCopy;
+  //
+  // Bit (1 << HASHALG_xxx) is set if Digest[HASHALG_xxx] is valid.
+  //
+  UINT32                   ValidMask;
+  UINT8                    Digest[HASHALG_MAX][MAX_DIGEST_SIZE];
+} PE_IMAGE_DIGEST_CACHE;
+
+/**
+  Drop all the cached digests.
+
+**/
+VOID
+InvalidatePeImageDigests (
+  VOID
+  );
+
+/**
+  Get a cached Authenticode digest of an image.
+
+  @param[in]  ImageBase         Start address of the image buffer.
+  @param[in]  ImageSize         Size of the image buffer in bytes.
+  @param[in]  HashAlg           Hash algorithm type, HASHALG_xxx.
+  @param[out] Digest            Buffer to receive the digest. If it's NULL,
+                                only the presence of the digest is checked.
+
+  @retval TRUE                  The digest is cached.
+  @retval FALSE                 The digest isn't cached.
+
+**/
+BOOLEAN
+GetPeImageDigest (
+  IN  UINT8             *ImageBase,
+  IN  UINTN             ImageSize,
+  IN  UINT32            HashAlg,
+  OUT UINT8             *Digest       OPTIONAL
+  );
+
+/**
+  Cache an Authenticode digest of an image.
+
+  Digests of any other image are dropped.
+
+  @param[in]  ImageBase         Start address of the image buffer.
+  @param[in]  ImageSize         Size of the image buffer in bytes.
+  @param[in]  HashAlg           Hash algorithm type, HASHALG_xxx.
+  @param[in]  Digest            The digest.
+
+**/
+VOID
+SetPeImageDigest (
+  IN UINT8              *ImageBase,
+  IN UINTN              ImageSize,
+  IN UINT32             HashAlg,
+  IN UINT8              *Digest
+  );
+
+/**
+  Publish the digests of the image that has just passed verification, for
+  its measurement to get them through the digest cache protocol.
+
+**/
+VOID
+PublishPeImageDigests (
+  VOID
+  );
+
+/**
+  Get the hash algorithms that the consumers of the digest cache protocol
+  have asked for.
+
+  @return Bit (1 << HASHALG_xxx) is set for every algorithm asked for.
+
+**/
+UINT32
+GetWantedPeImageDigests (
+  VOID
+  );
+
+/**
+  Install the digest cache protocol, so that the measurement of an image can
+  reuse the digests calculated for its verification.
+
+  @retval EFI_SUCCESS           The protocol is installed.
+  @retval Others                The protocol can't be installed.
+
+**/
+EFI_STATUS
+InstallPeImageDigestCache (
+  VOID
+  );
+
 #endif
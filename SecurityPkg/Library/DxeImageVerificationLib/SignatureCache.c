@@ -0,0 +1,398 @@
+/** @file
+  Cache of the signature databases used for image verification.
+
+  db, dbx and dbt are read and parsed once, and kept until their variable
+  content changes. Hash entries are sorted so that an image hash or a
+  certificate hash can be looked up by binary search instead of walking
+  every EFI_SIGNATURE_LIST for every image.
+
+  Caution: This file requires additional review when modified.
+  The signature database variables are authenticated when they are written,
+  but their EFI_SIGNATURE_LIST layout is still validated before use.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+SIGNATURE_DATABASE  mSignatureDatabase[] = {
+  { EFI_IMAGE_SECURITY_DATABASE,  FALSE, NULL, 0, NULL, 0, NULL, 0 },
+  { EFI_IMAGE_SECURITY_DATABASE1, FALSE, NULL, 0, NULL, 0, NULL, 0 },
+  { EFI_IMAGE_SECURITY_DATABASE2, FALSE, NULL, 0, NULL, 0, NULL, 0 }
+};
+
+/**
+  Compare a hash entry with a search key.
+
+  Entries are ordered by signature type, then by key size, then by key.
+
+  @param[in]  Entry             The hash entry.
+  @param[in]  SignatureType     Type of the signature list to compare with.
+  @param[in]  Key               The key to compare with. If it's NULL, only
+                                SignatureType is compared.
+  @param[in]  KeySize           Size of Key in bytes.
+
+  @retval 0                     The entry matches the key.
+  @retval <0                    The entry is ordered before the key.
+  @retval >0                    The entry is ordered after the key.
+
+**/
+INTN
+CompareSignatureHash (
+  IN SIGNATURE_HASH_ENTRY  *Entry,
+  IN EFI_GUID              *SignatureType,
+  IN UINT8                 *Key,          OPTIONAL
+  IN UINTN                 KeySize
+  )
+{
+  INTN                     Result;
+
+  Result = CompareMem (Entry->SignatureType, SignatureType, sizeof (EFI_GUID));
+  if ((Result != 0) || (Key == NULL)) {
+    return Result;
+  }
+
+  if (Entry->KeySize != KeySize) {
+    return (Entry->KeySize < KeySize) ? -1 : 1;
+  }
+
+  return CompareMem (Entry->Signature->SignatureData, Key, KeySize);
+}
+
+/**
+  Get the size of the key of the entries in a signature list.
+
+  @param[in]  SignatureList     The signature list.
+
+  @return The key size in bytes, or 0 if the entries aren't looked up by value.
+
+**/
+UINT32
+GetSignatureKeySize (
+  IN EFI_SIGNATURE_LIST    *SignatureList
+  )
+{
+  UINT32                   DataSize;
+  UINT32                   DigestSize;
+
+  DataSize = SignatureList->SignatureSize - sizeof (EFI_GUID);
+
+  if (CompareGuid (&SignatureList->SignatureType, &gEfiCertX509Guid)) {
+    return 0;
+  }
+
+  //
+  // EFI_CERT_X509_SHAxxx entries are the TBSCertificate digest followed by
+  // the revocation time.
+  //
+  if (CompareGuid (&SignatureList->SignatureType, &gEfiCertX509Sha256Guid)) {
+    DigestSize = SHA256_DIGEST_SIZE;
+  } else if (CompareGuid (&SignatureList->SignatureType, &gEfiCertX509Sha384Guid)) {
+    DigestSize = SHA384_DIGEST_SIZE;
+  } else if (CompareGuid (&SignatureList->SignatureType, &gEfiCertX509Sha512Guid)) {
+    DigestSize = SHA512_DIGEST_SIZE;
+  } else {
+    return DataSize;
+  }
+
+  if (DataSize < DigestSize + sizeof (EFI_TIME)) {
+    return 0;
+  }
+
+  return DigestSize;
+}
+
+/**
+  Free the parsed entries and the data of a cached signature database.
+
+  @param[in, out]  Database     The signature database.
+
+**/
+VOID
+FreeSignatureDatabase (
+  IN OUT SIGNATURE_DATABASE  *Database
+  )
+{
+  if (Database->Data != NULL) {
+    FreePool (Database->Data);
+  }
+  if (Database->Hashes != NULL) {
+    FreePool (Database->Hashes);
+  }
+  if (Database->Certs != NULL) {
+    FreePool (Database->Certs);
+  }
+
+  Database->Data      = NULL;
+  Database->DataSize  = 0;
+  Database->Hashes    = NULL;
+  Database->HashCount = 0;
+  Database->Certs     = NULL;
+  Database->CertCount = 0;
+}
+
+/**
+  Parse the signature lists in the data of a signature database into
+  the sorted hash entries and the certificate entries.
+
+  Parsing stops at the first malformed signature list; the entries before
+  it are kept.
+
+  @param[in, out]  Database     The signature database whose Data is set.
+
+  @retval EFI_SUCCESS           The database is parsed.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the entries.
+
+**/
+EFI_STATUS
+ParseSignatureDatabase (
+  IN OUT SIGNATURE_DATABASE  *Database
+  )
+{
+  EFI_SIGNATURE_LIST         *CertList;
+  EFI_SIGNATURE_DATA         *Cert;
+  UINTN                      DataSize;
+  UINTN                      CertCount;
+  UINTN                      HashCount;
+  UINTN                      Index;
+  UINTN                      Pass;
+  UINTN                      Sorted;
+  UINT32                     KeySize;
+  SIGNATURE_HASH_ENTRY       Entry;
+
+  //
+  // The first pass counts the entries, the second one fills them in.
+  //
+  for (Pass = 0; Pass < 2; Pass++) {
+    CertCount = 0;
+    HashCount = 0;
+    CertList  = (EFI_SIGNATURE_LIST *) Database->Data;
+    DataSize  = Database->DataSize;
+    while ((DataSize >= sizeof (EFI_SIGNATURE_LIST)) &&
+           (CertList->SignatureListSize >= sizeof (EFI_SIGNATURE_LIST)) &&
+           (DataSize >= CertList->SignatureListSize)) {
+      if ((CertList->SignatureSize <= sizeof (EFI_GUID)) ||
+          (CertList->SignatureHeaderSize > CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST))) {
+        break;
+      }
+
+      Cert    = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+      KeySize = GetSignatureKeySize (CertList);
+      for (Index = 0; Index < (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize; Index++) {
+        if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
+          if (Pass == 1) {
+            Database->Certs[CertCount].SignatureList = CertList;
+            Database->Certs[CertCount].Signature     = Cert;
+            Database->Certs[CertCount].CertSize      = CertList->SignatureSize - sizeof (EFI_GUID);
+          }
+          CertCount++;
+        } else if (KeySize != 0) {
+          if (Pass == 1) {
+            Database->Hashes[HashCount].SignatureType = &CertList->SignatureType;
+            Database->Hashes[HashCount].Signature     = Cert;
+            Database->Hashes[HashCount].SignatureSize = CertList->SignatureSize;
+            Database->Hashes[HashCount].KeySize       = KeySize;
+          }
+          HashCount++;
+        }
+
+        Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
+      }
+
+      DataSize -= CertList->SignatureListSize;
+      CertList  = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+    }
+
+    if (Pass == 0) {
+      if (CertCount != 0) {
+        Database->Certs = AllocatePool (CertCount * sizeof (SIGNATURE_CERT_ENTRY));
+        if (Database->Certs == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+      }
+      if (HashCount != 0) {
+        Database->Hashes = AllocatePool (HashCount * sizeof (SIGNATURE_HASH_ENTRY));
+        if (Database->Hashes == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+      }
+    }
+  }
+
+  Database->CertCount = CertCount;
+  Database->HashCount = HashCount;
+
+  //
+  // Sort the hash entries. The databases only change on a Secure Boot key
+  // update, so a simple insertion sort is good enough.
+  //
+  for (Sorted = 1; Sorted < HashCount; Sorted++) {
+    CopyMem (&Entry, &Database->Hashes[Sorted], sizeof (Entry));
+    for (Index = Sorted; Index > 0; Index--) {
+      if (CompareSignatureHash (
+            &Database->Hashes[Index - 1],
+            Entry.SignatureType,
+            Entry.Signature->SignatureData,
+            Entry.KeySize
+            ) <= 0) {
+        break;
+      }
+      CopyMem (&Database->Hashes[Index], &Database->Hashes[Index - 1], sizeof (Entry));
+    }
+    CopyMem (&Database->Hashes[Index], &Entry, sizeof (Entry));
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mark all the cached signature databases as unchecked, so that each of them
+  is compared with its variable again the next time it is used.
+
+  It is called once for every image to be verified, as the databases may be
+  updated between two images.
+
+**/
+VOID
+InvalidateSignatureDatabases (
+  VOID
+  )
+{
+  UINTN                Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    mSignatureDatabase[Index].Checked = FALSE;
+  }
+}
+
+/**
+  Get the cached signature database of a variable.
+
+  If the database hasn't been checked since the last call to
+  InvalidateSignatureDatabases(), the variable is read and the cache is
+  rebuilt when the variable content is different from the cached copy.
+
+  @param[in]  VariableName      Name of the signature database variable,
+                                EFI_IMAGE_SECURITY_DATABASE, EFI_IMAGE_SECURITY_DATABASE1
+                                or EFI_IMAGE_SECURITY_DATABASE2.
+
+  @return The signature database. It's empty if the variable can't be got.
+  @retval NULL                  VariableName isn't a signature database variable.
+
+**/
+SIGNATURE_DATABASE *
+GetSignatureDatabase (
+  IN CHAR16             *VariableName
+  )
+{
+  EFI_STATUS            Status;
+  SIGNATURE_DATABASE    *Database;
+  UINT8                 *Data;
+  UINTN                 DataSize;
+  UINTN                 Index;
+
+  Database = NULL;
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    if (StrCmp (VariableName, mSignatureDatabase[Index].VariableName) == 0) {
+      Database = &mSignatureDatabase[Index];
+      break;
+    }
+  }
+
+  if ((Database == NULL) || Database->Checked) {
+    return Database;
+  }
+
+  Database->Checked = TRUE;
+
+  Data     = NULL;
+  DataSize = 0;
+  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Data = AllocatePool (DataSize);
+    if (Data != NULL) {
+      Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
+      if (EFI_ERROR (Status)) {
+        FreePool (Data);
+        Data     = NULL;
+        DataSize = 0;
+      }
+    } else {
+      DataSize = 0;
+    }
+  }
+
+  //
+  // Keep the parsed entries if the variable is unchanged.
+  //
+  if ((DataSize == Database->DataSize) &&
+      ((DataSize == 0) || (CompareMem (Data, Database->Data, DataSize) == 0))) {
+    if (Data != NULL) {
+      FreePool (Data);
+    }
+    return Database;
+  }
+
+  FreeSignatureDatabase (Database);
+  if (Data == NULL) {
+    return Database;
+  }
+
+  Database->Data     = Data;
+  Database->DataSize = DataSize;
+  Status = ParseSignatureDatabase (Database);
+  if (EFI_ERROR (Status)) {
+    FreeSignatureDatabase (Database);
+    //
+    // Don't take the empty result as the variable content, parse it again
+    // next time.
+    //
+    Database->Checked = FALSE;
+  }
+
+  return Database;
+}
+
+/**
+  Find a hash entry in a signature database by binary search.
+
+  @param[in]  Database          The signature database.
+  @param[in]  SignatureType     Type of the signature list the entry is in.
+  @param[in]  Key               The hash to search for. If it's NULL, any entry
+                                of SignatureType matches.
+  @param[in]  KeySize           Size of Key in bytes. Ignored if Key is NULL.
+
+  @return The matched entry, or NULL if it's not found.
+
+**/
+SIGNATURE_HASH_ENTRY *
+FindSignatureHash (
+  IN SIGNATURE_DATABASE *Database,
+  IN EFI_GUID           *SignatureType,
+  IN UINT8              *Key,          OPTIONAL
+  IN UINTN              KeySize
+  )
+{
+  UINTN                 Low;
+  UINTN                 High;
+  UINTN                 Middle;
+  INTN                  Result;
+
+  Low  = 0;
+  High = Database->HashCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareSignatureHash (&Database->Hashes[Middle], SignatureType, Key, KeySize);
+    if (Result == 0) {
+      return &Database->Hashes[Middle];
+    } else if (Result < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return NULL;
+}
@@ -15,6 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID  Guid;
   UINT32    Mask;
@@ -70,3 +72,56 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count ++;
 }
+
+/**
+  Update the hash contexts of all the hash interfaces in use with the data.
+
+  The data is fed in blocks of HASH_UPDATE_BLOCK_SIZE bytes, so a large buffer
+  is only read from memory once, however many PCR banks it is hashed for.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one for each registered hash interface.
+  @param HashMask           Mask of the hash algorithms in use.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+Tpm2InterleavedHashUpdate (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  UINTN  ActiveIndex[HASH_COUNT];
+  UINTN  ActiveCount;
+  UINTN  Index;
+  UINT8  *Block;
+  UINTN  BlockSize;
+
+  ActiveCount = 0;
+  for (Index = 0; (Index < HashInterfaceCount) && (ActiveCount < HASH_COUNT); Index++) {
+    if ((Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid) & HashMask) != 0) {
+      ActiveIndex[ActiveCount++] = Index;
+    }
+  }
+
+  if (ActiveCount == 1) {
+    HashInterface[ActiveIndex[0]].HashUpdate (HashCtx[ActiveIndex[0]], DataToHash, DataToHashLen);
+    return;
+  }
+
+  Block = DataToHash;
+  while (DataToHashLen > 0) {
+    BlockSize = MIN (DataToHashLen, HASH_UPDATE_BLOCK_SIZE);
+    for (Index = 0; Index < ActiveCount; Index++) {
+      HashInterface[ActiveIndex[Index]].HashUpdate (HashCtx[ActiveIndex[Index]], Block, BlockSize);
+    }
+    Block         += BlockSize;
+    DataToHashLen -= BlockSize;
+  }
+}
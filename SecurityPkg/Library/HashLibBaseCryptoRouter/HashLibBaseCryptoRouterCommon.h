@@ -9,6 +9,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// Size of the blocks the data is fed to the hash interfaces in, when more
+// than one of them is in use. A block is hashed by every interface before
+// the next one, so it should fit in the CPU data cache.
+//
+#define HASH_UPDATE_BLOCK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -35,4 +42,28 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES     *Digest
   );
 
+/**
+  Update the hash contexts of all the hash interfaces in use with the data.
+
+  The data is fed in blocks of HASH_UPDATE_BLOCK_SIZE bytes, so a large buffer
+  is only read from memory once, however many PCR banks it is hashed for.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one for each registered hash interface.
+  @param HashMask           Mask of the hash algorithms in use.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+Tpm2InterleavedHashUpdate (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
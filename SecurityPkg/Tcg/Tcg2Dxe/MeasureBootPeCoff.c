@@ -22,9 +22,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PeCoffLib.h>
 #include <Library/Tpm2CommandLib.h>
 #include <Library/HashLib.h>
+#include <Library/PcdLib.h>
+#include <Protocol/PeImageDigestCache.h>
 
 UINTN  mTcg2DxeImageSize = 0;
 
+//
+// Hash algorithms that may be found in the PE image digest cache
+//
+TPMI_ALG_HASH  mCachedDigestHashAlg[] = {
+  TPM_ALG_SHA1,
+  TPM_ALG_SHA256,
+  TPM_ALG_SHA384,
+  TPM_ALG_SHA512
+};
+
 /**
   Reads contents of a PE/COFF image in memory buffer.
 
@@ -73,6 +85,65 @@ Tcg2DxeImageRead (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the digests of a PE/COFF image for all the PCR banks in use, if the image
+  verification handler has just verified this image.
+
+  The cached digests can only be got once, they are dropped by this call.
+
+  @param[in]  ImageAddress   Start address of image buffer.
+  @param[in]  ImageSize      Image size
+  @param[out] DigestList     Digest list of this image.
+
+  @retval TRUE               DigestList holds the digest of every PCR bank in use.
+  @retval FALSE              At least one of the digests is not cached.
+**/
+BOOLEAN
+GetCachedPeImageDigests (
+  IN  EFI_PHYSICAL_ADDRESS      ImageAddress,
+  IN  UINTN                     ImageSize,
+  OUT TPML_DIGEST_VALUES        *DigestList
+  )
+{
+  EFI_STATUS                            Status;
+  EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *DigestCache;
+  UINT32                                HashMask;
+  UINTN                                 Index;
+
+  Status = gBS->LocateProtocol (&gEdkiiPeImageDigestCacheProtocolGuid, NULL, (VOID **) &DigestCache);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  ZeroMem (DigestList, sizeof (*DigestList));
+  HashMask = PcdGet32 (PcdTpm2HashMask);
+  for (Index = 0; Index < ARRAY_SIZE (mCachedDigestHashAlg); Index++) {
+    if ((GetHashMaskFromAlgo (mCachedDigestHashAlg[Index]) & HashMask) != 0) {
+      DigestList->digests[DigestList->count].hashAlg = mCachedDigestHashAlg[Index];
+      DigestList->count++;
+    }
+  }
+
+  //
+  // Ask even if some bank can't be served, so that the cache is dropped
+  // and learns the algorithms to calculate for the next images.
+  //
+  Status = DigestCache->GetDigests (
+                          DigestCache,
+                          (VOID *) (UINTN) ImageAddress,
+                          ImageSize,
+                          DigestList
+                          );
+  if (EFI_ERROR (Status) || (DigestList->count == 0)) {
+    return FALSE;
+  }
+
+  //
+  // PCR banks using other algorithms can't be served by the cache.
+  //
+  return (BOOLEAN) ((HashMask & ~(HASH_ALG_SHA1 | HASH_ALG_SHA256 | HASH_ALG_SHA384 | HASH_ALG_SHA512)) == 0);
+}
+
 /**
   Measure PE image into TPM log based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A.
@@ -153,6 +224,14 @@ MeasurePeImageAndExtend (
     goto Finish;
   }
 
+  //
+  // The image verification handler may have hashed this image already.
+  //
+  if (GetCachedPeImageDigests (ImageAddress, ImageSize, DigestList)) {
+    Status = Tpm2PcrExtend (PCRIndex, DigestList);
+    goto Finish;
+  }
+
   //
   // PE/COFF Image Measurement
   //